@@ -470,6 +470,7 @@ set(BASE_CMN_SRC
     src/common/tarstrm.cpp
     src/common/textbuf.cpp
     src/common/textfile.cpp
+    src/common/threadpool.cpp
     src/common/time.cpp
     src/common/timercmn.cpp
     src/common/timerimpl.cpp
@@ -787,6 +788,7 @@ set(GUI_CMN_SRC
     src/common/geometry.cpp
     src/common/gifdecod.cpp
     src/common/graphcmn.cpp
+    src/common/graphrec.cpp
     src/common/headercolcmn.cpp
     src/common/headerctrlcmn.cpp
     src/common/helpbase.cpp
@@ -794,6 +796,7 @@ set(GUI_CMN_SRC
     src/common/imagall.cpp
     src/common/imagbmp.cpp
     src/common/image.cpp
+    src/common/imagebatch.cpp
     src/common/imagfill.cpp
     src/common/imaggif.cpp
     src/common/imagiff.cpp
@@ -1001,6 +1004,7 @@ set(GUI_CMN_HDR
     wx/generic/textdlgg.h
     wx/generic/treectlg.h
     wx/graphics.h
+    wx/graphrec.h
     wx/headercol.h
     wx/headerctrl.h
     wx/helphtml.h
@@ -1105,6 +1109,7 @@ set(GUI_CMN_HDR
     wx/iconbndl.h
     wx/imagbmp.h
     wx/image.h
+    wx/imagebatch.h
     wx/imaggif.h
     wx/imagiff.h
     wx/imagjpeg.h
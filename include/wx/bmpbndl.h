@@ -20,6 +20,29 @@ class WXDLLIMPEXP_FWD_CORE wxImageList;
 class WXDLLIMPEXP_FWD_BASE wxVariant;
 class WXDLLIMPEXP_FWD_CORE wxWindow;
 
+#ifdef wxHAS_SVG
+
+// ----------------------------------------------------------------------------
+// wxBitmapBundleCacheStats contains statistics of the cache of bitmaps
+// rasterized from SVG
+// ----------------------------------------------------------------------------
+
+struct wxBitmapBundleCacheStats
+{
+    // Number of bitmaps requests which were satisfied from the cache or not.
+    unsigned long hits = 0,
+                  misses = 0;
+
+    // Number of bitmaps removed from the cache to stay within its limit.
+    unsigned long evictions = 0;
+
+    // Number of bitmaps currently in the cache and their total size in bytes.
+    size_t count = 0,
+           bytes = 0;
+};
+
+#endif // wxHAS_SVG
+
 // ----------------------------------------------------------------------------
 // wxBitmapBundle provides 1 or more versions of a bitmap, all bundled together
 // ----------------------------------------------------------------------------
@@ -98,6 +121,27 @@ public:
     // On MacOS, name must be a file with an extension "svg" placed in the
     // "Resources" subdirectory of the application bundle.
     wxNODISCARD static wxBitmapBundle FromSVGResource(const wxString& name, const wxSize& sizeDef);
+
+    // Load several SVG files at once, reading and parsing them in parallel.
+    // The bundles corresponding to the files which couldn't be loaded are
+    // invalid.
+    wxNODISCARD static wxVector<wxBitmapBundle>
+    FromSVGFiles(const wxVector<wxString>& paths, const wxSize& sizeDef);
+
+    // The bitmaps rasterized from SVG are kept in a cache shared by all
+    // bundles, which uses at most the given amount of memory, 0 disables it.
+    static void SetSVGCacheLimit(size_t maxBytes);
+    wxNODISCARD static size_t GetSVGCacheLimit();
+
+    // Remove all the bitmaps from the cache and reset its statistics.
+    static void ClearSVGCache();
+
+    wxNODISCARD static wxBitmapBundleCacheStats GetSVGCacheStats();
+
+    // Rasterize the bitmaps of all the given sizes for all SVG bundles in
+    // background threads and put them into the cache when they're ready.
+    static void PrerasterizeSVG(const wxVector<wxBitmapBundle>& bundles,
+                                const wxVector<wxSize>& sizes);
 #endif // wxHAS_SVG
 
     // Create from the resources: all existing versions of the bitmap of the
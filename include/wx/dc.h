@@ -28,6 +28,7 @@
 #include "wx/image.h"
 #include "wx/region.h"
 #include "wx/affinematrix2d.h"
+#include "wx/vector.h"
 
 #define wxUSE_NEW_DC 1
 
@@ -359,6 +360,9 @@ public:
                                         wxCoord *heightLine = nullptr,
                                         const wxFont *font = nullptr) const;
     virtual bool DoGetPartialTextExtents(const wxString& text, wxArrayInt& widths) const;
+    virtual void DoGetMultipleTextExtents(const wxArrayString& strings,
+                                          wxVector<wxSize>& extents,
+                                          const wxFont *font = nullptr) const;
 
     // clearing
 
@@ -828,6 +832,11 @@ public:
     bool GetPartialTextExtents(const wxString& text, wxArrayInt& widths) const
         { return m_pimpl->DoGetPartialTextExtents(text, widths); }
 
+    void GetMultipleTextExtents(const wxArrayString& strings,
+                                wxVector<wxSize>& extents,
+                                const wxFont *font = nullptr) const
+        { m_pimpl->DoGetMultipleTextExtents(strings, extents, font); }
+
     // coordinates conversions and transforms
 
     wxCoord DeviceToLogicalX(wxCoord x) const
@@ -35,6 +35,11 @@
 // is private style and not returned by GetStyle.
 #define wxBUFFER_USES_SHARED_BUFFER 0x04
 
+// Keeps the buffer bitmap associated with the window between paint events and
+// only redraws and blits the parts of it which need to be updated. Can only be
+// used with wxBufferedPaintDC and wxBUFFER_CLIENT_AREA.
+#define wxBUFFER_PERSISTENT         0x08
+
 class WXDLLIMPEXP_CORE wxBufferedDC : public wxMemoryDC
 {
 public:
@@ -102,6 +107,10 @@ public:
     void SetStyle(int style) { m_style = style; }
     int GetStyle() const { return m_style & ~wxBUFFER_USES_SHARED_BUFFER; }
 
+    // Return the part of the buffer, in device coordinates, which needs to be
+    // redrawn when using wxBUFFER_PERSISTENT style.
+    const wxRegion& GetDirtyRegion() const { return m_dirtyRegion; }
+
 private:
     // common part of Init()s
     void InitCommon(wxDC *dc, int style)
@@ -115,6 +124,9 @@ private:
     // check that the bitmap is valid and use it
     void UseBuffer(wxCoord w = -1, wxCoord h = -1);
 
+    // blit the given part of the buffer, in device coordinates, to m_dc
+    void BlitToDC(const wxRect& rect, wxCoord x, wxCoord y);
+
     // the underlying DC to which we copy everything drawn on this one in
     // UnMask()
     //
@@ -130,6 +142,10 @@ private:
 
     wxSize m_area;
 
+    // the part of the buffer which needs to be redrawn and copied to the
+    // screen, only used with wxBUFFER_PERSISTENT
+    wxRegion m_dirtyRegion;
+
     wxDECLARE_DYNAMIC_CLASS(wxBufferedDC);
     wxDECLARE_NO_COPY_CLASS(wxBufferedDC);
 };
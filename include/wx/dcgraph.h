@@ -213,6 +213,9 @@ public:
         const wxFont *theFont = nullptr) const override;
 
     virtual bool DoGetPartialTextExtents(const wxString& text, wxArrayInt& widths) const override;
+    virtual void DoGetMultipleTextExtents(const wxArrayString& strings,
+                                          wxVector<wxSize>& extents,
+                                          const wxFont *theFont = nullptr) const override;
 
 #ifdef __WXMSW__
     virtual wxRect MSWApplyGDIPlusTransform(const wxRect& r) const override;
@@ -17,6 +17,8 @@
 #include "wx/dc.h"
 
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 #define wxSVGVersion wxT("v0101")
 
@@ -30,10 +32,10 @@ enum wxSVGShapeRenderingMode
     wxSVG_SHAPE_RENDERING_OPTIMISE_SPEED = wxSVG_SHAPE_RENDERING_OPTIMIZE_SPEED
 };
 
-class WXDLLIMPEXP_FWD_BASE wxFileOutputStream;
-
 class WXDLLIMPEXP_FWD_CORE wxSVGFileDC;
 
+class wxSVGStreamWriter;
+
 // Base class for bitmap handlers used by wxSVGFileDC, used by the standard
 // "embed" and "link" handlers below but can also be used to create a custom
 // handler.
@@ -141,6 +143,8 @@ public:
 
     void SetShapeRenderingMode(wxSVGShapeRenderingMode renderingMode);
 
+    void EnableBitmapSharing(bool enable) { m_shareBitmaps = enable; }
+
 private:
     virtual bool DoGetPixel(wxCoord WXUNUSED(x), wxCoord WXUNUSED(y),
                             wxColour* WXUNUSED(col)) const override
@@ -271,10 +275,26 @@ private:
     bool                m_graphics_changed;  // set by Set{Brush,Pen}()
     int                 m_width, m_height;
     double              m_dpi;
-    std::unique_ptr<wxFileOutputStream> m_outfile;
+    std::unique_ptr<wxSVGStreamWriter> m_writer;
     std::unique_ptr<wxSVGBitmapHandler> m_bmp_handler; // class to handle bitmaps
     wxSVGShapeRenderingMode m_renderingMode;
 
+    // If true, each distinct bitmap is written only once.
+    bool m_shareBitmaps;
+
+    // The already written bitmaps, indexed by their contents hash, used when
+    // sharing the bitmaps. The contents is kept to check that the bitmaps
+    // with the same hash are really identical.
+    struct SharedBitmap
+    {
+        int id;
+        wxImage image;
+    };
+    std::unordered_multimap<wxUint64, SharedBitmap> m_sharedBitmaps;
+
+    // Names of the already written brush patterns.
+    std::unordered_set<wxString> m_brushPatterns;
+
     // The clipping nesting level is incremented by every call to
     // SetClippingRegion() and reset when DestroyClippingRegion() is called.
     size_t m_clipNestingLevel;
@@ -310,6 +330,9 @@ public:
 
     void SetShapeRenderingMode(wxSVGShapeRenderingMode renderingMode);
 
+    // Write each distinct bitmap only once and refer to it elsewhere.
+    void EnableBitmapSharing(bool enable = true);
+
 private:
     wxDECLARE_ABSTRACT_CLASS(wxSVGFileDC);
 };
@@ -20,6 +20,9 @@
 #include "wx/cmndata.h"
 #include "wx/strvararg.h"
 
+#include <initializer_list>
+#include <string>
+
 //-----------------------------------------------------------------------------
 // wxPostScriptDC
 //-----------------------------------------------------------------------------
@@ -33,6 +36,10 @@ public:
     // Recommended constructor
     wxPostScriptDC(const wxPrintData& printData);
 
+    // Compress the bitmaps data using Flate filter, which requires a
+    // PostScript level 3 interpreter.
+    void EnableImageCompression(bool enable = true);
+
 private:
     wxDECLARE_DYNAMIC_CLASS(wxPostScriptDC);
 };
@@ -92,6 +99,10 @@ public:
     virtual int GetDepth() const override { return 24; }
 
     void PsPrint( const wxString& psdata );
+    void PsPrint( const char* psdata );
+    void PsPrint( char ch );
+
+    void EnableImageCompression(bool enable);
 
     // Overridden for wxPrinterDC Impl
 
@@ -149,6 +160,18 @@ protected:
     // Set PostScript color
     void SetPSColour(const wxColour& col);
 
+    // Append the data to the output buffer, writing it out when it's full.
+    void PsWrite(const char* data, size_t len);
+    // Print the given numbers, in compact format, followed by the operator.
+    void PsPrintOp(std::initializer_list<double> values, const char* op);
+    // Print the path consisting of straight lines between the points.
+    void PsPrintPolyPath(int n, const wxPoint points[],
+                         wxCoord xoffset, wxCoord yoffset);
+    // Print the data using ASCII85 encoding, including the EOD marker.
+    void PsPrintASCII85(const unsigned char* data, size_t len);
+    // Write all the buffered data to the output file or stream.
+    void PsFlush();
+
     FILE*             m_pstream;    // PostScript output stream
     unsigned char     m_currentRed;
     unsigned char     m_currentGreen;
@@ -161,6 +184,8 @@ protected:
     double            m_pageHeight;
     wxArrayString     m_definedPSFonts;
     bool              m_isFontChanged;
+    bool              m_compressImages;
+    std::string       m_psBuffer;   // not yet written output
 
 private:
     wxDECLARE_DYNAMIC_CLASS(wxPostScriptDCImpl);
@@ -87,6 +87,21 @@ enum wxGridRenderStyle
                           wxGRID_DRAW_BOX_RECT
 };
 
+// Flags used with wxGrid::SetColAutoSizeMode() to select how the cells are
+// measured when auto-sizing the columns.
+enum wxGridAutoSizeFlags
+{
+    // measure all cells using their renderers
+    wxGRID_AUTOSIZE_DEFAULT = 0x000,
+
+    // measure the text of each distinct value only once, using several
+    // threads if possible
+    wxGRID_AUTOSIZE_FAST = 0x001,
+
+    // measure only the currently visible rows
+    wxGRID_AUTOSIZE_VISIBLE_ROWS = 0x002
+};
+
 // ----------------------------------------------------------------------------
 // forward declarations
 // ----------------------------------------------------------------------------
@@ -120,6 +135,7 @@ class wxGridOperations;
 class wxGridRowOperations;
 class wxGridColumnOperations;
 class wxGridDirectionOperations;
+class wxGridTextWidthCache;
 
 #if wxUSE_ACCESSIBILITY
 class WXDLLIMPEXP_FWD_CORE wxGridAccessible;
@@ -271,6 +287,17 @@ public:
                                   wxGridCellAttr& attr,
                                   wxDC& dc);
 
+    // If the best size of the cell is just the extent of its text using the
+    // attribute font, as is the case for wxGridCellStringRenderer, this
+    // function can be overridden to return true and the text. This allows
+    // wxGrid to measure the cells faster when wxGRID_AUTOSIZE_FAST is used.
+    virtual bool GetTextToMeasure(wxGrid& WXUNUSED(grid),
+                                  int WXUNUSED(row), int WXUNUSED(col),
+                                  wxString& WXUNUSED(text))
+    {
+        return false;
+    }
+
 protected:
     // set the text colours before drawing
     void SetTextColoursAndFont(const wxGrid& grid,
@@ -1505,6 +1532,207 @@ private:
 };
 
 
+// ------ wxGridColumnarTable
+//
+// Data table storing the values of each column in a vector of the column
+// type, which is much more compact than wxGridStringTable for big tables and
+// avoids converting the values to strings until they're displayed
+//
+
+class WXDLLIMPEXP_CORE wxGridColumnarTable : public wxGridTableBase
+{
+public:
+    // types of the values which can be stored in the columns
+    enum ColumnType
+    {
+        Column_Number,  // 64-bit integers, wxGRID_VALUE_NUMBER
+        Column_Float,   // doubles, wxGRID_VALUE_FLOAT
+        Column_Bool,    // booleans, wxGRID_VALUE_BOOL
+        Column_String   // strings, wxGRID_VALUE_STRING
+    };
+
+    wxGridColumnarTable();
+    explicit wxGridColumnarTable( int numRows );
+
+    // add a column of the given type, all its cells are initialized with the
+    // default value, i.e. 0, false or empty string
+    void AppendColumn( ColumnType type, const wxString& label = wxString() );
+    ColumnType GetColumnType( int col ) const;
+
+    // preallocate memory for the given total number of rows
+    void ReserveRows( size_t numRows );
+
+    // set the values of the given number of cells in the column starting at
+    // the given row, the column must be of the corresponding type
+    void SetNumberValues( int col, size_t row,
+                          const wxLongLong_t* values, size_t count );
+    void SetFloatValues( int col, size_t row,
+                         const double* values, size_t count );
+    void SetBoolValues( int col, size_t row,
+                        const bool* values, size_t count );
+    void SetStringValues( int col, size_t row,
+                          const wxString* values, size_t count );
+
+    // access the full 64-bit value of the cells in a number column
+    wxLongLong_t GetValueAsLongLong( int row, int col ) const;
+    void SetValueAsLongLong( int row, int col, wxLongLong_t value );
+
+    // these are pure virtual in wxGridTableBase
+    //
+    virtual int GetNumberRows() override { return static_cast<int>(m_numRows); }
+    virtual int GetNumberCols() override { return static_cast<int>(m_columns.size()); }
+    virtual wxString GetValue( int row, int col ) override;
+    virtual void SetValue( int row, int col, const wxString& s ) override;
+
+    // overridden functions from wxGridTableBase
+    //
+    bool IsEmptyCell( int row, int col ) override;
+
+    wxString GetTypeName( int row, int col ) override;
+    bool CanGetValueAs( int row, int col, const wxString& typeName ) override;
+
+    long GetValueAsLong( int row, int col ) override;
+    double GetValueAsDouble( int row, int col ) override;
+    bool GetValueAsBool( int row, int col ) override;
+
+    void SetValueAsLong( int row, int col, long value ) override;
+    void SetValueAsDouble( int row, int col, double value ) override;
+    void SetValueAsBool( int row, int col, bool value ) override;
+
+    void Clear() override;
+    bool InsertRows( size_t pos = 0, size_t numRows = 1 ) override;
+    bool AppendRows( size_t numRows = 1 ) override;
+    bool DeleteRows( size_t pos = 0, size_t numRows = 1 ) override;
+
+    // the columns inserted by these functions contain strings
+    bool InsertCols( size_t pos = 0, size_t numCols = 1 ) override;
+    bool AppendCols( size_t numCols = 1 ) override;
+    bool DeleteCols( size_t pos = 0, size_t numCols = 1 ) override;
+
+    void SetColLabelValue( int col, const wxString& ) override;
+    wxString GetColLabelValue( int col ) override;
+
+private:
+    // the values of a single column, only the vector corresponding to its
+    // type is used
+    struct Column
+    {
+        explicit Column(ColumnType type_) : type(type_) { }
+
+        void Insert(size_t pos, size_t count);
+        void Erase(size_t pos, size_t count);
+        void Reserve(size_t count);
+        void Reset();
+
+        // return the index of the given string in the dictionary, adding it
+        // if necessary
+        wxUint32 GetStringIndex(const wxString& s);
+
+        ColumnType type;
+        wxString label;
+
+        std::vector<wxLongLong_t> numbers;
+        std::vector<double> floats;
+        std::vector<bool> bools;
+
+        // indices of the strings in the dictionary of all the distinct
+        // strings used in this column, the empty string always has index 0
+        std::vector<wxUint32> strings;
+        std::vector<wxString> dict;
+        std::unordered_map<wxString, wxUint32> dictIndex;
+    };
+
+    // return the column if the given cell is valid or nullptr otherwise
+    Column* GetColumn( int row, int col );
+    const Column* GetColumn( int row, int col ) const;
+
+    // return the column for bulk setting the values of the given type
+    Column* GetColumnForValues( int col, ColumnType type,
+                                size_t row, size_t count );
+
+    // insert string columns without notifying the view
+    void DoInsertCols( size_t pos, size_t numCols );
+
+    std::vector<Column> m_columns;
+    size_t m_numRows;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxGridColumnarTable);
+};
+
+
+// ------ wxGridAsyncTable
+//
+// Read-only table serving the cells from a cache of row blocks filled by
+// fetching the data from a possibly slow wxGridAsyncDataSource in a
+// background thread, so that drawing the grid never waits for it
+//
+
+class WXDLLIMPEXP_CORE wxGridAsyncDataSource
+{
+public:
+    wxGridAsyncDataSource() = default;
+    virtual ~wxGridAsyncDataSource() = default;
+
+    // these functions are called from the main thread and must be fast
+    virtual int GetNumberRows() = 0;
+    virtual int GetNumberCols() = 0;
+
+    // this function is called from a worker thread and must fill the values
+    // with numRows*numCols strings in row-major order, it must not use any
+    // GUI functions and return false if fetching the data failed
+    virtual bool FetchRows( int firstRow, int numRows, int numCols,
+                            wxVector<wxString>& values ) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridAsyncDataSource);
+};
+
+class wxGridAsyncTableImpl;
+
+class WXDLLIMPEXP_CORE wxGridAsyncTable : public wxGridTableBase
+{
+public:
+    // the table takes ownership of the data source
+    explicit wxGridAsyncTable( wxGridAsyncDataSource* source,
+                               int blockSize = 128 );
+    virtual ~wxGridAsyncTable();
+
+    wxGridAsyncDataSource* GetDataSource() const;
+
+    // number of blocks fetched on each side of the visible ones
+    void SetPrefetchBlocks( int numBlocks );
+
+    // maximal number of blocks kept in the cache
+    void SetCacheSize( int numBlocks );
+
+    // text shown in the cells which are still being fetched
+    void SetPlaceholder( const wxString& placeholder );
+    const wxString& GetPlaceholder() const;
+
+    // check if the row data is in the cache
+    bool IsRowAvailable( int row ) const;
+
+    // discard all the cached data and fetch it again, this must be called
+    // after the data source contents changes
+    void InvalidateCache();
+
+    // these are pure virtual in wxGridTableBase
+    //
+    virtual int GetNumberRows() override;
+    virtual int GetNumberCols() override;
+    virtual wxString GetValue( int row, int col ) override;
+
+    // the table is read-only, this function does nothing
+    virtual void SetValue( int row, int col, const wxString& s ) override;
+
+    void SetView( wxGrid *grid ) override;
+
+private:
+    wxGridAsyncTableImpl* const m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridAsyncTable);
+};
+
+
 
 // ============================================================================
 //  Grid view classes
@@ -1542,6 +1770,150 @@ struct WXDLLIMPEXP_CORE wxGridSizesInfo
     wxUnsignedToIntHashMap m_customSizes;
 };
 
+// ----------------------------------------------------------------------------
+// wxGridLineSizes: sizes and positions of the grid rows or columns
+//
+// This class is used by wxGrid implementation only. It stores the sizes of
+// the lines indexed by their index and allows to find the start and end of
+// the line, using its display position, and the line at the given coordinate
+// in O(log n) time.
+//
+// Initially only the sizes different from the base one are stored, which
+// allows to use it even for huge grids, but if there are too many of them or
+// if the lines are reordered, the sizes of all lines are stored together
+// with a Fenwick tree of partial sums of their sizes.
+//
+// As elsewhere in wxGrid, negative sizes are used for the hidden lines, with
+// the absolute value being the size to use when they're shown again.
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxGridLineSizes
+{
+public:
+    wxGridLineSizes() = default;
+
+    // Returns true if there are no sizes, meaning that all lines have the
+    // default size.
+    bool IsEmpty() const { return m_count == 0; }
+
+    // Initialize all the lines to have the given size. The lineAt array
+    // contains the line indices in display order or is empty if the lines
+    // are not reordered.
+    void Init(int count, int size, const wxArrayInt& lineAt);
+
+    // Reset to the empty state.
+    void Clear();
+
+    // Return the size of the line with the given index, 0 if it's hidden.
+    int GetSize(int line) const;
+
+    // Return the end coordinate of the line with the given index.
+    int GetEnd(int line) const;
+
+    // Return the position of the first line ending after the given
+    // coordinate or the number of lines if there is none.
+    int FindPosAt(int coord) const;
+
+    // Change the size of the given line: positive value sets it, 0 hides the
+    // line and -1 shows it back. Returns the change of the line visible size.
+    int SetSize(int line, int size);
+
+    // Update the sizes after inserting or deleting lines with the given
+    // index. The lineAt array must be already updated.
+    void InsertLines(int line, int count, int size, const wxArrayInt& lineAt);
+    void DeleteLines(int line, int count, const wxArrayInt& lineAt);
+
+    // Update the positions after the lines were reordered.
+    void SetLinesOrder(const wxArrayInt& lineAt);
+
+    // Apply the given function to the sizes of all visible lines.
+    template <typename F>
+    void TransformSizes(F func)
+    {
+        if ( IsEmpty() )
+            return;
+
+        if ( IsSparse() )
+        {
+            m_base = func(m_base);
+            for ( auto& custom : m_custom )
+            {
+                if ( custom.size > 0 )
+                    custom.size = func(custom.size);
+            }
+        }
+        else
+        {
+            for ( auto& size : m_sizes )
+            {
+                if ( size > 0 )
+                    size = func(size);
+            }
+        }
+
+        Rebuild();
+    }
+
+    // Return the sizes of all lines differing from the given default one.
+    wxGridSizesInfo GetSizesInfo(int defSize) const;
+
+private:
+    // A line with a size different from the base one in the sparse mode.
+    struct CustomSize
+    {
+        int line;
+        int size;
+
+        // Sum of differences between the visible sizes and the base size for
+        // this line and all custom lines preceding it.
+        int delta;
+    };
+
+    bool IsSparse() const { return m_sizes.empty(); }
+
+    // Return the position of the given line, only used in the dense mode.
+    int GetPos(int line) const
+        { return m_posOf.empty() ? line : m_posOf[line]; }
+
+    // Return the index of the first custom size with the line greater or
+    // equal to the given one.
+    size_t FindCustom(int line) const;
+
+    // Return the end of the line in the sparse mode.
+    int GetSparseEnd(int line) const;
+
+    // Update the deltas of the custom sizes starting from the given one.
+    void UpdateDeltas(size_t start);
+
+    // Switch to the dense mode, storing the sizes of all lines.
+    void MakeDense();
+
+    // Update the positions of the lines and recompute the sums.
+    void SetPositions(const wxArrayInt& lineAt);
+
+    // Recompute all sums from the sizes.
+    void Rebuild();
+
+    // Number of lines, 0 if the object is empty.
+    int m_count = 0;
+
+    // Size of the lines which don't have a custom size in the sparse mode.
+    int m_base = 0;
+
+    // Custom sizes sorted by line, used in the sparse mode only.
+    wxVector<CustomSize> m_custom;
+
+    // Sizes of all lines indexed by line, non-empty in the dense mode only.
+    wxVector<int> m_sizes;
+
+    // Fenwick tree of visible sizes indexed by line position (starting from
+    // 1) used in the dense mode.
+    wxVector<int> m_tree;
+
+    // Position of each line indexed by line or empty if not reordered.
+    wxVector<int> m_posOf;
+};
+
 // ----------------------------------------------------------------------------
 // wxGrid
 // ----------------------------------------------------------------------------
@@ -2180,9 +2552,9 @@ public:
     // wxGridSizesInfo which holds all of them at once
 
     wxGridSizesInfo GetColSizes() const
-        { return wxGridSizesInfo(GetDefaultColSize(), m_colWidths); }
+        { return m_colSizes.GetSizesInfo(GetDefaultColSize()); }
     wxGridSizesInfo GetRowSizes() const
-        { return wxGridSizesInfo(GetDefaultRowSize(), m_rowHeights); }
+        { return m_rowSizes.GetSizesInfo(GetDefaultRowSize()); }
 
     void SetColSizes(const wxGridSizesInfo& sizeInfo);
     void SetRowSizes(const wxGridSizesInfo& sizeInfo);
@@ -2253,6 +2625,14 @@ public:
     void     AutoSizeColumns( bool setAsMin = true );
     void     AutoSizeRows( bool setAsMin = true );
 
+    // change the way the cells are measured by AutoSizeColumn[s](), flags
+    // is a combination of wxGridAutoSizeFlags and, if maxValues is positive
+    // and wxGRID_AUTOSIZE_FAST is used, only this number of the longest
+    // distinct values is measured in each column
+    void     SetColAutoSizeMode( int flags, int maxValues = 0 );
+    int      GetColAutoSizeFlags() const { return m_colAutoSizeFlags; }
+    int      GetColAutoSizeMaxValues() const { return m_colAutoSizeMaxValues; }
+
     // auto size the grid, that is make the columns/rows of the "right" size
     // and also set the grid size to just fit its contents
     void     AutoSize();
@@ -2591,24 +2971,31 @@ protected:
     bool m_usesOverlaySelection = true;
 #endif
 
-    // NB: *never* access m_row/col arrays directly because they are created
+    // NB: *never* access m_row/colSizes directly because they are created
     //     on demand, *always* use accessor functions instead!
 
-    // init the m_rowHeights/Bottoms arrays with default values
+    // init the m_rowSizes with default values
     void InitRowHeights();
 
     int        m_defaultRowHeight;
     int        m_minAcceptableRowHeight;
-    wxArrayInt m_rowHeights;
-    wxArrayInt m_rowBottoms;
+    wxGridLineSizes m_rowSizes;
 
-    // init the m_colWidths/Rights arrays
+    // init the m_colSizes with default values
     void InitColWidths();
 
     int        m_defaultColWidth;
     int        m_minAcceptableColWidth;
-    wxArrayInt m_colWidths;
-    wxArrayInt m_colRights;
+    wxGridLineSizes m_colSizes;
+
+    // parameters set by SetColAutoSizeMode()
+    int m_colAutoSizeFlags;
+    int m_colAutoSizeMaxValues;
+
+    // widths of the texts measured in wxGRID_AUTOSIZE_FAST mode, created on
+    // demand and cleared when they may become invalid
+    wxGridTextWidthCache* m_textWidthCache;
+    void ClearTextWidthCache();
 
     int m_sortCol;
     bool m_sortIsAscending;
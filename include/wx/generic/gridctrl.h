@@ -46,6 +46,10 @@ public:
                                wxDC& dc,
                                int row, int col) override;
 
+    virtual bool GetTextToMeasure(wxGrid& grid,
+                                  int row, int col,
+                                  wxString& text) override;
+
     virtual wxGridCellRenderer *Clone() const override
         { return new wxGridCellStringRenderer(*this); }
 
@@ -88,6 +92,10 @@ public:
                                wxDC& dc,
                                int row, int col) override;
 
+    virtual bool GetTextToMeasure(wxGrid& grid,
+                                  int row, int col,
+                                  wxString& text) override;
+
     virtual wxSize GetMaxBestSize(wxGrid& grid,
                                   wxGridCellAttr& attr,
                                   wxDC& dc) override;
@@ -142,6 +150,10 @@ public:
                                wxDC& dc,
                                int row, int col) override;
 
+    virtual bool GetTextToMeasure(wxGrid& grid,
+                                  int row, int col,
+                                  wxString& text) override;
+
     // parameters string format is "width[,precision[,format]]"
     // with format being one of f|e|g|E|F|G
     virtual void SetParameters(const wxString& params) override;
@@ -230,6 +242,10 @@ public:
                                wxDC& dc,
                                int row, int col) override;
 
+    virtual bool GetTextToMeasure(wxGrid& grid,
+                                  int row, int col,
+                                  wxString& text) override;
+
     virtual wxSize GetMaxBestSize(wxGrid& grid,
                                   wxGridCellAttr& attr,
                                   wxDC& dc) override;
@@ -331,6 +347,10 @@ public:
                                wxDC& dc,
                                int row, int col) override;
 
+    virtual bool GetTextToMeasure(wxGrid& grid,
+                                  int row, int col,
+                                  wxString& text) override;
+
     virtual wxGridCellRenderer *Clone() const override
         { return new wxGridCellEnumRenderer(*this); }
 
@@ -376,6 +396,14 @@ public:
                               int row, int col,
                               int height) override;
 
+    // the best size of the cell is not just its text extent for this renderer
+    virtual bool GetTextToMeasure(wxGrid& WXUNUSED(grid),
+                                  int WXUNUSED(row), int WXUNUSED(col),
+                                  wxString& WXUNUSED(text)) override
+    {
+        return false;
+    }
+
     virtual wxGridCellRenderer *Clone() const override
         { return new wxGridCellAutoWrapStringRenderer(*this); }
 
@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/generic/private/dcpsg.h
+// Purpose:     Private helpers used by wxPostScriptDC
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_GENERIC_PRIVATE_DCPSG_H_
+#define _WX_GENERIC_PRIVATE_DCPSG_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_PRINTING_ARCHITECTURE && wxUSE_POSTSCRIPT
+
+// Format the number in the compact form used in the generated PostScript,
+// i.e. with at most 3 digits after the decimal point and without trailing
+// zeros. Notice that this is independent of the current locale.
+//
+// The buffer must have at least 32 characters and the length of the result,
+// which is not NUL-terminated, is returned.
+WXDLLIMPEXP_CORE size_t wxFormatPSNumber(double value, char *buf);
+
+#endif // wxUSE_PRINTING_ARCHITECTURE && wxUSE_POSTSCRIPT
+
+#endif // _WX_GENERIC_PRIVATE_DCPSG_H_
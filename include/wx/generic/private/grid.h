@@ -33,9 +33,6 @@
 // array classes
 // ----------------------------------------------------------------------------
 
-WX_DEFINE_ARRAY_WITH_DECL_PTR(wxGridCellAttr *, wxArrayAttrs,
-                                 class WXDLLIMPEXP_ADV);
-
 WX_DECLARE_HASH_MAP_WITH_DECL(wxLongLong_t, wxGridCellAttr*,
                               wxIntegerHash, wxIntegerEqual,
                               wxGridCoordsToAttrMap, class WXDLLIMPEXP_CORE);
@@ -465,6 +462,11 @@ private:
 };
 
 // this class stores attributes set for rows or columns
+//
+// Consecutive rows or columns using the same attribute are stored as a single
+// run, so that bands of rows or columns with the same attribute take very
+// little space, and the runs are sorted, so that the attribute can be found
+// in logarithmic time.
 class WXDLLIMPEXP_ADV wxGridRowOrColAttrData
 {
 public:
@@ -477,8 +479,32 @@ public:
     void UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols );
 
 private:
-    wxArrayInt m_rowsOrCols;
-    wxArrayAttrs m_attrs;
+    // A run of rows or columns, from first to last inclusive, using the same
+    // attribute, which is referenced once by the run.
+    struct Run
+    {
+        int first;
+        int last;
+        wxGridCellAttr *attr;
+    };
+
+    using Runs = wxVector<Run>;
+
+    // Return the index of the first run ending at or after the given row or
+    // column.
+    size_t FindRun(int rowOrCol) const;
+
+    // Append a new run to the given vector, merging it with the last one if
+    // possible. Takes ownership of the attribute reference.
+    static void AppendRun(Runs& runs, int first, int last, wxGridCellAttr *attr);
+
+    // Merge the run with the given index with the next one, if they're
+    // adjacent and use the same attribute.
+    void MergeWithNext(size_t n);
+
+    Runs m_runs;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridRowOrColAttrData);
 };
 
 // NB: this is just a wrapper around 3 objects: one which stores cell
@@ -587,8 +613,8 @@ public:
     // Get the height/width of the given row/column
     virtual int GetLineSize(const wxGrid *grid, int line) const = 0;
 
-    // Get wxGrid::m_rowBottoms/m_colRights array
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const = 0;
+    // Get wxGrid::m_rowSizes/m_colSizes object
+    virtual const wxGridLineSizes& GetLineSizes(const wxGrid *grid) const = 0;
 
     // Get default height row height or column width
     virtual int GetDefaultLineSize(const wxGrid *grid) const = 0;
@@ -747,8 +773,8 @@ public:
         { return grid->GetRowBottom(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const override
         { return grid->GetRowHeight(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const override
-        { return grid->m_rowBottoms; }
+    virtual const wxGridLineSizes& GetLineSizes(const wxGrid *grid) const override
+        { return grid->m_rowSizes; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const override
         { return grid->GetDefaultRowSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const override
@@ -903,8 +929,8 @@ public:
         { return grid->GetColRight(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const override
         { return grid->GetColWidth(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const override
-        { return grid->m_colRights; }
+    virtual const wxGridLineSizes& GetLineSizes(const wxGrid *grid) const override
+        { return grid->m_colSizes; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const override
         { return grid->GetDefaultColSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const override
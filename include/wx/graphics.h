@@ -852,6 +852,13 @@ public:
 
     virtual void GetPartialTextExtents(const wxString& text, wxArrayDouble& widths) const = 0;
 
+    // Get the extents of all strings at once: the default implementation just
+    // calls GetTextExtent() for each of them, but the derived classes may do
+    // it more efficiently.
+    virtual void GetMultipleTextExtents(const wxArrayString& strings,
+                                        wxArrayDouble& widths,
+                                        wxArrayDouble& heights) const;
+
     //
     // image support
     //
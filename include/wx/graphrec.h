@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/graphrec.h
+// Purpose:     wxGraphicsRecording: replayable list of drawing commands
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_GRAPHREC_H_
+#define _WX_GRAPHREC_H_
+
+#include "wx/graphics.h"
+
+#if wxUSE_GRAPHICS_CONTEXT
+
+#include "wx/affinematrix2d.h"
+#include "wx/colour.h"
+#include "wx/gdicmn.h"
+
+#include <functional>
+
+class WXDLLIMPEXP_FWD_CORE wxImage;
+class WXDLLIMPEXP_FWD_CORE wxRegion;
+
+class wxGraphicsRecordingData;
+
+// ----------------------------------------------------------------------------
+// wxGraphicsRecording: display list which can be replayed on any context
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxGraphicsRecording
+{
+public:
+    // Create an empty recording.
+    wxGraphicsRecording();
+
+    // Copies share the same commands list.
+    wxGraphicsRecording(const wxGraphicsRecording& other);
+    wxGraphicsRecording& operator=(const wxGraphicsRecording& other);
+
+    ~wxGraphicsRecording();
+
+    // Create a new context recording the drawing commands into this object.
+    //
+    // The renderer is used to create the pens, brushes and other graphics
+    // objects and the recording can only be replayed on the contexts created
+    // by the same renderer. If it is null, the default renderer is used.
+    //
+    // The caller is responsible for deleting the returned context.
+    wxGraphicsContext* CreateContext(wxDouble width = 0,
+                                     wxDouble height = 0,
+                                     wxGraphicsRenderer* renderer = nullptr);
+
+    // Return the renderer used by this recording, may be null if no context
+    // has been created yet.
+    wxGraphicsRenderer* GetRenderer() const;
+
+    // Return the number of recorded commands.
+    size_t GetCommandCount() const;
+    bool IsEmpty() const { return GetCommandCount() == 0; }
+
+    // Return the bounding box of everything drawn.
+    wxRect2DDouble GetBoundingBox() const;
+
+    // Remove all commands.
+    void Clear();
+
+    // Replay all commands on the given context, optionally transforming them
+    // by the given matrix.
+    void Replay(wxGraphicsContext* gc) const;
+    void Replay(wxGraphicsContext* gc, const wxAffineMatrix2D& transform) const;
+
+    // Replay only the drawing commands affecting the given region, which is
+    // expressed in the current coordinates of the target context, and clip
+    // the output to it.
+    void Replay(wxGraphicsContext* gc,
+                const wxRegion& region,
+                const wxAffineMatrix2D& transform = wxAffineMatrix2D()) const;
+
+private:
+    // Implementation of CreateContext() which can also create a recording not
+    // sharing any objects with the caller, and so usable in another thread.
+    wxGraphicsContext* DoCreateContext(wxDouble width,
+                                       wxDouble height,
+                                       wxGraphicsRenderer* renderer,
+                                       bool isolated);
+
+    wxObjectDataPtr<wxGraphicsRecordingData> m_data;
+
+    friend class wxGraphicsTiledImageRenderer;
+};
+
+// ----------------------------------------------------------------------------
+// wxGraphicsTiledImageRenderer: renders big images tile by tile
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxGraphicsTiledImageRenderer
+{
+public:
+    // Function drawing the image contents using the given context.
+    typedef std::function<void (wxGraphicsContext* gc)> DrawFunction;
+
+    // Function called with each rendered tile, in the top to bottom and left
+    // to right order, can return false to stop rendering.
+    typedef std::function<bool (const wxRect& rect,
+                                const wxImage& tile)> TileFunction;
+
+    // Create the renderer for the image of the given size using the specified
+    // graphics renderer, or the default one if it is null.
+    explicit wxGraphicsTiledImageRenderer(const wxSize& size,
+                                          wxGraphicsRenderer* renderer = nullptr);
+
+    // Set the size of the tiles, 256*256 by default.
+    void SetTileSize(const wxSize& tileSize);
+
+    // Set the maximal number of threads to use, 0 (default) means using as
+    // many as there are CPUs and 1 disables using the threads.
+    void SetMaxThreads(int maxThreads);
+
+    // Set the colour of the image background, white by default.
+    void SetBackgroundColour(const wxColour& colour);
+
+    // Render all tiles, calling onTile for each of them in the calling
+    // thread. Returns false if rendering was cancelled.
+    bool Render(const DrawFunction& draw, const TileFunction& onTile) const;
+
+    // Render the entire image at once.
+    wxImage RenderImage(const DrawFunction& draw) const;
+
+private:
+    const wxSize m_size;
+    wxGraphicsRenderer* const m_renderer;
+
+    wxSize m_tileSize;
+    int m_maxThreads;
+    wxColour m_backgroundColour;
+
+    wxDECLARE_NO_COPY_CLASS(wxGraphicsTiledImageRenderer);
+};
+
+#endif // wxUSE_GRAPHICS_CONTEXT
+
+#endif // _WX_GRAPHREC_H_
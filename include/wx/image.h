@@ -102,6 +102,29 @@ class WXDLLIMPEXP_FWD_CORE wxImageHandler;
 class WXDLLIMPEXP_FWD_CORE wxImage;
 class WXDLLIMPEXP_FWD_CORE wxPalette;
 
+//-----------------------------------------------------------------------------
+// wxImageRowSink
+//-----------------------------------------------------------------------------
+
+// Receives the rows of the image as they are decoded, see wxImage::LoadRows().
+class WXDLLIMPEXP_CORE wxImageRowSink
+{
+public:
+    wxImageRowSink() = default;
+    virtual ~wxImageRowSink() = default;
+
+    // Called once the image size is known, before any calls to OnRows().
+    virtual bool OnStart(int width, int height, bool hasAlpha) = 0;
+
+    // Called with RGB data and alpha, which is null if the image doesn't have
+    // it, of count rows starting with the given one.
+    virtual bool OnRows(int y, int count,
+                        const unsigned char* data,
+                        const unsigned char* alpha) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageRowSink);
+};
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -123,6 +146,12 @@ public:
                            bool WXUNUSED(verbose)=true )
         { return false; }
 
+    // Load the image passing its rows to the sink as soon as they're decoded,
+    // the default implementation loads the entire image first.
+    virtual bool LoadRows( wxImage *image, wxInputStream& stream,
+                           wxImageRowSink& sink,
+                           bool verbose=true, int index=-1 );
+
     int GetImageCount( wxInputStream& stream );
         // save the stream position, call DoGetImageCount() and restore the position
 
@@ -360,7 +389,7 @@ public:
     wxImage ResampleBicubic(int width, int height) const;
 
     // blur the image according to the specified pixel radius
-    wxImage Blur(int radius) const;
+    wxImage Blur(int radius, int numPasses = 1) const;
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
 
@@ -429,6 +458,15 @@ public:
     bool ConvertAlphaToMask(unsigned char mr, unsigned char mg, unsigned char mb,
                             unsigned char threshold = wxIMAGE_ALPHA_THRESHOLD);
 
+    // convert the image to or from 32 bit pixels with premultiplied alpha
+    // stored in native byte order, i.e. the format used by Cairo and many
+    // native APIs, stride is in bytes and 0 means 4*width
+    bool CopyToPremultipliedARGB(unsigned char* data, int stride = 0) const;
+    bool CreateFromPremultipliedARGB(int width, int height,
+                                     const unsigned char* data,
+                                     int stride = 0,
+                                     bool hasAlpha = true);
+
 
     // This method converts an image where the original alpha
     // information is only available as a shades of a colour
@@ -458,6 +496,12 @@ public:
     void SetLoadFlags(int flags);
     int GetLoadFlags() const;
 
+    // Methods for controlling the number of threads used by the functions
+    // processing image data, such as Scale(), Blur() or Rotate(). By default
+    // no additional threads are used, 0 means using all available CPUs.
+    static void SetParallelism(int numThreads);
+    static int GetParallelism();
+
     static bool CanRead( const wxString& name );
     static int GetImageCount( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
@@ -468,6 +512,10 @@ public:
     static int GetImageCount( wxInputStream& stream, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( wxInputStream& stream, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
     virtual bool LoadFile( wxInputStream& stream, const wxString& mimetype, int index = -1 );
+
+    // Load the image without storing it, but passing its rows to the sink.
+    bool LoadRows( wxInputStream& stream, wxImageRowSink& sink,
+                   wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
 #endif
 
     virtual bool SaveFile( const wxString& name ) const;
@@ -607,6 +655,9 @@ protected:
 private:
     friend class WXDLLIMPEXP_FWD_CORE wxImageHandler;
 
+    // needs to use DoLoad() with its own handler objects
+    friend class wxImageBatchLoaderImpl;
+
     // Helper function used internally by wxImage class only: it applies the
     // given functor, which is passed the pixel data for each image pixel.
     template <typename F>
@@ -643,6 +694,59 @@ private:
     wxDECLARE_DYNAMIC_CLASS(wxImage);
 };
 
+//-----------------------------------------------------------------------------
+// wxImageView: read-only view of a rectangular part of wxImage
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageView
+{
+public:
+    // Default ctor creates an invalid view.
+    wxImageView() = default;
+
+    // Create a view of the entire image or of the given part of it, which
+    // must be inside the image.
+    wxImageView(const wxImage& image);
+    wxImageView(const wxImage& image, const wxRect& rect);
+
+    bool IsOk() const { return m_image.IsOk(); }
+
+    // Get the image this view refers to and the rectangle inside it.
+    const wxImage& GetImage() const { return m_image; }
+    const wxRect& GetRect() const { return m_rect; }
+
+    int GetWidth() const { return m_rect.width; }
+    int GetHeight() const { return m_rect.height; }
+    wxSize GetSize() const { return m_rect.GetSize(); }
+
+    bool HasAlpha() const { return m_image.HasAlpha(); }
+
+    // Offsets, in bytes, between the starts of consecutive rows of RGB and
+    // alpha data respectively.
+    size_t GetStride() const { return 3*GetAlphaStride(); }
+    size_t GetAlphaStride() const { return static_cast<size_t>(m_image.GetWidth()); }
+
+    // Get the pointers to the data of the top left pixel of the view or of
+    // the first pixel of the given row. Alpha functions return null if the
+    // image doesn't have alpha.
+    const unsigned char* GetData() const { return GetRowData(0); }
+    const unsigned char* GetAlpha() const { return GetRowAlpha(0); }
+    const unsigned char* GetRowData(int y) const;
+    const unsigned char* GetRowAlpha(int y) const;
+
+    // Get the view of the part of this view, the rectangle is relative to it.
+    wxImageView GetSubView(const wxRect& rect) const;
+
+    // Create a new image with the copy of the data of this view.
+    wxImage ToImage() const;
+
+private:
+    // Holding a reference to the image keeps its data alive and unchanged,
+    // as all functions modifying wxImage make a copy of its shared data.
+    wxImage m_image;
+    wxRect m_rect;
+};
+
 
 extern void WXDLLIMPEXP_CORE wxInitAllImageHandlers();
 
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imagebatch.h
+// Purpose:     wxImageBatchLoader: loading many images in background threads
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_IMAGEBATCH_H_
+#define _WX_IMAGEBATCH_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS && wxUSE_FILE
+
+#include "wx/event.h"
+#include "wx/image.h"
+
+class wxImageBatchLoaderImpl;
+
+// ----------------------------------------------------------------------------
+// wxImageBatchEvent: event sent by wxImageBatchLoader
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageBatchEvent : public wxEvent
+{
+public:
+    wxImageBatchEvent(wxEventType eventType = wxEVT_NULL,
+                      int id = wxID_ANY,
+                      size_t index = 0,
+                      const wxString& fileName = wxString(),
+                      const wxImage& image = wxImage())
+        : wxEvent(id, eventType),
+          m_index(index),
+          m_fileName(fileName),
+          m_image(image)
+    {
+    }
+
+    // Index of the file in the order of wxImageBatchLoader::Add() calls.
+    size_t GetIndex() const { return m_index; }
+
+    const wxString& GetFileName() const { return m_fileName; }
+
+    // The image is invalid if loading it failed.
+    const wxImage& GetImage() const { return m_image; }
+    bool IsOk() const { return m_image.IsOk(); }
+
+    virtual wxEvent* Clone() const override
+    {
+        return new wxImageBatchEvent(*this);
+    }
+
+private:
+    size_t m_index;
+    wxString m_fileName;
+    wxImage m_image;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN_DEF_COPY(wxImageBatchEvent);
+};
+
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CORE, wxEVT_IMAGE_BATCH_LOADED,
+                         wxImageBatchEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CORE, wxEVT_IMAGE_BATCH_COMPLETED,
+                         wxImageBatchEvent);
+
+typedef void (wxEvtHandler::*wxImageBatchEventFunction)(wxImageBatchEvent&);
+
+#define wxImageBatchEventHandler(func) \
+    wxEVENT_HANDLER_CAST(wxImageBatchEventFunction, func)
+
+#define EVT_IMAGE_BATCH_LOADED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_IMAGE_BATCH_LOADED, id, wxImageBatchEventHandler(func))
+#define EVT_IMAGE_BATCH_COMPLETED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_IMAGE_BATCH_COMPLETED, id, wxImageBatchEventHandler(func))
+
+// ----------------------------------------------------------------------------
+// wxImageBatchLoader: loads images from files using a pool of threads
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageBatchLoader
+{
+public:
+    // Create the loader sending events to the given handler and using at most
+    // the given number of threads, 0 meaning using one thread per CPU.
+    explicit wxImageBatchLoader(wxEvtHandler* handler,
+                                int id = wxID_ANY,
+                                int maxThreads = 0);
+
+    // Cancels loading the remaining images and waits for the threads.
+    ~wxImageBatchLoader();
+
+    // Set the maximal number of images which may be loaded but not yet
+    // delivered to the handler, 0 means using the default limit.
+    void SetMaxPending(size_t maxPending);
+
+    // Set the maximal size of the loaded images, see wxIMAGE_OPTION_MAX_WIDTH
+    // and wxIMAGE_OPTION_MAX_HEIGHT.
+    void SetMaxSize(int maxWidth, int maxHeight);
+
+    // Queue the file for loading and return its index.
+    size_t Add(const wxString& fileName, wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    // Discard all files which haven't been loaded yet.
+    void Cancel();
+
+    // Return the number of files added but not delivered to the handler yet.
+    size_t GetPendingCount() const;
+
+private:
+    wxImageBatchLoaderImpl* const m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageBatchLoader);
+};
+
+#endif // wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS && wxUSE_FILE
+
+#endif // _WX_IMAGEBATCH_H_
@@ -38,6 +38,9 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) override;
+    virtual bool LoadRows( wxImage *image, wxInputStream& stream,
+                           wxImageRowSink& sink,
+                           bool verbose=true, int index=-1 ) override;
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) override;
 #endif
@@ -27,6 +27,7 @@
 #define wxIMAGE_OPTION_PNG_COMPRESSION_MEM_LEVEL   wxT("PngZM")
 #define wxIMAGE_OPTION_PNG_COMPRESSION_STRATEGY    wxT("PngZS")
 #define wxIMAGE_OPTION_PNG_COMPRESSION_BUFFER_SIZE wxT("PngZB")
+#define wxIMAGE_OPTION_PNG_COMPRESSION_THREADS     wxT("PngZT")
 
 enum
 {
@@ -36,6 +37,19 @@ enum
     wxPNG_TYPE_PALETTE = 4
 };
 
+// Values for wxIMAGE_OPTION_PNG_FILTER, they have the same values as the
+// corresponding PNG_FILTER_XXX libpng constants and can be combined together.
+enum
+{
+    wxPNG_FILTER_NONE  = 0x08,
+    wxPNG_FILTER_SUB   = 0x10,
+    wxPNG_FILTER_UP    = 0x20,
+    wxPNG_FILTER_AVG   = 0x40,
+    wxPNG_FILTER_PAETH = 0x80,
+    wxPNG_FILTER_ALL   = wxPNG_FILTER_NONE | wxPNG_FILTER_SUB |
+                         wxPNG_FILTER_UP | wxPNG_FILTER_AVG | wxPNG_FILTER_PAETH
+};
+
 class WXDLLIMPEXP_CORE wxPNGHandler: public wxImageHandler
 {
 public:
@@ -52,6 +66,9 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) override;
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) override;
+    virtual bool LoadRows( wxImage *image, wxInputStream& stream,
+                           wxImageRowSink& sink,
+                           bool verbose=true, int index=-1 ) override;
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) override;
 #endif
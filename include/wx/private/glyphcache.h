@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/glyphcache.h
+// Purpose:     wxGlyphAdvanceCache: cache of the character widths
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_GLYPHCACHE_H_
+#define _WX_PRIVATE_GLYPHCACHE_H_
+
+#include "wx/string.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+#include <list>
+#include <unordered_map>
+
+class WXDLLIMPEXP_FWD_CORE wxFont;
+
+// ----------------------------------------------------------------------------
+// wxGlyphAdvanceCache: widths of the individual characters in several fonts
+// ----------------------------------------------------------------------------
+
+// This class is used by the generic implementations of GetPartialTextExtents()
+// which measure each character of the string separately and so benefit a lot
+// from remembering the results.
+//
+// The fonts are identified by string keys which must describe everything
+// affecting the measurements, i.e. the font itself and the scale or
+// resolution used. Using strings rather than wxFont objects, whose reference
+// counts are not thread-safe, allows using this class from any thread: all
+// its methods lock the cache internally.
+//
+// Only a limited number of the most recently used fonts is kept, and the
+// number of characters cached for each font is limited too.
+class WXDLLIMPEXP_CORE wxGlyphAdvanceCache
+{
+public:
+    wxGlyphAdvanceCache() = default;
+
+    // Return the global cache object.
+    static wxGlyphAdvanceCache& Get();
+
+    // Return the key for the given font used with the given horizontal scale
+    // and resolution.
+    static wxString MakeKey(const wxFont& font, double scaleX, int ppi);
+
+    // Fill the advances array with the cached widths of all characters of
+    // the text, using -1 for the ones which are not in the cache.
+    //
+    // Returns the number of characters which are not in the cache.
+    size_t Lookup(const wxString& key,
+                  const wxString& text,
+                  wxVector<double>& advances);
+
+    // Remember the widths of all characters of the text for which the
+    // corresponding element of advances is not negative.
+    void Store(const wxString& key,
+               const wxString& text,
+               const wxVector<double>& advances);
+
+    // Forget all the cached widths.
+    void Clear();
+
+    // Return the number of fonts currently in the cache.
+    size_t GetFontCount() const;
+
+private:
+    // Number of the first characters stored in an array rather than a map, as
+    // the vast majority of the measured text uses them.
+    enum { DIRECT_SIZE = 256 };
+
+    struct FontEntry
+    {
+        explicit FontEntry(const wxString& key_);
+
+        const wxString key;
+
+        // The widths of the characters less than DIRECT_SIZE, -1 if unknown.
+        double direct[DIRECT_SIZE];
+
+        // The widths of all the other characters.
+        std::unordered_map<wxUint32, double> others;
+    };
+
+    typedef std::list<FontEntry> FontList;
+
+    // Find the entry for the given key and make it the most recently used
+    // one, return null if not found. Must be called with the lock held.
+    FontEntry* DoFind(const wxString& key);
+
+    // The fonts in the most recently used first order.
+    FontList m_fonts;
+
+    // Index of m_fonts by the key.
+    std::unordered_map<wxString, FontList::iterator> m_index;
+
+#if wxUSE_THREADS
+    // Protects both containers above.
+    mutable wxCriticalSection m_cs;
+#endif // wxUSE_THREADS
+
+    wxDECLARE_NO_COPY_CLASS(wxGlyphAdvanceCache);
+};
+
+#endif // _WX_PRIVATE_GLYPHCACHE_H_
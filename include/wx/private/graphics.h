@@ -162,6 +162,30 @@ public :
     virtual bool Contains( wxDouble x, wxDouble y, wxPolygonFillMode fillStyle = wxODDEVEN_RULE) const=0;
 };
 
+#if wxUSE_CAIRO
+
+// Statistics about the native objects caches used by the Cairo renderer, only
+// useful for profiling.
+struct wxCairoCacheStats
+{
+    // Number of times a cached copy of the path was reused or had to be
+    // created because the path was new or changed since it was last used.
+    unsigned long pathHits = 0;
+    unsigned long pathMisses = 0;
+
+    // Number of times the pen or brush pattern was reused or had to be
+    // created when it was used for the first time.
+    unsigned long patternHits = 0;
+    unsigned long patternMisses = 0;
+};
+
+// Return the statistics accumulated since the program start or the last call
+// to wxResetCairoCacheStats().
+WXDLLIMPEXP_CORE wxCairoCacheStats wxGetCairoCacheStats();
+WXDLLIMPEXP_CORE void wxResetCairoCacheStats();
+
+#endif // wxUSE_CAIRO
+
 #endif
 
 #endif // _WX_GRAPHICS_PRIVATE_H_
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/image.h
+// Purpose:     Private helpers for implementing wxImageHandler classes
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGE_H_
+#define _WX_PRIVATE_IMAGE_H_
+
+#include "wx/image.h"
+
+// ----------------------------------------------------------------------------
+// wxImageStoringRowSink: sink storing the rows in wxImage
+// ----------------------------------------------------------------------------
+
+// This sink is used by the handlers supporting loading the images row by row
+// to implement their LoadFile() in terms of LoadRows().
+//
+// Note that alpha channel is only created if any of the pixels is not opaque.
+class wxImageStoringRowSink : public wxImageRowSink
+{
+public:
+    explicit wxImageStoringRowSink(wxImage& image) : m_image(image) { }
+
+    virtual bool OnStart(int width, int height, bool hasAlpha) override;
+    virtual bool OnRows(int y, int count,
+                        const unsigned char* data,
+                        const unsigned char* alpha) override;
+
+private:
+    wxImage& m_image;
+};
+
+// ----------------------------------------------------------------------------
+// Helper functions
+// ----------------------------------------------------------------------------
+
+// Return the biggest size, preserving the aspect ratio of the given one, not
+// exceeding the maximal size specified by wxIMAGE_OPTION_MAX_WIDTH and
+// wxIMAGE_OPTION_MAX_HEIGHT options, with 0 meaning that the corresponding
+// dimension is not limited. If the size already fits, it is returned as is.
+wxSize wxGetImageSizeToFit(const wxSize& size,
+                           unsigned maxWidth,
+                           unsigned maxHeight);
+
+#endif // _WX_PRIVATE_IMAGE_H_
@@ -10,6 +10,8 @@
 #ifndef _WX_PRIVATE_TEXTMEASURE_H_
 #define _WX_PRIVATE_TEXTMEASURE_H_
 
+#include "wx/vector.h"
+
 class WXDLLIMPEXP_FWD_CORE wxDC;
 class WXDLLIMPEXP_FWD_CORE wxFont;
 class WXDLLIMPEXP_FWD_CORE wxWindow;
@@ -52,6 +54,12 @@ public:
         return GetLargestStringExtent(strings.size(), &strings[0]);
     }
 
+    // Fill the extents vector with the extents of all the given strings, as
+    // would be returned by GetTextExtent() for each of them, but preparing
+    // for measuring only once.
+    void GetMultipleTextExtents(const wxArrayString& strings,
+                                wxVector<wxSize>& extents);
+
     // Fill the array with the widths for each "0..N" substrings for N from 1
     // to text.length().
     //
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/threadpool.h
+// Purpose:     wxThreadPool: pool of worker threads used by the library
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_THREADPOOL_H_
+#define _WX_PRIVATE_THREADPOOL_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_THREADS
+
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+#include <deque>
+#include <functional>
+
+class wxThreadPoolWorker;
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: a simple pool of threads executing queued tasks
+// ----------------------------------------------------------------------------
+
+// This class is used internally by wxWidgets to perform CPU-intensive
+// operations, such as image processing, in parallel. All worker threads are
+// created on demand and are reused for all subsequent tasks, until the pool
+// is shut down.
+//
+// Note that the tasks executed by the worker threads must not use any GUI
+// functions.
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // Get the global pool shared by all library code. It is created on first
+    // use and destroyed when the application object is cleaned up, so that
+    // the tasks may safely use wxTheApp to post their results to the main
+    // thread, e.g. with CallAfter(), as it's guaranteed to remain valid while
+    // they run. It is destroyed again, if it was recreated after this, when
+    // the library is cleaned up.
+    static wxThreadPool& Get();
+
+    // Create a pool using up to the given number of threads, 0 means using as
+    // many threads as there are CPUs.
+    explicit wxThreadPool(int maxThreads = 0);
+
+    // Stops and waits for all the threads.
+    ~wxThreadPool();
+
+    // Return the maximal number of the worker threads.
+    int GetMaxThreads() const { return m_maxThreads; }
+
+    // Queue a task to be executed by one of the worker threads as soon as
+    // possible. If the threads can't be created, the task is executed
+    // synchronously in the current thread.
+    void Post(const Task& task);
+
+    // Call func(n) for all n in [0, count), possibly concurrently, using at
+    // most maxThreads threads including the current one (0 means using all
+    // pool threads) and return when all the calls have completed.
+    //
+    // The calling thread participates in processing, so it is safe to call
+    // this function even from a task running in this pool.
+    //
+    // If func throws, no new items are processed and the first exception is
+    // rethrown in the calling thread after all the calls which had already
+    // started have completed.
+    void ParallelFor(size_t count,
+                     const std::function<void(size_t)>& func,
+                     int maxThreads = 0);
+
+    // Wait until all currently running tasks finish and stop all threads,
+    // the tasks which haven't started yet are discarded.
+    void Shutdown();
+
+    // Delete the global pool, if it had been created.
+    static void CleanUp();
+
+private:
+    // Get the next task to execute, blocking until it becomes available.
+    // Returns false if the pool is being shut down.
+    bool GetNextTask(Task& task);
+
+    const int m_maxThreads;
+
+    // Protects all the fields below.
+    wxMutex m_mutex;
+
+    // Signalled when a new task is added or when the pool is shut down.
+    wxCondition m_condition;
+
+    std::deque<Task> m_tasks;
+    wxVector<wxThreadPoolWorker*> m_threads;
+
+    // Number of threads currently waiting for a task.
+    int m_idleThreads;
+
+    bool m_shuttingDown;
+
+    static wxThreadPool* ms_instance;
+
+    friend class wxThreadPoolWorker;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPool);
+};
+
+#endif // wxUSE_THREADS
+
+#endif // _WX_PRIVATE_THREADPOOL_H_
@@ -7,6 +7,33 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+/**
+    Statistics of the cache used by wxBitmapBundle objects created from SVG.
+
+    @see wxBitmapBundle::GetSVGCacheStats()
+
+    @library{wxcore}
+
+    @since 3.3.0
+ */
+struct wxBitmapBundleCacheStats
+{
+    /// Number of bitmaps requests which were satisfied from the cache.
+    unsigned long hits;
+
+    /// Number of bitmaps requests which required rasterizing the bitmap.
+    unsigned long misses;
+
+    /// Number of bitmaps removed from the cache to stay within its limit.
+    unsigned long evictions;
+
+    /// Number of bitmaps currently in the cache.
+    size_t count;
+
+    /// Total size of the bitmaps currently in the cache, in bytes.
+    size_t bytes;
+};
+
 /**
     Contains representations of the same bitmap in different resolutions.
 
@@ -323,6 +350,132 @@ public:
      */
     static wxBitmapBundle FromSVGResource(const wxString& name, const wxSize& sizeDef);
 
+    /**
+        Create bundles from several SVG files at once.
+
+        This function is equivalent to calling FromSVGFile() for all the
+        given paths, but is faster as it reads and parses the files in
+        parallel, using several threads, when possible. It is useful for
+        loading all the icons used by the application at once, e.g. when it
+        starts up.
+
+        Note that this function blocks until all the files are loaded.
+
+        @param paths Paths to the SVG files.
+        @param sizeDef The default size to return from GetDefaultSize() for
+            all the bundles.
+        @return Vector of the same size as @a paths containing the bundles
+            created from the corresponding files. The bundles for the files
+            which couldn't be loaded are invalid.
+
+        @see PrerasterizeSVG()
+
+        @since 3.3.0
+     */
+    static wxVector<wxBitmapBundle>
+    FromSVGFiles(const wxVector<wxString>& paths, const wxSize& sizeDef);
+
+    /**
+        Set the maximal amount of memory used for caching the bitmaps
+        rasterized from SVG.
+
+        Rasterizing SVG images is relatively slow, so the bitmaps created by
+        the bundles returned by FromSVG() and the related functions are kept
+        in a cache shared by all of them. The cache is indexed by the contents
+        of the SVG image, so even the bundles created from the same data
+        independently share the same bitmaps, and the bitmap size, so that
+        the bitmaps of all the sizes used, e.g. for the different DPIs, are
+        cached.
+
+        When the total size of the cached bitmaps, computed as 4 bytes per
+        pixel, exceeds the limit set by this function, the least recently
+        used bitmaps are removed from the cache. The default limit is 8MiB.
+
+        Note that the cache can be only used from the main thread.
+
+        Each bundle also keeps the last bitmap which was too big to be put
+        in the cache, so using the same bitmap repeatedly doesn't require
+        rasterizing it again even if it doesn't fit in the cache.
+
+        @param maxBytes The maximal amount of memory to use, in bytes. If it
+            is 0, the global cache is disabled and only the last bitmap is
+            kept by each bundle.
+
+        @see GetSVGCacheLimit(), ClearSVGCache(), GetSVGCacheStats()
+
+        @since 3.3.0
+     */
+    static void SetSVGCacheLimit(size_t maxBytes);
+
+    /**
+        Return the maximal amount of memory used for caching the bitmaps
+        rasterized from SVG.
+
+        @see SetSVGCacheLimit()
+
+        @since 3.3.0
+     */
+    static size_t GetSVGCacheLimit();
+
+    /**
+        Remove all the bitmaps from the cache of bitmaps rasterized from SVG
+        and reset its statistics.
+
+        @see SetSVGCacheLimit()
+
+        @since 3.3.0
+     */
+    static void ClearSVGCache();
+
+    /**
+        Return statistics of the cache of bitmaps rasterized from SVG.
+
+        This function can be used to check whether the cache limit is
+        appropriate for the application.
+
+        @see SetSVGCacheLimit()
+
+        @since 3.3.0
+     */
+    static wxBitmapBundleCacheStats GetSVGCacheStats();
+
+    /**
+        Rasterize the bitmaps from SVG in the background.
+
+        This function starts rasterizing the bitmaps of all the specified
+        sizes for all the given bundles created from SVG in the background
+        threads and returns immediately. The resulting bitmaps are put into
+        the cache, see SetSVGCacheLimit(), when they become available, so
+        that retrieving them later with GetBitmap() doesn't take any time.
+        Note that this happens when the events are dispatched by the event
+        loop, so this function is only useful when it is running.
+
+        This function can be used to avoid delays when showing the UI
+        elements using many SVG icons, such as toolbars or menus, for the
+        first time, e.g. it could be called with all the application icons
+        and the sizes appropriate for the current DPI scaling when the
+        application starts up. Please make sure that the cache limit is big
+        enough to hold all the bitmaps in this case, otherwise some of them
+        could be evicted from the cache before being used.
+
+        The bundles which are not created from SVG are simply ignored by this
+        function, as well as the sizes for which the bitmaps are already
+        available in the cache. If threads are not supported, this function
+        doesn't do anything.
+
+        This function can be called from the main thread only.
+
+        @param bundles Bundles to rasterize.
+        @param sizes Sizes of the bitmaps to create for all the bundles, in
+            physical pixels.
+
+        @see FromSVGFiles()
+
+        @since 3.3.0
+     */
+    static void PrerasterizeSVG(const wxVector<wxBitmapBundle>& bundles,
+                                const wxVector<wxSize>& sizes);
+
     /**
         Clear the existing bundle contents.
 
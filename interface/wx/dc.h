@@ -664,6 +664,32 @@ public:
     bool GetPartialTextExtents(const wxString& text,
                                wxArrayInt& widths) const;
 
+    /**
+        Gets the dimensions of all the given strings.
+
+        The results are the same as would be returned by GetTextExtent() for
+        each of the strings, and so are 0 for the empty strings, but this
+        function can be much faster when measuring many strings, e.g. when
+        computing the best width of a column in a control showing many items,
+        as it prepares the DC for measuring only once. For the DCs using Cairo
+        under wxGTK, the same Pango layout is reused for all the strings.
+
+        @param strings
+            The strings to measure.
+        @param extents
+            Filled with the extents of all the strings in the same order.
+        @param font
+            If specified and valid, this font is used for measuring instead
+            of the currently selected one.
+
+        @see GetTextExtent(), wxGraphicsContext::GetMultipleTextExtents()
+
+        @since 3.3.0
+    */
+    void GetMultipleTextExtents(const wxArrayString& strings,
+                                wxVector<wxSize>& extents,
+                                const wxFont* font = nullptr) const;
+
     /**
         Gets the dimensions of the string using the currently selected font.
         @a string is the text string to measure, @a descent is the dimension
@@ -17,6 +17,11 @@
 // is private style and not returned by GetStyle.
 #define wxBUFFER_USES_SHARED_BUFFER 0x04
 
+// Keeps the buffer bitmap associated with the window between paint events and
+// only redraws and blits the parts of it which need to be updated. Can only be
+// used with wxBufferedPaintDC and wxBUFFER_CLIENT_AREA.
+#define wxBUFFER_PERSISTENT         0x08
+
 
 /**
     @class wxBufferedDC
@@ -138,6 +143,23 @@ public:
        Get the style.
     */
     int GetStyle() const;
+
+    /**
+        Return the part of the buffer which needs to be redrawn.
+
+        This region is only used when wxBUFFER_PERSISTENT style is specified
+        and is empty otherwise. It is expressed in device coordinates, i.e.
+        in the client coordinates of the window.
+
+        Notice that if the region to update consists of many rectangles, its
+        entire bounding box is returned instead, so this region can be bigger
+        than the window update region even when the buffer is fully valid.
+
+        @see wxBufferedPaintDC
+
+        @since 3.3.0
+    */
+    const wxRegion& GetDirtyRegion() const;
 };
 
 
@@ -195,6 +217,29 @@ wxDC* wxAutoBufferedPaintDCFactory(wxWindow* window);
     wxScrolled::PrepareDC() on it as it already does this internally for the
     real underlying wxPaintDC.
 
+    @section bufferedpaintdc_persistent Persistent Buffer
+
+    By default, the buffer bitmap is only used during the lifetime of
+    wxBufferedPaintDC object and so everything has to be redrawn every time.
+    If ::wxBUFFER_PERSISTENT style is used, the buffer is kept, for each
+    window, between the paint events instead and only the parts of it which
+    need to be updated, i.e. the union of the window update region and the
+    parts of the buffer which don't have valid contents yet, have to be
+    redrawn. The DC is clipped to this region, which can be retrieved using
+    GetDirtyRegion() to avoid drawing the parts of the window outside of it,
+    and only this region is copied to the window.
+
+    Moreover, when using this style with wxScrolled, the existing contents of
+    the buffer is reused when the window is scrolled, so that only the newly
+    shown part of the window needs to be redrawn. For this to work, the
+    window must use the native scrolling, i.e. wxScrolled::EnableScrolling()
+    must not be used to disable it, and wxScrolled::DoPrepareDC() must be
+    called for wxBufferedPaintDC, as usual.
+
+    This style can only be used together with wxBUFFER_CLIENT_AREA and when
+    no buffer bitmap is provided. Note that it requires keeping a bitmap of
+    the window size in memory for all the windows using it.
+
     @library{wxcore}
     @category{dc}
 
@@ -212,7 +257,9 @@ public:
         Pass wxBUFFER_CLIENT_AREA for the @a style parameter to indicate that
         just the client area of the window is buffered, or
         wxBUFFER_VIRTUAL_AREA to indicate that the buffer bitmap covers the
-        virtual area.
+        virtual area. wxBUFFER_CLIENT_AREA can also be combined with
+        wxBUFFER_PERSISTENT (since wxWidgets 3.3.0) to keep the buffer between
+        the calls.
     */
     wxBufferedPaintDC(wxWindow* window, wxBitmap& buffer,
                       int style = wxBUFFER_CLIENT_AREA);
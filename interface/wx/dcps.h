@@ -32,5 +32,20 @@ public:
     */
     wxPostScriptDC(const wxPrintData& printData);
 
+    /**
+        Enable or disable compressing the bitmaps data.
+
+        If enabled, the bitmaps are compressed using Flate (zlib) filter,
+        which results in much smaller output when drawing big bitmaps, but
+        requires a PostScript level 3 interpreter to process the output. This
+        is why it is disabled by default.
+
+        This function must be called before StartDoc() and does nothing if
+        wxWidgets was built without zlib support, i.e. with @c wxUSE_ZLIB set
+        to 0.
+
+        @since 3.3.0
+    */
+    void EnableImageCompression(bool enable = true);
 };
 
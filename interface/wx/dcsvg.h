@@ -44,6 +44,15 @@ enum wxSVGShapeRenderingMode
     are supported and these are saved as separate files in the same folder
     as the SVG file, however it is possible to change this behaviour by
     replacing the built in bitmap handler using wxSVGFileDC::SetBitmapHandler().
+    Since wxWidgets 3.3.0, it is also possible to write each distinct bitmap
+    only once, even if it is drawn several times, by calling
+    wxSVGFileDC::EnableBitmapSharing().
+
+    The output is written to the file progressively while drawing, so the
+    memory used by wxSVGFileDC doesn't depend on the size of the document.
+    Also since wxWidgets 3.3.0, if the file name has @c .svgz extension, the
+    output is compressed using gzip, as expected for the files with this
+    extension. This requires wxUSE_ZLIB to be enabled.
 
     More substantial SVG libraries (for reading and writing) are available at
     <a href="http://wxart2d.sourceforge.net/" target="_blank">wxArt2D</a> and
@@ -102,6 +111,24 @@ public:
     */
     void SetShapeRenderingMode(wxSVGShapeRenderingMode renderingMode);
 
+    /**
+        Write each distinct bitmap only once.
+
+        By default, wxSVGBitmapHandler::ProcessBitmap() is called every time a
+        bitmap is drawn, with the position of the bitmap. If bitmap sharing is
+        enabled, it is called only once for all bitmaps with the same contents,
+        with 0 position and inside SVG @c defs element, and all the places
+        where the bitmap is drawn refer to it using SVG @c use element, which
+        can make the output much smaller if the same bitmaps are drawn many
+        times. Notice that the custom bitmap handlers must support being used
+        in this way for this to work.
+
+        Bitmap sharing is disabled by default.
+
+        @since 3.3.0
+    */
+    void EnableBitmapSharing(bool enable = true);
+
     /**
         Destroys the current clipping region so that none of the DC is clipped.
         Since intersections arising from sequential calls to SetClippingRegion are represented
@@ -159,8 +186,10 @@ public:
         important that the XML is properly formed.
 
         @param bitmap A valid bitmap to add to SVG.
-        @param x Horizontal position of the bitmap.
-        @param y Vertical position of the bitmap.
+        @param x Horizontal position of the bitmap, always 0 if bitmap
+            sharing is enabled, see wxSVGFileDC::EnableBitmapSharing().
+        @param y Vertical position of the bitmap, always 0 if bitmap
+            sharing is enabled.
         @param stream The stream to write SVG contents to.
     */
     virtual bool ProcessBitmap(const wxBitmap& bitmap,
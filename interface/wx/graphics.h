@@ -967,6 +967,30 @@ public:
                                wxDouble* height, wxDouble* descent,
                                wxDouble* externalLeading) const = 0;
 
+    /**
+        Gets the dimensions of all the given strings using the currently
+        selected font.
+
+        The results are the same as would be returned by calling
+        GetTextExtent() for each of the strings, but this function can be
+        significantly faster when measuring many strings, as the
+        implementation can prepare for measuring only once. In particular,
+        Cairo-based implementation reuses the same Pango layout for all
+        strings.
+
+        @param strings
+            The strings to measure.
+        @param widths
+            Array filled with the widths of all strings, in the same order.
+        @param heights
+            Array filled with the heights of all strings, in the same order.
+
+        @since 3.3.0
+    */
+    virtual void GetMultipleTextExtents(const wxArrayString& strings,
+                                        wxArrayDouble& widths,
+                                        wxArrayDouble& heights) const;
+
     /** @}
     */
 
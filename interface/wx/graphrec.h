@@ -0,0 +1,292 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        graphrec.h
+// Purpose:     interface of wxGraphicsRecording
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxGraphicsRecording
+
+    A list of drawing commands which can be replayed on a wxGraphicsContext.
+
+    The commands are recorded by drawing on a context returned by
+    CreateContext() and can then be replayed any number of times using
+    Replay(), possibly with a different transformation or only partially.
+    This is useful for drawing complex, but rarely changing, contents: e.g.
+    a window can record its contents once and replay only the commands
+    affecting its update region in its wxEVT_PAINT handler.
+
+    Example of using this class:
+    @code
+    wxGraphicsRecording recording;
+    {
+        std::unique_ptr<wxGraphicsContext> gc(recording.CreateContext());
+        gc->SetPen(*wxBLACK_PEN);
+        gc->DrawRectangle(10, 10, 100, 50);
+        ... more drawing ...
+    }
+
+    // Later, e.g. in a paint handler:
+    wxPaintDC dc(this);
+    std::unique_ptr<wxGraphicsContext> gc(wxGraphicsContext::Create(dc));
+    recording.Replay(gc.get(), GetUpdateRegion());
+    @endcode
+
+    The graphics objects, such as pens, brushes and paths, used by the
+    recorded commands are created by the renderer specified when creating the
+    recording context and are stored in the recording itself, so replaying it
+    doesn't recreate them. This implies that the recording can only be
+    replayed on the contexts created by the same renderer.
+
+    Objects of this class are reference-counted, so copying them is cheap and
+    the copies share the same commands.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.3.0
+*/
+class wxGraphicsRecording
+{
+public:
+    /**
+        Default constructor creates an empty recording.
+    */
+    wxGraphicsRecording();
+
+    /**
+        Create a new context recording all the drawing commands into this
+        object.
+
+        The commands are appended to the existing ones, if any.
+
+        Note that the context can't be used to retrieve any information about
+        the drawing surface: e.g. wxGraphicsContext::GetNativeContext()
+        returns @NULL for it.
+
+        @param width
+            Width of the context returned by wxGraphicsContext::GetSize().
+        @param height
+            Height of the context returned by wxGraphicsContext::GetSize().
+        @param renderer
+            The renderer used to create the graphics objects used by the
+            recording. If @NULL, the default renderer is used. Note that if
+            the recording already has some commands, the renderer must be the
+            same as the one used for them.
+        @return
+            The new context which must be deleted by the caller.
+    */
+    wxGraphicsContext* CreateContext(wxDouble width = 0,
+                                     wxDouble height = 0,
+                                     wxGraphicsRenderer* renderer = nullptr);
+
+    /**
+        Return the renderer used by this recording.
+
+        Returns @NULL if CreateContext() hadn't been called yet.
+    */
+    wxGraphicsRenderer* GetRenderer() const;
+
+    /**
+        Return the number of recorded commands.
+
+        This includes both the drawing commands and the commands changing the
+        context state, such as setting the pen or the transformation.
+    */
+    size_t GetCommandCount() const;
+
+    /**
+        Return @true if there are no recorded commands.
+    */
+    bool IsEmpty() const;
+
+    /**
+        Return the bounding box of everything drawn by the recorded commands.
+
+        The box is expressed in the coordinates of the recording context,
+        i.e. without any transformation applied to it, and may be slightly
+        bigger than the actually drawn area.
+    */
+    wxRect2DDouble GetBoundingBox() const;
+
+    /**
+        Remove all recorded commands.
+
+        Note that this affects all the copies of this object.
+    */
+    void Clear();
+
+    /**
+        Replay all recorded commands on the given context.
+
+        The state of the context, such as its transformation and clipping
+        region, is preserved. Notice that if the recording calls
+        wxGraphicsContext::ResetClip(), the clipping region of the context is
+        restored as its bounding box, see wxGraphicsContext::GetClipBox().
+
+        @param gc
+            The context to draw on, must be non-@NULL and created by the same
+            renderer as the recording context.
+    */
+    void Replay(wxGraphicsContext* gc) const;
+
+    /**
+        Replay all recorded commands on the given context applying the
+        specified transformation to them.
+
+        The transformation is combined with the current transformation of
+        the context.
+    */
+    void Replay(wxGraphicsContext* gc, const wxAffineMatrix2D& transform) const;
+
+    /**
+        Replay only the commands affecting the given region.
+
+        The drawing commands which are entirely outside of the region are
+        skipped and the output of the others is clipped to it, which can make
+        repainting a small part of a complex drawing much faster.
+
+        @param gc
+            The context to draw on.
+        @param region
+            The region to draw, in the current coordinates of the context,
+            i.e. without @a transform applied to it.
+        @param transform
+            Optional transformation applied to the recorded commands.
+    */
+    void Replay(wxGraphicsContext* gc,
+                const wxRegion& region,
+                const wxAffineMatrix2D& transform = wxAffineMatrix2D()) const;
+};
+
+/**
+    @class wxGraphicsTiledImageRenderer
+
+    Renders a, possibly very big, image by tiles.
+
+    This class can be used for rendering images which are too big to be
+    rendered at once, e.g. when exporting a drawing at high resolution: the
+    image is split into tiles which are rendered independently and passed to
+    the provided function, which can e.g. write them to a file, so that the
+    memory needed for the entire image is never allocated.
+
+    When using the Cairo renderer, the tiles are rendered in parallel using
+    several threads. To make this possible, the drawing function is called
+    once for each thread in the calling thread, recording the drawing
+    commands in wxGraphicsRecording objects, which are then replayed for each
+    tile in a worker thread. Because of this, the drawing function must
+    create all the graphics objects it uses, such as pens, brushes, paths and
+    bitmaps, using the provided context instead of reusing the same objects
+    for all calls. Note that wxBitmap, wxIcon and wxRegion objects passed to
+    the context are converted to the graphics objects, or copied, when they
+    are recorded, so it's fine to use them, but calling
+    wxGraphicsContext::CreateBitmap() once in the drawing function is still
+    more efficient if the same bitmap is drawn several times.
+
+    Example of using this class:
+    @code
+    wxGraphicsTiledImageRenderer renderer(wxSize(10000, 10000));
+    renderer.Render(
+        [](wxGraphicsContext* gc)
+        {
+            gc->SetBrush(*wxBLUE_BRUSH);
+            gc->DrawEllipse(100, 100, 9800, 9800);
+        },
+        [&](const wxRect& rect, const wxImage& tile)
+        {
+            // Save the tile somewhere, returning false in case of error
+            // would stop rendering.
+            return true;
+        }
+    );
+    @endcode
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.3.0
+*/
+class wxGraphicsTiledImageRenderer
+{
+public:
+    /**
+        Function drawing the image using the given context.
+
+        This function can be called more than once.
+    */
+    typedef std::function<void (wxGraphicsContext* gc)> DrawFunction;
+
+    /**
+        Function called for each rendered tile.
+
+        The tiles are passed to this function in the calling thread, in the
+        order of rows from top to bottom and from left to right inside each
+        row. The function can return @false to stop rendering.
+    */
+    typedef std::function<bool (const wxRect& rect,
+                                const wxImage& tile)> TileFunction;
+
+    /**
+        Create the object rendering the image of the given size.
+
+        @param size
+            The size of the entire image, must be positive.
+        @param renderer
+            The renderer to use, if @NULL the default renderer is used. Note
+            that the tiles are only rendered in parallel when using Cairo
+            renderer.
+    */
+    explicit wxGraphicsTiledImageRenderer(const wxSize& size,
+                                          wxGraphicsRenderer* renderer = nullptr);
+
+    /**
+        Set the size of the tiles.
+
+        The tiles in the last row and column may be smaller than this size.
+        By default, 256 by 256 tiles are used.
+    */
+    void SetTileSize(const wxSize& tileSize);
+
+    /**
+        Set the maximal number of threads used for rendering.
+
+        Default value of 0 means using as many threads as there are CPUs,
+        while 1 renders all tiles in the calling thread.
+    */
+    void SetMaxThreads(int maxThreads);
+
+    /**
+        Set the colour used for the image background.
+
+        The background is white by default. If the colour is not opaque, the
+        tiles have alpha channel.
+    */
+    void SetBackgroundColour(const wxColour& colour);
+
+    /**
+        Render all the tiles.
+
+        At most one row of tiles is kept in memory at any time.
+
+        @param draw
+            Function drawing the image contents.
+        @param onTile
+            Function called with each tile.
+        @return
+            @true if all tiles were rendered or @false if @a onTile returned
+            @false or an error occurred.
+    */
+    bool Render(const DrawFunction& draw, const TileFunction& onTile) const;
+
+    /**
+        Render the entire image.
+
+        This is a convenient wrapper for Render() assembling all the tiles
+        together. Note that it requires allocating the memory for the entire
+        image.
+
+        Returns invalid image in case of error.
+    */
+    wxImage RenderImage(const DrawFunction& draw) const;
+};
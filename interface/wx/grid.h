@@ -108,6 +108,41 @@ public:
                                   wxGridCellAttr& attr,
                                   wxDC& dc);
 
+    /**
+        Get the text whose extent is the best size of the cell, if possible.
+
+        This function is used by wxGrid to measure the cells more efficiently
+        when wxGRID_AUTOSIZE_FAST flag is passed to
+        wxGrid::SetColAutoSizeMode(): instead of calling GetBestWidth() for
+        each cell, the text returned by this function is measured using the
+        font of the cell attribute, only once for all cells with the same
+        text.
+
+        The base class version returns @false, meaning that the cell must be
+        measured using GetBestWidth(). wxGridCellStringRenderer and all the
+        standard renderers deriving from it, except for
+        wxGridCellAutoWrapStringRenderer, override it to return the string
+        shown in the cell. Notice that if a custom renderer deriving from
+        wxGridCellStringRenderer overrides GetBestSize(), it should override
+        this function too to return @false.
+
+        @param grid
+            The grid containing the cell.
+        @param row
+            The row of the cell.
+        @param col
+            The column of the cell.
+        @param text
+            Receives the text of the cell if the function returns @true.
+        @return
+            @true if the best size of the cell is the extent of @a text.
+
+        @since 3.3.0
+     */
+    virtual bool GetTextToMeasure(wxGrid& grid,
+                                  int row, int col,
+                                  wxString& text);
+
 protected:
     /**
         Helper function setting the correct colours and font.
@@ -1943,6 +1978,349 @@ public:
     wxString GetCornerLabelValue() const;
 };
 
+/**
+    Data table storing values of different types in columns.
+
+    Unlike wxGridStringTable, which stores all values as strings, this table
+    stores the values of each column in a vector of the column type: 64-bit
+    integers, doubles, booleans or strings. This uses much less memory for
+    big tables of numbers, and the values are only converted to strings when
+    they're displayed. The strings are stored only once per column, so
+    columns with many repeated values are compact as well.
+
+    The table reports the type of each column using GetTypeName(), so that
+    wxGrid uses the matching renderer and editor for its cells. This means
+    that the numbers are formatted only for the cells which are displayed.
+
+    Columns are added using AppendColumn(). The data is loaded in bulk by
+    adding the rows and then setting the values of each column, e.g.
+    @code
+    wxGridColumnarTable* table = new wxGridColumnarTable;
+    table->AppendColumn(wxGridColumnarTable::Column_Number, "Id");
+    table->AppendColumn(wxGridColumnarTable::Column_Float, "Value");
+
+    table->AppendRows(ids.size());
+    table->SetNumberValues(0, 0, ids.data(), ids.size());
+    table->SetFloatValues(1, 0, values.data(), values.size());
+
+    grid->AssignTable(table);
+    @endcode
+
+    @since 3.3.0
+ */
+class wxGridColumnarTable : public wxGridTableBase
+{
+public:
+    /**
+        Types of values which can be stored in the table columns.
+     */
+    enum ColumnType
+    {
+        /// 64-bit integers, using ::wxGRID_VALUE_NUMBER type.
+        Column_Number,
+
+        /// Floating point numbers, using ::wxGRID_VALUE_FLOAT type.
+        Column_Float,
+
+        /// Booleans, using ::wxGRID_VALUE_BOOL type.
+        Column_Bool,
+
+        /// Strings, using ::wxGRID_VALUE_STRING type.
+        Column_String
+    };
+
+    /**
+        Default constructor creates an empty table.
+     */
+    wxGridColumnarTable();
+
+    /**
+        Constructor creating a table with the given number of rows and no
+        columns.
+     */
+    explicit wxGridColumnarTable( int numRows );
+
+    /**
+        Add a new column of the given type.
+
+        All cells of the new column contain the default value for its type,
+        i.e. 0, @false or an empty string.
+
+        @param type
+            Type of the values stored in the column.
+        @param label
+            Label of the column, the default one is used if empty.
+     */
+    void AppendColumn( ColumnType type, const wxString& label = wxString() );
+
+    /**
+        Return the type of the given column.
+     */
+    ColumnType GetColumnType( int col ) const;
+
+    /**
+        Preallocate memory for the given total number of rows.
+
+        Calling this function before appending many rows is not necessary but
+        avoids reallocations.
+     */
+    void ReserveRows( size_t numRows );
+
+    /**
+        Set values of several cells of a number column.
+
+        @param col
+            Column, which must be of Column_Number type.
+        @param row
+            The first row to set the value of.
+        @param values
+            Pointer to @a count values.
+        @param count
+            Number of values to set, the table must have at least @a row +
+            @a count rows.
+     */
+    void SetNumberValues( int col, size_t row,
+                          const wxLongLong_t* values, size_t count );
+
+    /**
+        Set values of several cells of a floating point column.
+
+        This function is similar to SetNumberValues() but the column must be
+        of Column_Float type.
+     */
+    void SetFloatValues( int col, size_t row,
+                         const double* values, size_t count );
+
+    /**
+        Set values of several cells of a boolean column.
+
+        This function is similar to SetNumberValues() but the column must be
+        of Column_Bool type.
+     */
+    void SetBoolValues( int col, size_t row,
+                        const bool* values, size_t count );
+
+    /**
+        Set values of several cells of a string column.
+
+        This function is similar to SetNumberValues() but the column must be
+        of Column_String type.
+     */
+    void SetStringValues( int col, size_t row,
+                          const wxString* values, size_t count );
+
+    /**
+        Get the value of a cell in a number column.
+
+        Unlike GetValueAsLong(), this function returns the full 64-bit value
+        even on the platforms where @c long is 32 bits. Notice that
+        CanGetValueAs() returns @false for ::wxGRID_VALUE_NUMBER if the value
+        doesn't fit into @c long, so this function or GetValue() must be used
+        to retrieve such values.
+     */
+    wxLongLong_t GetValueAsLongLong( int row, int col ) const;
+
+    /**
+        Set the value of a cell in a number column.
+     */
+    void SetValueAsLongLong( int row, int col, wxLongLong_t value );
+
+    /**
+        Insert columns containing strings.
+     */
+    bool InsertCols( size_t pos = 0, size_t numCols = 1 );
+
+    /**
+        Append columns containing strings.
+     */
+    bool AppendCols( size_t numCols = 1 );
+};
+
+/**
+    Data source used by wxGridAsyncTable.
+
+    Derive from this class and implement its pure virtual functions to
+    provide the data for wxGridAsyncTable.
+
+    Note that FetchRows() is called from a worker thread while the other
+    functions are called from the main thread, so the implementation must be
+    thread-safe.
+
+    @since 3.3.0
+ */
+class wxGridAsyncDataSource
+{
+public:
+    /// Default constructor.
+    wxGridAsyncDataSource();
+
+    /// Virtual destructor.
+    virtual ~wxGridAsyncDataSource();
+
+    /**
+        Return the number of rows.
+
+        This function is called from the main thread and should be fast.
+     */
+    virtual int GetNumberRows() = 0;
+
+    /**
+        Return the number of columns.
+
+        This function is called from the main thread and should be fast.
+     */
+    virtual int GetNumberCols() = 0;
+
+    /**
+        Fetch the values of the given rows.
+
+        This function is called from a worker thread and so must not use any
+        GUI functions. It may take a long time to execute, e.g. when the data
+        is read from a database, without blocking the user interface.
+
+        @param firstRow
+            The first row to fetch.
+        @param numRows
+            The number of rows to fetch, always positive.
+        @param numCols
+            The number of columns, as returned by GetNumberCols().
+        @param values
+            Empty vector to fill with @a numRows times @a numCols values,
+            with all the values of the first row, then of the second one and
+            so on.
+        @return
+            @true if the data was fetched successfully or @false otherwise,
+            in which case fetching it is retried when it's needed again,
+            which happens after a short delay if these rows are still
+            shown in the grid.
+     */
+    virtual bool FetchRows(int firstRow, int numRows, int numCols,
+                           wxVector<wxString>& values) = 0;
+};
+
+/**
+    Read-only table fetching the data from a slow data source asynchronously.
+
+    This table is useful when getting the data takes a long time, e.g. when
+    it is read from a database. Instead of retrieving the values of each cell
+    when it's drawn, which would block the user interface, the table fetches
+    blocks of consecutive rows from wxGridAsyncDataSource in a background
+    thread and keeps the fetched blocks in a cache of limited size.
+
+    The cells which are not available yet show a placeholder text. When a
+    block is fetched, only the cells of this block are refreshed. In addition
+    to the blocks containing the visible rows, the table also prefetches some
+    blocks around them, so that scrolling doesn't show the placeholders in
+    most cases.
+
+    Example of using this class:
+    @code
+    class MyDataSource : public wxGridAsyncDataSource
+    {
+    public:
+        int GetNumberRows() override { return m_numRows; }
+        int GetNumberCols() override { return 3; }
+
+        bool FetchRows(int firstRow, int numRows, int numCols,
+                       wxVector<wxString>& values) override
+        {
+            // Execute "SELECT ... LIMIT numRows OFFSET firstRow" query and
+            // append the values of all columns of each row to the vector.
+            ...
+        }
+
+    private:
+        int m_numRows;
+    };
+
+    grid->AssignTable(new wxGridAsyncTable(new MyDataSource));
+    @endcode
+
+    Note that if threads are not available, i.e. @c wxUSE_THREADS is 0, the
+    data is fetched synchronously.
+
+    @since 3.3.0
+ */
+class wxGridAsyncTable : public wxGridTableBase
+{
+public:
+    /**
+        Create the table using the given data source.
+
+        @param source
+            The data source, must be non-@NULL. The table takes ownership of
+            it and deletes it when it is destroyed.
+        @param blockSize
+            The number of rows fetched at once, must be positive.
+     */
+    explicit wxGridAsyncTable(wxGridAsyncDataSource* source,
+                              int blockSize = 128);
+
+    /**
+        Destructor waits until the block being currently fetched, if any, is
+        fetched.
+     */
+    virtual ~wxGridAsyncTable();
+
+    /**
+        Return the data source used by this table.
+     */
+    wxGridAsyncDataSource* GetDataSource() const;
+
+    /**
+        Set the number of blocks fetched before and after the visible ones.
+
+        The default value is 2.
+     */
+    void SetPrefetchBlocks(int numBlocks);
+
+    /**
+        Set the maximal number of blocks kept in the cache.
+
+        When the cache is full, the least recently used blocks are removed
+        from it. The default value is 64 and it must be big enough to contain
+        all the visible blocks and the prefetched ones.
+     */
+    void SetCacheSize(int numBlocks);
+
+    /**
+        Set the text shown in the cells which are not fetched yet.
+
+        The default placeholder is "...".
+     */
+    void SetPlaceholder(const wxString& placeholder);
+
+    /**
+        Return the text shown in the cells which are not fetched yet.
+     */
+    const wxString& GetPlaceholder() const;
+
+    /**
+        Return @true if the data of the given row is in the cache.
+     */
+    bool IsRowAvailable(int row) const;
+
+    /**
+        Discard all the cached data.
+
+        This function must be called when the data source contents changes.
+        It also refreshes the grid, which results in fetching the data of the
+        visible rows again.
+     */
+    void InvalidateCache();
+
+    /**
+        Return the value of the cell if it's available or the placeholder
+        otherwise, in which case fetching the data is requested.
+     */
+    wxString GetValue(int row, int col);
+
+    /**
+        Does nothing, as this table is read-only.
+     */
+    void SetValue(int row, int col, const wxString& value);
+};
+
 /**
     Represents coordinates of a grid cell.
 
@@ -2864,6 +3242,44 @@ enum wxGridRenderStyle
                           wxGRID_DRAW_BOX_RECT
 };
 
+/**
+    Flags used with wxGrid::SetColAutoSizeMode().
+
+    @since 3.3.0
+ */
+enum wxGridAutoSizeFlags
+{
+    /// Measure all the cells using wxGridCellRenderer::GetBestWidth().
+    wxGRID_AUTOSIZE_DEFAULT = 0x000,
+
+    /**
+        Measure the text of the cells directly.
+
+        When this flag is used, the text of all the cells using the renderers
+        supporting wxGridCellRenderer::GetTextToMeasure() is collected first
+        and then each distinct text is measured only once. When using Cairo
+        graphics renderer, the text is measured using several threads.
+
+        The widths of the texts are also cached by the grid, so that calling
+        wxGrid::AutoSizeColumns() again only measures the new texts. This cache
+        is cleared when the table, the cell attributes set using wxGrid
+        functions or the DPI change.
+
+        Note that the result is the same independently of the number of
+        threads used, but it may be slightly different from the one obtained
+        without using this flag, as the text may be measured differently.
+    */
+    wxGRID_AUTOSIZE_FAST = 0x001,
+
+    /**
+        Measure only the currently visible rows.
+
+        This makes auto-sizing the columns of a grid with many rows fast, but
+        the other rows may not fit into the columns.
+    */
+    wxGRID_AUTOSIZE_VISIBLE_ROWS = 0x002
+};
+
 
 
 /**
@@ -4087,6 +4503,42 @@ public:
     */
     void AutoSizeRows(bool setAsMin = true);
 
+    /**
+        Change the way the cells are measured when auto-sizing columns.
+
+        By default, AutoSizeColumn() and AutoSizeColumns() measure all cells
+        of the column using their renderers, which can take a long time for
+        the grids with many rows. This function allows to make it faster.
+
+        @param flags
+            Combination of wxGridAutoSizeFlags elements.
+        @param maxValues
+            If positive and @a flags contains wxGRID_AUTOSIZE_FAST, only this
+            number of the longest distinct texts is measured in each column.
+            This is a heuristic assuming that the longer texts are wider,
+            which is usually, but not always, the case. The same texts are
+            selected each time for the same contents.
+
+        @see GetColAutoSizeFlags(), GetColAutoSizeMaxValues()
+
+        @since 3.3.0
+     */
+    void SetColAutoSizeMode(int flags, int maxValues = 0);
+
+    /**
+        Return the flags set by SetColAutoSizeMode().
+
+        @since 3.3.0
+     */
+    int GetColAutoSizeFlags() const;
+
+    /**
+        Return the maximal number of values set by SetColAutoSizeMode().
+
+        @since 3.3.0
+     */
+    int GetColAutoSizeMaxValues() const;
+
     /**
         Returns the cell fitting mode.
 
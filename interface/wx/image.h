@@ -113,6 +113,26 @@ enum wxImagePNGType
     wxPNG_TYPE_PALETTE = 4      ///< Palette encoding.
 };
 
+/**
+    Possible values for PNG filter option.
+
+    These values can be combined together to let the PNG handler choose the
+    best filter for each row among the specified ones.
+
+    @see wxImage::SetOption(), wxIMAGE_OPTION_PNG_FILTER
+
+    @since 3.3.0
+ */
+enum wxImagePNGFilter
+{
+    wxPNG_FILTER_NONE  = 0x08,  ///< Don't filter the data.
+    wxPNG_FILTER_SUB   = 0x10,  ///< Use the difference with the left pixel.
+    wxPNG_FILTER_UP    = 0x20,  ///< Use the difference with the pixel above.
+    wxPNG_FILTER_AVG   = 0x40,  ///< Use the difference with the average of the two.
+    wxPNG_FILTER_PAETH = 0x80,  ///< Use Paeth predictor.
+    wxPNG_FILTER_ALL   = 0xf8   ///< Choose the best filter for each row.
+};
+
 
 /**
    Image option names.
@@ -144,6 +164,7 @@ enum wxImagePNGType
 #define wxIMAGE_OPTION_PNG_COMPRESSION_MEM_LEVEL        wxString("PngZM")
 #define wxIMAGE_OPTION_PNG_COMPRESSION_STRATEGY         wxString("PngZS")
 #define wxIMAGE_OPTION_PNG_COMPRESSION_BUFFER_SIZE      wxString("PngZB")
+#define wxIMAGE_OPTION_PNG_COMPRESSION_THREADS          wxString("PngZT")
 
 #define wxIMAGE_OPTION_TIFF_BITSPERSAMPLE               wxString("BitsPerSample")
 #define wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL             wxString("SamplesPerPixel")
@@ -167,6 +188,76 @@ enum
 };
 
 
+/**
+    @class wxImageRowSink
+
+    Abstract base class for the objects receiving the image data as it is
+    being decoded by wxImage::LoadRows().
+
+    Using a custom sink allows processing the images without keeping all of
+    their pixels in memory, which is especially useful for very big images,
+    or showing the partially loaded image while the rest of its data is still
+    arriving.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.3.0
+*/
+class wxImageRowSink
+{
+public:
+    /// Default constructor.
+    wxImageRowSink();
+
+    /// Trivial but virtual destructor.
+    virtual ~wxImageRowSink();
+
+    /**
+        Called once the size of the image is known, before any calls to
+        OnRows().
+
+        @param width
+            Width of the image.
+        @param height
+            Height of the image.
+        @param hasAlpha
+            @true if the image may have alpha channel and so OnRows() will be
+            passed non-null alpha data.
+        @return @true to continue loading or @false to stop it, in which case
+            wxImage::LoadRows() returns @false.
+    */
+    virtual bool OnStart(int width, int height, bool hasAlpha) = 0;
+
+    /**
+        Called with the consecutive rows of the image as they are decoded.
+
+        The rows are usually passed in order from top to bottom, but the same
+        row can be passed more than once for interlaced images, with each
+        subsequent call containing more detailed data. In this case, the
+        pixels which haven't been decoded yet are filled with the nearest
+        already decoded ones, so that each pass provides a complete, if
+        blocky, version of the image.
+
+        @param y
+            The index of the first row.
+        @param count
+            The number of rows, positive.
+        @param data
+            RGB data of the rows, with 3 bytes per pixel and no padding.
+            This pointer is only valid during this function execution.
+        @param alpha
+            Alpha values of the pixels of the rows or @NULL if the image
+            doesn't have alpha channel.
+        @return @true to continue loading or @false to stop it, in which case
+            wxImage::LoadRows() returns @false.
+    */
+    virtual bool OnRows(int y, int count,
+                        const unsigned char* data,
+                        const unsigned char* alpha) = 0;
+};
+
+
 /**
     @class wxImageHandler
 
@@ -308,6 +399,40 @@ public:
     virtual bool LoadFile(wxImage* image, wxInputStream& stream,
                           bool verbose = true, int index = -1);
 
+    /**
+        Loads an image from a stream, passing its data to the given sink as it
+        is being decoded instead of storing it in the image.
+
+        The default implementation calls LoadFile() and then passes all the
+        image rows to the sink at once, but the handlers for the formats
+        which can be decoded incrementally, currently PNG and JPEG, override
+        it to pass the rows to the sink as soon as they are available.
+
+        @param image
+            The image object used for the load options and receiving the
+            options set by the handler, such as wxIMAGE_OPTION_RESOLUTIONX.
+            Its contents after the call is unspecified.
+        @param stream
+            Opened input stream for reading image data.
+        @param sink
+            The object receiving the image data.
+        @param verbose
+            If set to @true, errors reported by the image handler will produce
+            wxLogMessages.
+        @param index
+            The index of the image in the file (starting from zero).
+
+        @return @true if the operation succeeded, @false if an error occurred
+            or if loading was cancelled by the sink.
+
+        @see wxImage::LoadRows()
+
+        @since 3.3.0
+    */
+    virtual bool LoadRows(wxImage* image, wxInputStream& stream,
+                          wxImageRowSink& sink,
+                          bool verbose = true, int index = -1);
+
     /**
         Saves an image in the output stream.
 
@@ -817,9 +942,24 @@ public:
         specified pixel @a blurRadius. This should not be used when using
         a single mask colour for transparency.
 
+        Each pass replaces every pixel with the average of the pixels in the
+        box of size @c 2*blurRadius+1 centered on it, with the time taken not
+        depending on the radius. Applying several box blur passes gives a
+        good approximation of the Gaussian blur, e.g. 3 passes correspond
+        to the Gaussian blur with the standard deviation of approximately
+        @c sqrt(blurRadius*(blurRadius+1)), which is useful for creating soft
+        shadows or glow effects. This is equivalent to, but faster than and
+        uses less memory than, calling this function repeatedly.
+
+        @param blurRadius
+            The radius of the box used for blurring, must be non-negative.
+        @param numPasses
+            The number of times to apply the box blur, must be positive.
+            This parameter is new since wxWidgets 3.3.0.
+
         @see BlurHorizontal(), BlurVertical()
     */
-    wxImage Blur(int blurRadius) const;
+    wxImage Blur(int blurRadius, int numPasses = 1) const;
 
     /**
         Blurs the image in the horizontal direction only. This should not be used
@@ -986,6 +1126,11 @@ public:
         image and will therefore remove the mask partially. Using the alpha channel
         will work.
 
+        Bilinear and bicubic resampling use fixed point arithmetic, and SIMD
+        instructions when available, so their results may differ from the
+        mathematically exact values, and between different platforms, by at
+        most 1 in each channel.
+
         Example:
         @code
         // get the bitmap from somewhere
@@ -1080,6 +1225,73 @@ public:
     bool ConvertAlphaToMask(unsigned char mr, unsigned char mg, unsigned char mb,
                             unsigned char threshold = wxIMAGE_ALPHA_THRESHOLD);
 
+    /**
+        Copies the image data to a buffer of 32 bit pixels with premultiplied
+        alpha.
+
+        Each pixel is stored as a 32 bit value in native byte order, with the
+        alpha component in the most significant byte followed by red, green
+        and blue ones, and the colour components are multiplied by alpha. This
+        is the format used by Cairo @c CAIRO_FORMAT_ARGB32 surfaces, as well
+        as by many other graphics APIs, so this function can be used to fill
+        such surfaces directly, without any intermediate conversions.
+
+        If the image doesn't have alpha channel, all pixels are stored as
+        opaque, making the result also suitable for the surfaces without
+        alpha, such as @c CAIRO_FORMAT_RGB24 ones. If the image has a mask,
+        the pixels of the mask colour are fully transparent.
+
+        The conversion is done using multiple threads if enabled by
+        SetParallelism().
+
+        @param data
+            The buffer of at least @a stride times image height bytes.
+        @param stride
+            The distance between the starting bytes of two consecutive rows in
+            the buffer, must be at least 4 times the image width. The default
+            value of 0 means to use exactly this value.
+        @return @true on success or @false if the image is invalid.
+
+        @see CreateFromPremultipliedARGB()
+
+        @since 3.3.0
+    */
+    bool CopyToPremultipliedARGB(unsigned char* data, int stride = 0) const;
+
+    /**
+        Creates the image from a buffer of 32 bit pixels with premultiplied
+        alpha.
+
+        This is the inverse of CopyToPremultipliedARGB(): the buffer must use
+        the same format and the image is created with alpha channel, unless
+        @a hasAlpha is @false, in which case the alpha component of the
+        pixels is ignored, as with @c CAIRO_FORMAT_RGB24 surfaces.
+
+        Notice that converting the image to premultiplied format and back is
+        lossy for partially transparent pixels, as the precision of their
+        colour components is reduced.
+
+        @param width
+            The width of the image in pixels.
+        @param height
+            The height of the image in pixels.
+        @param data
+            The buffer containing the pixels, it is not used after this
+            function returns.
+        @param stride
+            The distance between the starting bytes of two consecutive rows in
+            the buffer, 0 means 4 times the width.
+        @param hasAlpha
+            Whether the pixels contain alpha component which should be used.
+        @return @true on success or @false if the parameters are invalid.
+
+        @since 3.3.0
+    */
+    bool CreateFromPremultipliedARGB(int width, int height,
+                                     const unsigned char* data,
+                                     int stride = 0,
+                                     bool hasAlpha = true);
+
     /**
         Returns a greyscale version of the image.
 
@@ -1319,16 +1531,21 @@ public:
         Generic options:
         @li @c wxIMAGE_OPTION_MAX_WIDTH and @c wxIMAGE_OPTION_MAX_HEIGHT: If either
             of these options is specified, the loaded image will be scaled down
-            (preserving its aspect ratio) so that its width is less than the
-            max width given if it is not 0 @em and its height is less than the
-            max height given if it is not 0. This is typically used for loading
-            thumbnails and the advantage of using these options compared to
-            calling Rescale() after loading is that some handlers (only JPEG
-            one right now) support rescaling the image during loading which is
-            vastly more efficient than loading the entire huge image and
-            rescaling it later (if these options are not supported by the
-            handler, this is still what happens however). These options must be
-            set before calling LoadFile() to have any effect.
+            (preserving its aspect ratio) to the biggest size such that its
+            width is not greater than the max width given if it is not 0 @em
+            and its height is not greater than the max height given if it is
+            not 0. This is typically used for loading thumbnails and the
+            advantage of using these options compared to calling Rescale()
+            after loading is that some handlers (only JPEG one right now)
+            support downscaling the image during decoding, which is vastly
+            more efficient than loading the entire huge image and rescaling it
+            later (if these options are not supported by the handler, this is
+            still what happens however, and if the handler can only scale the
+            image approximately, only the remaining part is done by Rescale()).
+            These options must be set before calling LoadFile() to have any
+            effect. Note that before wxWidgets 3.3.0 the image was scaled down
+            by a power of 2, and so could be significantly smaller than the
+            maximal size.
 
         @li @c wxIMAGE_OPTION_ORIGINAL_WIDTH and @c wxIMAGE_OPTION_ORIGINAL_HEIGHT:
             These options will return the original size of the image if either
@@ -1359,9 +1576,12 @@ public:
         @li @c wxIMAGE_OPTION_PNG_FORMAT: Format for saving a PNG file, see
             wxImagePNGType for the supported values.
         @li @c wxIMAGE_OPTION_PNG_BITDEPTH: Bit depth for every channel (R/G/B/A).
-        @li @c wxIMAGE_OPTION_PNG_FILTER: Filter for saving a PNG file, see libpng
-            (http://www.libpng.org/pub/png/libpng-1.2.5-manual.html) for possible values
-            (e.g. PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, etc).
+        @li @c wxIMAGE_OPTION_PNG_FILTER: Filter for saving a PNG file, see
+            wxImagePNGFilter for the possible values, which are the same as
+            libpng PNG_FILTER_XXX constants. By default, the best filter is
+            chosen for each row, unless the image uses a palette, in which
+            case no filtering is done. Using ::wxPNG_FILTER_NONE makes saving
+            faster, but the resulting file bigger.
         @li @c wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL: Compression level (0..9) for
             saving a PNG file. A high value creates smaller-but-slower PNG file.
             Note that unlike other formats (e.g. JPEG) the PNG format is always
@@ -1371,13 +1591,24 @@ public:
             level (1..9) for saving a PNG file. A high value means the saving
             process consumes more memory, but may create smaller PNG file.
         @li @c wxIMAGE_OPTION_PNG_COMPRESSION_STRATEGY: Possible values are 0 for
-            default strategy, 1 for filter, and 2 for Huffman-only.
+            default strategy, 1 for filter, 2 for Huffman-only and 3 for RLE.
             You can use OptiPNG (http://optipng.sourceforge.net/) to get a suitable
             value for your application.
         @li @c wxIMAGE_OPTION_PNG_COMPRESSION_BUFFER_SIZE: Internal buffer size
             (in bytes) for saving a PNG file. Ideally this should be as big as
             the resulting PNG file. Use this option if your application produces
             images with small size variation.
+        @li @c wxIMAGE_OPTION_PNG_COMPRESSION_THREADS: The number of threads
+            to use for compressing the image data when saving a PNG file. If
+            this value is different from 1, the image is split into several
+            parts compressed independently and in parallel, which is much
+            faster for big images, at the price of making the file slightly
+            bigger. As with wxImage::SetParallelism(), 0 means using as many
+            threads as there are CPUs. If this option is not specified, the
+            value returned by wxImage::GetParallelism() is used, i.e. a
+            single thread is used by default. This option is ignored when
+            saving images with less than 8 bits per channel. This option is
+            available since wxWidgets 3.3.0.
 
         Options specific to wxTIFFHandler:
         @li @c wxIMAGE_OPTION_TIFF_BITSPERSAMPLE: Number of bits per
@@ -1455,6 +1686,9 @@ public:
     /**
         Returns a sub image of the current one as long as the rect belongs entirely
         to the image.
+
+        Note that this function copies the image data, use wxImageView to
+        access a part of the image without copying it.
     */
     wxImage GetSubImage(const wxRect& rect) const;
 
@@ -1606,6 +1840,46 @@ public:
     virtual bool LoadFile(wxInputStream& stream, const wxString& mimetype,
                           int index = -1);
 
+    /**
+        Loads an image from an input stream passing its data to the sink.
+
+        This function is similar to LoadFile(wxInputStream&, wxBitmapType, int)
+        but, instead of storing all image data in this object, passes it to
+        the provided @a sink as soon as it becomes available. This allows
+        processing huge images using bounded amount of memory or showing the
+        image while it is still being loaded.
+
+        Any load options, e.g. wxIMAGE_OPTION_MAX_WIDTH, must be set on this
+        object before calling this function and the options set by the
+        handler, e.g. wxIMAGE_OPTION_RESOLUTIONX, can be retrieved from it
+        after it returns, but otherwise this image should not be used and
+        its contents after the call is unspecified.
+
+        Note that, unlike LoadFile(), this function doesn't rescale the image
+        to fit the maximal size, if one is specified: only the handlers
+        supporting downscaling the image during decoding, such as JPEG one,
+        honour these options when using it, and the image passed to the sink
+        may still be bigger than the maximal size as they can only scale it
+        by some fixed factors.
+
+        @param stream
+            Opened input stream from which to load the image. If @a type is
+            wxBITMAP_TYPE_ANY, the stream must support seeking.
+        @param sink
+            The object receiving the image data, see wxImageRowSink.
+        @param type
+            The type of the image, see LoadFile() for the possible values.
+        @param index
+            See the description in the LoadFile(wxInputStream&, wxBitmapType, int) overload.
+
+        @return @true if the image was loaded successfully, @false if an
+            error occurred or loading was cancelled by the sink.
+
+        @since 3.3.0
+    */
+    bool LoadRows(wxInputStream& stream, wxImageRowSink& sink,
+                  wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1);
+
     /**
         Saves an image in the given stream.
 
@@ -1791,6 +2065,34 @@ public:
      */
     void SetLoadFlags(int flags);
 
+    /**
+        Sets the number of threads used by the image processing functions.
+
+        By default, all image processing is done in the calling thread.
+        Calling this function with a value different from 1 allows the
+        functions such as Scale(), Rescale(), Blur(), BlurHorizontal(),
+        BlurVertical(), Rotate(), RotateHue(), ChangeSaturation(),
+        ChangeBrightness() and ChangeHSV() to split big images into bands of
+        rows processed concurrently by a pool of worker threads. Small images
+        are always processed in the calling thread as the overhead of using
+        threads would outweigh any gains for them.
+
+        The results of image processing are exactly the same whether threads
+        are used or not and don't depend on the number of threads.
+
+        This setting is global and affects all wxImage objects. It doesn't
+        have any effect if wxWidgets was built without threads support.
+
+        @param numThreads Maximal number of threads to use, including the
+            calling one. The special value 0 means to use as many threads as
+            there are CPUs in the system, while 1 disables the use of threads.
+
+        @see GetParallelism()
+
+        @since 3.3.0
+     */
+    static void SetParallelism(int numThreads);
+
     /**
         Specifies whether there is a mask or not.
 
@@ -2047,6 +2349,15 @@ public:
      */
     static int GetDefaultLoadFlags();
 
+    /**
+        Returns the number of threads used by the image processing functions.
+
+        See SetParallelism() for more information.
+
+        @since 3.3.0
+     */
+    static int GetParallelism();
+
     ///@{
     /**
         If the image file contains more than one image and the image handler is
@@ -2124,6 +2435,170 @@ public:
     static wxImage::RGBValue HSVtoRGB(const wxImage::HSVValue& hsv);
 };
 
+/**
+    @class wxImageView
+
+    Read-only view of a rectangular part of wxImage.
+
+    This class allows accessing the pixels of a part of an image, e.g. a tile
+    of a big image, without copying them, unlike wxImage::GetSubImage(). The
+    data of the view is stored in the rows of the original image, so the
+    distance between the starts of two consecutive rows, returned by
+    GetStride() and GetAlphaStride(), is bigger than the view width unless
+    the view spans the entire image width.
+
+    The view keeps a reference to the image, so it remains valid even if the
+    original image object is destroyed. As wxImage functions modifying the
+    image make a copy of its data if it is shared, the data of the view also
+    doesn't change if the original image is modified using them, e.g.
+    wxImage::SetRGB() or wxImage::Paste(). However directly modifying the
+    data returned by wxImage::GetData() does affect all the views of this
+    image, just as it affects all the other wxImage objects sharing the data.
+
+    Example of processing an image in tiles:
+    @code
+    void ProcessImage(const wxImage& image)
+    {
+        const int tileSize = 256;
+        for ( int y = 0; y < image.GetHeight(); y += tileSize )
+        {
+            for ( int x = 0; x < image.GetWidth(); x += tileSize )
+            {
+                wxRect rect(x, y, tileSize, tileSize);
+                rect.Intersect(wxRect(image.GetSize()));
+
+                ProcessTile(wxImageView(image, rect));
+            }
+        }
+    }
+
+    void ProcessTile(const wxImageView& view)
+    {
+        for ( int y = 0; y < view.GetHeight(); y++ )
+        {
+            const unsigned char* rgb = view.GetRowData(y);
+            ... use 3*view.GetWidth() bytes starting at rgb ...
+        }
+    }
+    @endcode
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage
+
+    @since 3.3.0
+*/
+class wxImageView
+{
+public:
+    /**
+        Default constructor creates an invalid view.
+    */
+    wxImageView();
+
+    /**
+        Creates a view of the entire image.
+    */
+    wxImageView(const wxImage& image);
+
+    /**
+        Creates a view of the given rectangle of the image.
+
+        The rectangle must be entirely inside the image.
+    */
+    wxImageView(const wxImage& image, const wxRect& rect);
+
+    /**
+        Returns @true if the view is valid.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the image this view refers to.
+    */
+    const wxImage& GetImage() const;
+
+    /**
+        Returns the rectangle of the image corresponding to this view.
+    */
+    const wxRect& GetRect() const;
+
+    /// Returns the width of the view.
+    int GetWidth() const;
+
+    /// Returns the height of the view.
+    int GetHeight() const;
+
+    /// Returns the size of the view.
+    wxSize GetSize() const;
+
+    /**
+        Returns @true if the image has alpha channel.
+    */
+    bool HasAlpha() const;
+
+    /**
+        Returns the offset, in bytes, between the starts of consecutive rows
+        of RGB data.
+    */
+    size_t GetStride() const;
+
+    /**
+        Returns the offset, in bytes, between the starts of consecutive rows
+        of alpha data.
+    */
+    size_t GetAlphaStride() const;
+
+    /**
+        Returns the pointer to RGB data of the top left pixel of the view.
+
+        This is the same as GetRowData() with 0 argument.
+    */
+    const unsigned char* GetData() const;
+
+    /**
+        Returns the pointer to alpha value of the top left pixel of the view.
+
+        Returns @NULL if the image doesn't have alpha channel.
+    */
+    const unsigned char* GetAlpha() const;
+
+    /**
+        Returns the pointer to RGB data of the first pixel of the given row.
+
+        @param y
+            Row index, between 0 and GetHeight() (exclusive).
+    */
+    const unsigned char* GetRowData(int y) const;
+
+    /**
+        Returns the pointer to alpha value of the first pixel of the given
+        row or @NULL if the image doesn't have alpha channel.
+
+        @param y
+            Row index, between 0 and GetHeight() (exclusive).
+    */
+    const unsigned char* GetRowAlpha(int y) const;
+
+    /**
+        Returns the view of a part of this view.
+
+        @param rect
+            The rectangle relative to this view, which must be entirely
+            inside it.
+    */
+    wxImageView GetSubView(const wxRect& rect) const;
+
+    /**
+        Creates a new image with the copy of the data of this view.
+
+        The returned image has alpha channel if the original image has it and
+        uses the same mask colour, if any.
+    */
+    wxImage ToImage() const;
+};
+
 
 class wxImageHistogram : public wxImageHistogramBase
 {
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imagebatch.h
+// Purpose:     interface of wxImageBatchLoader and wxImageBatchEvent
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxImageBatchLoader
+
+    Loads many images from files concurrently, using background threads.
+
+    This class is useful for loading a big number of images, e.g. for showing
+    thumbnails of all images in a directory, as fast as possible and without
+    blocking the user interface. The files are loaded in the order in which
+    they are added using Add() by a pool of worker threads and each loaded
+    image is sent to the event handler specified when creating the loader in a
+    wxImageBatchEvent of type @c wxEVT_IMAGE_BATCH_LOADED. Once all the files
+    have been handled, @c wxEVT_IMAGE_BATCH_COMPLETED event is sent too.
+
+    The events are always processed in the main thread, from the event loop,
+    but notice that they can arrive in a different order than the files were
+    added in, as some images take longer to load than others, so
+    wxImageBatchEvent::GetIndex() should be used to find which file the event
+    corresponds to.
+
+    To prevent using too much memory when the images are loaded faster than
+    the application handles them, the number of the images loaded but not yet
+    handled is limited, see SetMaxPending().
+
+    Each worker thread uses its own copies of the image handlers registered
+    with wxImage::AddHandler() when the file is added, so all the standard
+    handlers can be used concurrently. The custom handlers must use
+    wxDECLARE_DYNAMIC_CLASS() and be default-constructible for this to work
+    for them too, otherwise the same handler object is shared by all threads
+    and must be thread-safe.
+
+    Example of using this class in a frame showing image thumbnails:
+    @code
+    MyFrame::MyFrame()
+        : m_loader(this)
+    {
+        m_loader.SetMaxSize(128, 128);
+
+        Bind(wxEVT_IMAGE_BATCH_LOADED, [this](wxImageBatchEvent& event) {
+            if ( event.IsOk() )
+                m_thumbnails->SetThumbnail(event.GetIndex(),
+                                           wxBitmap(event.GetImage()));
+        });
+    }
+
+    void MyFrame::ShowDirectory(const wxArrayString& files)
+    {
+        m_loader.Cancel();
+
+        for ( const auto& file : files )
+            m_loader.Add(file);
+    }
+    @endcode
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage, wxImageBatchEvent
+
+    @since 3.3.0
+*/
+class wxImageBatchLoader
+{
+public:
+    /**
+        Create the loader sending events to the given handler.
+
+        @param handler
+            The event handler receiving the events about the loaded images,
+            must be non-null and remain valid for the lifetime of this object.
+        @param id
+            The identifier used for the events generated by this object.
+        @param maxThreads
+            The maximal number of threads to use for loading the images. The
+            default value of 0 means to use as many threads as there are
+            CPUs.
+    */
+    explicit wxImageBatchLoader(wxEvtHandler* handler,
+                                int id = wxID_ANY,
+                                int maxThreads = 0);
+
+    /**
+        Destructor cancels loading of the remaining images.
+
+        It waits until the images currently being loaded by the worker threads
+        are loaded, but doesn't send any events for them.
+    */
+    ~wxImageBatchLoader();
+
+    /**
+        Set the maximal number of images which may be loaded before the
+        handler processes the events for them.
+
+        When this number is reached, worker threads don't load any more
+        images until the events for the already loaded ones are handled. The
+        images currently being loaded are counted too, so this number should
+        be at least equal to the number of threads to use all of them.
+
+        By default, the limit is equal to twice the number of threads.
+
+        @param maxPending
+            The limit on the number of pending images or 0 to use the default
+            one.
+    */
+    void SetMaxPending(size_t maxPending);
+
+    /**
+        Set the maximal size of the images.
+
+        The images bigger than the specified size are scaled down to fit it,
+        preserving their aspect ratio, as with @c wxIMAGE_OPTION_MAX_WIDTH and
+        @c wxIMAGE_OPTION_MAX_HEIGHT options, which allows some image formats,
+        such as JPEG, to be loaded much faster. The value of 0 means that the
+        corresponding dimension is not limited, which is the default.
+
+        This function affects only the images loaded after it is called.
+    */
+    void SetMaxSize(int maxWidth, int maxHeight);
+
+    /**
+        Add the file to the queue of files to load.
+
+        This function must be called from the main thread only.
+
+        @param fileName
+            The name of the file to load.
+        @param type
+            The type of the image in the file, by default it is determined
+            automatically.
+        @return The index of the file which is returned by
+            wxImageBatchEvent::GetIndex() for the corresponding event. The
+            files are numbered consecutively starting from 0.
+    */
+    size_t Add(const wxString& fileName,
+               wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    /**
+        Cancel loading of all images added until now.
+
+        The events for the images being loaded when this function is called
+        are not sent, even if they are already loaded.
+
+        New images can be added after calling this function.
+    */
+    void Cancel();
+
+    /**
+        Return the number of files which were added, but for which the events
+        haven't been processed yet.
+    */
+    size_t GetPendingCount() const;
+};
+
+/**
+    @class wxImageBatchEvent
+
+    Event sent by wxImageBatchLoader.
+
+    @beginEventTable{wxImageBatchEvent}
+    @event{EVT_IMAGE_BATCH_LOADED(id, func)}
+        Process a @c wxEVT_IMAGE_BATCH_LOADED event, sent when loading an
+        image finished, successfully or not.
+    @event{EVT_IMAGE_BATCH_COMPLETED(id, func)}
+        Process a @c wxEVT_IMAGE_BATCH_COMPLETED event, sent after the event
+        for the last added image has been processed.
+    @endEventTable
+
+    @library{wxcore}
+    @category{events}
+
+    @since 3.3.0
+*/
+class wxImageBatchEvent : public wxEvent
+{
+public:
+    /**
+        Return the index of the file, as returned by wxImageBatchLoader::Add().
+    */
+    size_t GetIndex() const;
+
+    /**
+        Return the name of the file.
+    */
+    const wxString& GetFileName() const;
+
+    /**
+        Return the loaded image.
+
+        The image is invalid if it couldn't be loaded. Notice that no errors
+        are logged in this case.
+    */
+    const wxImage& GetImage() const;
+
+    /**
+        Return @true if the image was successfully loaded.
+    */
+    bool IsOk() const;
+};
+
+wxEventType wxEVT_IMAGE_BATCH_LOADED;
+wxEventType wxEVT_IMAGE_BATCH_COMPLETED;
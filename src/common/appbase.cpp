@@ -40,6 +40,7 @@
 #include "wx/scopedptr.h"
 #include "wx/sysopt.h"
 #include "wx/tokenzr.h"
+#include "wx/private/threadpool.h"
 #include "wx/thread.h"
 #include "wx/stdpaths.h"
 
@@ -235,6 +236,13 @@ wxEventLoopBase *wxAppConsoleBase::CreateMainLoop()
 
 void wxAppConsoleBase::CleanUp()
 {
+#if wxUSE_THREADS
+    // Stop the background tasks before the application object is destroyed,
+    // as they may be using it to send their results to the main thread. Note
+    // that wxAppBase::CleanUp() already does it for the GUI applications.
+    wxThreadPool::CleanUp();
+#endif // wxUSE_THREADS
+
 #if wxUSE_CONFIG
     // Delete the global wxConfig object, if any, and reset it.
     delete wxConfigBase::Set(nullptr);
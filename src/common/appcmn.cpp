@@ -38,6 +38,7 @@
 #include "wx/thread.h"
 #include "wx/vidmode.h"
 #include "wx/evtloop.h"
+#include "wx/private/threadpool.h"
 #include "wx/uilocale.h"
 
 #if wxUSE_FONTMAP
@@ -161,6 +162,12 @@ void wxAppBase::CleanUp()
     delete wxLog::SetActiveTarget(nullptr);
 #endif // wxUSE_LOG
 
+#if wxUSE_THREADS
+    // Wait for the background tasks which may still be running and posting
+    // their results to the application object before it becomes invalid.
+    wxThreadPool::CleanUp();
+#endif // wxUSE_THREADS
+
     // Starting from now, the application object is no longer valid and
     // shouldn't be used any longer, so reset the global pointer to it.
     wxApp::SetInstance(nullptr);
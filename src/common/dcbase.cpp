@@ -637,6 +637,16 @@ bool wxDCImpl::DoGetPartialTextExtents(const wxString& text, wxArrayInt& widths)
     return tm.GetPartialTextExtents(text, widths, m_scaleX);
 }
 
+void wxDCImpl::DoGetMultipleTextExtents(const wxArrayString& strings,
+                                        wxVector<wxSize>& extents,
+                                        const wxFont *font) const
+{
+    // Don't use our own font explicitly if no font is specified, this would
+    // be unnecessary and could result in resetting it for every string.
+    wxTextMeasure tm(GetOwner(), font && font->IsOk() ? font : nullptr);
+    tm.GetMultipleTextExtents(strings, extents);
+}
+
 void wxDCImpl::GetMultiLineTextExtent(const wxString& text,
                                       wxCoord *x,
                                       wxCoord *y,
@@ -20,11 +20,14 @@
 
 
 #include "wx/dcbuffer.h"
+#include "wx/scrolwin.h"
 
 #ifndef WX_PRECOMP
     #include "wx/module.h"
 #endif
 
+#include <unordered_map>
+
 // ============================================================================
 // implementation
 // ============================================================================
@@ -32,6 +35,49 @@
 wxIMPLEMENT_DYNAMIC_CLASS(wxBufferedDC, wxMemoryDC);
 wxIMPLEMENT_ABSTRACT_CLASS(wxBufferedPaintDC, wxBufferedDC);
 
+// ----------------------------------------------------------------------------
+// wxPersistentDCBuffer: backing store bitmap associated with a window
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Maximal number of rectangles in the region to update, if it is more complex
+// than this, its entire bounding box is redrawn and blitted instead.
+const size_t MAX_BLIT_RECTS = 16;
+
+bool IsRegionTooComplex(const wxRegion& region)
+{
+    size_t count = 0;
+    for ( wxRegionIterator it(region); it; ++it )
+    {
+        if ( ++count > MAX_BLIT_RECTS )
+            return true;
+    }
+
+    return false;
+}
+
+struct wxPersistentDCBuffer
+{
+    // The buffer itself, possibly bigger than the window.
+    wxBitmap bitmap;
+
+    // Another bitmap of the same size used when scrolling.
+    wxBitmap spare;
+
+    // The part of the bitmap used for the window contents.
+    wxSize size;
+
+    // The unscrolled position of the window origin when it was last drawn.
+    wxPoint viewStart;
+
+    // The part of the bitmap which doesn't contain valid contents.
+    wxRegion invalid;
+};
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // wxSharedDCBufferManager: helper class maintaining backing store bitmap
 // ----------------------------------------------------------------------------
@@ -42,7 +88,12 @@ public:
     wxSharedDCBufferManager() { }
 
     virtual bool OnInit() override { return true; }
-    virtual void OnExit() override { wxDELETE(ms_buffer); }
+    virtual void OnExit() override
+    {
+        wxDELETE(ms_buffer);
+
+        ms_windowBuffers.clear();
+    }
 
     static wxBitmap* GetBuffer(wxDC* dc, int w, int h)
     {
@@ -76,7 +127,140 @@ public:
         }
     }
 
+    // Return the persistent buffer of at least the given size for the window
+    // and fill the provided region with its part which needs to be redrawn.
+    static wxBitmap* GetWindowBuffer(wxWindow* window, wxDC* dc,
+                                     int w, int h,
+                                     wxRegion& dirty)
+    {
+        const auto it = ms_windowBuffers.find(window);
+        if ( it == ms_windowBuffers.end() )
+            window->Bind(wxEVT_DESTROY, &wxSharedDCBufferManager::OnWindowDestroy);
+
+        wxPersistentDCBuffer& buf = ms_windowBuffers[window];
+
+        const double scale = dc->GetContentScaleFactor();
+        const wxRect rect(0, 0, w, h);
+
+        wxPoint viewStart;
+        if ( wxScrollHelperBase* const
+                scroll = dynamic_cast<wxScrollHelperBase*>(window) )
+            viewStart = scroll->CalcUnscrolledPosition(wxPoint());
+
+        if ( !buf.bitmap.IsOk() || buf.bitmap.GetScaleFactor() != scale )
+        {
+            buf.bitmap = DoCreatePersistentBuffer(scale, w, h);
+            buf.spare = wxBitmap();
+            buf.size = wxSize();
+            buf.viewStart = viewStart;
+            buf.invalid = wxRegion(rect);
+        }
+        else if ( w > buf.bitmap.GetLogicalWidth() ||
+                    h > buf.bitmap.GetLogicalHeight() )
+        {
+            // Allocate some extra space to avoid doing it again if the window
+            // keeps growing, as it typically does when it's being resized.
+            const wxSize old = buf.bitmap.GetLogicalSize();
+            wxBitmap bitmap = DoCreatePersistentBuffer
+                              (
+                                scale,
+                                w > old.x ? wxMax(w, old.x + old.x / 4) : old.x,
+                                h > old.y ? wxMax(h, old.y + old.y / 4) : old.y
+                              );
+
+            CopyBitmapPart(buf.bitmap, wxRect(buf.size), bitmap, wxPoint());
+
+            buf.bitmap = bitmap;
+            buf.spare = wxBitmap();
+        }
+
+        // The previously unused part of the bitmap doesn't have valid contents.
+        if ( w > buf.size.x || h > buf.size.y )
+        {
+            wxRegion added(rect);
+            added.Subtract(wxRect(buf.size));
+            buf.invalid.Union(added);
+        }
+
+        buf.size = rect.GetSize();
+
+        // If the window was scrolled, reuse the part of the old contents still
+        // visible in it.
+        if ( viewStart != buf.viewStart )
+        {
+            const wxPoint delta = buf.viewStart - viewStart;
+
+            wxRect src(-delta.x, -delta.y, w, h);
+            src.Intersect(rect);
+
+            if ( !buf.spare.IsOk() )
+                buf.spare = DoCreatePersistentBuffer(scale,
+                                                     buf.bitmap.GetLogicalWidth(),
+                                                     buf.bitmap.GetLogicalHeight());
+
+            // The bitmaps are swapped, so everything not copied is invalid.
+            wxRegion invalid(rect);
+            if ( !src.IsEmpty() )
+            {
+                CopyBitmapPart(buf.bitmap, src, buf.spare, src.GetPosition() + delta);
+
+                invalid.Subtract(wxRect(src.GetPosition() + delta, src.GetSize()));
+            }
+
+            wxSwap(buf.bitmap, buf.spare);
+
+            if ( !buf.invalid.IsEmpty() )
+                buf.invalid.Offset(delta.x, delta.y);
+            buf.invalid.Union(invalid);
+
+            buf.viewStart = viewStart;
+        }
+
+        // We assume that everything needing to be redrawn will be drawn now.
+        dirty = buf.invalid;
+        dirty.Union(window->GetUpdateRegion());
+        if ( !dirty.IsEmpty() )
+            dirty.Intersect(rect);
+
+        // Avoid doing too many blits if the region is complex, but in this
+        // case the whole bounding box must be redrawn, as the buffer contents
+        // outside of the region itself may be out of date.
+        if ( IsRegionTooComplex(dirty) )
+            dirty = wxRegion(dirty.GetBox());
+
+        buf.invalid.Clear();
+
+        return &buf.bitmap;
+    }
+
 private:
+    static void OnWindowDestroy(wxWindowDestroyEvent& event)
+    {
+        event.Skip();
+
+        ms_windowBuffers.erase(event.GetWindow());
+    }
+
+    static wxBitmap DoCreatePersistentBuffer(double scale, int w, int h)
+    {
+        wxBitmap bitmap;
+        bitmap.CreateWithLogicalSize(wxMax(w, 1), wxMax(h, 1), scale);
+
+        return bitmap;
+    }
+
+    // Copy the given rectangle of one bitmap to another one.
+    static void CopyBitmapPart(wxBitmap& from, const wxRect& rect,
+                               wxBitmap& to, const wxPoint& pos)
+    {
+        if ( rect.IsEmpty() )
+            return;
+
+        wxMemoryDC dcFrom(from);
+        wxMemoryDC dcTo(to);
+        dcTo.Blit(pos, rect.GetSize(), &dcFrom, rect.GetPosition());
+    }
+
     static wxBitmap* DoCreateBuffer(wxDC* dc, int w, int h)
     {
         const double scale = dc ? dc->GetContentScaleFactor() : 1.0;
@@ -92,11 +276,15 @@ private:
     static wxBitmap *ms_buffer;
     static bool ms_usingSharedBuffer;
 
+    static std::unordered_map<wxWindow*, wxPersistentDCBuffer> ms_windowBuffers;
+
     wxDECLARE_DYNAMIC_CLASS(wxSharedDCBufferManager);
 };
 
 wxBitmap* wxSharedDCBufferManager::ms_buffer = nullptr;
 bool wxSharedDCBufferManager::ms_usingSharedBuffer = false;
+std::unordered_map<wxWindow*, wxPersistentDCBuffer>
+    wxSharedDCBufferManager::ms_windowBuffers;
 
 wxIMPLEMENT_DYNAMIC_CLASS(wxSharedDCBufferManager, wxModule);
 
@@ -113,15 +301,49 @@ void wxBufferedDC::UseBuffer(wxCoord w, wxCoord h)
         if ( w == -1 || h == -1 )
             m_dc->GetSize(&w, &h);
 
-        m_buffer = wxSharedDCBufferManager::GetBuffer(m_dc, w, h);
-        m_style |= wxBUFFER_USES_SHARED_BUFFER;
+        if ( m_style & wxBUFFER_PERSISTENT )
+        {
+            wxWindow* const window = m_dc ? m_dc->GetWindow() : nullptr;
+            if ( !window ||
+                    !wxDynamicCast(m_dc, wxPaintDC) ||
+                        (m_style & wxBUFFER_VIRTUAL_AREA) )
+            {
+                wxFAIL_MSG( "wxBUFFER_PERSISTENT can only be used with "
+                            "wxBufferedPaintDC and wxBUFFER_CLIENT_AREA" );
+
+                m_style &= ~wxBUFFER_PERSISTENT;
+            }
+            else
+            {
+                m_buffer = wxSharedDCBufferManager::GetWindowBuffer(window, m_dc,
+                                                                    w, h,
+                                                                    m_dirtyRegion);
+            }
+        }
+
+        if ( !(m_style & wxBUFFER_PERSISTENT) )
+        {
+            m_buffer = wxSharedDCBufferManager::GetBuffer(m_dc, w, h);
+            m_style |= wxBUFFER_USES_SHARED_BUFFER;
+        }
+
         m_area.Set(w,h);
     }
     else
+    {
+        // The persistent buffer is only used if no buffer is specified.
+        m_style &= ~wxBUFFER_PERSISTENT;
+
         m_area = m_buffer->GetSize();
+    }
 
     SelectObject(*m_buffer);
 
+    // Don't bother drawing anything outside of the region which will be
+    // copied to the screen.
+    if ( (m_style & wxBUFFER_PERSISTENT) && !m_dirtyRegion.IsEmpty() )
+        SetDeviceClippingRegion(m_dirtyRegion);
+
     // now that the DC is valid we can inherit the attributes (fonts, colours,
     // layout direction, ...) from the original DC
     if ( m_dc && m_dc->IsOk() )
@@ -159,10 +381,34 @@ void wxBufferedDC::UnMask()
         height = wxMin(height, heightDC);
     }
 
-    const wxPoint origin = GetLogicalOrigin();
-    m_dc->Blit(-origin.x, -origin.y, width, height, this, -x, -y);
+    if ( m_style & wxBUFFER_PERSISTENT )
+    {
+        // Only copy the part of the buffer which was redrawn, notice that it
+        // is never too complex as GetWindowBuffer() simplifies it if needed.
+        const wxRect rectAll(0, 0, width, height);
+
+        for ( wxRegionIterator it(m_dirtyRegion); it; ++it )
+            BlitToDC(it.GetRect().Intersect(rectAll), x, y);
+
+        m_dirtyRegion.Clear();
+    }
+    else
+    {
+        BlitToDC(wxRect(0, 0, width, height), x, y);
+    }
+
     m_dc = nullptr;
 
     if ( m_style & wxBUFFER_USES_SHARED_BUFFER )
         wxSharedDCBufferManager::ReleaseBuffer(m_buffer);
 }
+
+void wxBufferedDC::BlitToDC(const wxRect& rect, wxCoord x, wxCoord y)
+{
+    if ( rect.IsEmpty() )
+        return;
+
+    const wxPoint origin = GetLogicalOrigin();
+    m_dc->Blit(rect.x - origin.x, rect.y - origin.y, rect.width, rect.height,
+               this, rect.x - x, rect.y - y);
+}
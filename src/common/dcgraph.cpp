@@ -1281,6 +1281,34 @@ bool wxGCDCImpl::DoGetPartialTextExtents(const wxString& text, wxArrayInt& width
     return true;
 }
 
+void wxGCDCImpl::DoGetMultipleTextExtents(const wxArrayString& strings,
+                                          wxVector<wxSize>& extents,
+                                          const wxFont *theFont) const
+{
+    extents.assign(strings.size(), wxSize());
+
+    wxCHECK_RET( m_graphicContext, wxT("wxGCDC(cg)::DoGetMultipleTextExtents - invalid DC") );
+
+    if ( theFont )
+    {
+        m_graphicContext->SetFont( *theFont, m_textForegroundColour );
+    }
+
+    wxArrayDouble widths, heights;
+    m_graphicContext->GetMultipleTextExtents( strings, widths, heights );
+
+    for ( size_t i = 0; i < extents.size(); ++i )
+    {
+        extents[i].x = (wxCoord)ceil(widths[i]);
+        extents[i].y = (wxCoord)ceil(heights[i]);
+    }
+
+    if ( theFont )
+    {
+        m_graphicContext->SetFont( m_font, m_textForegroundColour );
+    }
+}
+
 wxCoord wxGCDCImpl::GetCharWidth() const
 {
     wxCoord width = 0;
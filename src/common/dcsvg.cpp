@@ -16,6 +16,7 @@
     #include "wx/dcscreen.h"
     #include "wx/icon.h"
     #include "wx/image.h"
+    #include "wx/log.h"
     #include "wx/math.h"
 #endif
 
@@ -28,6 +29,10 @@
 #include "wx/display.h"
 #include "wx/private/rescale.h"
 
+#if wxUSE_ZLIB
+    #include "wx/zstream.h"
+#endif
+
 #if wxUSE_MARKUP
     #include "wx/private/markupparser.h"
 #endif
@@ -61,6 +66,219 @@ inline wxString NumStr(float f)
     return NumStr(double(f));
 }
 
+// Write the decimal representation of the given number, which must be less
+// than 10^20, to the end of the buffer and return the pointer to its start.
+inline char* FormatUnsigned(wxUint64 n, char* end)
+{
+    char* p = end;
+    do
+    {
+        *--p = static_cast<char>('0' + n % 10);
+        n /= 10;
+    }
+    while ( n );
+
+    return p;
+}
+
+// Format the number in the same way as NumStr() does, but much faster, as
+// this function is called for all coordinates in the output.
+//
+// The buffer must be big enough to contain the result, i.e. have at least
+// NUM_BUF_SIZE characters, and the length of the result is returned.
+const size_t NUM_BUF_SIZE = 64;
+
+size_t FormatNum(double f, char* buf)
+{
+    if ( f == 0 )
+    {
+        memcpy(buf, "0.00", 4);
+        return 4;
+    }
+
+    const double scaled = fabs(f) * 100;
+
+    // The result of the simple rounding below may differ from the one
+    // produced by printf() for the numbers very close to the mid point
+    // between two representable values, as printf() uses the exact value of
+    // the number, so fall back to the slow, but exact, conversion for them,
+    // as well as for the numbers too big for our integer arithmetic and NaNs.
+    const double frac = scaled - floor(scaled);
+    if ( !(scaled < 1e11) || fabs(frac - 0.5) < 1e-4 )
+    {
+        const wxScopedCharBuffer str = NumStr(f).utf8_str();
+        const size_t len = wxMin(str.length(), NUM_BUF_SIZE);
+        memcpy(buf, str.data(), len);
+        return len;
+    }
+
+    const wxUint64 n = static_cast<wxUint64>(floor(scaled + 0.5));
+
+    char tmp[32];
+    char* const end = tmp + WXSIZEOF(tmp);
+    char* p = end;
+    *--p = static_cast<char>('0' + n % 10);
+    *--p = static_cast<char>('0' + (n / 10) % 10);
+    *--p = '.';
+    p = FormatUnsigned(n / 100, p);
+
+    // Note that we still need to output the sign if the number rounds to 0,
+    // as printf() does.
+    if ( f < 0 )
+        *--p = '-';
+
+    const size_t len = end - p;
+    memcpy(buf, p, len);
+    return len;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxSVGStreamWriter: buffered output of the SVG document
+// ----------------------------------------------------------------------------
+
+// This class accumulates the output in a fixed size buffer and writes it to
+// the stream only when the buffer is full, which is much faster than writing
+// each element separately, and provides efficient functions for formatting
+// the numbers, avoiding the use of wxString::Format() for each of them.
+class wxSVGStreamWriter
+{
+public:
+    // Takes ownership of the stream, which may be null, in which case nothing
+    // is written and IsOk() always returns false.
+    explicit wxSVGStreamWriter(wxOutputStream* stream)
+        : m_file(stream),
+          m_stream(stream),
+          m_used(0)
+    {
+    }
+
+    // Compress the output using gzip format.
+    bool UseGzip()
+    {
+#if wxUSE_ZLIB
+        if ( !m_file || !wxZlibOutputStream::CanHandleGZip() )
+            return false;
+
+        m_filter.reset(new wxZlibOutputStream(*m_file, -1, wxZLIB_GZIP));
+        m_stream = m_filter.get();
+        return true;
+#else // !wxUSE_ZLIB
+        return false;
+#endif // wxUSE_ZLIB/!wxUSE_ZLIB
+    }
+
+    ~wxSVGStreamWriter()
+    {
+        Flush();
+
+        // Close the compressing stream before deleting the underlying one.
+        m_filter.reset();
+    }
+
+    bool IsOk() const
+    {
+        return m_stream && m_stream->IsOk();
+    }
+
+    // Return the stream after writing all the buffered data to it.
+    wxOutputStream* GetStream()
+    {
+        Flush();
+
+        return m_stream;
+    }
+
+    void Flush()
+    {
+        if ( m_used && m_stream )
+            m_stream->Write(m_buffer, m_used);
+
+        m_used = 0;
+    }
+
+    void Write(const char* data, size_t len)
+    {
+        if ( m_used + len > BUFFER_SIZE )
+        {
+            Flush();
+
+            // Don't bother copying the data which wouldn't fit in the buffer
+            // anyhow.
+            if ( len > BUFFER_SIZE )
+            {
+                if ( m_stream )
+                    m_stream->Write(data, len);
+                return;
+            }
+        }
+
+        memcpy(m_buffer + m_used, data, len);
+        m_used += len;
+    }
+
+    wxSVGStreamWriter& operator<<(const char* s)
+    {
+        Write(s, strlen(s));
+        return *this;
+    }
+
+    wxSVGStreamWriter& operator<<(const wxString& s)
+    {
+        const wxScopedCharBuffer buf = s.utf8_str();
+        Write(buf.data(), buf.length());
+        return *this;
+    }
+
+    wxSVGStreamWriter& operator<<(char c)
+    {
+        if ( m_used == BUFFER_SIZE )
+            Flush();
+
+        m_buffer[m_used++] = c;
+        return *this;
+    }
+
+    wxSVGStreamWriter& operator<<(int n)
+    {
+        char tmp[16];
+        char* const end = tmp + WXSIZEOF(tmp);
+        char* p = FormatUnsigned(n < 0 ? -static_cast<wxInt64>(n) : n, end);
+        if ( n < 0 )
+            *--p = '-';
+
+        Write(p, end - p);
+        return *this;
+    }
+
+    // Doubles are always written with 2 digits after the decimal point.
+    wxSVGStreamWriter& operator<<(double f)
+    {
+        char tmp[NUM_BUF_SIZE];
+        Write(tmp, FormatNum(f, tmp));
+        return *this;
+    }
+
+private:
+    enum { BUFFER_SIZE = 64*1024 };
+
+    // The file stream we own and the filter stream writing to it, if any.
+    std::unique_ptr<wxOutputStream> m_file;
+    std::unique_ptr<wxOutputStream> m_filter;
+
+    // The stream to write to, either m_file or m_filter.
+    wxOutputStream* m_stream;
+
+    char m_buffer[BUFFER_SIZE];
+    size_t m_used;
+
+    wxDECLARE_NO_COPY_CLASS(wxSVGStreamWriter);
+};
+
+namespace
+{
+
 // Return the colour representation as HTML-like "#rrggbb" string and also
 // returns its alpha as opacity number in 0..1 range.
 wxString Col2SVG(wxColour c, float* opacity = nullptr)
@@ -348,7 +566,7 @@ wxString CreateBrushFill(const wxBrush& brush, wxSVGShapeRenderingMode mode)
 
         float opacity;
         wxString brushColourStr = Col2SVG(brush.GetColour(), &opacity);
-        wxString brushStrokeStr = wxS("stroke-width:1; stroke-linecap:round; stroke-linejoin:round;");
+        wxString brushStrokeStr = wxS("stroke-width:1; stroke-linecap:round; stroke-linejoin:round; stroke-dasharray:none;");
 
         s += wxString::Format(wxS("  <pattern id=\"%s\" patternUnits=\"userSpaceOnUse\" width=\"8\" height=\"8\">\n"),
             patternName);
@@ -360,6 +578,48 @@ wxString CreateBrushFill(const wxBrush& brush, wxSVGShapeRenderingMode mode)
     return s;
 }
 
+// Compute the hash of the image contents using FNV-1a algorithm.
+wxUint64 GetImageHash(const wxImage& image)
+{
+    wxUint64 hash = wxULL(14695981039346656037);
+    const auto update = [&hash](const unsigned char* data, size_t len)
+    {
+        for ( size_t n = 0; n < len; n++ )
+        {
+            hash ^= data[n];
+            hash *= wxULL(1099511628211);
+        }
+    };
+
+    const int size[] = { image.GetWidth(), image.GetHeight() };
+    update(reinterpret_cast<const unsigned char*>(size), sizeof(size));
+
+    const size_t numPixels = static_cast<size_t>(size[0]) * size[1];
+    if ( image.GetData() )
+        update(image.GetData(), 3*numPixels);
+    if ( image.HasAlpha() )
+        update(image.GetAlpha(), numPixels);
+
+    return hash;
+}
+
+// Check if the two images have exactly the same pixels.
+bool AreImagesEqual(const wxImage& image1, const wxImage& image2)
+{
+    if ( image1.GetSize() != image2.GetSize() ||
+            image1.HasAlpha() != image2.HasAlpha() )
+        return false;
+
+    const size_t numPixels = static_cast<size_t>(image1.GetWidth()) *
+                                image1.GetHeight();
+
+    if ( memcmp(image1.GetData(), image2.GetData(), 3*numPixels) != 0 )
+        return false;
+
+    return !image1.HasAlpha() ||
+            memcmp(image1.GetAlpha(), image2.GetAlpha(), numPixels) == 0;
+}
+
 void SetScaledScreenDCFont(wxScreenDC& sDC, const wxFont& font)
 {
     const double screenDPI = sDC.GetPPI().y;
@@ -506,6 +766,11 @@ void wxSVGFileDC::SetShapeRenderingMode(wxSVGShapeRenderingMode renderingMode)
     ((wxSVGFileDCImpl*)GetImpl())->SetShapeRenderingMode(renderingMode);
 }
 
+void wxSVGFileDC::EnableBitmapSharing(bool enable)
+{
+    ((wxSVGFileDCImpl*)GetImpl())->EnableBitmapSharing(enable);
+}
+
 // ----------------------------------------------------------
 // wxSVGFileDCImpl
 // ----------------------------------------------------------
@@ -550,14 +815,25 @@ void wxSVGFileDCImpl::Init(const wxString& filename, int width, int height,
 
     m_renderingMode = wxSVG_SHAPE_RENDERING_AUTO;
 
+    m_shareBitmaps = false;
+
     ////////////////////code here
 
     m_bmp_handler.reset();
 
-    if ( m_filename.empty() )
-        m_outfile.reset();
-    else
-        m_outfile.reset(new wxFileOutputStream(m_filename));
+    m_writer.reset(new wxSVGStreamWriter(m_filename.empty()
+                                            ? nullptr
+                                            : new wxFileOutputStream(m_filename)));
+
+    // Use compressed output for the files with the conventional extension
+    // for the compressed SVG.
+    if ( wxFileName(m_filename).GetExt().IsSameAs("svgz", false) )
+    {
+        if ( !m_writer->UseGzip() )
+        {
+            wxLogDebug("Compressed SVG output is not available.");
+        }
+    }
 
     const wxSize dpiSize = FromDIP(wxSize(m_width, m_height));
 
@@ -627,11 +903,9 @@ void wxSVGFileDCImpl::DoDrawLine(wxCoord x1, wxCoord y1, wxCoord x2, wxCoord y2)
 {
     NewGraphicsIfNeeded();
 
-    wxString s;
-    s = wxString::Format(wxS("  <path d=\"M%d %d L%d %d\" %s %s/>\n"),
-        x1, y1, x2, y2, GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
-
-    write(s);
+    *m_writer << "  <path d=\"M" << x1 << ' ' << y1
+              << " L" << x2 << ' ' << y2 << "\"/>\n";
+    m_OK = m_writer->IsOk();
 
     CalcBoundingBox(x1, y1, x2, y2);
 }
@@ -641,23 +915,21 @@ void wxSVGFileDCImpl::DoDrawLines(int n, const wxPoint points[], wxCoord xoffset
     if (n > 1)
     {
         NewGraphicsIfNeeded();
-        wxString s;
 
-        s = wxString::Format(wxS("  <path d=\"M%d %d"),
-            (points[0].x + xoffset), (points[0].y + yoffset));
+        *m_writer << "  <path d=\"M"
+                  << (points[0].x + xoffset) << ' ' << (points[0].y + yoffset);
 
         CalcBoundingBox(points[0].x + xoffset, points[0].y + yoffset);
 
         for (int i = 1; i < n; ++i)
         {
-            s += wxString::Format(wxS(" L%d %d"), (points[i].x + xoffset), (points[i].y + yoffset));
+            *m_writer << " L"
+                      << (points[i].x + xoffset) << ' ' << (points[i].y + yoffset);
             CalcBoundingBox(points[i].x + xoffset, points[i].y + yoffset);
         }
 
-        s += wxString::Format(wxS("\" style=\"fill:none\" %s %s/>\n"),
-            GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
-
-        write(s);
+        *m_writer << "\" style=\"fill:none\"/>\n";
+        m_OK = m_writer->IsOk();
     }
 }
 
@@ -677,10 +949,10 @@ void wxSVGFileDCImpl::DoDrawSpline(const wxPointList* points)
     wxPoint2DDouble p2(*pt);
     wxPoint2DDouble p3 = (p1 + p2) / 2.0;
 
-    wxString s = "  <path d=\"";
+    wxSVGStreamWriter& w = *m_writer;
 
-    s += wxString::Format("M %s %s L %s %s",
-                          NumStr(p1.m_x), NumStr(p1.m_y), NumStr(p3.m_x), NumStr(p3.m_y));
+    w << "  <path d=\"M " << p1.m_x << ' ' << p1.m_y
+      << " L " << p3.m_x << ' ' << p3.m_y;
     CalcBoundingBox(wxRound(p1.m_x), wxRound(p1.m_y));
     CalcBoundingBox(wxRound(p3.m_x), wxRound(p3.m_y));
 
@@ -697,18 +969,18 @@ void wxSVGFileDCImpl::DoDrawSpline(const wxPointList* points)
         wxPoint2DDouble c1 = (p0 + (p1 * 2.0)) / 3.0;
         wxPoint2DDouble c2 = ((p1 * 2.0) + p3) / 3.0;
 
-        s += wxString::Format(" C %s %s, %s %s, %s %s",
-             NumStr(c1.m_x), NumStr(c1.m_y), NumStr(c2.m_x), NumStr(c2.m_y), NumStr(p3.m_x), NumStr(p3.m_y));
+        w << " C " << c1.m_x << ' ' << c1.m_y
+          << ", " << c2.m_x << ' ' << c2.m_y
+          << ", " << p3.m_x << ' ' << p3.m_y;
 
         CalcBoundingBox(wxRound(p0.m_x), wxRound(p0.m_y));
         CalcBoundingBox(wxRound(p3.m_x), wxRound(p3.m_y));
     }
-    s += wxString::Format(" L %s %s", NumStr(p2.m_x), NumStr(p2.m_y));
+    w << " L " << p2.m_x << ' ' << p2.m_y;
     CalcBoundingBox(wxRound(p2.m_x), wxRound(p2.m_y));
 
-    s += wxString::Format("\" style=\"fill:none\" %s %s/>\n",
-                          GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
-    write(s);
+    w << "\" style=\"fill:none\"/>\n";
+    m_OK = w.IsOk();
 }
 #endif // wxUSE_SPLINES
 
@@ -716,15 +988,12 @@ void wxSVGFileDCImpl::DoDrawPoint(wxCoord x, wxCoord y)
 {
     NewGraphicsIfNeeded();
 
-    wxString s;
-
-    s = wxS("  <g style=\"stroke-width:1; stroke-linecap:round;\">\n  ");
-    write(s);
+    *m_writer << "  <g style=\"stroke-width:1; stroke-linecap:round;\">\n  ";
 
     DoDrawLine(x, y, x, y);
 
-    s = wxS("  </g>\n");
-    write(s);
+    *m_writer << "  </g>\n";
+    m_OK = m_writer->IsOk();
 }
 
 void wxSVGFileDCImpl::DoDrawText(const wxString& text, wxCoord x, wxCoord y)
@@ -813,7 +1082,7 @@ void wxSVGFileDCImpl::DoDrawRotatedText(const wxString& sText, wxCoord x, wxCoor
         {
             // draw text background
             const wxString rectStyle = wxString::Format(
-                wxS("style=\"%s %s stroke-width:1;\""),
+                wxS("style=\"%s %s stroke-width:1; stroke-dasharray:none;\""),
                 GetBrushFill(m_textBackgroundColour),
                 GetPenStroke(m_textBackgroundColour));
 
@@ -822,9 +1091,9 @@ void wxSVGFileDCImpl::DoDrawRotatedText(const wxString& sText, wxCoord x, wxCoor
                 NumStr(-angle), NumStr(xRect), NumStr(yRect));
 
             s = wxString::Format(
-                wxS("  <rect x=\"%s\" y=\"%s\" width=\"%d\" height=\"%d\" %s %s %s/>\n"),
+                wxS("  <rect x=\"%s\" y=\"%s\" width=\"%d\" height=\"%d\" %s %s/>\n"),
                 NumStr(xRect), NumStr(yRect), ww, hh,
-                GetRenderMode(m_renderingMode), rectStyle, rectTransform);
+                rectStyle, rectTransform);
 
             write(s);
         }
@@ -855,13 +1124,17 @@ void wxSVGFileDCImpl::DoDrawRectangle(wxCoord x, wxCoord y, wxCoord width, wxCoo
 void wxSVGFileDCImpl::DoDrawRoundedRectangle(wxCoord x, wxCoord y, wxCoord width, wxCoord height, double radius)
 {
     NewGraphicsIfNeeded();
-    wxString s;
 
-    s = wxString::Format(wxS("  <rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" rx=\"%s\" %s %s %s/>\n"),
-        x, y, width, height, NumStr(radius),
-        GetRenderMode(m_renderingMode), GetPenPattern(m_pen), GetBrushPattern(m_brush));
+    *m_writer << "  <rect x=\"" << x << "\" y=\"" << y
+              << "\" width=\"" << width << "\" height=\"" << height
+              << "\" rx=\"" << radius << '"';
 
-    write(s);
+    const wxString brushPattern = GetBrushPattern(m_brush);
+    if ( !brushPattern.empty() )
+        *m_writer << ' ' << brushPattern;
+
+    *m_writer << "/>\n";
+    m_OK = m_writer->IsOk();
 
     CalcBoundingBox(wxPoint(x, y), wxSize(width, height));
 }
@@ -872,21 +1145,26 @@ void wxSVGFileDCImpl::DoDrawPolygon(int n, const wxPoint points[],
 {
     NewGraphicsIfNeeded();
 
-    wxString s;
+    wxSVGStreamWriter& w = *m_writer;
 
-    s = wxS("  <polygon points=\"");
+    w << "  <polygon points=\"";
 
     for (int i = 0; i < n; i++)
     {
-        s += wxString::Format(wxS("%d %d "), points[i].x + xoffset, points[i].y + yoffset);
+        w << (points[i].x + xoffset) << ' ' << (points[i].y + yoffset) << ' ';
         CalcBoundingBox(points[i].x + xoffset, points[i].y + yoffset);
     }
 
-    s += wxString::Format(wxS("\" %s %s %s style=\"fill-rule:%s;\"/>\n"),
-        GetRenderMode(m_renderingMode), GetPenPattern(m_pen), GetBrushPattern(m_brush),
-        fillStyle == wxODDEVEN_RULE ? wxS("evenodd") : wxS("nonzero"));
+    w << '"';
 
-    write(s);
+    const wxString brushPattern = GetBrushPattern(m_brush);
+    if ( !brushPattern.empty() )
+        w << ' ' << brushPattern;
+
+    w << " style=\"fill-rule:"
+      << (fillStyle == wxODDEVEN_RULE ? "evenodd" : "nonzero")
+      << ";\"/>\n";
+    m_OK = w.IsOk();
 }
 
 void wxSVGFileDCImpl::DoDrawPolyPolygon(int n, const int count[], const wxPoint points[],
@@ -938,13 +1216,9 @@ void wxSVGFileDCImpl::DoDrawEllipse(wxCoord x, wxCoord y, wxCoord width, wxCoord
     const double rh = height / 2.0;
     const double rw = width / 2.0;
 
-    wxString s;
-    s = wxString::Format(wxS("  <ellipse cx=\"%s\" cy=\"%s\" rx=\"%s\" ry=\"%s\" %s %s"),
-        NumStr(x + rw), NumStr(y + rh), NumStr(rw), NumStr(rh),
-        GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
-    s += wxS("/>\n");
-
-    write(s);
+    *m_writer << "  <ellipse cx=\"" << (x + rw) << "\" cy=\"" << (y + rh)
+              << "\" rx=\"" << rw << "\" ry=\"" << rh << "\"/>\n";
+    m_OK = m_writer->IsOk();
 
     CalcBoundingBox(wxPoint(x, y), wxSize(width, height));
 }
@@ -1008,8 +1282,7 @@ void wxSVGFileDCImpl::DoDrawArc(wxCoord x1, wxCoord y1, wxCoord x2, wxCoord y2,
             x1, y1, NumStr(r1), NumStr(r2), fArc, fSweep, x2, y2, line);
     }
 
-    s += wxString::Format(wxS("\" %s %s/>\n"),
-        GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
+    s += wxS("\"/>\n");
 
     write(s);
 }
@@ -1094,17 +1367,15 @@ void wxSVGFileDCImpl::DoDrawEllipticArc(wxCoord x, wxCoord y, wxCoord w, wxCoord
         NewGraphicsIfNeeded();
 
         wxString arcFill = arcPath;
-        arcFill += wxString::Format(wxS(" L%s %s z\" %s %s/>\n"),
-            NumStr(xc), NumStr(yc),
-            GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
+        arcFill += wxString::Format(wxS(" L%s %s z\"/>\n"),
+            NumStr(xc), NumStr(yc));
         write(arcFill);
     }
 
     wxDCBrushChanger setTransp(*GetOwner(), *wxTRANSPARENT_BRUSH);
     NewGraphicsIfNeeded();
 
-    wxString arcLine = wxString::Format(wxS("%s\" %s %s/>\n"),
-        arcPath, GetRenderMode(m_renderingMode), GetPenPattern(m_pen));
+    wxString arcLine = arcPath + wxS("\"/>\n");
     write(arcLine);
 }
 
@@ -1136,9 +1407,9 @@ void wxSVGFileDCImpl::DoGradientFillLinear(const wxRect& rect,
     s += wxS("    </linearGradient>\n");
     s += wxS("  </defs>\n");
 
-    s += wxString::Format(wxS("  <rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"url(#gradient%zu)\" %s %s %s/>\n"),
+    s += wxString::Format(wxS("  <rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"url(#gradient%zu)\" %s/>\n"),
         rect.x, rect.y, rect.width, rect.height, m_gradientUniqueId,
-        GetRenderMode(m_renderingMode), GetPenPattern(m_pen), GetBrushPattern(m_brush));
+        GetBrushPattern(m_brush));
 
     m_gradientUniqueId++;
 
@@ -1175,9 +1446,9 @@ void wxSVGFileDCImpl::DoGradientFillConcentric(const wxRect& rect,
     s += wxS("    </radialGradient>\n");
     s += wxS("  </defs>\n");
 
-    s += wxString::Format(wxS("  <rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"url(#gradient%zu)\" %s %s %s/>\n"),
+    s += wxString::Format(wxS("  <rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"url(#gradient%zu)\" %s/>\n"),
         rect.x, rect.y, rect.width, rect.height, m_gradientUniqueId,
-        GetRenderMode(m_renderingMode), GetPenPattern(m_pen), GetBrushPattern(m_brush));
+        GetBrushPattern(m_brush));
 
     m_gradientUniqueId++;
 
@@ -1326,6 +1597,8 @@ void wxSVGFileDCImpl::SetBitmapHandler(wxSVGBitmapHandler* handler)
 void wxSVGFileDCImpl::SetShapeRenderingMode(wxSVGShapeRenderingMode renderingMode)
 {
     m_renderingMode = renderingMode;
+
+    m_graphics_changed = true;
 }
 
 void wxSVGFileDCImpl::SetBrush(const wxBrush& brush)
@@ -1334,12 +1607,15 @@ void wxSVGFileDCImpl::SetBrush(const wxBrush& brush)
 
     m_graphics_changed = true;
 
-    wxString pattern = CreateBrushFill(m_brush, m_renderingMode);
-    if ( !pattern.empty() )
+    // Each pattern only needs to be defined once in the document.
+    const wxString patternName = GetBrushStyleName(m_brush);
+    if ( !patternName.empty() && m_brushPatterns.insert(patternName).second )
     {
         NewGraphicsIfNeeded();
 
-        write(pattern);
+        write(wxS("<defs>\n") +
+              CreateBrushFill(m_brush, m_renderingMode) +
+              wxS("</defs>\n"));
     }
 }
 
@@ -1364,18 +1640,20 @@ void wxSVGFileDCImpl::NewGraphicsIfNeeded()
 
 void wxSVGFileDCImpl::DoStartNewGraphics()
 {
-    wxString s;
-
-    s = wxString::Format(wxS("<g style=\"%s %s %s\" transform=\"translate(%d %d) scale(%s %s)\">\n"),
-        GetPenStyle(m_pen),
-        GetBrushFill(m_brush.GetColour(), m_brush.GetStyle()),
-        GetPenStroke(m_pen.GetColour(), m_pen.GetStyle()),
-        (m_deviceOriginX - m_logicalOriginX) * m_signX,
-        (m_deviceOriginY - m_logicalOriginY) * m_signY,
-        NumStr(m_scaleX * m_signX),
-        NumStr(m_scaleY * m_signY));
-
-    write(s);
+    // The attributes common to all the elements using the current pen and
+    // brush are specified for the group only and inherited by its children.
+    *m_writer << "<g style=\""
+              << GetPenStyle(m_pen) << ' '
+              << GetBrushFill(m_brush.GetColour(), m_brush.GetStyle()) << ' '
+              << GetPenStroke(m_pen.GetColour(), m_pen.GetStyle())
+              << "\" " << GetRenderMode(m_renderingMode)
+              << ' ' << GetPenPattern(m_pen)
+              << " transform=\"translate("
+              << (m_deviceOriginX - m_logicalOriginX) * m_signX << ' '
+              << (m_deviceOriginY - m_logicalOriginY) * m_signY
+              << ") scale(" << m_scaleX * m_signX << ' ' << m_scaleY * m_signY
+              << ")\">\n";
+    m_OK = m_writer->IsOk();
 }
 
 void wxSVGFileDCImpl::SetFont(const wxFont& font)
@@ -1429,23 +1707,57 @@ void wxSVGFileDCImpl::DoDrawBitmap(const wxBitmap& bmp, wxCoord x, wxCoord y,
     if ( !m_bmp_handler )
         m_bmp_handler.reset(new wxSVGBitmapFileHandler(m_filename));
 
-    m_OK = m_outfile && m_outfile->IsOk();
+    m_OK = m_writer->IsOk();
     if (!m_OK)
         return;
 
-    m_bmp_handler->ProcessBitmap(bmp, x, y, *m_outfile);
-    m_OK = m_outfile->IsOk();
+    if ( !m_shareBitmaps )
+    {
+        m_bmp_handler->ProcessBitmap(bmp, x, y, *m_writer->GetStream());
+        m_OK = m_writer->IsOk();
+        return;
+    }
+
+    // Write every distinct bitmap only once and refer to it from all the
+    // places where it is used. Note that the bitmaps with the same hash are
+    // compared to be sure that they are really the same.
+    const wxImage image = bmp.ConvertToImage();
+    const wxUint64 hash = GetImageHash(image);
+
+    int id = wxNOT_FOUND;
+    const auto range = m_sharedBitmaps.equal_range(hash);
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+        if ( AreImagesEqual(it->second.image, image) )
+        {
+            id = it->second.id;
+            break;
+        }
+    }
+
+    if ( id == wxNOT_FOUND )
+    {
+        id = static_cast<int>(m_sharedBitmaps.size());
+
+        SharedBitmap shared;
+        shared.id = id;
+        shared.image = image;
+        m_sharedBitmaps.insert(std::make_pair(hash, shared));
+
+        *m_writer << "<defs>\n<g id=\"bitmap" << id << "\">\n";
+        m_bmp_handler->ProcessBitmap(bmp, 0, 0, *m_writer->GetStream());
+        *m_writer << "</g>\n</defs>\n";
+    }
+
+    *m_writer << "  <use xlink:href=\"#bitmap" << id
+              << "\" x=\"" << x << "\" y=\"" << y << "\"/>\n";
+    m_OK = m_writer->IsOk();
 }
 
 void wxSVGFileDCImpl::write(const wxString& s)
 {
-    m_OK = m_outfile && m_outfile->IsOk();
-    if (!m_OK)
-        return;
-
-    const wxCharBuffer buf = s.utf8_str();
-    m_outfile->Write(buf, strlen((const char*)buf));
-    m_OK = m_outfile->IsOk();
+    *m_writer << s;
+    m_OK = m_writer->IsOk();
 }
 
 #endif // wxUSE_SVG
@@ -727,6 +727,20 @@ wxGraphicsContext::DoDrawRotatedText(const wxString &str,
     Translate(-x,-y);
 }
 
+void
+wxGraphicsContext::GetMultipleTextExtents(const wxArrayString& strings,
+                                          wxArrayDouble& widths,
+                                          wxArrayDouble& heights) const
+{
+    const size_t count = strings.size();
+
+    widths.assign(count, 0.);
+    heights.assign(count, 0.);
+
+    for ( size_t i = 0; i < count; ++i )
+        GetTextExtent(strings[i], &widths[i], &heights[i], nullptr, nullptr);
+}
+
 void
 wxGraphicsContext::DoDrawFilledText(const wxString &str,
                                     wxDouble x,
@@ -0,0 +1,1466 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/graphrec.cpp
+// Purpose:     wxGraphicsRecording implementation
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#if wxUSE_GRAPHICS_CONTEXT
+
+#ifndef WX_PRECOMP
+    #include "wx/bitmap.h"
+    #include "wx/icon.h"
+    #include "wx/image.h"
+    #include "wx/region.h"
+#endif // WX_PRECOMP
+
+#include "wx/graphrec.h"
+#include "wx/private/threadpool.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// Recorded operations
+// ----------------------------------------------------------------------------
+
+enum wxGraphicsRecordingOp
+{
+    // State changing operations, which are always replayed.
+    Op_PushState,
+    Op_PopState,
+    Op_ClipRegion,
+    Op_ClipRect,
+    Op_ResetClip,
+    Op_SetAntialiasMode,
+    Op_SetInterpolationQuality,
+    Op_SetCompositionMode,
+    Op_EnableOffset,
+    Op_BeginLayer,
+    Op_EndLayer,
+    Op_Translate,
+    Op_Scale,
+    Op_Rotate,
+    Op_ConcatTransform,
+    Op_SetTransform,
+    Op_SetPen,
+    Op_SetBrush,
+    Op_SetFont,
+
+    // Drawing operations, which can be skipped if they don't intersect the
+    // region being replayed.
+    Op_StrokePath,
+    Op_FillPath,
+    Op_DrawPath,
+    Op_ClearRectangle,
+    Op_DrawGraphicsBitmap,
+    Op_DrawBitmap,
+    Op_DrawIcon,
+    Op_StrokeLine,
+    Op_StrokeLines,
+    Op_StrokeLineSegments,
+    Op_DrawLines,
+    Op_DrawRectangle,
+    Op_DrawEllipse,
+    Op_DrawRoundedRectangle,
+    Op_DrawText,
+    Op_DrawRotatedText
+};
+
+struct wxGraphicsRecordingCommand
+{
+    wxGraphicsRecordingOp op;
+
+    // Small argument of the operation, e.g. an enum value or a fill style.
+    int arg;
+
+    // Index of the object used by this operation in the array corresponding
+    // to the operation type, e.g. wxGraphicsRecordingData::m_pens for
+    // Op_SetPen, or of the first point in m_points.
+    size_t index;
+
+    // Number of points used by this operation.
+    size_t count;
+
+    // Index of the first numeric argument in m_values.
+    size_t values;
+
+    // Bounding box of the output of this command in the coordinates of the
+    // context at the recording start, only valid if hasBounds is true.
+    wxRect2DDouble bounds;
+    bool hasBounds;
+};
+
+// Helper converting wxGraphicsMatrix to wxAffineMatrix2D.
+wxAffineMatrix2D ToAffine(const wxGraphicsMatrix& matrix)
+{
+    wxDouble a, b, c, d, tx, ty;
+    matrix.Get(&a, &b, &c, &d, &tx, &ty);
+
+    wxAffineMatrix2D affine;
+    affine.Set(wxMatrix2D(a, b, c, d), wxPoint2DDouble(tx, ty));
+    return affine;
+}
+
+// Return the bounding box of the rectangle transformed by the matrix.
+wxRect2DDouble
+TransformRect(const wxAffineMatrix2D& matrix, const wxRect2DDouble& rect)
+{
+    const wxPoint2DDouble corners[] =
+    {
+        matrix.TransformPoint(rect.GetLeftTop()),
+        matrix.TransformPoint(rect.GetRightTop()),
+        matrix.TransformPoint(rect.GetRightBottom()),
+        matrix.TransformPoint(rect.GetLeftBottom()),
+    };
+
+    wxDouble x1 = corners[0].m_x,
+             y1 = corners[0].m_y,
+             x2 = x1,
+             y2 = y1;
+    for ( size_t n = 1; n < WXSIZEOF(corners); n++ )
+    {
+        x1 = wxMin(x1, corners[n].m_x);
+        y1 = wxMin(y1, corners[n].m_y);
+        x2 = wxMax(x2, corners[n].m_x);
+        y2 = wxMax(y2, corners[n].m_y);
+    }
+
+    return wxRect2DDouble(x1, y1, x2 - x1, y2 - y1);
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxGraphicsRecordingData: the display list itself
+// ----------------------------------------------------------------------------
+
+class wxGraphicsRecordingData : public wxRefCounter
+{
+public:
+    wxGraphicsRecordingData() : m_renderer(nullptr) { }
+
+    void Clear()
+    {
+        m_commands.clear();
+        m_values.clear();
+        m_points.clear();
+        m_strings.clear();
+        m_pens.clear();
+        m_brushes.clear();
+        m_fonts.clear();
+        m_paths.clear();
+        m_graphicsBitmaps.clear();
+        m_bitmaps.clear();
+        m_icons.clear();
+        m_regions.clear();
+    }
+
+    // Add a new command and return it to allow filling in its fields.
+    wxGraphicsRecordingCommand& AddCommand(wxGraphicsRecordingOp op, int arg = 0)
+    {
+        wxGraphicsRecordingCommand cmd;
+        cmd.op = op;
+        cmd.arg = arg;
+        cmd.index = 0;
+        cmd.count = 0;
+        cmd.values = m_values.size();
+        cmd.hasBounds = false;
+
+        m_commands.push_back(cmd);
+
+        return m_commands.back();
+    }
+
+    void AddValues(wxDouble v1)
+    {
+        m_values.push_back(v1);
+    }
+
+    void AddValues(wxDouble v1, wxDouble v2)
+    {
+        m_values.push_back(v1);
+        m_values.push_back(v2);
+    }
+
+    void AddValues(wxDouble v1, wxDouble v2, wxDouble v3, wxDouble v4)
+    {
+        AddValues(v1, v2);
+        AddValues(v3, v4);
+    }
+
+    void AddMatrix(const wxAffineMatrix2D& matrix)
+    {
+        wxMatrix2D mat;
+        wxPoint2DDouble tr;
+        matrix.Get(&mat, &tr);
+
+        AddValues(mat.m_11, mat.m_12, mat.m_21, mat.m_22);
+        AddValues(tr.m_x, tr.m_y);
+    }
+
+    wxAffineMatrix2D GetMatrix(size_t values) const
+    {
+        const wxDouble* const v = &m_values[values];
+
+        wxAffineMatrix2D matrix;
+        matrix.Set(wxMatrix2D(v[0], v[1], v[2], v[3]), wxPoint2DDouble(v[4], v[5]));
+        return matrix;
+    }
+
+    // Add the object to the given array, reusing the last element if it's the
+    // same, and return its index.
+    template <typename T>
+    static size_t AddObject(wxVector<T>& objects, const T& obj)
+    {
+        if ( objects.empty() || !objects.back().IsSameAs(obj) )
+            objects.push_back(obj);
+
+        return objects.size() - 1;
+    }
+
+    void Replay(wxGraphicsContext* gc,
+                const wxRegion* region,
+                const wxAffineMatrix2D& transform) const;
+
+    wxGraphicsRenderer* m_renderer;
+
+    wxVector<wxGraphicsRecordingCommand> m_commands;
+
+    // Arguments of the commands.
+    wxVector<wxDouble> m_values;
+    wxVector<wxPoint2DDouble> m_points;
+    wxVector<wxString> m_strings;
+    wxVector<wxGraphicsPen> m_pens;
+    wxVector<wxGraphicsBrush> m_brushes;
+    wxVector<wxGraphicsFont> m_fonts;
+    wxVector<wxGraphicsPath> m_paths;
+    wxVector<wxGraphicsBitmap> m_graphicsBitmaps;
+    wxVector<wxBitmap> m_bitmaps;
+    wxVector<wxIcon> m_icons;
+    wxVector<wxRegion> m_regions;
+
+    wxDECLARE_NO_COPY_CLASS(wxGraphicsRecordingData);
+};
+
+void wxGraphicsRecordingData::Replay(wxGraphicsContext* gc,
+                                     const wxRegion* region,
+                                     const wxAffineMatrix2D& transform) const
+{
+    wxCHECK_RET( gc, wxS("must have a valid context") );
+
+    if ( m_commands.empty() )
+        return;
+
+    wxCHECK_RET( gc->GetRenderer() == m_renderer,
+                 wxS("recording can only be replayed on the contexts using the same renderer") );
+
+    const wxAntialiasMode antialias = gc->GetAntialiasMode();
+    const wxInterpolationQuality interpolation = gc->GetInterpolationQuality();
+    const wxCompositionMode composition = gc->GetCompositionMode();
+
+    // Remember the clipping box of the context in order to restore it if the
+    // recording resets clipping: it must not affect the clipping region set
+    // by the caller. Note that we can only restore it as a rectangle, which
+    // is exact in the common case of the caller clipping to a rectangle and
+    // only larger than the original region otherwise.
+    wxDouble clipX, clipY, clipW, clipH;
+    gc->GetClipBox(&clipX, &clipY, &clipW, &clipH);
+
+    gc->PushState();
+
+    const wxAffineMatrix2D base = ToAffine(gc->GetTransform());
+
+    // Find the rectangle to which the output is restricted in the recording
+    // coordinates: this is what allows to skip the commands outside of it.
+    wxRect2DDouble clipRect;
+    if ( region )
+    {
+        gc->Clip(*region);
+
+        const wxRect box = region->GetBox();
+        clipRect = wxRect2DDouble(box.x, box.y, box.width, box.height);
+    }
+
+    // Transformation from the recording coordinates to those of the context.
+    wxAffineMatrix2D origin = base;
+    origin.Concat(transform);
+
+    if ( !transform.IsIdentity() )
+        gc->SetTransform(gc->CreateMatrix(origin));
+
+    // Number of PushState() and BeginLayer() calls without the matching
+    // PopState() and EndLayer() ones: we must not pop the state we pushed
+    // ourselves above if the recording is unbalanced.
+    int states = 0,
+        layers = 0;
+
+    for ( size_t n = 0; n < m_commands.size(); n++ )
+    {
+        const wxGraphicsRecordingCommand& cmd = m_commands[n];
+
+        if ( region && cmd.hasBounds )
+        {
+            const wxRect2DDouble r = TransformRect(transform, cmd.bounds);
+            if ( !r.Intersects(clipRect) )
+                continue;
+
+            // The region may be complex, check it more precisely.
+            const wxPoint topLeft(int(floor(r.m_x)), int(floor(r.m_y)));
+            const wxPoint bottomRight(int(ceil(r.GetRight())),
+                                      int(ceil(r.GetBottom())));
+            if ( region->Contains(wxRect(topLeft, bottomRight)) == wxOutRegion )
+                continue;
+        }
+
+        const wxDouble* const v = m_values.empty() ? nullptr
+                                                   : &m_values[0] + cmd.values;
+
+        switch ( cmd.op )
+        {
+            case Op_PushState:
+                gc->PushState();
+                states++;
+                break;
+
+            case Op_PopState:
+                if ( states )
+                {
+                    gc->PopState();
+                    states--;
+                }
+                break;
+
+            case Op_ClipRegion:
+                gc->Clip(m_regions[cmd.index]);
+                break;
+
+            case Op_ClipRect:
+                gc->Clip(v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_ResetClip:
+                {
+                    gc->ResetClip();
+
+                    // Restore the clipping in effect when the replay started,
+                    // including our own region, which must be done in the
+                    // original coordinates in which they are expressed.
+                    const wxGraphicsMatrix current = gc->GetTransform();
+                    gc->SetTransform(gc->CreateMatrix(base));
+                    gc->Clip(clipX, clipY, clipW, clipH);
+                    if ( region )
+                        gc->Clip(*region);
+                    gc->SetTransform(current);
+                }
+                break;
+
+            case Op_SetAntialiasMode:
+                gc->SetAntialiasMode(static_cast<wxAntialiasMode>(cmd.arg));
+                break;
+
+            case Op_SetInterpolationQuality:
+                gc->SetInterpolationQuality(static_cast<wxInterpolationQuality>(cmd.arg));
+                break;
+
+            case Op_SetCompositionMode:
+                gc->SetCompositionMode(static_cast<wxCompositionMode>(cmd.arg));
+                break;
+
+            case Op_EnableOffset:
+                gc->EnableOffset(cmd.arg != 0);
+                break;
+
+            case Op_BeginLayer:
+                gc->BeginLayer(v[0]);
+                layers++;
+                break;
+
+            case Op_EndLayer:
+                if ( layers )
+                {
+                    gc->EndLayer();
+                    layers--;
+                }
+                break;
+
+            case Op_Translate:
+                gc->Translate(v[0], v[1]);
+                break;
+
+            case Op_Scale:
+                gc->Scale(v[0], v[1]);
+                break;
+
+            case Op_Rotate:
+                gc->Rotate(v[0]);
+                break;
+
+            case Op_ConcatTransform:
+                gc->ConcatTransform(gc->CreateMatrix(GetMatrix(cmd.values)));
+                break;
+
+            case Op_SetTransform:
+                {
+                    // The transformation is relative to the recording origin.
+                    wxAffineMatrix2D matrix = origin;
+                    matrix.Concat(GetMatrix(cmd.values));
+                    gc->SetTransform(gc->CreateMatrix(matrix));
+                }
+                break;
+
+            case Op_SetPen:
+                gc->SetPen(m_pens[cmd.index]);
+                break;
+
+            case Op_SetBrush:
+                gc->SetBrush(m_brushes[cmd.index]);
+                break;
+
+            case Op_SetFont:
+                gc->SetFont(m_fonts[cmd.index]);
+                break;
+
+            case Op_StrokePath:
+                gc->StrokePath(m_paths[cmd.index]);
+                break;
+
+            case Op_FillPath:
+                gc->FillPath(m_paths[cmd.index],
+                             static_cast<wxPolygonFillMode>(cmd.arg));
+                break;
+
+            case Op_DrawPath:
+                gc->DrawPath(m_paths[cmd.index],
+                             static_cast<wxPolygonFillMode>(cmd.arg));
+                break;
+
+            case Op_ClearRectangle:
+                gc->ClearRectangle(v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_DrawGraphicsBitmap:
+                gc->DrawBitmap(m_graphicsBitmaps[cmd.index], v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_DrawBitmap:
+                gc->DrawBitmap(m_bitmaps[cmd.index], v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_DrawIcon:
+                gc->DrawIcon(m_icons[cmd.index], v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_StrokeLine:
+                gc->StrokeLine(v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_StrokeLines:
+                gc->StrokeLines(cmd.count, &m_points[cmd.index]);
+                break;
+
+            case Op_StrokeLineSegments:
+                gc->StrokeLines(cmd.count,
+                                &m_points[cmd.index],
+                                &m_points[cmd.index + cmd.count]);
+                break;
+
+            case Op_DrawLines:
+                gc->DrawLines(cmd.count, &m_points[cmd.index],
+                              static_cast<wxPolygonFillMode>(cmd.arg));
+                break;
+
+            case Op_DrawRectangle:
+                gc->DrawRectangle(v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_DrawEllipse:
+                gc->DrawEllipse(v[0], v[1], v[2], v[3]);
+                break;
+
+            case Op_DrawRoundedRectangle:
+                gc->DrawRoundedRectangle(v[0], v[1], v[2], v[3], v[4]);
+                break;
+
+            case Op_DrawText:
+                gc->DrawText(m_strings[cmd.index], v[0], v[1]);
+                break;
+
+            case Op_DrawRotatedText:
+                gc->DrawText(m_strings[cmd.index], v[0], v[1], v[2]);
+                break;
+        }
+    }
+
+    while ( layers-- )
+        gc->EndLayer();
+
+    while ( states-- )
+        gc->PopState();
+
+    gc->PopState();
+
+    gc->SetAntialiasMode(antialias);
+    gc->SetInterpolationQuality(interpolation);
+    gc->SetCompositionMode(composition);
+}
+
+// ----------------------------------------------------------------------------
+// wxGraphicsRecordingContext: context adding commands to the recording
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+class wxGraphicsRecordingContext : public wxGraphicsContext
+{
+public:
+    // If isolated is true, the recording doesn't share any objects with the
+    // caller, which allows replaying it in another thread.
+    wxGraphicsRecordingContext(wxGraphicsRenderer* renderer,
+                               wxGraphicsRecordingData* data,
+                               wxDouble width,
+                               wxDouble height,
+                               bool isolated = false)
+        : wxGraphicsContext(renderer),
+          m_data(data),
+          m_isolated(isolated),
+          m_penExtent(0)
+    {
+        m_data->IncRef();
+
+        m_width = width;
+        m_height = height;
+    }
+
+    virtual ~wxGraphicsRecordingContext()
+    {
+        m_data->DecRef();
+    }
+
+    virtual void PushState() override
+    {
+        m_data->AddCommand(Op_PushState);
+
+        m_stateStack.push_back(m_transform);
+    }
+
+    virtual void PopState() override
+    {
+        wxCHECK_RET( !m_stateStack.empty(), wxS("unbalanced PopState()") );
+
+        m_data->AddCommand(Op_PopState);
+
+        m_transform = m_stateStack.back();
+        m_stateStack.pop_back();
+    }
+
+    virtual void Clip(const wxRegion& region) override
+    {
+        if ( m_isolated )
+        {
+            // Copying the region would share its data, so create a new one.
+            wxRegion copy;
+            for ( wxRegionIterator it(region); it; ++it )
+                copy.Union(it.GetRect());
+
+            m_data->AddCommand(Op_ClipRegion).index =
+                wxGraphicsRecordingData::AddObject(m_data->m_regions, copy);
+            return;
+        }
+
+        m_data->AddCommand(Op_ClipRegion).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_regions, region);
+    }
+
+    virtual void Clip(wxDouble x, wxDouble y, wxDouble w, wxDouble h) override
+    {
+        m_data->AddCommand(Op_ClipRect);
+        m_data->AddValues(x, y, w, h);
+    }
+
+    virtual void ResetClip() override
+    {
+        m_data->AddCommand(Op_ResetClip);
+    }
+
+    virtual void GetClipBox(wxDouble* x, wxDouble* y,
+                            wxDouble* w, wxDouble* h) override
+    {
+        // We don't keep track of the clipping region, so just return the
+        // entire area, which is unbounded if its size is unknown: this is
+        // important for replaying other recordings on this context, which
+        // restore the clipping box after resetting the clipping.
+        const wxDouble UNBOUNDED = 1e9;
+
+        if ( x )
+            *x = m_width > 0 ? 0 : -UNBOUNDED;
+        if ( y )
+            *y = m_height > 0 ? 0 : -UNBOUNDED;
+        if ( w )
+            *w = m_width > 0 ? m_width : 2*UNBOUNDED;
+        if ( h )
+            *h = m_height > 0 ? m_height : 2*UNBOUNDED;
+    }
+
+    virtual void* GetNativeContext() override
+    {
+        return nullptr;
+    }
+
+    virtual bool SetAntialiasMode(wxAntialiasMode antialias) override
+    {
+        m_data->AddCommand(Op_SetAntialiasMode, antialias);
+        m_antialias = antialias;
+        return true;
+    }
+
+    virtual bool
+    SetInterpolationQuality(wxInterpolationQuality interpolation) override
+    {
+        m_data->AddCommand(Op_SetInterpolationQuality, interpolation);
+        m_interpolation = interpolation;
+        return true;
+    }
+
+    virtual bool SetCompositionMode(wxCompositionMode op) override
+    {
+        m_data->AddCommand(Op_SetCompositionMode, op);
+        m_composition = op;
+        return true;
+    }
+
+    virtual void EnableOffset(bool enable) override
+    {
+        m_data->AddCommand(Op_EnableOffset, enable);
+        wxGraphicsContext::EnableOffset(enable);
+    }
+
+    virtual void BeginLayer(wxDouble opacity) override
+    {
+        m_data->AddCommand(Op_BeginLayer);
+        m_data->AddValues(opacity);
+    }
+
+    virtual void EndLayer() override
+    {
+        m_data->AddCommand(Op_EndLayer);
+    }
+
+    virtual void Translate(wxDouble dx, wxDouble dy) override
+    {
+        m_data->AddCommand(Op_Translate);
+        m_data->AddValues(dx, dy);
+
+        m_transform.Translate(dx, dy);
+    }
+
+    virtual void Scale(wxDouble xScale, wxDouble yScale) override
+    {
+        m_data->AddCommand(Op_Scale);
+        m_data->AddValues(xScale, yScale);
+
+        m_transform.Scale(xScale, yScale);
+    }
+
+    virtual void Rotate(wxDouble angle) override
+    {
+        m_data->AddCommand(Op_Rotate);
+        m_data->AddValues(angle);
+
+        m_transform.Rotate(angle);
+    }
+
+    virtual void ConcatTransform(const wxGraphicsMatrix& matrix) override
+    {
+        const wxAffineMatrix2D affine = ToAffine(matrix);
+
+        m_data->AddCommand(Op_ConcatTransform);
+        m_data->AddMatrix(affine);
+
+        m_transform.Concat(affine);
+    }
+
+    virtual void SetTransform(const wxGraphicsMatrix& matrix) override
+    {
+        const wxAffineMatrix2D affine = ToAffine(matrix);
+
+        m_data->AddCommand(Op_SetTransform);
+        m_data->AddMatrix(affine);
+
+        m_transform = affine;
+    }
+
+    virtual wxGraphicsMatrix GetTransform() const override
+    {
+        return CreateMatrix(m_transform);
+    }
+
+    virtual void SetPen(const wxGraphicsPen& pen) override
+    {
+        m_data->AddCommand(Op_SetPen).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_pens, pen);
+
+        wxGraphicsContext::SetPen(pen);
+
+        if ( pen.IsNull() )
+        {
+            m_penExtent = 0;
+        }
+        else
+        {
+            const auto it = m_penExtents.find(pen.GetRefData());
+            m_penExtent = it != m_penExtents.end() ? it->second.extent : -1;
+        }
+    }
+
+    virtual void SetBrush(const wxGraphicsBrush& brush) override
+    {
+        m_data->AddCommand(Op_SetBrush).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_brushes, brush);
+
+        wxGraphicsContext::SetBrush(brush);
+    }
+
+    virtual void SetFont(const wxGraphicsFont& font) override
+    {
+        m_data->AddCommand(Op_SetFont).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_fonts, font);
+
+        wxGraphicsContext::SetFont(font);
+    }
+
+    virtual void StrokePath(const wxGraphicsPath& path) override
+    {
+        AddPathCommand(Op_StrokePath, path, wxODDEVEN_RULE, true);
+    }
+
+    virtual void FillPath(const wxGraphicsPath& path,
+                          wxPolygonFillMode fillStyle) override
+    {
+        AddPathCommand(Op_FillPath, path, fillStyle, false);
+    }
+
+    virtual void DrawPath(const wxGraphicsPath& path,
+                          wxPolygonFillMode fillStyle) override
+    {
+        AddPathCommand(Op_DrawPath, path, fillStyle, true);
+    }
+
+    virtual void ClearRectangle(wxDouble x, wxDouble y,
+                                wxDouble w, wxDouble h) override
+    {
+        AddRectCommand(Op_ClearRectangle, x, y, w, h, false);
+    }
+
+    virtual void GetTextExtent(const wxString& text,
+                               wxDouble* width, wxDouble* height,
+                               wxDouble* descent,
+                               wxDouble* externalLeading) const override
+    {
+        if ( !PrepareMeasuring() )
+        {
+            if ( width )
+                *width = 0;
+            if ( height )
+                *height = 0;
+            if ( descent )
+                *descent = 0;
+            if ( externalLeading )
+                *externalLeading = 0;
+            return;
+        }
+
+        m_measuringContext->GetTextExtent(text, width, height,
+                                          descent, externalLeading);
+    }
+
+    virtual void GetPartialTextExtents(const wxString& text,
+                                       wxArrayDouble& widths) const override
+    {
+        widths.clear();
+
+        if ( PrepareMeasuring() )
+            m_measuringContext->GetPartialTextExtents(text, widths);
+    }
+
+    virtual void GetMultipleTextExtents(const wxArrayString& strings,
+                                        wxArrayDouble& widths,
+                                        wxArrayDouble& heights) const override
+    {
+        if ( PrepareMeasuring() )
+        {
+            m_measuringContext->GetMultipleTextExtents(strings, widths, heights);
+        }
+        else
+        {
+            widths.assign(strings.size(), 0.);
+            heights.assign(strings.size(), 0.);
+        }
+    }
+
+    virtual void DrawBitmap(const wxGraphicsBitmap& bmp,
+                            wxDouble x, wxDouble y,
+                            wxDouble w, wxDouble h) override
+    {
+        AddRectCommand(Op_DrawGraphicsBitmap, x, y, w, h, false).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_graphicsBitmaps, bmp);
+    }
+
+    virtual void DrawBitmap(const wxBitmap& bmp,
+                            wxDouble x, wxDouble y,
+                            wxDouble w, wxDouble h) override
+    {
+        // wxBitmap can't be used from the other threads, but the graphics
+        // bitmap created from it here, in this thread, can be.
+        if ( m_isolated )
+        {
+            DrawBitmap(CreateBitmap(bmp), x, y, w, h);
+            return;
+        }
+
+        AddRectCommand(Op_DrawBitmap, x, y, w, h, false).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_bitmaps, bmp);
+    }
+
+    virtual void DrawIcon(const wxIcon& icon,
+                          wxDouble x, wxDouble y,
+                          wxDouble w, wxDouble h) override
+    {
+        if ( m_isolated )
+        {
+            wxBitmap bmp;
+            if ( bmp.CopyFromIcon(icon) )
+                DrawBitmap(CreateBitmap(bmp), x, y, w, h);
+            return;
+        }
+
+        AddRectCommand(Op_DrawIcon, x, y, w, h, false).index =
+            wxGraphicsRecordingData::AddObject(m_data->m_icons, icon);
+    }
+
+    virtual void StrokeLine(wxDouble x1, wxDouble y1,
+                            wxDouble x2, wxDouble y2) override
+    {
+        if ( m_pen.IsNull() )
+            return;
+
+        wxGraphicsRecordingCommand& cmd = m_data->AddCommand(Op_StrokeLine);
+        m_data->AddValues(x1, y1, x2, y2);
+
+        SetBounds(cmd, wxRect2DDouble(wxMin(x1, x2), wxMin(y1, y2),
+                                      fabs(x2 - x1), fabs(y2 - y1)),
+                  true);
+    }
+
+    virtual void StrokeLines(size_t n, const wxPoint2DDouble* points) override
+    {
+        wxCHECK_RET( n > 1, wxS("need at least two points") );
+
+        if ( m_pen.IsNull() )
+            return;
+
+        SetBounds(AddPointsCommand(Op_StrokeLines, n, points), true);
+    }
+
+    virtual void StrokeLines(size_t n,
+                             const wxPoint2DDouble* beginPoints,
+                             const wxPoint2DDouble* endPoints) override
+    {
+        wxCHECK_RET( n > 0, wxS("need at least one line") );
+
+        if ( m_pen.IsNull() )
+            return;
+
+        wxGraphicsRecordingCommand&
+            cmd = AddPointsCommand(Op_StrokeLineSegments, n, beginPoints);
+        m_data->m_points.insert(m_data->m_points.end(),
+                                endPoints, endPoints + n);
+
+        SetBounds(cmd, true);
+    }
+
+    virtual void DrawLines(size_t n, const wxPoint2DDouble* points,
+                           wxPolygonFillMode fillStyle) override
+    {
+        wxCHECK_RET( n > 1, wxS("need at least two points") );
+
+        wxGraphicsRecordingCommand&
+            cmd = AddPointsCommand(Op_DrawLines, n, points);
+        cmd.arg = fillStyle;
+
+        SetBounds(cmd, true);
+    }
+
+    virtual void DrawRectangle(wxDouble x, wxDouble y,
+                               wxDouble w, wxDouble h) override
+    {
+        AddRectCommand(Op_DrawRectangle, x, y, w, h, true);
+    }
+
+    virtual void DrawEllipse(wxDouble x, wxDouble y,
+                             wxDouble w, wxDouble h) override
+    {
+        AddRectCommand(Op_DrawEllipse, x, y, w, h, true);
+    }
+
+    virtual void DrawRoundedRectangle(wxDouble x, wxDouble y,
+                                      wxDouble w, wxDouble h,
+                                      wxDouble radius) override
+    {
+        AddRectCommand(Op_DrawRoundedRectangle, x, y, w, h, true);
+        m_data->AddValues(radius);
+    }
+
+    virtual void Flush() override
+    {
+    }
+
+#ifdef __WXMSW__
+    virtual WXHDC GetNativeHDC() override
+    {
+        return nullptr;
+    }
+
+    virtual void ReleaseNativeHDC(WXHDC WXUNUSED(hdc)) override
+    {
+    }
+#endif // __WXMSW__
+
+protected:
+    virtual wxGraphicsPen DoCreatePen(const wxGraphicsPenInfo& info) const override
+    {
+        const wxGraphicsPen pen = wxGraphicsContext::DoCreatePen(info);
+
+        // Remember how far the pen can extend beyond the path, this is needed
+        // to compute the bounding box of the stroked paths. Note that the
+        // miter joins may be as long as 10 times the half of the pen width
+        // with the default miter limit used by all renderers, and the corners
+        // of projecting caps of diagonal lines extend by half of the diagonal
+        // of the square with the side equal to the pen width.
+        const wxDouble halfWidth = info.GetWidth() / 2;
+
+        wxDouble extent = halfWidth;
+        if ( info.GetJoin() == wxJOIN_MITER )
+            extent = 10*halfWidth;
+        else if ( info.GetCap() == wxCAP_PROJECTING )
+            extent = sqrt(2.0)*halfWidth;
+
+        PenExtent& penExtent = m_penExtents[pen.GetRefData()];
+        penExtent.pen = pen;
+        penExtent.extent = extent;
+
+        return pen;
+    }
+
+    virtual void DoDrawText(const wxString& str, wxDouble x, wxDouble y) override
+    {
+        wxGraphicsRecordingCommand& cmd = m_data->AddCommand(Op_DrawText);
+        cmd.index = m_data->m_strings.size();
+        m_data->m_strings.push_back(str);
+        m_data->AddValues(x, y);
+
+        wxDouble w, h;
+        if ( GetTextBox(str, &w, &h) )
+            SetBounds(cmd, wxRect2DDouble(x, y, w, h), false);
+    }
+
+    virtual void DoDrawRotatedText(const wxString& str,
+                                   wxDouble x, wxDouble y,
+                                   wxDouble angle) override
+    {
+        wxGraphicsRecordingCommand& cmd = m_data->AddCommand(Op_DrawRotatedText);
+        cmd.index = m_data->m_strings.size();
+        m_data->m_strings.push_back(str);
+        m_data->AddValues(x, y);
+        m_data->AddValues(angle);
+
+        wxDouble w, h;
+        if ( GetTextBox(str, &w, &h) )
+        {
+            // This is the same transformation as used by the default
+            // wxGraphicsContext::DoDrawRotatedText() implementation.
+            wxAffineMatrix2D rotation;
+            rotation.Translate(x, y);
+            rotation.Rotate(-angle);
+
+            SetBounds(cmd,
+                      TransformRect(rotation, wxRect2DDouble(0, 0, w, h)),
+                      false);
+        }
+    }
+
+private:
+    struct PenExtent
+    {
+        // This is only stored to prevent the pen data from being reused.
+        wxGraphicsPen pen;
+        wxDouble extent;
+    };
+
+    wxGraphicsRecordingCommand&
+    AddPathCommand(wxGraphicsRecordingOp op,
+                   const wxGraphicsPath& path,
+                   wxPolygonFillMode fillStyle,
+                   bool stroke)
+    {
+        wxGraphicsRecordingCommand& cmd = m_data->AddCommand(op, fillStyle);
+        cmd.index = wxGraphicsRecordingData::AddObject(m_data->m_paths, path);
+
+        SetBounds(cmd, path.GetBox(), stroke);
+
+        return cmd;
+    }
+
+    wxGraphicsRecordingCommand&
+    AddRectCommand(wxGraphicsRecordingOp op,
+                   wxDouble x, wxDouble y, wxDouble w, wxDouble h,
+                   bool stroke)
+    {
+        wxGraphicsRecordingCommand& cmd = m_data->AddCommand(op);
+        m_data->AddValues(x, y, w, h);
+
+        // Normalize the rectangle as negative sizes are allowed here.
+        if ( w < 0 )
+        {
+            x += w;
+            w = -w;
+        }
+        if ( h < 0 )
+        {
+            y += h;
+            h = -h;
+        }
+
+        SetBounds(cmd, wxRect2DDouble(x, y, w, h), stroke);
+
+        return cmd;
+    }
+
+    wxGraphicsRecordingCommand&
+    AddPointsCommand(wxGraphicsRecordingOp op,
+                     size_t n, const wxPoint2DDouble* points)
+    {
+        wxGraphicsRecordingCommand& cmd = m_data->AddCommand(op);
+        cmd.index = m_data->m_points.size();
+        cmd.count = n;
+
+        m_data->m_points.insert(m_data->m_points.end(), points, points + n);
+
+        return cmd;
+    }
+
+    // Set the bounds of the command using all its points.
+    void SetBounds(wxGraphicsRecordingCommand& cmd, bool stroke)
+    {
+        const wxPoint2DDouble* const
+            points = &m_data->m_points[cmd.index];
+        const size_t count = cmd.op == Op_StrokeLineSegments ? 2*cmd.count
+                                                             : cmd.count;
+
+        wxDouble x1 = points[0].m_x,
+                 y1 = points[0].m_y,
+                 x2 = x1,
+                 y2 = y1;
+        for ( size_t n = 1; n < count; n++ )
+        {
+            x1 = wxMin(x1, points[n].m_x);
+            y1 = wxMin(y1, points[n].m_y);
+            x2 = wxMax(x2, points[n].m_x);
+            y2 = wxMax(y2, points[n].m_y);
+        }
+
+        SetBounds(cmd, wxRect2DDouble(x1, y1, x2 - x1, y2 - y1), stroke);
+    }
+
+    // Set the bounds of the command to the given rectangle in the current
+    // coordinates, extending it by the pen width if the command strokes.
+    void SetBounds(wxGraphicsRecordingCommand& cmd,
+                   wxRect2DDouble rect,
+                   bool stroke)
+    {
+        if ( stroke && !m_pen.IsNull() )
+        {
+            // We don't know how wide this pen is.
+            if ( m_penExtent < 0 )
+                return;
+
+            rect.Inset(-m_penExtent, -m_penExtent);
+        }
+
+        cmd.bounds = TransformRect(m_transform, rect);
+
+        // Account for anti-aliasing and pixel offsetting.
+        cmd.bounds.Inset(-1, -1);
+
+        cmd.hasBounds = true;
+    }
+
+    bool PrepareMeasuring() const
+    {
+        if ( m_font.IsNull() )
+            return false;
+
+        if ( !m_measuringContext )
+        {
+            m_measuringContext.reset(GetRenderer()->CreateMeasuringContext());
+            if ( !m_measuringContext )
+                return false;
+        }
+
+        m_measuringContext->SetFont(m_font);
+
+        return true;
+    }
+
+    bool GetTextBox(const wxString& str, wxDouble* w, wxDouble* h)
+    {
+        if ( !PrepareMeasuring() )
+            return false;
+
+        m_measuringContext->GetTextExtent(str, w, h, nullptr, nullptr);
+
+        return true;
+    }
+
+
+    wxGraphicsRecordingData* const m_data;
+
+    const bool m_isolated;
+
+    // Current transformation and the saved ones.
+    wxAffineMatrix2D m_transform;
+    wxVector<wxAffineMatrix2D> m_stateStack;
+
+    // Extents of the pens created by this context, indexed by their data.
+    mutable std::unordered_map<const wxObjectRefData*, PenExtent> m_penExtents;
+
+    // Extent of the current pen or -1 if unknown.
+    wxDouble m_penExtent;
+
+    // Used for measuring text, created on demand.
+    mutable std::unique_ptr<wxGraphicsContext> m_measuringContext;
+
+    wxDECLARE_NO_COPY_CLASS(wxGraphicsRecordingContext);
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// wxGraphicsRecording implementation
+// ============================================================================
+
+wxGraphicsRecording::wxGraphicsRecording()
+    : m_data(new wxGraphicsRecordingData())
+{
+}
+
+wxGraphicsRecording::wxGraphicsRecording(const wxGraphicsRecording& other)
+    : m_data(other.m_data)
+{
+}
+
+wxGraphicsRecording&
+wxGraphicsRecording::operator=(const wxGraphicsRecording& other)
+{
+    m_data = other.m_data;
+    return *this;
+}
+
+wxGraphicsRecording::~wxGraphicsRecording()
+{
+}
+
+wxGraphicsContext*
+wxGraphicsRecording::CreateContext(wxDouble width,
+                                   wxDouble height,
+                                   wxGraphicsRenderer* renderer)
+{
+    return DoCreateContext(width, height, renderer, false);
+}
+
+wxGraphicsContext*
+wxGraphicsRecording::DoCreateContext(wxDouble width,
+                                     wxDouble height,
+                                     wxGraphicsRenderer* renderer,
+                                     bool isolated)
+{
+    if ( !renderer )
+        renderer = wxGraphicsRenderer::GetDefaultRenderer();
+
+    wxCHECK_MSG( renderer, nullptr, wxS("no graphics renderer available") );
+
+    wxCHECK_MSG( !m_data->m_renderer || m_data->m_renderer == renderer,
+                 nullptr,
+                 wxS("all contexts must use the same renderer") );
+
+    m_data->m_renderer = renderer;
+
+    return new wxGraphicsRecordingContext(renderer, m_data.get(),
+                                          width, height, isolated);
+}
+
+wxGraphicsRenderer* wxGraphicsRecording::GetRenderer() const
+{
+    return m_data->m_renderer;
+}
+
+size_t wxGraphicsRecording::GetCommandCount() const
+{
+    return m_data->m_commands.size();
+}
+
+wxRect2DDouble wxGraphicsRecording::GetBoundingBox() const
+{
+    wxRect2DDouble box;
+    bool first = true;
+
+    const wxVector<wxGraphicsRecordingCommand>& commands = m_data->m_commands;
+    for ( size_t n = 0; n < commands.size(); n++ )
+    {
+        const wxGraphicsRecordingCommand& cmd = commands[n];
+        if ( !cmd.hasBounds )
+            continue;
+
+        if ( first )
+        {
+            box = cmd.bounds;
+            first = false;
+        }
+        else
+        {
+            box.Union(cmd.bounds);
+        }
+    }
+
+    return box;
+}
+
+void wxGraphicsRecording::Clear()
+{
+    m_data->Clear();
+}
+
+void wxGraphicsRecording::Replay(wxGraphicsContext* gc) const
+{
+    m_data->Replay(gc, nullptr, wxAffineMatrix2D());
+}
+
+void wxGraphicsRecording::Replay(wxGraphicsContext* gc,
+                                 const wxAffineMatrix2D& transform) const
+{
+    m_data->Replay(gc, nullptr, transform);
+}
+
+void wxGraphicsRecording::Replay(wxGraphicsContext* gc,
+                                 const wxRegion& region,
+                                 const wxAffineMatrix2D& transform) const
+{
+    m_data->Replay(gc, &region, transform);
+}
+
+// ============================================================================
+// wxGraphicsTiledImageRenderer implementation
+// ============================================================================
+
+wxGraphicsTiledImageRenderer::wxGraphicsTiledImageRenderer(const wxSize& size,
+                                                           wxGraphicsRenderer* renderer)
+    : m_size(size),
+      m_renderer(renderer ? renderer
+                          : wxGraphicsRenderer::GetDefaultRenderer()),
+      m_tileSize(256, 256),
+      m_maxThreads(0),
+      m_backgroundColour(*wxWHITE)
+{
+}
+
+void wxGraphicsTiledImageRenderer::SetTileSize(const wxSize& tileSize)
+{
+    wxCHECK_RET( tileSize.x > 0 && tileSize.y > 0, "invalid tile size" );
+
+    m_tileSize = tileSize;
+}
+
+void wxGraphicsTiledImageRenderer::SetMaxThreads(int maxThreads)
+{
+    wxCHECK_RET( maxThreads >= 0, "invalid number of threads" );
+
+    m_maxThreads = maxThreads;
+}
+
+void wxGraphicsTiledImageRenderer::SetBackgroundColour(const wxColour& colour)
+{
+    m_backgroundColour = colour;
+}
+
+bool
+wxGraphicsTiledImageRenderer::Render(const DrawFunction& draw,
+                                     const TileFunction& onTile) const
+{
+    wxCHECK_MSG( m_renderer, false, "no graphics renderer" );
+    wxCHECK_MSG( m_size.x > 0 && m_size.y > 0, false, "invalid image size" );
+
+    const int tilesPerRow = (m_size.x + m_tileSize.x - 1) / m_tileSize.x;
+    const int tileRows = (m_size.y + m_tileSize.y - 1) / m_tileSize.y;
+
+    // Only Cairo graphics objects can be used from the worker threads, so
+    // don't use them with the other renderers, whose thread safety is not
+    // guaranteed.
+    int numThreads = 1;
+#if wxUSE_THREADS && wxUSE_CAIRO
+    if ( m_renderer == wxGraphicsRenderer::GetCairoRenderer() )
+    {
+        numThreads = m_maxThreads ? m_maxThreads
+                                  : wxThreadPool::Get().GetMaxThreads();
+        numThreads = wxMin(numThreads, tilesPerRow);
+    }
+#endif // wxUSE_THREADS && wxUSE_CAIRO
+
+    // Each thread replays its own recording as the graphics objects can't be
+    // shared between the threads: even copying them is not thread-safe, as
+    // their reference counts are not atomic. For the same reason, these
+    // recordings don't keep the objects passed to the context, such as
+    // wxBitmap or wxRegion, but create their own copies of them.
+    //
+    // Recording the drawing commands also allows to skip the commands which
+    // don't affect the tile when replaying them.
+    wxVector<wxGraphicsRecording> recordings(numThreads);
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        std::unique_ptr<wxGraphicsContext>
+            gc(recordings[n].DoCreateContext(m_size.x, m_size.y, m_renderer,
+                                             numThreads > 1));
+        wxCHECK_MSG( gc, false, "failed to create recording context" );
+
+        draw(gc.get());
+    }
+
+    // Make sure any one-time initialization done by the renderer when
+    // creating a context happens in this thread.
+    delete m_renderer->CreateMeasuringContext();
+
+    const bool hasAlpha = m_backgroundColour.Alpha() != wxALPHA_OPAQUE;
+
+    auto renderTile = [&](const wxGraphicsRecording& recording,
+                          const wxRect& rect,
+                          wxImage& image)
+    {
+        image.Create(rect.width, rect.height, false);
+        image.SetRGB(wxRect(rect.GetSize()),
+                     m_backgroundColour.Red(),
+                     m_backgroundColour.Green(),
+                     m_backgroundColour.Blue());
+        if ( hasAlpha )
+        {
+            image.InitAlpha();
+            memset(image.GetAlpha(), m_backgroundColour.Alpha(),
+                   rect.width*rect.height);
+        }
+
+        std::unique_ptr<wxGraphicsContext>
+            gc(m_renderer->CreateContextFromImage(image));
+        if ( !gc )
+            return;
+
+        wxAffineMatrix2D transform;
+        transform.Translate(-rect.x, -rect.y);
+        recording.Replay(gc.get(), wxRegion(wxRect(rect.GetSize())), transform);
+    };
+
+    // Render the tiles one row at a time, to limit the memory used by them.
+    wxVector<wxImage> tiles(tilesPerRow);
+    wxVector<wxRect> rects(tilesPerRow);
+
+#if wxUSE_THREADS
+    // Indices of the recordings not currently used by any thread.
+    wxVector<int> freeRecordings;
+    wxCriticalSection csFree;
+#endif // wxUSE_THREADS
+
+    for ( int row = 0; row < tileRows; row++ )
+    {
+        for ( int col = 0; col < tilesPerRow; col++ )
+        {
+            wxRect& rect = rects[col];
+            rect.x = col*m_tileSize.x;
+            rect.y = row*m_tileSize.y;
+            rect.width = wxMin(m_tileSize.x, m_size.x - rect.x);
+            rect.height = wxMin(m_tileSize.y, m_size.y - rect.y);
+        }
+
+#if wxUSE_THREADS
+        if ( numThreads > 1 )
+        {
+            freeRecordings.clear();
+            for ( int n = 0; n < numThreads; n++ )
+                freeRecordings.push_back(n);
+
+            wxThreadPool::Get().ParallelFor(tilesPerRow, [&](size_t col)
+            {
+                int index;
+                {
+                    wxCRIT_SECT_LOCKER(lock, csFree);
+                    index = freeRecordings.back();
+                    freeRecordings.pop_back();
+                }
+
+                renderTile(recordings[index], rects[col], tiles[col]);
+
+                wxCRIT_SECT_LOCKER(lock, csFree);
+                freeRecordings.push_back(index);
+            }, numThreads);
+        }
+        else
+#endif // wxUSE_THREADS
+        {
+            for ( int col = 0; col < tilesPerRow; col++ )
+                renderTile(recordings[0], rects[col], tiles[col]);
+        }
+
+        for ( int col = 0; col < tilesPerRow; col++ )
+        {
+            if ( !onTile(rects[col], tiles[col]) )
+                return false;
+
+            tiles[col].Destroy();
+        }
+    }
+
+    return true;
+}
+
+wxImage
+wxGraphicsTiledImageRenderer::RenderImage(const DrawFunction& draw) const
+{
+    wxCHECK_MSG( m_size.x > 0 && m_size.y > 0, wxImage(), "invalid image size" );
+
+    wxImage image(m_size, false);
+    if ( m_backgroundColour.Alpha() != wxALPHA_OPAQUE )
+        image.InitAlpha();
+
+    const bool ok = Render(draw, [&image](const wxRect& rect, const wxImage& tile)
+    {
+        image.Paste(tile, rect.x, rect.y);
+        return true;
+    });
+
+    return ok ? image : wxImage();
+}
+
+#endif // wxUSE_GRAPHICS_CONTEXT
@@ -27,11 +27,25 @@
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
 
+#include "wx/private/image.h"
+
+#if wxUSE_THREADS
+    #include "wx/private/threadpool.h"
+#endif
+
 // For memcpy
 #include <string.h>
 
+#include <memory>
 #include <unordered_set>
 
+// SSE2 is always available when targeting x86-64, so use it if possible.
+#if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define wxIMAGE_RESAMPLE_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
 // make the code compile with either wxFile*Stream or wxFFile*Stream:
 #define HAS_FILE_STREAMS (wxUSE_STREAMS && (wxUSE_FILE || wxUSE_FFILE))
 
@@ -130,6 +144,64 @@ wxImageRefData::~wxImageRefData()
         free( m_alpha );
 }
 
+//-----------------------------------------------------------------------------
+// parallel processing helpers
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Number of threads to use, see wxImage::SetParallelism().
+int gs_imageParallelism = 1;
+
+// It is not worth using a separate thread for processing fewer pixels.
+const size_t MIN_PIXELS_PER_BAND = 32768;
+
+// Call func(start, end) for the bands of lines [start, end) covering all the
+// lines in [0, count) range, each line consisting of lineSize pixels.
+//
+// The bands may be processed concurrently if parallel processing is enabled,
+// so func must only modify the lines in its band. As each line is always
+// processed in the same way, the result doesn't depend on the number of
+// threads used.
+template <typename F>
+void ProcessInBands(int count, int lineSize, const F& func)
+{
+#if wxUSE_THREADS
+    if ( gs_imageParallelism != 1 && count > 1 )
+    {
+        wxThreadPool& pool = wxThreadPool::Get();
+
+        const int maxThreads = gs_imageParallelism > 0
+                                ? gs_imageParallelism
+                                : pool.GetMaxThreads();
+
+        // Use more bands than threads to ensure that all threads are busy
+        // even if some bands take longer to process than the others.
+        size_t bands = static_cast<size_t>(count) * lineSize / MIN_PIXELS_PER_BAND;
+        bands = wxMin(bands, static_cast<size_t>(4 * maxThreads));
+        bands = wxMin(bands, static_cast<size_t>(count));
+
+        if ( bands > 1 )
+        {
+            pool.ParallelFor(bands, [=, &func](size_t n)
+            {
+                func(static_cast<int>(wxUint64(count) * n / bands),
+                     static_cast<int>(wxUint64(count) * (n + 1) / bands));
+            }, maxThreads);
+
+            return;
+        }
+    }
+#else // !wxUSE_THREADS
+    wxUnusedVar(lineSize);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    func(0, count);
+}
+
+} // anonymous namespace
+
 
 //-----------------------------------------------------------------------------
 // wxImage
@@ -566,30 +638,33 @@ wxImage wxImage::ResampleNearest(int width, int height) const
     const wxUIntPtr x_delta = (old_width  << 16) / width;
     const wxUIntPtr y_delta = (old_height << 16) / height;
 
-    unsigned char* dest_pixel = target_data;
-
-    wxUIntPtr y = 0;
-    for (int j = 0; j < height; j++)
+    ProcessInBands(height, width, [=](int start, int end)
     {
-        const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
-        const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : nullptr ;
+        unsigned char* dest_pixel = target_data + static_cast<size_t>(start)*width*3;
+        unsigned char* dest_alpha = target_alpha ? target_alpha + static_cast<size_t>(start)*width : nullptr;
 
-        wxUIntPtr x = 0;
-        for (int i = 0; i < width; i++)
+        wxUIntPtr y = start*y_delta;
+        for (int j = start; j < end; j++)
         {
-            const unsigned char* src_pixel = &src_line[(x>>16)*3];
-            const unsigned char* src_alpha_pixel = source_alpha ? &src_alpha_line[(x>>16)] : nullptr ;
-            dest_pixel[0] = src_pixel[0];
-            dest_pixel[1] = src_pixel[1];
-            dest_pixel[2] = src_pixel[2];
-            dest_pixel += 3;
-            if ( source_alpha )
-                *(target_alpha++) = *src_alpha_pixel ;
-            x += x_delta;
-        }
+            const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
+            const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : nullptr ;
 
-        y += y_delta;
-    }
+            wxUIntPtr x = 0;
+            for (int i = 0; i < width; i++)
+            {
+                const unsigned char* src_pixel = &src_line[(x>>16)*3];
+                dest_pixel[0] = src_pixel[0];
+                dest_pixel[1] = src_pixel[1];
+                dest_pixel[2] = src_pixel[2];
+                dest_pixel += 3;
+                if ( source_alpha )
+                    *(dest_alpha++) = src_alpha_line[x>>16];
+                x += x_delta;
+            }
+
+            y += y_delta;
+        }
+    });
 
     return image;
 }
@@ -677,77 +752,290 @@ wxImage wxImage::ResampleBox(int width, int height) const
         dst_alpha = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+    const size_t src_width = M_IMGDATA->m_width;
 
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
+    const int channels = src_alpha ? 4 : 3;
+
+    ProcessInBands(height, width, [&](int start, int end)
     {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+        unsigned char* dst = dst_data + static_cast<size_t>(start) * width * 3;
+        unsigned char* dst_a = dst_alpha ? dst_alpha + static_cast<size_t>(start) * width
+                                         : nullptr;
+
+        // Sums of the (alpha-weighted, if we have alpha) channel values of all
+        // pixels in the boxes of the current destination row. Integer
+        // arithmetic gives exactly the same results as the floating point one,
+        // but is much faster, and we use 64 bits as the boxes can be
+        // arbitrarily big when shrinking huge images.
+        wxVector<wxUint64> sums(width * channels);
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
+        for ( int y = start; y < end; y++ )         // Destination image - Y direction
         {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+            // Source pixels in the Y direction
+            const BoxPrecalc& vPrecalc = vPrecalcs[y];
 
-            // Box of pixels to average
-            averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
-                                * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+            memset(&sums[0], 0, sums.size() * sizeof(wxUint64));
 
             for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                const unsigned char* const src_line = src_data + j * src_width * 3;
+                wxUint64* sum = &sums[0];
+
+                if ( src_alpha )
                 {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+                    const unsigned char* const
+                        src_alpha_line = src_alpha + j * src_width;
 
-                    if (src_alpha)
+                    for ( int x = 0; x < width; x++, sum += 4 )
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
+                        const BoxPrecalc& hPrecalc = hPrecalcs[x];
+                        for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                        {
+                            const unsigned a = src_alpha_line[i];
+                            sum[0] += src_line[i * 3 + 0] * a;
+                            sum[1] += src_line[i * 3 + 1] * a;
+                            sum[2] += src_line[i * 3 + 2] * a;
+                            sum[3] += a;
+                        }
                     }
-                    else
+                }
+                else
+                {
+                    for ( int x = 0; x < width; x++, sum += 3 )
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
+                        const BoxPrecalc& hPrecalc = hPrecalcs[x];
+                        for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                        {
+                            sum[0] += src_line[i * 3 + 0];
+                            sum[1] += src_line[i * 3 + 1];
+                            sum[2] += src_line[i * 3 + 2];
+                        }
                     }
                 }
             }
 
             // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
+            const wxUint64* sum = &sums[0];
+            for ( int x = 0; x < width; x++, sum += channels )
             {
-                if (sum_a != 0)
+                const BoxPrecalc& hPrecalc = hPrecalcs[x];
+                const wxUint64
+                    averaged_pixels = wxUint64(vPrecalc.boxEnd - vPrecalc.boxStart + 1)
+                                        * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+
+                if ( src_alpha )
                 {
-                    dst_data[0] = (unsigned char)(sum_r / sum_a);
-                    dst_data[1] = (unsigned char)(sum_g / sum_a);
-                    dst_data[2] = (unsigned char)(sum_b / sum_a);
+                    const wxUint64 sum_a = sum[3];
+                    if ( sum_a != 0 )
+                    {
+                        dst[0] = (unsigned char)(sum[0] / sum_a);
+                        dst[1] = (unsigned char)(sum[1] / sum_a);
+                        dst[2] = (unsigned char)(sum[2] / sum_a);
+                    }
+                    else
+                    {
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
+                    }
+                    *dst_a++ = (unsigned char)(sum_a / averaged_pixels);
                 }
                 else
                 {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
+                    dst[0] = (unsigned char)(sum[0] / averaged_pixels);
+                    dst[1] = (unsigned char)(sum[1] / averaged_pixels);
+                    dst[2] = (unsigned char)(sum[2] / averaged_pixels);
                 }
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
+                dst += 3;
             }
-            else
+        }
+    });
+
+    return ret_image;
+}
+
+// ----------------------------------------------------------------------------
+// Fixed point separable resampling
+// ----------------------------------------------------------------------------
+
+// Both bilinear and bicubic kernels are separable, so instead of applying the
+// full 2D kernel to each destination pixel, we first filter the source rows
+// horizontally and then combine the filtered rows vertically. This is done
+// using fixed point arithmetic, which is much faster than using doubles and
+// allows processing several values at once using SIMD instructions, when
+// available. The results differ from the exact values by at most 1 in each
+// channel.
+
+namespace
+{
+
+// Number of fractional bits in the filter weights.
+const int RESAMPLE_WEIGHT_BITS = 14;
+const int RESAMPLE_WEIGHT_ONE = 1 << RESAMPLE_WEIGHT_BITS;
+
+// Number of fractional bits kept in the horizontally filtered values: this
+// is the maximal number for which they still fit into 16 bit signed integers.
+const int RESAMPLE_INTER_BITS = 7;
+
+// Filter with N taps used to compute a single destination pixel.
+template <int N>
+struct ResampleTaps
+{
+    int offset[N];
+    int weight[N];
+};
+
+// Convert floating point weights, whose sum must be 1, to the fixed point
+// ones whose sum is exactly RESAMPLE_WEIGHT_ONE.
+template <int N>
+void SetResampleWeights(ResampleTaps<N>& taps, const double* weights)
+{
+    int sum = 0;
+    int maxIndex = 0;
+    for ( int n = 0; n < N; n++ )
+    {
+        taps.weight[n] = wxRound(weights[n] * RESAMPLE_WEIGHT_ONE);
+        sum += taps.weight[n];
+
+        if ( taps.weight[n] > taps.weight[maxIndex] )
+            maxIndex = n;
+    }
+
+    // Put the rounding error, if any, into the biggest weight.
+    taps.weight[maxIndex] += RESAMPLE_WEIGHT_ONE - sum;
+}
+
+// Filter a single source row horizontally, the results have
+// RESAMPLE_INTER_BITS fractional bits.
+template <int N, int Channels>
+void ResampleRowHorz(const unsigned char* src,
+                     const wxVector< ResampleTaps<N> >& taps,
+                     wxInt16* dst)
+{
+    const int shift = RESAMPLE_WEIGHT_BITS - RESAMPLE_INTER_BITS;
+    const int round = 1 << (shift - 1);
+
+    const size_t count = taps.size();
+    for ( size_t x = 0; x < count; x++ )
+    {
+        const ResampleTaps<N>& t = taps[x];
+        for ( int c = 0; c < Channels; c++ )
+        {
+            int sum = round;
+            for ( int n = 0; n < N; n++ )
+                sum += t.weight[n] * src[t.offset[n] * Channels + c];
+
+            *dst++ = static_cast<wxInt16>(sum >> shift);
+        }
+    }
+}
+
+// Combine N horizontally filtered rows into a single destination row.
+template <int N>
+void ResampleRowVert(const wxInt16* const* rows,
+                     const int* weights,
+                     int count,
+                     unsigned char* dst)
+{
+    wxCOMPILE_TIME_ASSERT( N % 2 == 0, MustHaveEvenNumberOfTaps );
+
+    const int shift = RESAMPLE_WEIGHT_BITS + RESAMPLE_INTER_BITS;
+    const int round = 1 << (shift - 1);
+
+    int i = 0;
+
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+    // Process 8 values at once, combining pairs of rows using madd, which
+    // computes row0*weight0 + row1*weight1 for each pair of interleaved
+    // 16 bit values. Note that the weights are non-negative and sum to
+    // RESAMPLE_WEIGHT_ONE, so the sums can't overflow.
+    const __m128i vround = _mm_set1_epi32(round);
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        __m128i lo = vround,
+                hi = vround;
+        for ( int n = 0; n < N; n += 2 )
+        {
+            const __m128i w = _mm_set1_epi32((weights[n + 1] << 16) | weights[n]);
+            const __m128i
+                r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[n] + i)),
+                r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[n + 1] + i));
+
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(r0, r1), w));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(r0, r1), w));
+        }
+
+        const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(lo, shift),
+                                               _mm_srai_epi32(hi, shift));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(packed, packed));
+    }
+#endif // wxIMAGE_RESAMPLE_USE_SSE2
+
+    for ( ; i < count; i++ )
+    {
+        int sum = round;
+        for ( int n = 0; n < N; n++ )
+            sum += weights[n] * rows[n][i];
+
+        sum >>= shift;
+        dst[i] = static_cast<unsigned char>(sum > 255 ? 255 : sum);
+    }
+}
+
+// Resample a plane with the given number of channels, i.e. either the RGB
+// data or the alpha channel, into the rows [yStart, yEnd) of a plane of size
+// hTaps.size()*vTaps.size().
+template <int N, int Channels>
+void ResamplePlane(const unsigned char* src,
+                   int srcWidth,
+                   const wxVector< ResampleTaps<N> >& hTaps,
+                   const wxVector< ResampleTaps<N> >& vTaps,
+                   int yStart,
+                   int yEnd,
+                   unsigned char* dst)
+{
+    const size_t srcLineLen = static_cast<size_t>(srcWidth) * Channels;
+    const int lineLen = static_cast<int>(hTaps.size()) * Channels;
+
+    // The rows used for a single destination row are always consecutive
+    // (except for the rows repeated at the edges), so storing the filtered
+    // row i in the slot i % N of this ring buffer is enough to ensure that we
+    // never need to filter the same row again when going from top to bottom.
+    wxVector<wxInt16> buffer(N * lineLen);
+    int slotRows[N];
+    for ( int n = 0; n < N; n++ )
+        slotRows[n] = -1;
+
+    const wxInt16* rows[N];
+
+    dst += static_cast<size_t>(yStart) * lineLen;
+    for ( int y = yStart; y < yEnd; y++ )
+    {
+        const ResampleTaps<N>& t = vTaps[y];
+        for ( int n = 0; n < N; n++ )
+        {
+            const int row = t.offset[n];
+            const int slot = row % N;
+
+            wxInt16* const slotData = &buffer[slot * lineLen];
+            if ( slotRows[slot] != row )
             {
-                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
+                ResampleRowHorz<N, Channels>(src + row * srcLineLen,
+                                             hTaps, slotData);
+                slotRows[slot] = row;
             }
-            dst_data += 3;
+
+            rows[n] = slotData;
         }
-    }
 
-    return ret_image;
+        ResampleRowVert<N>(rows, t.weight, lineLen, dst);
+        dst += lineLen;
+    }
 }
 
+} // anonymous namespace
+
 namespace
 {
 
@@ -806,6 +1094,23 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
+void ResampleBilinearTaps(wxVector< ResampleTaps<2> >& taps, int oldDim)
+{
+    wxVector<BilinearPrecalc> precalcs(taps.size());
+    ResampleBilinearPrecalc(precalcs, oldDim);
+
+    for ( size_t n = 0; n < taps.size(); n++ )
+    {
+        const BilinearPrecalc& precalc = precalcs[n];
+
+        taps[n].offset[0] = precalc.offset1;
+        taps[n].offset[1] = precalc.offset2;
+
+        const double weights[2] = { precalc.dd1, precalc.dd };
+        SetResampleWeights(taps[n], weights);
+    }
+}
+
 } // anonymous namespace
 
 wxImage wxImage::ResampleBilinear(int width, int height) const
@@ -815,76 +1120,35 @@ wxImage wxImage::ResampleBilinear(int width, int height) const
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = nullptr;
 
     wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
 
+    wxVector< ResampleTaps<2> > vTaps(height);
+    wxVector< ResampleTaps<2> > hTaps(width);
+    ResampleBilinearTaps(vTaps, M_IMGDATA->m_height);
+    ResampleBilinearTaps(hTaps, M_IMGDATA->m_width);
+
+    unsigned char* dst_alpha = nullptr;
     if ( src_alpha )
     {
         ret_image.SetAlpha();
         dst_alpha = ret_image.GetAlpha();
     }
 
-    wxVector<BilinearPrecalc> vPrecalcs(height);
-    wxVector<BilinearPrecalc> hPrecalcs(width);
-    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    const int src_width = M_IMGDATA->m_width;
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
+    // Colour and alpha channels are interpolated independently here.
+    ProcessInBands(height, width, [&](int start, int end)
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
-
+        ResamplePlane<2, 3>(src_data, src_width, hTaps, vTaps,
+                            start, end, dst_data);
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+        if ( src_alpha )
         {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
-
-            // result lines
-
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
-
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+            ResamplePlane<2, 1>(src_alpha, src_width, hTaps, vTaps,
+                                start, end, dst_alpha);
         }
-    }
+    });
 
     return ret_image;
 }
@@ -958,6 +1222,126 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
     }
 }
 
+
+void ResampleBicubicTaps(wxVector< ResampleTaps<4> >& taps, int oldDim)
+{
+    wxVector<BicubicPrecalc> precalcs(taps.size());
+    ResampleBicubicPrecalc(precalcs, oldDim);
+
+    for ( size_t n = 0; n < taps.size(); n++ )
+    {
+        const BicubicPrecalc& precalc = precalcs[n];
+
+        for ( int k = 0; k < 4; k++ )
+            taps[n].offset[k] = precalc.offset[k];
+
+        SetResampleWeights(taps[n], precalc.weight);
+    }
+}
+
+// Resample RGB data weighting each pixel by its alpha value, i.e. working with
+// premultiplied colour values, as this is what the bicubic algorithm does.
+//
+// This is similar to ResamplePlane() but the horizontally filtered rows keep
+// 4 values (alpha-weighted R, G, B and alpha itself) per pixel with full
+// precision, as we need to divide by the alpha sum at the end.
+void ResampleBicubicWithAlpha(const unsigned char* srcData,
+                              const unsigned char* srcAlpha,
+                              int srcWidth,
+                              const wxVector< ResampleTaps<4> >& hTaps,
+                              const wxVector< ResampleTaps<4> >& vTaps,
+                              int yStart,
+                              int yEnd,
+                              unsigned char* dstData,
+                              unsigned char* dstAlpha)
+{
+    const int width = static_cast<int>(hTaps.size());
+    const int lineLen = width * 4;
+
+    wxVector<wxInt32> buffer(4 * lineLen);
+    int slotRows[4] = { -1, -1, -1, -1 };
+    const wxInt32* rows[4];
+
+    dstData += static_cast<size_t>(yStart) * width * 3;
+    dstAlpha += static_cast<size_t>(yStart) * width;
+    for ( int y = yStart; y < yEnd; y++ )
+    {
+        const ResampleTaps<4>& vt = vTaps[y];
+        for ( int k = 0; k < 4; k++ )
+        {
+            const int row = vt.offset[k];
+            const int slot = row % 4;
+
+            wxInt32* const slotData = &buffer[slot * lineLen];
+            if ( slotRows[slot] != row )
+            {
+                const size_t start = static_cast<size_t>(row) * srcWidth;
+                const unsigned char* const data = srcData + start * 3;
+                const unsigned char* const alpha = srcAlpha + start;
+
+                wxInt32* dst = slotData;
+                for ( int x = 0; x < width; x++, dst += 4 )
+                {
+                    const ResampleTaps<4>& ht = hTaps[x];
+
+                    // This can't overflow as the weights sum to 2^14.
+                    wxInt32 sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+                    for ( int i = 0; i < 4; i++ )
+                    {
+                        const int offset = ht.offset[i];
+                        const wxInt32 wa = ht.weight[i] * alpha[offset];
+                        sum_r += data[offset * 3 + 0] * wa;
+                        sum_g += data[offset * 3 + 1] * wa;
+                        sum_b += data[offset * 3 + 2] * wa;
+                        sum_a += wa;
+                    }
+
+                    dst[0] = sum_r;
+                    dst[1] = sum_g;
+                    dst[2] = sum_b;
+                    dst[3] = sum_a;
+                }
+
+                slotRows[slot] = row;
+            }
+
+            rows[k] = slotData;
+        }
+
+        for ( int x = 0; x < width; x++ )
+        {
+            wxInt64 sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            for ( int k = 0; k < 4; k++ )
+            {
+                const wxInt32* const p = rows[k] + x * 4;
+                const wxInt64 w = vt.weight[k];
+                sum_r += w * p[0];
+                sum_g += w * p[1];
+                sum_b += w * p[2];
+                sum_a += w * p[3];
+            }
+
+            if ( sum_a != 0 )
+            {
+                dstData[0] = static_cast<unsigned char>(wxMin(255, (sum_r + sum_a / 2) / sum_a));
+                dstData[1] = static_cast<unsigned char>(wxMin(255, (sum_g + sum_a / 2) / sum_a));
+                dstData[2] = static_cast<unsigned char>(wxMin(255, (sum_b + sum_a / 2) / sum_a));
+            }
+            else
+            {
+                dstData[0] = 0;
+                dstData[1] = 0;
+                dstData[2] = 0;
+            }
+            dstData += 3;
+
+            // Alpha is truncated and not rounded, as in the original version
+            // of this algorithm using doubles.
+            *dstAlpha++ = static_cast<unsigned char>(sum_a >> (2 * RESAMPLE_WEIGHT_BITS));
+        }
+    }
+}
+
 } // anonymous namespace
 
 // This is the bicubic resampling algorithm
@@ -996,206 +1380,242 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = nullptr;
 
     wxCHECK_MSG( dst_data, ret_image, wxS("unable to create image") );
 
+    // Precalculate weights
+    wxVector< ResampleTaps<4> > vTaps(height);
+    wxVector< ResampleTaps<4> > hTaps(width);
+
+    ResampleBicubicTaps(vTaps, M_IMGDATA->m_height);
+    ResampleBicubicTaps(hTaps, M_IMGDATA->m_width);
+
+    unsigned char* dst_alpha = nullptr;
     if ( src_alpha )
     {
         ret_image.SetAlpha();
         dst_alpha = ret_image.GetAlpha();
     }
 
-    // Precalculate weights
-    wxVector<BicubicPrecalc> vPrecalcs(height);
-    wxVector<BicubicPrecalc> hPrecalcs(width);
+    const int src_width = M_IMGDATA->m_width;
+
+    ProcessInBands(height, width, [&](int start, int end)
+    {
+        if ( src_alpha )
+        {
+            ResampleBicubicWithAlpha(src_data, src_alpha, src_width,
+                                     hTaps, vTaps, start, end,
+                                     dst_data, dst_alpha);
+        }
+        else
+        {
+            ResamplePlane<4, 3>(src_data, src_width, hTaps, vTaps,
+                                start, end, dst_data);
+        }
+    });
+
+    return ret_image;
+}
+
+namespace
+{
+
+// Number of lines blurred together by BlurLines(): when the result is stored
+// transposed, this allows writing it in contiguous chunks instead of touching
+// a different cache line for every pixel.
+const int BLUR_TILE_LINES = 8;
+
+// Divides the sums of blurArea pixels by blurArea, using multiplication
+// instead of (much slower) division when it gives exactly the same result.
+class BlurDivider
+{
+public:
+    explicit BlurDivider(unsigned area)
+        : m_area(area)
+    {
+        // As sum <= 255*area, using m = 2^32/area + 1 results in exact
+        // quotient as long as 255*area*area < 2^32, i.e. for all practically
+        // useful blur radii.
+        m_mult = 255*wxUint64(area)*area < (wxUint64(1) << 32)
+                    ? (wxUint64(1) << 32) / area + 1
+                    : 0;
+    }
+
+    unsigned char operator()(unsigned sum) const
+    {
+        return static_cast<unsigned char>(m_mult ? (sum*m_mult) >> 32
+                                                 : sum / m_area);
+    }
 
-    ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
+private:
+    const unsigned m_area;
+    wxUint64 m_mult;
+};
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+// Describes the layout of the lines of pixels with the given number of
+// interleaved channels: pixelStep is the offset between the consecutive
+// pixels of a line and lineStep is the offset between the starts of the
+// consecutive lines.
+struct BlurLayout
+{
+    size_t pixelStep;
+    size_t lineStep;
+};
+
+// Blur the lines in [lineStart, lineEnd) range, each of which has len pixels,
+// along their direction using box filter of the given radius, with the pixels
+// beyond the ends of the line being replaced with the edge pixels.
+//
+// Each pixel is computed in constant time, independently of the radius, by
+// updating the running sums of the pixels in the box.
+template <int Channels>
+void BlurLines(const unsigned char* src, const BlurLayout& srcLayout,
+               unsigned char* dst, const BlurLayout& dstLayout,
+               int len, int lineStart, int lineEnd, int radius)
+{
+    const BlurDivider divide(2*radius + 1);
+
+    const size_t srcStep = srcLayout.pixelStep;
+    const size_t dstStep = dstLayout.pixelStep;
+
+    // Beyond these positions, the pixels leaving the box on the left and
+    // entering it on the right are the edge pixels respectively.
+    const int leftEdgeEnd = wxMin(len, radius + 1);
+    const int rightEdgeStart = wxMax(1, len - radius);
+
+    const unsigned char* lines[BLUR_TILE_LINES];
+    unsigned char* outs[BLUR_TILE_LINES];
+    unsigned sums[BLUR_TILE_LINES][Channels];
+
+    for ( int tileStart = lineStart; tileStart < lineEnd; tileStart += BLUR_TILE_LINES )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+        const int tileLines = wxMin(BLUR_TILE_LINES, lineEnd - tileStart);
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+        // Compute the sums for the first pixel of each line.
+        for ( int t = 0; t < tileLines; t++ )
         {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+            const unsigned char* const line = src + (tileStart + t)*srcLayout.lineStep;
+            const unsigned char* const last = line + (len - 1)*srcStep;
+
+            lines[t] = line;
+            outs[t] = dst + (tileStart + t)*dstLayout.lineStep;
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            // The first pixel is repeated radius + 1 times and the last one,
+            // if the box is bigger than the line, radius - (len - 1) times.
+            const unsigned firstCount = radius + 1;
+            const unsigned lastCount = radius >= len ? radius - (len - 1) : 0;
+            const int innerEnd = wxMin(radius, len - 1);
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+            for ( int c = 0; c < Channels; c++ )
             {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+                unsigned sum = line[c]*firstCount + last[c]*lastCount;
+                for ( int k = 1; k <= innerEnd; k++ )
+                    sum += line[k*srcStep + c];
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
-                    {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    }
-                }
+                sums[t][c] = sum;
+                outs[t][c] = divide(sum);
             }
+        }
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
+        // And now move the box along the lines: this lambda handles the
+        // pixels in [from, to) range for which the leaving and entering
+        // pixels are either inside the line or clamped to its edges.
+        const auto slide = [&](int from, int to, bool clampLeft, bool clampRight)
+        {
+            for ( int x = from; x < to; x++ )
             {
-                if (sum_a != 0)
-                {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
-                }
-                else
+                const size_t leaving = clampLeft ? 0 : (x - radius - 1)*srcStep;
+                const size_t entering = clampRight ? (len - 1)*srcStep
+                                                   : (x + radius)*srcStep;
+
+                for ( int t = 0; t < tileLines; t++ )
                 {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
+                    const unsigned char* const line = lines[t];
+                    unsigned char* const out = outs[t] + x*dstStep;
+
+                    for ( int c = 0; c < Channels; c++ )
+                    {
+                        sums[t][c] += line[entering + c];
+                        sums[t][c] -= line[leaving + c];
+                        out[c] = divide(sums[t][c]);
+                    }
                 }
-                *dst_alpha++ = (unsigned char)sum_a;
             }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
-            }
-            dst_data += 3;
-        }
+        };
+
+        const int innerStart = wxMin(leftEdgeEnd, rightEdgeStart);
+        const int innerEnd = wxMax(leftEdgeEnd, rightEdgeStart);
+
+        slide(1, innerStart, true, false);
+        if ( leftEdgeEnd <= rightEdgeStart )
+            slide(innerStart, innerEnd, false, false);
+        else // The box is bigger than the line.
+            slide(innerStart, innerEnd, true, true);
+        slide(innerEnd, len, false, true);
     }
+}
 
-    return ret_image;
+// Blur all lines of the plane, possibly in parallel.
+template <int Channels>
+void BlurPlane(const unsigned char* src, const BlurLayout& srcLayout,
+               unsigned char* dst, const BlurLayout& dstLayout,
+               int len, int count, int radius)
+{
+    ProcessInBands(count, len, [=](int start, int end)
+    {
+        BlurLines<Channels>(src, srcLayout, dst, dstLayout,
+                            len, start, end, radius);
+    });
 }
 
+// Blur the plane of the given size in both directions numPasses times.
+//
+// Vertical blurring is done by blurring the lines of the transposed plane,
+// which is much more cache-friendly than blurring the columns directly: the
+// horizontal pass stores its result transposed in the scratch buffer and the
+// vertical pass transposes it back to dst, which is also used as input for
+// all the passes except the first one.
+template <int Channels>
+void BlurPlaneBoth(const unsigned char* src, unsigned char* dst,
+                   unsigned char* scratch,
+                   int width, int height, int radius, int numPasses)
+{
+    const BlurLayout rows = { Channels, width*size_t(Channels) };
+    const BlurLayout columns = { width*size_t(Channels), Channels };
+    const BlurLayout scratchRows = { Channels, height*size_t(Channels) };
+    const BlurLayout scratchColumns = { height*size_t(Channels), Channels };
+
+    for ( int pass = 0; pass < numPasses; pass++ )
+    {
+        BlurPlane<Channels>(pass ? dst : src, rows, scratch, scratchColumns,
+                            width, height, radius);
+        BlurPlane<Channels>(scratch, scratchRows, dst, columns,
+                            height, width, radius);
+    }
+}
+
+} // anonymous namespace
+
 // Blur in the horizontal direction
 wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
+    wxCHECK_MSG( blurRadius >= 0, ret_image, wxS("invalid blur radius") );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+    const BlurLayout rgbRows = { 3, width*size_t(3) };
+    BlurPlane<3>(M_IMGDATA->m_data, rgbRows, ret_image.GetData(), rgbRows,
+                 width, height, blurRadius);
 
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
+    if ( M_IMGDATA->m_alpha )
+    {
+        const BlurLayout alphaRows = { 1, size_t(width) };
+        BlurPlane<1>(M_IMGDATA->m_alpha, alphaRows, ret_image.GetAlpha(), alphaRows,
+                     width, height, blurRadius);
     }
 
     return ret_image;
@@ -1207,112 +1627,50 @@ wxImage wxImage::BlurVertical(int blurRadius) const
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
+    wxCHECK_MSG( blurRadius >= 0, ret_image, wxS("invalid blur radius") );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    // Blur the adjacent columns together, see BLUR_TILE_LINES, without
+    // transposing the image, as it's not worth it for a single pass.
+    const BlurLayout rgbColumns = { width*size_t(3), 3 };
+    BlurPlane<3>(M_IMGDATA->m_data, rgbColumns, ret_image.GetData(), rgbColumns,
+                 height, width, blurRadius);
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
+    if ( M_IMGDATA->m_alpha )
+    {
+        const BlurLayout alphaColumns = { size_t(width), 1 };
+        BlurPlane<1>(M_IMGDATA->m_alpha, alphaColumns, ret_image.GetAlpha(), alphaColumns,
+                     height, width, blurRadius);
     }
 
     return ret_image;
 }
 
-// The new blur function
-wxImage wxImage::Blur(int blurRadius) const
+wxImage wxImage::Blur(int blurRadius, int numPasses) const
 {
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+    wxImage ret_image(MakeEmptyClone());
 
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+    wxCHECK( ret_image.IsOk(), ret_image );
+    wxCHECK_MSG( blurRadius >= 0, ret_image, wxS("invalid blur radius") );
+    wxCHECK_MSG( numPasses > 0, ret_image, wxS("invalid number of passes") );
+
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
+
+    // The same scratch buffer is used for all the passes and all the planes.
+    std::unique_ptr<unsigned char[]>
+        scratch(new unsigned char[static_cast<size_t>(width)*height*3]);
+
+    BlurPlaneBoth<3>(M_IMGDATA->m_data, ret_image.GetData(), scratch.get(),
+                     width, height, blurRadius, numPasses);
+
+    if ( M_IMGDATA->m_alpha )
+    {
+        BlurPlaneBoth<1>(M_IMGDATA->m_alpha, ret_image.GetAlpha(), scratch.get(),
+                         width, height, blurRadius, numPasses);
+    }
 
     return ret_image;
 }
@@ -1543,50 +1901,104 @@ wxImage wxImage::Mirror( bool horizontally ) const
 
 wxImage wxImage::GetSubImage( const wxRect &rect ) const
 {
-    wxImage image;
-
-    wxCHECK_MSG( IsOk(), image, wxT("invalid image") );
+    wxCHECK_MSG( IsOk(), wxNullImage, wxT("invalid image") );
 
     wxCHECK_MSG( (rect.GetLeft()>=0) && (rect.GetTop()>=0) &&
                  (rect.GetRight()<=GetWidth()) && (rect.GetBottom()<=GetHeight()),
-                 image, wxT("invalid subimage size") );
+                 wxNullImage, wxT("invalid subimage size") );
 
-    const int subwidth = rect.GetWidth();
-    const int subheight = rect.GetHeight();
+    return wxImageView(*this, rect).ToImage();
+}
 
-    image.Create( subwidth, subheight, false );
+// ----------------------------------------------------------------------------
+// wxImageView
+// ----------------------------------------------------------------------------
 
-    const unsigned char *src_data = GetData();
-    const unsigned char *src_alpha = M_IMGDATA->m_alpha;
-    unsigned char *subdata = image.GetData();
-    unsigned char *subalpha = nullptr;
+wxImageView::wxImageView(const wxImage& image)
+    : m_image(image),
+      m_rect(image.IsOk() ? image.GetSize() : wxSize())
+{
+}
 
-    wxCHECK_MSG( subdata, image, wxT("unable to create image") );
+wxImageView::wxImageView(const wxImage& image, const wxRect& rect)
+{
+    wxCHECK_RET( image.IsOk(), wxS("invalid image") );
 
-    if ( src_alpha ) {
-        image.SetAlpha();
-        subalpha = image.GetAlpha();
-        wxCHECK_MSG( subalpha, image, wxT("unable to create alpha channel"));
-    }
+    wxCHECK_RET( rect.x >= 0 && rect.y >= 0 &&
+                 rect.width >= 0 && rect.height >= 0 &&
+                 rect.x + rect.width <= image.GetWidth() &&
+                 rect.y + rect.height <= image.GetHeight(),
+                 wxS("view rectangle must be inside the image") );
 
-    if (M_IMGDATA->m_hasMask)
-        image.SetMaskColour( M_IMGDATA->m_maskRed, M_IMGDATA->m_maskGreen, M_IMGDATA->m_maskBlue );
+    m_image = image;
+    m_rect = rect;
+}
+
+const unsigned char* wxImageView::GetRowData(int y) const
+{
+    wxCHECK_MSG( IsOk(), nullptr, wxS("invalid view") );
+
+    return m_image.GetData() + (m_rect.y + y)*GetStride() + 3*m_rect.x;
+}
+
+const unsigned char* wxImageView::GetRowAlpha(int y) const
+{
+    wxCHECK_MSG( IsOk(), nullptr, wxS("invalid view") );
+
+    const unsigned char* const alpha = m_image.GetAlpha();
+    if ( !alpha )
+        return nullptr;
+
+    return alpha + (m_rect.y + y)*GetAlphaStride() + m_rect.x;
+}
+
+wxImageView wxImageView::GetSubView(const wxRect& rect) const
+{
+    wxCHECK_MSG( IsOk(), wxImageView(), wxS("invalid view") );
+
+    wxCHECK_MSG( rect.x >= 0 && rect.y >= 0 &&
+                 rect.x + rect.width <= m_rect.width &&
+                 rect.y + rect.height <= m_rect.height,
+                 wxImageView(), wxS("subview must be inside the view") );
+
+    return wxImageView(m_image, wxRect(m_rect.GetPosition() + rect.GetPosition(),
+                                       rect.GetSize()));
+}
+
+wxImage wxImageView::ToImage() const
+{
+    wxImage image;
+
+    wxCHECK_MSG( IsOk(), image, wxS("invalid view") );
 
     const int width = GetWidth();
-    const int pixsoff = rect.GetLeft() + width * rect.GetTop();
+    const int height = GetHeight();
+
+    if ( !image.Create(width, height, false) )
+        return image;
 
-    src_data += 3 * pixsoff;
-    src_alpha += pixsoff; // won't be used if was nullptr, so this is ok
+    const bool hasAlpha = HasAlpha();
+    if ( hasAlpha )
+        image.SetAlpha();
+
+    if ( m_image.HasMask() )
+    {
+        image.SetMaskColour(m_image.GetMaskRed(),
+                            m_image.GetMaskGreen(),
+                            m_image.GetMaskBlue());
+    }
 
-    for (long j = 0; j < subheight; ++j)
+    unsigned char* data = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+    for ( int y = 0; y < height; y++ )
     {
-        memcpy( subdata, src_data, 3 * subwidth );
-        subdata += 3 * subwidth;
-        src_data += 3 * width;
-        if (subalpha != nullptr) {
-            memcpy( subalpha, src_alpha, subwidth );
-            subalpha += subwidth;
-            src_alpha += width;
+        memcpy(data, GetRowData(y), 3*width);
+        data += 3*width;
+
+        if ( hasAlpha )
+        {
+            memcpy(alpha, GetRowAlpha(y), width);
+            alpha += width;
         }
     }
 
@@ -2124,49 +2536,231 @@ void wxImage::SetData( unsigned char *data, int new_width, int new_height, bool
 // alpha channel support
 // ----------------------------------------------------------------------------
 
-void wxImage::SetAlpha(int x, int y, unsigned char alpha)
-{
-    wxCHECK_RET( HasAlpha(), wxT("no alpha channel") );
+void wxImage::SetAlpha(int x, int y, unsigned char alpha)
+{
+    wxCHECK_RET( HasAlpha(), wxT("no alpha channel") );
+
+    long pos = XYToIndex(x, y);
+    wxCHECK_RET( pos != -1, wxT("invalid image coordinates") );
+
+    AllocExclusive();
+
+    M_IMGDATA->m_alpha[pos] = alpha;
+}
+
+unsigned char wxImage::GetAlpha(int x, int y) const
+{
+    wxCHECK_MSG( HasAlpha(), 0, wxT("no alpha channel") );
+
+    long pos = XYToIndex(x, y);
+    wxCHECK_MSG( pos != -1, 0, wxT("invalid image coordinates") );
+
+    return M_IMGDATA->m_alpha[pos];
+}
+
+bool
+wxImage::ConvertColourToAlpha(unsigned char r, unsigned char g, unsigned char b)
+{
+    SetAlpha(nullptr);
+
+    const int w = M_IMGDATA->m_width;
+    const int h = M_IMGDATA->m_height;
+
+    unsigned char *alpha = GetAlpha();
+    unsigned char *data = GetData();
+
+    for ( int y = 0; y < h; y++ )
+    {
+        for ( int x = 0; x < w; x++ )
+        {
+            *alpha++ = *data;
+            *data++ = r;
+            *data++ = g;
+            *data++ = b;
+        }
+    }
+
+    return true;
+}
+
+namespace
+{
+
+// Table of the colour component values corresponding to all possible
+// combinations of alpha and premultiplied component values, computing them
+// is too slow to do it for every pixel.
+class UnpremultiplyTable
+{
+public:
+    UnpremultiplyTable()
+    {
+        for ( int c = 0; c < 256; c++ )
+            m_values[0][c] = static_cast<unsigned char>(c);
+
+        for ( int a = 1; a < 256; a++ )
+        {
+            for ( int c = 0; c < 256; c++ )
+            {
+                // Premultiplied value can't be greater than alpha in valid
+                // data, but don't overflow even if it is.
+                m_values[a][c] = static_cast<unsigned char>(
+                                    wxMin((c * 0xff) / a, 0xff)
+                                 );
+            }
+        }
+    }
+
+    const unsigned char* GetRow(unsigned char alpha) const
+    {
+        return m_values[alpha];
+    }
+
+    static const UnpremultiplyTable& Get()
+    {
+        static const UnpremultiplyTable s_table;
+        return s_table;
+    }
+
+private:
+    unsigned char m_values[256][256];
+};
+
+} // anonymous namespace
+
+bool wxImage::CopyToPremultipliedARGB(unsigned char* data, int stride) const
+{
+    wxCHECK_MSG( IsOk(), false, wxS("invalid image") );
+    wxCHECK_MSG( data, false, wxS("null buffer") );
+
+    const int width = M_IMGDATA->m_width;
+    const int height = M_IMGDATA->m_height;
+
+    if ( !stride )
+        stride = 4*width;
+
+    wxCHECK_MSG( stride >= 4*width, false, wxS("invalid stride") );
+
+    const unsigned char* const src = M_IMGDATA->m_data;
+    const unsigned char* const srcAlpha = M_IMGDATA->m_alpha;
+
+    const bool hasMask = M_IMGDATA->m_hasMask;
+    const unsigned char mr = M_IMGDATA->m_maskRed;
+    const unsigned char mg = M_IMGDATA->m_maskGreen;
+    const unsigned char mb = M_IMGDATA->m_maskBlue;
+
+    ProcessInBands(height, width, [=](int start, int end)
+    {
+        for ( int y = start; y < end; y++ )
+        {
+            const size_t offset = static_cast<size_t>(y)*width;
+            const unsigned char* s = src + 3*offset;
+            const unsigned char* alpha = srcAlpha ? srcAlpha + offset : nullptr;
+
+            // We work with wxUint32 values and not bytes because the pixels
+            // are stored in native endianness.
+            wxUint32* dst = reinterpret_cast<wxUint32*>(data + static_cast<size_t>(y)*stride);
 
-    long pos = XYToIndex(x, y);
-    wxCHECK_RET( pos != -1, wxT("invalid image coordinates") );
+            for ( int x = 0; x < width; x++, s += 3 )
+            {
+                if ( hasMask && s[0] == mr && s[1] == mg && s[2] == mb )
+                {
+                    *dst++ = 0;
+                }
+                else if ( !alpha || *alpha == wxALPHA_OPAQUE )
+                {
+                    *dst++ = 0xff000000 | s[0] << 16 | s[1] << 8 | s[2];
+                }
+                else
+                {
+                    const unsigned a = *alpha;
+                    *dst++ = a << 24 |
+                             ((a * s[0]) / 255) << 16 |
+                             ((a * s[1]) / 255) <<  8 |
+                             ((a * s[2]) / 255);
+                }
 
-    AllocExclusive();
+                if ( alpha )
+                    alpha++;
+            }
+        }
+    });
 
-    M_IMGDATA->m_alpha[pos] = alpha;
+    return true;
 }
 
-unsigned char wxImage::GetAlpha(int x, int y) const
+bool wxImage::CreateFromPremultipliedARGB(int width, int height,
+                                          const unsigned char* data,
+                                          int stride,
+                                          bool hasAlpha)
 {
-    wxCHECK_MSG( HasAlpha(), 0, wxT("no alpha channel") );
+    wxCHECK_MSG( data, false, wxS("null buffer") );
 
-    long pos = XYToIndex(x, y);
-    wxCHECK_MSG( pos != -1, 0, wxT("invalid image coordinates") );
+    if ( !stride )
+        stride = 4*width;
 
-    return M_IMGDATA->m_alpha[pos];
-}
+    wxCHECK_MSG( stride >= 4*width, false, wxS("invalid stride") );
 
-bool
-wxImage::ConvertColourToAlpha(unsigned char r, unsigned char g, unsigned char b)
-{
-    SetAlpha(nullptr);
+    if ( !Create(width, height, false /* don't clear */) )
+        return false;
 
-    const int w = M_IMGDATA->m_width;
-    const int h = M_IMGDATA->m_height;
+    unsigned char* const dstData = M_IMGDATA->m_data;
+    unsigned char* dstAlpha = nullptr;
+    if ( hasAlpha )
+    {
+        SetAlpha();
+        dstAlpha = M_IMGDATA->m_alpha;
+    }
 
-    unsigned char *alpha = GetAlpha();
-    unsigned char *data = GetData();
+    const UnpremultiplyTable& table = UnpremultiplyTable::Get();
 
-    for ( int y = 0; y < h; y++ )
+    ProcessInBands(height, width, [=, &table](int start, int end)
     {
-        for ( int x = 0; x < w; x++ )
+        for ( int y = start; y < end; y++ )
         {
-            *alpha++ = *data;
-            *data++ = r;
-            *data++ = g;
-            *data++ = b;
+            const size_t offset = static_cast<size_t>(y)*width;
+            unsigned char* d = dstData + 3*offset;
+
+            const wxUint32* src = reinterpret_cast<const wxUint32*>(data + static_cast<size_t>(y)*stride);
+
+            if ( !dstAlpha )
+            {
+                for ( int x = 0; x < width; x++ )
+                {
+                    const wxUint32 argb = *src++;
+
+                    *d++ = static_cast<unsigned char>(argb >> 16);
+                    *d++ = static_cast<unsigned char>(argb >> 8);
+                    *d++ = static_cast<unsigned char>(argb);
+                }
+
+                continue;
+            }
+
+            unsigned char* alpha = dstAlpha + offset;
+            for ( int x = 0; x < width; x++ )
+            {
+                const wxUint32 argb = *src++;
+
+                const unsigned char a = static_cast<unsigned char>(argb >> 24);
+                *alpha++ = a;
+
+                if ( a == wxALPHA_OPAQUE )
+                {
+                    *d++ = static_cast<unsigned char>(argb >> 16);
+                    *d++ = static_cast<unsigned char>(argb >> 8);
+                    *d++ = static_cast<unsigned char>(argb);
+                }
+                else
+                {
+                    const unsigned char* const row = table.GetRow(a);
+
+                    *d++ = row[static_cast<unsigned char>(argb >> 16)];
+                    *d++ = row[static_cast<unsigned char>(argb >> 8)];
+                    *d++ = row[static_cast<unsigned char>(argb)];
+                }
+            }
         }
-    }
+    });
 
     return true;
 }
@@ -2563,6 +3157,20 @@ int wxImage::GetLoadFlags() const
     return M_IMGDATA ? M_IMGDATA->m_loadFlags : wxImageRefData::sm_defaultLoadFlags;
 }
 
+/* static */
+void wxImage::SetParallelism(int numThreads)
+{
+    wxCHECK_RET( numThreads >= 0, wxS("invalid number of threads") );
+
+    gs_imageParallelism = numThreads;
+}
+
+/* static */
+int wxImage::GetParallelism()
+{
+    return gs_imageParallelism;
+}
+
 // Under Windows we can load wxImage not only from files but also from
 // resources.
 #if defined(__WINDOWS__) && wxUSE_WXDIB && wxUSE_IMAGE
@@ -2863,30 +3471,23 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
     // rescale the image to the specified size if needed
     if ( maxWidth || maxHeight )
     {
-        const unsigned widthOrig = GetWidth(),
-                       heightOrig = GetHeight();
+        const wxSize sizeLoaded = GetSize();
 
-        // this uses the same (trivial) algorithm as the JPEG handler
-        unsigned width = widthOrig,
-                 height = heightOrig;
-        while ( (maxWidth && width > maxWidth) ||
-                    (maxHeight && height > maxHeight) )
-        {
-            width /= 2;
-            height /= 2;
-        }
+        // the handler may have already scaled the image down (but possibly
+        // not enough), in which case it sets the original size option
+        wxSize sizeOrig(GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH),
+                        GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT));
+        if ( !sizeOrig.x || !sizeOrig.y )
+            sizeOrig = sizeLoaded;
 
-        if ( width != widthOrig || height != heightOrig )
+        const wxSize size = wxGetImageSizeToFit(sizeOrig, maxWidth, maxHeight);
+        if ( size != sizeLoaded )
         {
-            // get the original size if it was set by the image handler
-            // but also in order to restore it after Rescale
-            int widthOrigOption = GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH),
-                heightOrigOption = GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT);
+            Rescale(size.x, size.y, wxIMAGE_QUALITY_HIGH);
 
-            Rescale(width, height, wxIMAGE_QUALITY_HIGH);
-
-            SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, widthOrigOption ? widthOrigOption : widthOrig);
-            SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, heightOrigOption ? heightOrigOption : heightOrig);
+            // set the original size, also in order to restore it after Rescale
+            SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, sizeOrig.x);
+            SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, sizeOrig.y);
         }
     }
 
@@ -2994,6 +3595,78 @@ bool wxImage::LoadFile( wxInputStream& stream, const wxString& mimetype, int ind
     return DoLoad(*handler, stream, index);
 }
 
+bool wxImage::LoadRows( wxInputStream& stream, wxImageRowSink& sink,
+                        wxBitmapType type, int index )
+{
+    AllocExclusive();
+
+    wxImageHandler *handler = nullptr;
+
+    // do we issue warning/error messages?
+    const bool verbose = M_IMGDATA->m_loadFlags & Load_Verbose;
+
+    if ( type == wxBITMAP_TYPE_ANY )
+    {
+        if ( !stream.IsSeekable() )
+        {
+            if ( verbose )
+            {
+                wxLogError(_("Can't automatically determine the image format "
+                             "for non-seekable input."));
+            }
+            return false;
+        }
+
+        // Unlike in LoadFile(), we can't try the next handler if loading
+        // fails as the sink could have already received some rows, so just
+        // use the first one which can read this stream.
+        const wxList& list = GetHandlers();
+        for ( wxList::compatibility_iterator node = list.GetFirst();
+              node;
+              node = node->GetNext() )
+        {
+            wxImageHandler* const h = (wxImageHandler*)node->GetData();
+            if ( h->CanRead(stream) )
+            {
+                handler = h;
+                break;
+            }
+        }
+
+        if ( !handler )
+        {
+            if ( verbose )
+            {
+                wxLogWarning( _("Unknown image data format.") );
+            }
+            return false;
+        }
+    }
+    else
+    {
+        handler = FindHandler(type);
+        if ( !handler )
+        {
+            if ( verbose )
+            {
+                wxLogWarning( _("No image handler for type %d defined."), type );
+            }
+            return false;
+        }
+
+        if ( stream.IsSeekable() && !handler->CanRead(stream) )
+        {
+            if ( verbose )
+            {
+                wxLogError(_("This is not a %s."), handler->GetName());
+            }
+            return false;
+        }
+    }
+
+    return handler->LoadRows(this, stream, sink, verbose, index);
+}
+
 bool wxImage::DoSave(wxImageHandler& handler, wxOutputStream& stream) const
 {
     wxImage * const self = const_cast<wxImage *>(this);
@@ -3468,6 +4141,93 @@ bool wxImageHandler::CallDoCanRead(wxInputStream& stream)
             .CallIfCanSeek(&wxImageHandler::DoCanRead, this);
 }
 
+bool wxImageHandler::LoadRows(wxImage *image,
+                              wxInputStream& stream,
+                              wxImageRowSink& sink,
+                              bool verbose,
+                              int index)
+{
+    wxCHECK_MSG( image, false, wxS("null image pointer") );
+
+    if ( !LoadFile(image, stream, verbose, index) )
+        return false;
+
+    const int height = image->GetHeight();
+
+    return sink.OnStart(image->GetWidth(), height, image->HasAlpha()) &&
+            sink.OnRows(0, height, image->GetData(), image->GetAlpha());
+}
+
+wxSize wxGetImageSizeToFit(const wxSize& size,
+                           unsigned maxWidth,
+                           unsigned maxHeight)
+{
+    const wxUint64 width = size.x,
+                   height = size.y;
+
+    if ( (!maxWidth || width <= maxWidth) && (!maxHeight || height <= maxHeight) )
+        return size;
+
+    // Check which dimension limits the size, i.e. compare maxWidth/width
+    // with maxHeight/height, and scale the other one proportionally,
+    // rounding the result (which can't exceed the other limit then).
+    if ( maxWidth && (!maxHeight || maxWidth*height <= maxHeight*width) )
+    {
+        const int h = static_cast<int>((height*maxWidth + width/2) / width);
+        return wxSize(maxWidth, wxMax(h, 1));
+    }
+    else
+    {
+        const int w = static_cast<int>((width*maxHeight + height/2) / height);
+        return wxSize(wxMax(w, 1), maxHeight);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// wxImageStoringRowSink
+// ----------------------------------------------------------------------------
+
+bool wxImageStoringRowSink::OnStart(int width, int height, bool WXUNUSED(hasAlpha))
+{
+    // Don't initialize the pixels, they will all be overwritten by OnRows().
+    return m_image.Create(width, height, false);
+}
+
+bool wxImageStoringRowSink::OnRows(int y, int count,
+                                   const unsigned char* data,
+                                   const unsigned char* alpha)
+{
+    const size_t width = m_image.GetWidth();
+    const size_t numPixels = width*count;
+
+    memcpy(m_image.GetData() + 3*width*y, data, 3*numPixels);
+
+    if ( alpha )
+    {
+        unsigned char* dst = m_image.GetAlpha();
+        if ( !dst )
+        {
+            // Don't create alpha channel as long as all pixels are opaque.
+            size_t n = 0;
+            while ( n < numPixels && alpha[n] == wxIMAGE_ALPHA_OPAQUE )
+                n++;
+
+            if ( n == numPixels )
+                return true;
+
+            // All the rows passed to us previously were opaque and the
+            // remaining ones will be overwritten later anyhow.
+            m_image.SetAlpha();
+            dst = m_image.GetAlpha();
+            memset(dst, wxIMAGE_ALPHA_OPAQUE, width*m_image.GetHeight());
+        }
+
+        memcpy(dst + width*y, alpha, numPixels);
+    }
+
+    return true;
+}
+
 #endif // wxUSE_STREAMS
 
 /* static */
@@ -3678,11 +4438,11 @@ wxImage wxImage::Rotate(double angle,
         *offset_after_rotation = wxPoint (x1a, y1a);
     }
 
-    // the rotated (destination) image is always accessed sequentially via this
-    // pointer, there is no need for pointer-based arrays here
-    unsigned char *dst = rotated.GetData();
+    // the rotated (destination) image is always accessed sequentially, there
+    // is no need for pointer-based arrays here
+    unsigned char * const dst_data = rotated.GetData();
 
-    unsigned char *alpha_dst = has_alpha ? rotated.GetAlpha() : nullptr;
+    unsigned char * const dst_alpha = has_alpha ? rotated.GetAlpha() : nullptr;
 
     // if the original image has a mask, use its RGB values as the blank pixel,
     // else, fall back to default (black).
@@ -3709,183 +4469,199 @@ wxImage wxImage::Rotate(double angle,
     // only once, instead of repeating it for each pixel.
     if (interpolating)
     {
-        for (int y = 0; y < rH; y++)
+        ProcessInBands(rH, rW, [&](int start, int end)
         {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+            unsigned char *dst = dst_data + static_cast<size_t>(start) * rW * 3;
+            unsigned char *alpha_dst = has_alpha
+                                        ? dst_alpha + static_cast<size_t>(start) * rW
+                                        : nullptr;
 
-                if (-0.25 < src.x && src.x < w - 0.75 &&
-                    -0.25 < src.y && src.y < h - 0.75)
+            for (int y = start; y < end; y++)
+            {
+                for (int x = 0; x < rW; x++)
                 {
-                    // interpolate using the 4 enclosing grid-points.  Those
-                    // points can be obtained using floor and ceiling of the
-                    // exact coordinates of the point
-                    int x1, y1, x2, y2;
+                    wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
 
-                    if (0 < src.x && src.x < w - 1)
+                    if (-0.25 < src.x && src.x < w - 0.75 &&
+                        -0.25 < src.y && src.y < h - 0.75)
                     {
-                        x1 = (int) floor(src.x);
-                        x2 = (int) ceil(src.x);
-                    }
-                    else    // else means that x is near one of the borders (0 or width-1)
-                    {
-                        x1 = x2 = wxRound (src.x);
-                    }
+                        // interpolate using the 4 enclosing grid-points.  Those
+                        // points can be obtained using floor and ceiling of the
+                        // exact coordinates of the point
+                        int x1, y1, x2, y2;
 
-                    if (0 < src.y && src.y < h - 1)
-                    {
-                        y1 = (int) floor(src.y);
-                        y2 = (int) ceil(src.y);
-                    }
-                    else
-                    {
-                        y1 = y2 = wxRound (src.y);
-                    }
+                        if (0 < src.x && src.x < w - 1)
+                        {
+                            x1 = (int) floor(src.x);
+                            x2 = (int) ceil(src.x);
+                        }
+                        else    // else means that x is near one of the borders (0 or width-1)
+                        {
+                            x1 = x2 = wxRound (src.x);
+                        }
 
-                    // get four points and the distances (square of the distance,
-                    // for efficiency reasons) for the interpolation formula
+                        if (0 < src.y && src.y < h - 1)
+                        {
+                            y1 = (int) floor(src.y);
+                            y2 = (int) ceil(src.y);
+                        }
+                        else
+                        {
+                            y1 = y2 = wxRound (src.y);
+                        }
 
-                    // GRG: Do not calculate the points until they are
-                    //      really needed -- this way we can calculate
-                    //      just one, instead of four, if d1, d2, d3
-                    //      or d4 are < wxROTATE_EPSILON
+                        // get four points and the distances (square of the distance,
+                        // for efficiency reasons) for the interpolation formula
 
-                    const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
-                    const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
-                    const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
-                    const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
+                        // GRG: Do not calculate the points until they are
+                        //      really needed -- this way we can calculate
+                        //      just one, instead of four, if d1, d2, d3
+                        //      or d4 are < wxROTATE_EPSILON
 
-                    // Now interpolate as a weighted average of the four surrounding
-                    // points, where the weights are the distances to each of those points
+                        const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
+                        const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
+                        const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
+                        const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
 
-                    // If the point is exactly at one point of the grid of the source
-                    // image, then don't interpolate -- just assign the pixel
+                        // Now interpolate as a weighted average of the four surrounding
+                        // points, where the weights are the distances to each of those points
 
-                    // d1,d2,d3,d4 are positive -- no need for abs()
-                    if (d1 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        // If the point is exactly at one point of the grid of the source
+                        // image, then don't interpolate -- just assign the pixel
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x1);
-                    }
-                    else if (d2 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        // d1,d2,d3,d4 are positive -- no need for abs()
+                        if (d1 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y1] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x2);
-                    }
-                    else if (d3 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y1] + x1);
+                        }
+                        else if (d2 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y1] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x2);
-                    }
-                    else if (d4 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y1] + x2);
+                        }
+                        else if (d3 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y2] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x1);
-                    }
-                    else
-                    {
-                        // weights for the weighted average are proportional to the inverse of the distance
-                        unsigned char *v1 = data[y1] + (3 * x1);
-                        unsigned char *v2 = data[y1] + (3 * x2);
-                        unsigned char *v3 = data[y2] + (3 * x2);
-                        unsigned char *v4 = data[y2] + (3 * x1);
-
-                        const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
-
-                        // GRG: Unrolled.
-
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *v1 + w2 * *v2 +
-                               w3 * *v3 + w4 * *v4) /
-                              (w1 + w2 + w3 + w4) );
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y2] + x2);
+                        }
+                        else if (d4 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y2] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y2] + x1);
+                        }
+                        else
                         {
-                            v1 = alpha[y1] + (x1);
-                            v2 = alpha[y1] + (x2);
-                            v3 = alpha[y2] + (x2);
-                            v4 = alpha[y2] + (x1);
+                            // weights for the weighted average are proportional to the inverse of the distance
+                            unsigned char *v1 = data[y1] + (3 * x1);
+                            unsigned char *v2 = data[y1] + (3 * x2);
+                            unsigned char *v3 = data[y2] + (3 * x2);
+                            unsigned char *v4 = data[y2] + (3 * x1);
+
+                            const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
 
-                            *(alpha_dst++) = (unsigned char)
+                            // GRG: Unrolled.
+
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
                                 ( (w1 * *v1 + w2 * *v2 +
                                    w3 * *v3 + w4 * *v4) /
                                   (w1 + w2 + w3 + w4) );
+
+                            if (has_alpha)
+                            {
+                                v1 = alpha[y1] + (x1);
+                                v2 = alpha[y1] + (x2);
+                                v3 = alpha[y2] + (x2);
+                                v4 = alpha[y2] + (x1);
+
+                                *(alpha_dst++) = (unsigned char)
+                                    ( (w1 * *v1 + w2 * *v2 +
+                                       w3 * *v3 + w4 * *v4) /
+                                      (w1 + w2 + w3 + w4) );
+                            }
                         }
                     }
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+                    else
+                    {
+                        *(dst++) = blank_r;
+                        *(dst++) = blank_g;
+                        *(dst++) = blank_b;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = 0;
+                        if (has_alpha)
+                            *(alpha_dst++) = 0;
+                    }
                 }
             }
-        }
+        });
     }
     else // not interpolating
     {
-        for (int y = 0; y < rH; y++)
+        ProcessInBands(rH, rW, [&](int start, int end)
         {
-            for (int x = 0; x < rW; x++)
+            unsigned char *dst = dst_data + static_cast<size_t>(start) * rW * 3;
+            unsigned char *alpha_dst = has_alpha
+                                        ? dst_alpha + static_cast<size_t>(start) * rW
+                                        : nullptr;
+
+            for (int y = start; y < end; y++)
             {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+                for (int x = 0; x < rW; x++)
+                {
+                    wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
 
-                const int xs = wxRound (src.x);      // wxRound rounds to the
-                const int ys = wxRound (src.y);      // closest integer
+                    const int xs = wxRound (src.x);      // wxRound rounds to the
+                    const int ys = wxRound (src.y);      // closest integer
 
-                if (0 <= xs && xs < w && 0 <= ys && ys < h)
-                {
-                    unsigned char *p = data[ys] + (3 * xs);
-                    *(dst++) = *(p++);
-                    *(dst++) = *(p++);
-                    *(dst++) = *p;
+                    if (0 <= xs && xs < w && 0 <= ys && ys < h)
+                    {
+                        unsigned char *p = data[ys] + (3 * xs);
+                        *(dst++) = *(p++);
+                        *(dst++) = *(p++);
+                        *(dst++) = *p;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = *(alpha[ys] + (xs));
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+                        if (has_alpha)
+                            *(alpha_dst++) = *(alpha[ys] + (xs));
+                    }
+                    else
+                    {
+                        *(dst++) = blank_r;
+                        *(dst++) = blank_g;
+                        *(dst++) = blank_b;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = 255;
+                        if (has_alpha)
+                            *(alpha_dst++) = 255;
+                    }
                 }
             }
-        }
+        });
     }
 
     delete [] data;
@@ -3900,13 +4676,19 @@ void wxImage::ApplyToAllPixels(const F& func)
 {
     AllocExclusive();
 
-    const size_t size = GetWidth() * GetHeight();
-    unsigned char *data = GetData();
+    const int width = GetWidth();
+    unsigned char * const data = GetData();
 
-    for ( size_t i = 0; i < size; i++, data += 3 )
+    ProcessInBands(GetHeight(), width, [=, &func](int start, int end)
     {
-        func(data);
-    }
+        const size_t size = static_cast<size_t>(end - start) * width;
+        unsigned char *p = data + static_cast<size_t>(start) * width * 3;
+
+        for ( size_t i = 0; i < size; i++, p += 3 )
+        {
+            func(p);
+        }
+    });
 }
 
 // A module to allow wxImage initialization/cleanup
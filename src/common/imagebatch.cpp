@@ -0,0 +1,468 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/imagebatch.cpp
+// Purpose:     wxImageBatchLoader implementation
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#if wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS && wxUSE_FILE
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+#endif // WX_PRECOMP
+
+#include "wx/imagebatch.h"
+#include "wx/wfstream.h"
+
+#include "wx/private/threadpool.h"
+
+#include <deque>
+#include <memory>
+
+wxDEFINE_EVENT(wxEVT_IMAGE_BATCH_LOADED, wxImageBatchEvent);
+wxDEFINE_EVENT(wxEVT_IMAGE_BATCH_COMPLETED, wxImageBatchEvent);
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxImageBatchEvent, wxEvent);
+
+namespace
+{
+
+// Default maximal number of pending images per thread.
+const size_t DEFAULT_PENDING_PER_THREAD = 2;
+
+// ----------------------------------------------------------------------------
+// wxImageBatchHandlers: image handlers used by a single worker
+// ----------------------------------------------------------------------------
+
+// The global image handlers are not meant to be used from several threads at
+// once, so each worker uses its own copies of them. These copies must be
+// created in the main thread, as the handlers list is not protected in any
+// way.
+class wxImageBatchHandlers
+{
+public:
+    wxImageBatchHandlers()
+    {
+        const wxList& list = wxImage::GetHandlers();
+        for ( wxList::compatibility_iterator node = list.GetFirst();
+              node;
+              node = node->GetNext() )
+        {
+            wxImageHandler* const handler =
+                static_cast<wxImageHandler*>(node->GetData());
+
+            // Check that the copy is really of the same type: this is not
+            // the case for handlers not using wxDECLARE_DYNAMIC_CLASS() but
+            // deriving from a class using it. Such handlers have to be
+            // shared, there is nothing else we can do with them.
+            wxObject* const obj = handler->GetClassInfo()->CreateObject();
+            wxImageHandler* const copy = wxDynamicCast(obj, wxImageHandler);
+            if ( copy &&
+                    copy->GetType() == handler->GetType() &&
+                        copy->GetName() == handler->GetName() )
+            {
+                m_owned.push_back(copy);
+                m_handlers.push_back(copy);
+            }
+            else
+            {
+                delete obj;
+                m_handlers.push_back(handler);
+            }
+        }
+    }
+
+    ~wxImageBatchHandlers()
+    {
+        for ( size_t n = 0; n < m_owned.size(); n++ )
+            delete m_owned[n];
+    }
+
+    const wxVector<wxImageHandler*>& Get() const { return m_handlers; }
+
+private:
+    // All handlers in the same order as in the global list.
+    wxVector<wxImageHandler*> m_handlers;
+
+    // Handlers owned by this object.
+    wxVector<wxImageHandler*> m_owned;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageBatchHandlers);
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxImageBatchLoaderImpl: the real implementation of wxImageBatchLoader
+// ----------------------------------------------------------------------------
+
+class wxImageBatchLoaderImpl
+{
+public:
+    wxImageBatchLoaderImpl(wxEvtHandler* handler, int id, int maxThreads)
+        : m_handler(handler),
+          m_id(id),
+          m_pool(maxThreads),
+          m_condition(m_mutex),
+          m_maxPending(0),
+          m_maxWidth(0),
+          m_maxHeight(0),
+          m_nextIndex(0),
+          m_inFlight(0),
+          m_inFlightCurrent(0),
+          m_numWorkers(0),
+          m_generation(0),
+          m_stopping(false)
+    {
+    }
+
+    ~wxImageBatchLoaderImpl()
+    {
+        {
+            wxMutexLocker lock(m_mutex);
+
+            m_stopping = true;
+            m_items.clear();
+
+            m_condition.Broadcast();
+        }
+
+        // Wait until all workers exit: the results of the images loaded in
+        // the meanwhile are discarded together with m_dispatcher.
+        m_pool.Shutdown();
+    }
+
+    void SetMaxPending(size_t maxPending)
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_maxPending = maxPending;
+
+        m_condition.Broadcast();
+    }
+
+    void SetMaxSize(int maxWidth, int maxHeight)
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_maxWidth = maxWidth;
+        m_maxHeight = maxHeight;
+    }
+
+    size_t Add(const wxString& fileName, wxBitmapType type)
+    {
+        wxASSERT_MSG( wxThread::IsMain(),
+                      wxS("must be called from the main thread") );
+
+        size_t index;
+        bool startWorker = false;
+        {
+            wxMutexLocker lock(m_mutex);
+
+            index = m_nextIndex++;
+
+            Item item;
+            item.index = index;
+            item.fileName = fileName;
+            item.type = type;
+            m_items.push_back(item);
+
+            if ( m_numWorkers < m_pool.GetMaxThreads() )
+            {
+                m_numWorkers++;
+                startWorker = true;
+            }
+        }
+
+        // Note that this must be done without holding the lock, as the task
+        // is executed synchronously if no threads can be created.
+        if ( startWorker )
+        {
+            std::shared_ptr<wxImageBatchHandlers>
+                handlers(new wxImageBatchHandlers());
+
+            m_pool.Post([this, handlers]() { DoWork(*handlers); });
+        }
+
+        return index;
+    }
+
+    void Cancel()
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_items.clear();
+
+        // The images being loaded now won't be delivered to the handler.
+        m_generation++;
+        m_inFlightCurrent = 0;
+
+        m_condition.Broadcast();
+    }
+
+    size_t GetPendingCount() const
+    {
+        wxMutexLocker lock(m_mutex);
+
+        return m_items.size() + m_inFlightCurrent;
+    }
+
+private:
+    struct Item
+    {
+        size_t index;
+        wxString fileName;
+        wxBitmapType type;
+    };
+
+    size_t GetMaxPending() const
+    {
+        return m_maxPending ? m_maxPending
+                            : DEFAULT_PENDING_PER_THREAD*m_pool.GetMaxThreads();
+    }
+
+    // Function executed by the worker threads: loads the images until there
+    // are no more of them.
+    void DoWork(const wxImageBatchHandlers& handlers)
+    {
+        // Don't show any errors from the worker threads, failing to load the
+        // image is reported by the event anyhow.
+        wxLogNull noLog;
+
+        for ( ;; )
+        {
+            Item item;
+            int maxWidth,
+                maxHeight;
+            unsigned generation;
+            {
+                wxMutexLocker lock(m_mutex);
+
+                // Wait until the main thread handles some of the already
+                // loaded images to avoid using too much memory. This can't be
+                // done if we're executed by the main thread itself, which only
+                // happens if creating the threads failed.
+                if ( !wxThread::IsMain() )
+                {
+                    while ( !m_stopping && !m_items.empty() &&
+                                m_inFlight >= GetMaxPending() )
+                        m_condition.Wait();
+                }
+
+                if ( m_stopping || m_items.empty() )
+                {
+                    m_numWorkers--;
+                    return;
+                }
+
+                item = m_items.front();
+                m_items.pop_front();
+
+                m_inFlight++;
+                m_inFlightCurrent++;
+
+                maxWidth = m_maxWidth;
+                maxHeight = m_maxHeight;
+                generation = m_generation;
+            }
+
+            wxImage image = LoadImage(handlers, item, maxWidth, maxHeight);
+
+            std::shared_ptr<wxImageBatchEvent>
+                event(new wxImageBatchEvent(wxEVT_IMAGE_BATCH_LOADED, m_id,
+                                            item.index, item.fileName, image));
+
+            // The image reference count is not atomic, so we must not keep
+            // any references to it once the event is sent to the main thread.
+            image = wxImage();
+
+            m_dispatcher.CallAfter([this, event, generation]()
+            {
+                OnLoaded(*event, generation);
+            });
+        }
+    }
+
+    wxImage LoadImage(const wxImageBatchHandlers& handlers,
+                      const Item& item,
+                      int maxWidth,
+                      int maxHeight) const
+    {
+        wxFileInputStream stream(item.fileName);
+        if ( !stream.IsOk() )
+            return wxImage();
+
+        const wxVector<wxImageHandler*>& list = handlers.Get();
+        for ( size_t n = 0; n < list.size(); n++ )
+        {
+            wxImageHandler& handler = *list[n];
+
+            if ( item.type == wxBITMAP_TYPE_ANY )
+            {
+                if ( !handler.CanRead(stream) )
+                    continue;
+            }
+            else if ( handler.GetType() != item.type )
+            {
+                continue;
+            }
+
+            // Set the options before each attempt, as the handlers can reset
+            // them when they fail.
+            wxImage image;
+            image.SetLoadFlags(image.GetLoadFlags() & ~wxImage::Load_Verbose);
+            if ( maxWidth )
+                image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, maxWidth);
+            if ( maxHeight )
+                image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, maxHeight);
+
+            if ( image.DoLoad(handler, stream, -1) )
+                return image;
+
+            if ( item.type != wxBITMAP_TYPE_ANY )
+                break;
+        }
+
+        return wxImage();
+    }
+
+    // Called in the main thread for each loaded image.
+    void OnLoaded(wxImageBatchEvent& event, unsigned generation)
+    {
+        bool isCurrent;
+        {
+            wxMutexLocker lock(m_mutex);
+            isCurrent = generation == m_generation;
+        }
+
+        if ( isCurrent )
+            m_handler->SafelyProcessEvent(event);
+
+        // Only now allow the workers to continue loading, as the handler
+        // might still have been using the image until now.
+        bool completed;
+        {
+            wxMutexLocker lock(m_mutex);
+
+            m_inFlight--;
+            m_condition.Broadcast();
+
+            // The images loaded before the last Cancel() call are not taken
+            // into account here: the batch is completed even if some of them
+            // are still being loaded.
+            if ( isCurrent )
+                m_inFlightCurrent--;
+
+            completed = isCurrent && m_items.empty() && !m_inFlightCurrent;
+        }
+
+        if ( completed )
+        {
+            wxImageBatchEvent eventCompleted(wxEVT_IMAGE_BATCH_COMPLETED, m_id);
+            m_handler->SafelyProcessEvent(eventCompleted);
+        }
+    }
+
+
+    wxEvtHandler* const m_handler;
+    const int m_id;
+
+    // Used to execute OnLoaded() in the main thread, must be declared before
+    // m_pool to ensure that it is still alive while the workers are running.
+    wxEvtHandler m_dispatcher;
+
+    wxThreadPool m_pool;
+
+    // Protects all the fields below.
+    mutable wxMutex m_mutex;
+
+    // Signalled when the items are removed, m_inFlight decreases or we're
+    // stopping.
+    wxCondition m_condition;
+
+    // Files which haven't been loaded yet.
+    std::deque<Item> m_items;
+
+    size_t m_maxPending;
+    int m_maxWidth,
+        m_maxHeight;
+
+    // Index of the next file to be added.
+    size_t m_nextIndex;
+
+    // Number of images being loaded or loaded but not delivered yet.
+    size_t m_inFlight;
+
+    // Part of m_inFlight added since the last call to Cancel().
+    size_t m_inFlightCurrent;
+
+    // Number of currently running DoWork() calls.
+    int m_numWorkers;
+
+    // Incremented by Cancel() to ignore the previously loaded images.
+    unsigned m_generation;
+
+    // Set when the loader is being destroyed.
+    bool m_stopping;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageBatchLoaderImpl);
+};
+
+// ============================================================================
+// wxImageBatchLoader implementation
+// ============================================================================
+
+wxImageBatchLoader::wxImageBatchLoader(wxEvtHandler* handler,
+                                       int id,
+                                       int maxThreads)
+    : m_impl(new wxImageBatchLoaderImpl(handler, id, maxThreads))
+{
+    wxASSERT_MSG( handler, wxS("must have a valid event handler") );
+}
+
+wxImageBatchLoader::~wxImageBatchLoader()
+{
+    delete m_impl;
+}
+
+void wxImageBatchLoader::SetMaxPending(size_t maxPending)
+{
+    m_impl->SetMaxPending(maxPending);
+}
+
+void wxImageBatchLoader::SetMaxSize(int maxWidth, int maxHeight)
+{
+    wxCHECK_RET( maxWidth >= 0 && maxHeight >= 0, wxS("invalid size") );
+
+    m_impl->SetMaxSize(maxWidth, maxHeight);
+}
+
+size_t wxImageBatchLoader::Add(const wxString& fileName, wxBitmapType type)
+{
+    return m_impl->Add(fileName, type);
+}
+
+void wxImageBatchLoader::Cancel()
+{
+    m_impl->Cancel();
+}
+
+size_t wxImageBatchLoader::GetPendingCount() const
+{
+    return m_impl->GetPendingCount();
+}
+
+#endif // wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS && wxUSE_FILE
@@ -39,6 +39,8 @@
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 
+#include "wx/private/image.h"
+
 // For memcpy
 #include <string.h>
 // For JPEG library error handling
@@ -229,13 +231,22 @@ static inline void wx_cmyk_to_rgb(unsigned char* rgb, const unsigned char* cmyk)
     #pragma warning(disable:4611)
 #endif /* VC++ */
 
-bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int WXUNUSED(index) )
+bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
+{
+    wxCHECK_MSG( image, false, "null image pointer" );
+
+    wxImageStoringRowSink sink(*image);
+    return LoadRows( image, stream, sink, verbose, index );
+}
+
+bool wxJPEGHandler::LoadRows( wxImage *image, wxInputStream& stream,
+                              wxImageRowSink& sink,
+                              bool verbose, int WXUNUSED(index) )
 {
     wxCHECK_MSG( image, false, "null image pointer" );
 
     struct jpeg_decompress_struct cinfo;
     wx_error_mgr jerr;
-    unsigned char *ptr;
 
     // save this before calling Destroy()
     const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
@@ -282,39 +293,60 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     // scale the picture to fit in the specified max size if necessary
     if ( maxWidth > 0 || maxHeight > 0 )
     {
-        unsigned& scale = cinfo.scale_denom;
-        while ( (maxWidth && (cinfo.image_width / scale > maxWidth)) ||
-                    (maxHeight && (cinfo.image_height / scale > maxHeight)) )
+        const wxSize size = wxGetImageSizeToFit(wxSize(cinfo.image_width,
+                                                       cinfo.image_height),
+                                                maxWidth, maxHeight);
+
+        // libjpeg can only scale the image by N/8 during decoding (and its
+        // older versions only support N = 1, 2 or 4, using the next bigger
+        // supported factor for the other values), so choose the smallest
+        // factor giving the image at least as big as needed: wxImage will
+        // then rescale it to the exact size, which is much faster than
+        // rescaling the full image.
+        cinfo.scale_num = 8;
+        cinfo.scale_denom = 8;
+        for ( unsigned n = 1; n < 8; n++ )
         {
-            scale *= 2;
+            if ( (cinfo.image_width*n + 7) / 8 >= (unsigned)size.x &&
+                    (cinfo.image_height*n + 7) / 8 >= (unsigned)size.y )
+            {
+                cinfo.scale_num = n;
+                break;
+            }
         }
     }
 
     jpeg_start_decompress( &cinfo );
 
-    image->Create( cinfo.output_width, cinfo.output_height );
-    if (!image->IsOk()) {
-        jpeg_finish_decompress( &cinfo );
+    if ( !sink.OnStart(cinfo.output_width, cinfo.output_height, false) )
+    {
+        // Note that we can't call jpeg_finish_decompress() here, as not all
+        // the scanlines have been read, so abort decompression instead.
+        (cinfo.src->term_source)(&cinfo);
         jpeg_destroy_decompress( &cinfo );
+        if (image->IsOk()) image->Destroy();
         return false;
     }
-    image->SetMask( false );
-    ptr = image->GetData();
 
     unsigned stride = cinfo.output_width * bytesPerPixel;
     JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
                             ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
 
+    // buffer for converting CMYK data to RGB, if needed
+    JSAMPARRAY rgbbuf = cinfo.out_color_space == JCS_RGB
+                            ? tempbuf
+                            : (*cinfo.mem->alloc_sarray)
+                                ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                                 cinfo.output_width * 3, 1 );
+
     while ( cinfo.output_scanline < cinfo.output_height )
     {
+        const int y = cinfo.output_scanline;
+
         jpeg_read_scanlines( &cinfo, tempbuf, 1 );
-        if (cinfo.out_color_space == JCS_RGB)
-        {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
-        }
-        else // CMYK
+        if (cinfo.out_color_space != JCS_RGB) // CMYK
         {
+            unsigned char* ptr = (unsigned char*) rgbbuf[0];
             const unsigned char* inptr = (const unsigned char*) tempbuf[0];
             for (size_t i = 0; i < cinfo.output_width; i++)
             {
@@ -323,6 +355,14 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
                 inptr += 4;
             }
         }
+
+        if ( !sink.OnRows(y, 1, (const unsigned char*) rgbbuf[0], nullptr) )
+        {
+            (cinfo.src->term_source)(&cinfo);
+            jpeg_destroy_decompress( &cinfo );
+            if (image->IsOk()) image->Destroy();
+            return false;
+        }
     }
 
     // set up resolution if available: it's part of optional JFIF APP0 chunk
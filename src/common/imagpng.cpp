@@ -23,30 +23,31 @@
 #include "wx/imagpng.h"
 #include "wx/versioninfo.h"
 
+#include "wx/private/image.h"
+#include "wx/private/threadpool.h"
+
 #ifndef WX_PRECOMP
     #include "wx/log.h"
     #include "wx/intl.h"
     #include "wx/palette.h"
     #include "wx/stream.h"
+    #include "wx/utils.h"
 #endif
 
 #include "png.h"
 
+// See the comment in src/common/zstream.cpp about this.
+#if defined(__WINDOWS__) && !defined(__WX_SETUP_H__) && !defined(wxUSE_ZLIB_H_IN_PATH)
+    #include "../zlib/zlib.h"
+#else
+    #include "zlib.h"
+#endif
+
 // For memcpy
 #include <string.h>
 
 #include <unordered_map>
-
-// ----------------------------------------------------------------------------
-// local functions
-// ----------------------------------------------------------------------------
-
-// is the pixel with this value of alpha a fully opaque one?
-static inline
-bool IsOpaque(unsigned char a)
-{
-    return a == 0xff;
-}
+#include <vector>
 
 // ============================================================================
 // wxPNGHandler implementation
@@ -107,40 +108,48 @@ struct wxPNGImageData
     {
         lines = nullptr;
         m_buf = nullptr;
+        m_rowBuf = nullptr;
         info_ptr = (png_infop) nullptr;
         png_ptr = (png_structp) nullptr;
         ok = false;
+        cancelled = false;
     }
 
-    bool Alloc(png_uint_32 width, png_uint_32 height, unsigned char* buf)
+    // Allocate the buffer for the given number of lines, which is either 1
+    // or, for the interlaced images, all of them, and, if the image has
+    // alpha, the buffer for splitting the RGBA data into RGB and alpha.
+    bool Alloc(png_uint_32 width, png_uint_32 numLines, bool hasAlpha)
     {
-        lines = (unsigned char **)malloc(height * sizeof(unsigned char *));
+        lines = (unsigned char **)malloc(numLines * sizeof(unsigned char *));
         if ( !lines )
             return false;
 
-        size_t w = width;
-        // if RGB data will be written directly to wxImage buffer
-        if (buf)
-            w *= 3;
-        else
+        const size_t w = width * (hasAlpha ? 4 : 3);
+
+        // Interlaced images rows are passed to the sink before all their
+        // pixels are decoded, so ensure they don't contain garbage.
+        m_buf = static_cast<unsigned char*>(numLines > 1 ? calloc(numLines, w)
+                                                         : malloc(w));
+        if (!m_buf)
+            return false;
+
+        lines[0] = m_buf;
+        for (png_uint_32 i = 1; i < numLines; i++)
+            lines[i] = lines[i - 1] + w;
+
+        if ( hasAlpha )
         {
-            // allocate intermediate RGBA buffer
-            w *= 4;
-            buf =
-            m_buf = static_cast<unsigned char*>(malloc(w * height));
-            if (!m_buf)
+            m_rowBuf = static_cast<unsigned char*>(malloc(width * 4));
+            if ( !m_rowBuf )
                 return false;
         }
 
-        lines[0] = buf;
-        for (png_uint_32 i = 1; i < height; i++)
-            lines[i] = lines[i - 1] + w;
-
         return true;
     }
 
     ~wxPNGImageData()
     {
+        free(m_rowBuf);
         free(m_buf);
         free( lines );
 
@@ -153,13 +162,25 @@ struct wxPNGImageData
         }
     }
 
-    void DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo);
+    void DoLoadPNGFile(wxImage* image,
+                       wxImageRowSink& sink,
+                       wxPNGInfoStruct& wxinfo);
+
+    // Pass the given row, in RGB or RGBA format, to the sink.
+    bool PutRow(wxImageRowSink& sink,
+                png_uint_32 y,
+                const unsigned char* line,
+                png_uint_32 width);
 
     unsigned char** lines;
     unsigned char* m_buf;
+    unsigned char* m_rowBuf;
     png_infop info_ptr;
     png_structp png_ptr;
     bool ok;
+
+    // Set if loading failed because the sink asked to stop it.
+    bool cancelled;
 };
 
 } // anonymous namespace
@@ -212,21 +233,27 @@ PNGLINKAGEMODE wx_PNG_error(png_structp png_ptr, png_const_charp message)
 // LoadFile() helpers
 // ----------------------------------------------------------------------------
 
-// init the alpha channel for the image and fill it with 1s up to (x, y)
-static
-unsigned char *InitAlpha(wxImage *image, png_uint_32 x, png_uint_32 y)
+bool
+wxPNGImageData::PutRow(wxImageRowSink& sink,
+                       png_uint_32 y,
+                       const unsigned char* line,
+                       png_uint_32 width)
 {
-    // create alpha channel
-    image->SetAlpha();
-
-    unsigned char *alpha = image->GetAlpha();
+    if ( !m_rowBuf )
+        return sink.OnRows(y, 1, line, nullptr);
 
-    // set alpha for the pixels we had so far
-    png_uint_32 end = y * image->GetWidth() + x;
-    // all the previous pixels were opaque
-    memset(alpha, 0xff, end);
+    // split RGBA data into RGB and alpha
+    unsigned char* ptrRGB = m_rowBuf;
+    unsigned char* ptrAlpha = m_rowBuf + 3*width;
+    for ( png_uint_32 x = 0; x < width; x++ )
+    {
+        *ptrRGB++ = *line++;
+        *ptrRGB++ = *line++;
+        *ptrRGB++ = *line++;
+        *ptrAlpha++ = *line++;
+    }
 
-    return alpha + end;
+    return sink.OnRows(y, 1, m_rowBuf, m_rowBuf + 3*width);
 }
 
 // ----------------------------------------------------------------------------
@@ -243,44 +270,6 @@ bool wxPNGHandler::DoCanRead( wxInputStream& stream )
     return memcmp(hdr, "\211PNG", WXSIZEOF(hdr)) == 0;
 }
 
-// convert data from RGB to wxImage format
-static
-void CopyDataFromPNG(wxImage *image,
-                     unsigned char **lines,
-                     png_uint_32 width,
-                     png_uint_32 height)
-{
-    // allocated on demand if we have any non-opaque pixels
-    unsigned char *alpha = nullptr;
-
-    unsigned char *ptrDst = image->GetData();
-    {
-        for ( png_uint_32 y = 0; y < height; y++ )
-        {
-            const unsigned char *ptrSrc = lines[y];
-            for ( png_uint_32 x = 0; x < width; x++ )
-            {
-                unsigned char r = *ptrSrc++;
-                unsigned char g = *ptrSrc++;
-                unsigned char b = *ptrSrc++;
-                unsigned char a = *ptrSrc++;
-
-                // the first time we encounter a transparent pixel we must
-                // allocate alpha channel for the image
-                if ( !IsOpaque(a) && !alpha )
-                    alpha = InitAlpha(image, x, y);
-
-                if ( alpha )
-                    *alpha++ = a;
-
-                *ptrDst++ = r;
-                *ptrDst++ = g;
-                *ptrDst++ = b;
-            }
-        }
-    }
-}
-
 // temporarily disable the warning C4611 (interaction between '_setjmp' and
 // C++ object destruction is non-portable) - I don't see any dtors here
 #ifdef __VISUALC__
@@ -293,7 +282,9 @@ void CopyDataFromPNG(wxImage *image,
 // "returns" its result via wxPNGImageData: use its "ok" field to check
 // whether loading succeeded or failed.
 void
-wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
+wxPNGImageData::DoLoadPNGFile(wxImage* image,
+                              wxImageRowSink& sink,
+                              wxPNGInfoStruct& wxinfo)
 {
     png_uint_32 width, height = 0;
     int bit_depth, color_type;
@@ -329,23 +320,58 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     png_set_strip_16( png_ptr );
     png_set_packing( png_ptr );
 
-    image->Create((int)width, (int)height, (bool) false /* no need to init pixels */);
-
-    if (!image->IsOk())
-        return;
+    const int passes = png_set_interlace_handling( png_ptr );
+    png_read_update_info( png_ptr, info_ptr );
 
-    const bool needCopy =
+    const bool hasAlpha =
         (color_type & PNG_COLOR_MASK_ALPHA) ||
         png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
-    if (!Alloc(width, height, needCopy ? nullptr : image->GetData()))
+    if ( !sink.OnStart((int)width, (int)height, hasAlpha) )
+    {
+        cancelled = true;
         return;
+    }
+
+    // Non-interlaced images are read one row at a time, but all rows of the
+    // interlaced ones need to be kept as each pass only fills some of their
+    // pixels.
+    if (!Alloc(width, passes > 1 ? height : 1, hasAlpha))
+        return;
+
+    for ( int pass = 0; pass < passes; pass++ )
+    {
+        for ( png_uint_32 y = 0; y < height; y++ )
+        {
+            unsigned char* const line = lines[passes > 1 ? y : 0];
+
+            // For the interlaced images, use the "display" row which libpng
+            // fills by replicating the pixels decoded so far, so that all the
+            // rows passed to the sink show the progressively refined image.
+            if ( passes > 1 )
+                png_read_row( png_ptr, nullptr, line );
+            else
+                png_read_row( png_ptr, line, nullptr );
+
+            // The rows outside of the last pass are not modified by it, so
+            // don't pass them to the sink again.
+            if ( passes > 1 && pass == passes - 1 &&
+                    !PNG_ROW_IN_INTERLACE_PASS(y, pass) )
+                continue;
+
+            if ( !PutRow(sink, y, line, width) )
+            {
+                cancelled = true;
+                return;
+            }
+        }
+    }
 
-    png_read_image( png_ptr, lines );
     png_read_end( png_ptr, info_ptr );
 
 #if wxUSE_PALETTE
-    if (color_type == PNG_COLOR_TYPE_PALETTE)
+    // Note that the image is not created when loading it using a custom sink
+    if (color_type == PNG_COLOR_TYPE_PALETTE && image->IsOk())
     {
         png_colorp palette = nullptr;
         int numPalette = 0;
@@ -410,11 +436,6 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
         image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, res);
     }
 
-
-    // loaded successfully, now init wxImage with this data
-    if (needCopy)
-        CopyDataFromPNG(image, lines, width, height);
-
     // This will indicate to the caller that loading succeeded.
     ok = true;
 }
@@ -423,18 +444,33 @@ bool
 wxPNGHandler::LoadFile(wxImage *image,
                        wxInputStream& stream,
                        bool verbose,
+                       int index)
+{
+    wxCHECK_MSG( image, false, "null image pointer" );
+
+    wxImageStoringRowSink sink(*image);
+    return LoadRows(image, stream, sink, verbose, index);
+}
+
+bool
+wxPNGHandler::LoadRows(wxImage *image,
+                       wxInputStream& stream,
+                       wxImageRowSink& sink,
+                       bool verbose,
                        int WXUNUSED(index))
 {
+    wxCHECK_MSG( image, false, "null image pointer" );
+
     wxPNGInfoStruct wxinfo;
     wxinfo.verbose = verbose;
     wxinfo.stream.in = &stream;
 
     wxPNGImageData data;
-    data.DoLoadPNGFile(image, wxinfo);
+    data.DoLoadPNGFile(image, sink, wxinfo);
 
     if ( !data.ok )
     {
-        if (verbose)
+        if (verbose && !data.cancelled)
         {
            wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
         }
@@ -488,6 +524,615 @@ static long PaletteAdd(PaletteMap *palette, const png_color_8& clr)
     return index;
 }
 
+// ----------------------------------------------------------------------------
+// SaveFile() rows helpers
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Converts the image rows to the format of the PNG being written.
+class wxPNGRowConverter
+{
+public:
+    wxPNGRowConverter(const wxImage& image,
+                      int colorType,
+                      int bitDepth,
+                      bool usePalette,
+                      bool useAlpha,
+                      const png_color_8& mask,
+                      const PaletteMap& palette)
+        : m_palette(palette),
+          m_mask(mask),
+          m_data(image.GetData()),
+          m_alpha(image.HasAlpha() ? image.GetAlpha() : nullptr),
+          m_width(image.GetWidth()),
+          m_colorType(colorType),
+          m_bitDepth(bitDepth),
+          m_rowSize(static_cast<size_t>(image.GetWidth())*
+                        GetBytesPerPixel(colorType, bitDepth, useAlpha)),
+          m_usePalette(usePalette),
+          m_useAlpha(useAlpha),
+          m_hasMask(image.HasMask())
+    {
+    }
+
+    size_t GetRowSize() const { return m_rowSize; }
+
+    // Return true if the image data can be written directly, without
+    // converting it, i.e. if GetRow() never uses the provided buffer.
+    bool IsDirect() const
+    {
+        return m_colorType == wxPNG_TYPE_COLOUR && m_bitDepth == 8 && !m_useAlpha;
+    }
+
+    // Return the pointer to the data of the given row, which is either the
+    // image data itself or the provided buffer of GetRowSize() size.
+    //
+    // This function may be called from multiple threads concurrently.
+    const unsigned char* GetRow(int y, unsigned char* buf) const;
+
+private:
+    static int GetBytesPerPixel(int colorType, int bitDepth, bool useAlpha)
+    {
+        int n = colorType == wxPNG_TYPE_COLOUR ? 3 : 1;
+        if ( useAlpha )
+            n++;
+        if ( bitDepth == 16 )
+            n *= 2;
+
+        return n;
+    }
+
+    const PaletteMap& m_palette;
+    const png_color_8 m_mask;
+    const unsigned char* const m_data;
+    const unsigned char* const m_alpha;
+    const int m_width;
+    const int m_colorType;
+    const int m_bitDepth;
+    const size_t m_rowSize;
+    const bool m_usePalette;
+    const bool m_useAlpha;
+    const bool m_hasMask;
+
+    wxDECLARE_NO_COPY_CLASS(wxPNGRowConverter);
+};
+
+const unsigned char* wxPNGRowConverter::GetRow(int y, unsigned char* buf) const
+{
+    const unsigned char* pColors = m_data + 3*static_cast<size_t>(m_width)*y;
+    if ( IsDirect() )
+        return pColors;
+
+    const unsigned char*
+        pAlpha = m_alpha ? m_alpha + static_cast<size_t>(m_width)*y : nullptr;
+
+    unsigned char *pData = buf;
+
+    // Handle the common case of RGBA image without mask separately, as it's
+    // much faster than the general loop below.
+    if ( m_colorType == wxPNG_TYPE_COLOUR && m_bitDepth == 8 &&
+            m_useAlpha && pAlpha && !m_hasMask )
+    {
+        for (int x = 0; x != m_width; x++)
+        {
+            *pData++ = *pColors++;
+            *pData++ = *pColors++;
+            *pData++ = *pColors++;
+            *pData++ = *pAlpha++;
+        }
+
+        return buf;
+    }
+
+    for (int x = 0; x != m_width; x++)
+    {
+        png_color_8 clr;
+        clr.red   = *pColors++;
+        clr.green = *pColors++;
+        clr.blue  = *pColors++;
+        clr.gray  = 0;
+        clr.alpha = (m_usePalette && pAlpha) ? *pAlpha++ : 0; // use with wxPNG_TYPE_PALETTE only
+
+        switch ( m_colorType )
+        {
+            default:
+                wxFAIL_MSG( wxT("unknown wxPNG_TYPE_XXX") );
+                wxFALLTHROUGH;
+
+            case wxPNG_TYPE_COLOUR:
+                *pData++ = clr.red;
+                if ( m_bitDepth == 16 )
+                    *pData++ = 0;
+                *pData++ = clr.green;
+                if ( m_bitDepth == 16 )
+                    *pData++ = 0;
+                *pData++ = clr.blue;
+                if ( m_bitDepth == 16 )
+                    *pData++ = 0;
+                break;
+
+            case wxPNG_TYPE_GREY:
+                {
+                    // where do these coefficients come from? maybe we
+                    // should have image options for them as well?
+                    unsigned uiColor =
+                        (unsigned) (76.544*(unsigned)clr.red +
+                                    150.272*(unsigned)clr.green +
+                                    36.864*(unsigned)clr.blue);
+
+                    *pData++ = (unsigned char)((uiColor >> 8) & 0xFF);
+                    if ( m_bitDepth == 16 )
+                        *pData++ = (unsigned char)(uiColor & 0xFF);
+                }
+                break;
+
+            case wxPNG_TYPE_GREY_RED:
+                *pData++ = clr.red;
+                if ( m_bitDepth == 16 )
+                    *pData++ = 0;
+                break;
+
+            case wxPNG_TYPE_PALETTE:
+                *pData++ = (unsigned char) PaletteFind(m_palette, clr);
+                break;
+        }
+
+        if ( m_useAlpha )
+        {
+            unsigned char uchAlpha = 255;
+            if ( pAlpha )
+                uchAlpha = *pAlpha++;
+
+            if ( m_hasMask )
+            {
+                if ( (clr.red == m_mask.red)
+                        && (clr.green == m_mask.green)
+                            && (clr.blue == m_mask.blue) )
+                    uchAlpha = 0;
+            }
+
+            *pData++ = uchAlpha;
+            if ( m_bitDepth == 16 )
+                *pData++ = 0;
+        }
+    }
+
+    return buf;
+}
+
+// ----------------------------------------------------------------------------
+// Parallel compression of PNG image data
+// ----------------------------------------------------------------------------
+
+// The image data is compressed by splitting it into chunks of approximately
+// this size, which are compressed independently, using the last 32KiB of the
+// previous chunk as the dictionary, and then concatenated together, as done
+// by pigz.
+const size_t PNG_PARALLEL_CHUNK_SIZE = 256*1024;
+
+// Size of the deflate window and hence the maximal useful dictionary size.
+const size_t PNG_DEFLATE_WINDOW_SIZE = 32*1024;
+
+inline int PNGAbs(int x) { return x < 0 ? -x : x; }
+
+// Paeth predictor as defined in the PNG specification.
+inline unsigned char PNGPaeth(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = PNGAbs(p - a);
+    const int pb = PNGAbs(p - b);
+    const int pc = PNGAbs(p - c);
+
+    if ( pa <= pb && pa <= pc )
+        return (unsigned char)a;
+
+    return (unsigned char)(pb <= pc ? b : c);
+}
+
+// Apply the filter with the given type (i.e. PNG_FILTER_VALUE_XXX) to the row
+// of the given size and store the result, including the leading filter type
+// byte, in out. Return the sum of absolute values of the filtered bytes, used
+// for choosing the best filter.
+unsigned long
+PNGFilterRow(int type,
+             const unsigned char* row,
+             const unsigned char* prev,
+             size_t size,
+             size_t bpp,
+             unsigned char* out)
+{
+    *out++ = (unsigned char)type;
+
+    unsigned long sum = 0;
+    for ( size_t i = 0; i < size; i++ )
+    {
+        const int a = i >= bpp ? row[i - bpp] : 0;
+        const int b = prev ? prev[i] : 0;
+        const int c = prev && i >= bpp ? prev[i - bpp] : 0;
+
+        int pred;
+        switch ( type )
+        {
+            default:
+            case PNG_FILTER_VALUE_NONE:
+                pred = 0;
+                break;
+
+            case PNG_FILTER_VALUE_SUB:
+                pred = a;
+                break;
+
+            case PNG_FILTER_VALUE_UP:
+                pred = b;
+                break;
+
+            case PNG_FILTER_VALUE_AVG:
+                pred = (a + b) / 2;
+                break;
+
+            case PNG_FILTER_VALUE_PAETH:
+                pred = PNGPaeth(a, b, c);
+                break;
+        }
+
+        const unsigned char v = (unsigned char)(row[i] - pred);
+        out[i] = v;
+        sum += PNGAbs((signed char)v);
+    }
+
+    return sum;
+}
+
+// Parameters of the parallel compression.
+struct wxPNGDeflateParams
+{
+    // Combination of PNG_FILTER_XXX values.
+    int filters;
+
+    // Number of bytes per complete pixel, rounded up to 1.
+    size_t bpp;
+
+    int level;
+    int memLevel;
+    int strategy;
+};
+
+// Part of the image data compressed independently.
+struct wxPNGDeflateChunk
+{
+    wxPNGDeflateChunk() : firstRow(0), lastRow(0), adler(0), len(0) { }
+
+    // The range of rows of this chunk, last one is exclusive.
+    int firstRow,
+        lastRow;
+
+    // Raw deflate data, without zlib header and trailer.
+    std::vector<unsigned char> out;
+
+    // Checksum and length of the uncompressed data.
+    uLong adler;
+    size_t len;
+};
+
+// Helper class used for filtering consecutive rows of the image.
+class wxPNGRowFilter
+{
+public:
+    wxPNGRowFilter(const wxPNGRowConverter& conv, const wxPNGDeflateParams& params)
+        : m_conv(conv),
+          m_params(params),
+          m_prev(nullptr)
+    {
+        const size_t rowSize = conv.GetRowSize();
+
+        if ( !conv.IsDirect() )
+        {
+            m_rowBuf[0].resize(rowSize);
+            m_rowBuf[1].resize(rowSize);
+        }
+
+        m_out.resize(rowSize + 1);
+        m_best.resize(rowSize + 1);
+    }
+
+    // Filter the given row, which must be either the first one or directly
+    // follow the row passed to the previous call, and return the pointer to
+    // the filtered data of GetFilteredSize() size.
+    const unsigned char* Filter(int y)
+    {
+        // Start from the previous row if we hadn't done it.
+        if ( !m_prev && y > 0 )
+            m_prev = m_conv.GetRow(y - 1, RowBuf(y - 1));
+
+        const unsigned char* const row = m_conv.GetRow(y, RowBuf(y));
+        const size_t size = m_conv.GetRowSize();
+
+        unsigned long bestSum = (unsigned long)-1;
+        for ( int type = PNG_FILTER_VALUE_NONE; type < PNG_FILTER_VALUE_LAST; type++ )
+        {
+            if ( !(m_params.filters & (PNG_FILTER_NONE << type)) )
+                continue;
+
+            const unsigned long
+                sum = PNGFilterRow(type, row, m_prev, size, m_params.bpp, &m_out[0]);
+            if ( sum < bestSum )
+            {
+                bestSum = sum;
+                m_best.swap(m_out);
+            }
+        }
+
+        m_prev = row;
+
+        return &m_best[0];
+    }
+
+    size_t GetFilteredSize() const { return m_best.size(); }
+
+private:
+    unsigned char* RowBuf(int y)
+    {
+        return m_rowBuf[y % 2].empty() ? nullptr : &m_rowBuf[y % 2][0];
+    }
+
+    const wxPNGRowConverter& m_conv;
+    const wxPNGDeflateParams& m_params;
+
+    // Buffers for the current and previous row, if conversion is needed.
+    std::vector<unsigned char> m_rowBuf[2];
+
+    const unsigned char* m_prev;
+
+    // The filtered row being computed and the best one found so far.
+    std::vector<unsigned char> m_out,
+                               m_best;
+
+    wxDECLARE_NO_COPY_CLASS(wxPNGRowFilter);
+};
+
+// Compress all the data in the stream input buffer, using the given flush
+// mode, and append it to the output vector.
+bool PNGDeflate(z_stream& zs, int flush, std::vector<unsigned char>& out)
+{
+    for ( ;; )
+    {
+        const size_t pos = out.size();
+        const size_t avail = wxMax(deflateBound(&zs, zs.avail_in), 1024);
+        out.resize(pos + avail);
+
+        zs.next_out = &out[pos];
+        zs.avail_out = static_cast<uInt>(avail);
+
+        const int rc = deflate(&zs, flush);
+
+        out.resize(pos + avail - zs.avail_out);
+
+        if ( rc == Z_STREAM_ERROR )
+            return false;
+
+        if ( flush == Z_FINISH )
+        {
+            if ( rc == Z_STREAM_END )
+                return true;
+        }
+        else if ( zs.avail_in == 0 && zs.avail_out != 0 )
+        {
+            return true;
+        }
+    }
+}
+
+// Compress the rows of the given chunk, this is executed by the worker
+// threads.
+bool
+PNGDeflateChunk(const wxPNGRowConverter& conv,
+                const wxPNGDeflateParams& params,
+                wxPNGDeflateChunk& chunk,
+                bool isLast)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+
+    // Use raw deflate as the zlib header and trailer are written separately.
+    if ( deflateInit2(&zs, params.level, Z_DEFLATED, -MAX_WBITS,
+                      params.memLevel, params.strategy) != Z_OK )
+        return false;
+
+    wxPNGRowFilter filter(conv, params);
+    const size_t filteredSize = filter.GetFilteredSize();
+
+    bool ok = true;
+
+    // Use the end of the previous chunk data as dictionary, this makes the
+    // result almost as good as when compressing all the data at once.
+    if ( chunk.firstRow > 0 )
+    {
+        const int numRows = static_cast<int>(
+            (PNG_DEFLATE_WINDOW_SIZE + filteredSize - 1) / filteredSize);
+        const int dictRow = wxMax(chunk.firstRow - numRows, 0);
+
+        std::vector<unsigned char> dict;
+        dict.reserve((chunk.firstRow - dictRow)*filteredSize);
+        for ( int y = dictRow; y < chunk.firstRow; y++ )
+        {
+            const unsigned char* const data = filter.Filter(y);
+            dict.insert(dict.end(), data, data + filteredSize);
+        }
+
+        const size_t dictSize = wxMin(dict.size(), PNG_DEFLATE_WINDOW_SIZE);
+        if ( deflateSetDictionary(&zs, &dict[dict.size() - dictSize],
+                                  static_cast<uInt>(dictSize)) != Z_OK )
+            ok = false;
+    }
+
+    chunk.adler = adler32(0, nullptr, 0);
+    chunk.len = 0;
+
+    for ( int y = chunk.firstRow; ok && y < chunk.lastRow; y++ )
+    {
+        const unsigned char* const data = filter.Filter(y);
+
+        chunk.adler = adler32(chunk.adler, data, static_cast<uInt>(filteredSize));
+        chunk.len += filteredSize;
+
+        zs.next_in = const_cast<Bytef*>(data);
+        zs.avail_in = static_cast<uInt>(filteredSize);
+        ok = PNGDeflate(zs, Z_NO_FLUSH, chunk.out);
+    }
+
+    // Terminate the last chunk and align all the others on a byte boundary
+    // without marking their last block as final, so that they can be simply
+    // concatenated together.
+    if ( ok )
+        ok = PNGDeflate(zs, isLast ? Z_FINISH : Z_SYNC_FLUSH, chunk.out);
+
+    deflateEnd(&zs);
+
+    return ok;
+}
+
+void PNGPutUInt32(unsigned char* p, png_uint_32 value)
+{
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+}
+
+// Write a PNG chunk directly to the output stream.
+bool
+PNGWriteChunk(wxOutputStream& stream,
+              const char* name,
+              const unsigned char* data,
+              size_t len)
+{
+    unsigned char header[8];
+    PNGPutUInt32(header, static_cast<png_uint_32>(len));
+    memcpy(header + 4, name, 4);
+
+    uLong crc = crc32(0, nullptr, 0);
+    crc = crc32(crc, header + 4, 4);
+    if ( len )
+        crc = crc32(crc, data, static_cast<uInt>(len));
+
+    unsigned char trailer[4];
+    PNGPutUInt32(trailer, static_cast<png_uint_32>(crc));
+
+    stream.Write(header, sizeof(header));
+    if ( len )
+        stream.Write(data, len);
+    stream.Write(trailer, sizeof(trailer));
+
+    return stream.IsOk();
+}
+
+// Compress the image data using multiple threads and write it, as well as the
+// end chunk, to the stream. This function doesn't use libpng at all.
+bool
+PNGWriteDataParallel(wxOutputStream& stream,
+                     const wxPNGRowConverter& conv,
+                     const wxPNGDeflateParams& params,
+                     int height,
+                     int numThreads)
+{
+    // Split the image in the chunks of (at least) one row.
+    const size_t filteredSize = conv.GetRowSize() + 1;
+    const int rowsPerChunk = static_cast<int>(
+        wxMax(PNG_PARALLEL_CHUNK_SIZE / filteredSize, 1));
+
+    std::vector<wxPNGDeflateChunk> chunks((height + rowsPerChunk - 1) / rowsPerChunk);
+    for ( size_t n = 0; n < chunks.size(); n++ )
+    {
+        chunks[n].firstRow = static_cast<int>(n)*rowsPerChunk;
+        chunks[n].lastRow = wxMin(chunks[n].firstRow + rowsPerChunk, height);
+    }
+
+    // Don't use bool here as std::vector<bool> can't be safely modified from
+    // multiple threads.
+    std::vector<unsigned char> results(chunks.size());
+
+    const auto compress = [&](size_t n)
+    {
+        results[n] = PNGDeflateChunk(conv, params, chunks[n],
+                                     n == chunks.size() - 1);
+    };
+
+#if wxUSE_THREADS
+    if ( numThreads != 1 && chunks.size() > 1 )
+    {
+        wxThreadPool::Get().ParallelFor(chunks.size(), compress, numThreads);
+    }
+    else
+#endif // wxUSE_THREADS
+    {
+        wxUnusedVar(numThreads);
+
+        for ( size_t n = 0; n < chunks.size(); n++ )
+            compress(n);
+    }
+
+    for ( size_t n = 0; n < chunks.size(); n++ )
+    {
+        if ( !results[n] )
+            return false;
+    }
+
+    // Prepend zlib header to the first chunk, see RFC 1950.
+    const int level = params.level == Z_DEFAULT_COMPRESSION ? 6 : params.level;
+
+    int levelFlags;
+    if ( level < 2 || params.strategy >= Z_HUFFMAN_ONLY )
+        levelFlags = 0;
+    else if ( level < 6 )
+        levelFlags = 1;
+    else if ( level == 6 )
+        levelFlags = 2;
+    else
+        levelFlags = 3;
+
+    unsigned char zlibHeader[2];
+    zlibHeader[0] = 0x78; // deflate with 32KiB window
+    zlibHeader[1] = (unsigned char)(levelFlags << 6);
+    zlibHeader[1] += 31 - (zlibHeader[0]*256 + zlibHeader[1]) % 31;
+
+    std::vector<unsigned char>& first = chunks.front().out;
+    first.insert(first.begin(), zlibHeader, zlibHeader + 2);
+
+    // And append the checksum of all the data to the last one.
+    uLong adler = chunks.front().adler;
+    for ( size_t n = 1; n < chunks.size(); n++ )
+    {
+        adler = adler32_combine(adler, chunks[n].adler,
+                                static_cast<z_off_t>(chunks[n].len));
+    }
+
+    unsigned char zlibTrailer[4];
+    PNGPutUInt32(zlibTrailer, static_cast<png_uint_32>(adler));
+
+    std::vector<unsigned char>& last = chunks.back().out;
+    last.insert(last.end(), zlibTrailer, zlibTrailer + 4);
+
+    // Now write all chunks as separate IDAT chunks.
+    for ( size_t n = 0; n < chunks.size(); n++ )
+    {
+        const std::vector<unsigned char>& out = chunks[n].out;
+        if ( out.empty() )
+            continue;
+
+        if ( !PNGWriteChunk(stream, "IDAT", &out[0], out.size()) )
+            return false;
+
+        // Free the memory as soon as possible.
+        std::vector<unsigned char>().swap(chunks[n].out);
+    }
+
+    return PNGWriteChunk(stream, "IEND", nullptr, 0);
+}
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------
 // writing PNGs
 // ----------------------------------------------------------------------------
@@ -684,7 +1329,6 @@ bool wxPNGHandler::SaveFile( wxImage *image, wxOutputStream& stream, bool verbos
                   PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                   PNG_FILTER_TYPE_BASE);
 
-    int iElements;
     png_color_8 sig_bit;
 
     if ( iPngColorType & PNG_COLOR_MASK_COLOR )
@@ -692,23 +1336,17 @@ bool wxPNGHandler::SaveFile( wxImage *image, wxOutputStream& stream, bool verbos
         sig_bit.red =
         sig_bit.green =
         sig_bit.blue = (png_byte)iBitDepth;
-        iElements = 3;
     }
     else // grey
     {
         sig_bit.gray = (png_byte)iBitDepth;
-        iElements = 1;
     }
 
     if ( bUseAlpha )
     {
         sig_bit.alpha = (png_byte)iBitDepth;
-        iElements++;
     }
 
-    if ( iBitDepth == 16 )
-        iElements *= 2;
-
     // save the image resolution if we have it
     int resX, resY;
     switch ( GetResolutionFromOptions(*image, &resX, &resY) )
@@ -741,96 +1379,78 @@ bool wxPNGHandler::SaveFile( wxImage *image, wxOutputStream& stream, bool verbos
     png_set_shift( png_ptr, &sig_bit );
     png_set_packing( png_ptr );
 
-    unsigned char *
-        data = (unsigned char *)malloc( image->GetWidth() * iElements );
-    if ( !data )
-    {
-        png_destroy_write_struct( &png_ptr, (png_infopp)nullptr );
-        return false;
-    }
-
-    const unsigned char *
-        pAlpha = (const unsigned char *)(bHasAlpha ? image->GetAlpha() : nullptr);
-
-    const unsigned char *pColors = image->GetData();
+    const wxPNGRowConverter conv(*image, iColorType, iBitDepth,
+                                 bUsePalette, bUseAlpha, mask, palette);
 
-    for (int y = 0; y != iHeight; ++y)
+    // Compress the data ourselves if we can use multiple threads for it, this
+    // is not supported for the images with less than 8 bits per sample, as
+    // they need to be packed, which is done by libpng.
+    const int numThreads = image->HasOption(wxIMAGE_OPTION_PNG_COMPRESSION_THREADS)
+                            ? image->GetOptionInt(wxIMAGE_OPTION_PNG_COMPRESSION_THREADS)
+                            : wxImage::GetParallelism();
+    if ( numThreads != 1 && iBitDepth >= 8 )
     {
-        unsigned char *pData = data;
-        for (int x = 0; x != iWidth; x++)
+        wxPNGDeflateParams params;
+
+        // Use the same defaults as libpng.
+        params.filters = bUsePalette ? PNG_FILTER_NONE : PNG_ALL_FILTERS;
+        if ( image->HasOption(wxIMAGE_OPTION_PNG_FILTER) )
         {
-            png_color_8 clr;
-            clr.red   = *pColors++;
-            clr.green = *pColors++;
-            clr.blue  = *pColors++;
-            clr.gray  = 0;
-            clr.alpha = (bUsePalette && pAlpha) ? *pAlpha++ : 0; // use with wxPNG_TYPE_PALETTE only
-
-            switch ( iColorType )
-            {
-                default:
-                    wxFAIL_MSG( wxT("unknown wxPNG_TYPE_XXX") );
-                    wxFALLTHROUGH;
-
-                case wxPNG_TYPE_COLOUR:
-                    *pData++ = clr.red;
-                    if ( iBitDepth == 16 )
-                        *pData++ = 0;
-                    *pData++ = clr.green;
-                    if ( iBitDepth == 16 )
-                        *pData++ = 0;
-                    *pData++ = clr.blue;
-                    if ( iBitDepth == 16 )
-                        *pData++ = 0;
-                    break;
+            const int filters = image->GetOptionInt(wxIMAGE_OPTION_PNG_FILTER);
+
+            // As with png_set_filter(), a single filter can be specified
+            // using PNG_FILTER_VALUE_XXX too.
+            if ( filters >= PNG_FILTER_VALUE_NONE && filters < PNG_FILTER_VALUE_LAST )
+                params.filters = PNG_FILTER_NONE << filters;
+            else if ( filters & PNG_ALL_FILTERS )
+                params.filters = filters & PNG_ALL_FILTERS;
+        }
 
-                case wxPNG_TYPE_GREY:
-                    {
-                        // where do these coefficients come from? maybe we
-                        // should have image options for them as well?
-                        unsigned uiColor =
-                            (unsigned) (76.544*(unsigned)clr.red +
-                                        150.272*(unsigned)clr.green +
-                                        36.864*(unsigned)clr.blue);
-
-                        *pData++ = (unsigned char)((uiColor >> 8) & 0xFF);
-                        if ( iBitDepth == 16 )
-                            *pData++ = (unsigned char)(uiColor & 0xFF);
-                    }
-                    break;
+        params.bpp = conv.GetRowSize() / iWidth;
 
-                case wxPNG_TYPE_GREY_RED:
-                    *pData++ = clr.red;
-                    if ( iBitDepth == 16 )
-                        *pData++ = 0;
-                    break;
+        params.level = image->HasOption(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL)
+                        ? image->GetOptionInt(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL)
+                        : Z_DEFAULT_COMPRESSION;
+        params.memLevel = image->HasOption(wxIMAGE_OPTION_PNG_COMPRESSION_MEM_LEVEL)
+                        ? image->GetOptionInt(wxIMAGE_OPTION_PNG_COMPRESSION_MEM_LEVEL)
+                        : 8;
+        params.strategy = image->HasOption(wxIMAGE_OPTION_PNG_COMPRESSION_STRATEGY)
+                        ? image->GetOptionInt(wxIMAGE_OPTION_PNG_COMPRESSION_STRATEGY)
+                        : params.filters != PNG_FILTER_NONE ? Z_FILTERED
+                                                            : Z_DEFAULT_STRATEGY;
 
-                case wxPNG_TYPE_PALETTE:
-                    *pData++ = (unsigned char) PaletteFind(palette, clr);
-                    break;
-            }
+        // Note that we can't use libpng any more after this, as it doesn't
+        // know that we wrote the image data, so just destroy it.
+        const bool ok = PNGWriteDataParallel(stream, conv, params,
+                                             iHeight, numThreads);
 
-            if ( bUseAlpha )
-            {
-                unsigned char uchAlpha = 255;
-                if ( bHasAlpha )
-                    uchAlpha = *pAlpha++;
+        png_destroy_write_struct( &png_ptr, (png_infopp)&info_ptr );
 
-                if ( bHasMask )
-                {
-                    if ( (clr.red == mask.red)
-                            && (clr.green == mask.green)
-                                && (clr.blue == mask.blue) )
-                        uchAlpha = 0;
-                }
+        if ( !ok && verbose )
+        {
+            wxLogError(_("Couldn't save PNG image."));
+        }
 
-                *pData++ = uchAlpha;
-                if ( iBitDepth == 16 )
-                    *pData++ = 0;
-            }
+        return ok;
+    }
+
+    // Note that we don't need a buffer at all if the image data can be used
+    // directly.
+    unsigned char *data = nullptr;
+    if ( !conv.IsDirect() )
+    {
+        data = (unsigned char *)malloc( conv.GetRowSize() );
+        if ( !data )
+        {
+            png_destroy_write_struct( &png_ptr, (png_infopp)nullptr );
+            return false;
         }
+    }
 
-        png_bytep row_ptr = data;
+    for (int y = 0; y != iHeight; ++y)
+    {
+        // libpng doesn't modify the row, but its API is not const-correct.
+        png_bytep row_ptr = const_cast<png_bytep>(conv.GetRow(y, data));
         png_write_rows( png_ptr, &row_ptr, 1 );
     }
 
@@ -23,6 +23,7 @@
     #include "wx/window.h"
 #endif //WX_PRECOMP
 
+#include "wx/private/glyphcache.h"
 #include "wx/private/textmeasure.h"
 
 // ============================================================================
@@ -208,6 +209,28 @@ wxSize wxTextMeasureBase::GetLargestStringExtent(size_t n,
     return wxSize(widthMax, heightMax);
 }
 
+void wxTextMeasureBase::GetMultipleTextExtents(const wxArrayString& strings,
+                                               wxVector<wxSize>& extents)
+{
+    extents.assign(strings.size(), wxSize());
+
+    MeasuringGuard guard(*this);
+
+    for ( size_t i = 0; i < strings.size(); ++i )
+    {
+        if ( strings[i].empty() )
+            continue;
+
+        // Contrary to CallGetTextExtent(), do pass the font to wxDC, as it
+        // may be different from the font currently used by it.
+        if ( m_useDCImpl )
+            m_dc->GetTextExtent(strings[i], &extents[i].x, &extents[i].y,
+                                nullptr, nullptr, m_font);
+        else
+            DoGetTextExtent(strings[i], &extents[i].x, &extents[i].y);
+    }
+}
+
 bool wxTextMeasureBase::GetPartialTextExtents(const wxString& text,
                                               wxArrayInt& widths,
                                               double scaleX)
@@ -233,73 +256,193 @@ bool wxTextMeasureBase::GetPartialTextExtents(const wxString& text,
 // if available and if faster.  Note: pango_layout_index_to_pos is much slower
 // than calling GetTextExtent!!
 
-#define FWC_SIZE 256
-
-class FontWidthCache
+bool wxTextMeasureBase::DoGetPartialTextExtents(const wxString& text,
+                                                wxArrayInt& widths,
+                                                double scaleX)
 {
-public:
-    FontWidthCache() : m_scaleX(1), m_widths(nullptr) { }
-    ~FontWidthCache() { delete []m_widths; }
+    const wxSize ppi = m_dc ? m_dc->GetPPI() : m_win->GetDPI();
+    const wxString
+        key = wxGlyphAdvanceCache::MakeKey(GetFont(), scaleX, ppi.y);
+
+    wxGlyphAdvanceCache& cache = wxGlyphAdvanceCache::Get();
 
-    void Reset()
+    wxVector<double> advances;
+    if ( cache.Lookup(key, text, advances) )
     {
-        if ( !m_widths )
-            m_widths = new int[FWC_SIZE];
+        // Measure the characters which are not in the cache yet: notice that
+        // we don't hold the cache lock while doing it, as this is relatively
+        // slow.
+        size_t n = 0;
+        for ( wxString::const_iterator it = text.begin();
+              it != text.end();
+              ++it, ++n )
+        {
+            if ( advances[n] >= 0 )
+                continue;
+
+            int w, dummyHeight;
+            DoGetTextExtent(*it, &w, &dummyHeight);
+            advances[n] = w;
+        }
 
-        memset(m_widths, 0, sizeof(int)*FWC_SIZE);
+        cache.Store(key, text, advances);
     }
 
-    wxFont m_font;
-    double m_scaleX;
-    int *m_widths;
-};
+    // Calculate the position of each character based on the widths of
+    // the previous characters. This is inexact for not fixed fonts.
+    int totalWidth = 0;
+    for ( size_t n = 0; n < advances.size(); n++ )
+    {
+        totalWidth += static_cast<int>(advances[n]);
+        widths[n] = totalWidth;
+    }
 
-static FontWidthCache s_fontWidthCache;
+    return true;
+}
 
-bool wxTextMeasureBase::DoGetPartialTextExtents(const wxString& text,
-                                                wxArrayInt& widths,
-                                                double scaleX)
+// ============================================================================
+// wxGlyphAdvanceCache implementation
+// ============================================================================
+
+namespace
 {
-    int totalWidth = 0;
 
-    // reset the cache if font or horizontal scale have changed
-    const wxFont& font = GetFont();
-    if ( !s_fontWidthCache.m_widths ||
-         !wxIsSameDouble(s_fontWidthCache.m_scaleX, scaleX) ||
-         (s_fontWidthCache.m_font != font) )
-    {
-        s_fontWidthCache.Reset();
-        s_fontWidthCache.m_font = font;
-        s_fontWidthCache.m_scaleX = scaleX;
-    }
+// Maximal number of fonts in the cache.
+const size_t MAX_CACHED_FONTS = 16;
 
-    // Calculate the position of each character based on the widths of
-    // the previous characters. This is inexact for not fixed fonts.
-    int n = 0;
+// Maximal number of characters not in the direct array cached for each font.
+const size_t MAX_CACHED_OTHERS = 4096;
+
+} // anonymous namespace
+
+wxGlyphAdvanceCache::FontEntry::FontEntry(const wxString& key_)
+    : key(key_)
+{
+    for ( size_t n = 0; n < DIRECT_SIZE; n++ )
+        direct[n] = -1;
+}
+
+/* static */
+wxGlyphAdvanceCache& wxGlyphAdvanceCache::Get()
+{
+    // Initialization of local statics is thread-safe, so this can be called
+    // from any thread.
+    static wxGlyphAdvanceCache s_cache;
+
+    return s_cache;
+}
+
+/* static */
+wxString
+wxGlyphAdvanceCache::MakeKey(const wxFont& font, double scaleX, int ppi)
+{
+    return wxString::Format("%s|%g|%d",
+                            font.GetNativeFontInfoDesc(), scaleX, ppi);
+}
+
+wxGlyphAdvanceCache::FontEntry*
+wxGlyphAdvanceCache::DoFind(const wxString& key)
+{
+    const auto it = m_index.find(key);
+    if ( it == m_index.end() )
+        return nullptr;
+
+    // Move the entry to the front of the list without invalidating the
+    // iterators pointing to it.
+    m_fonts.splice(m_fonts.begin(), m_fonts, it->second);
+
+    return &*it->second;
+}
+
+size_t wxGlyphAdvanceCache::Lookup(const wxString& key,
+                                   const wxString& text,
+                                   wxVector<double>& advances)
+{
+    advances.assign(text.length(), -1);
+
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    const FontEntry* const entry = DoFind(key);
+    if ( !entry )
+        return advances.size();
+
+    size_t missing = 0;
+    size_t n = 0;
     for ( wxString::const_iterator it = text.begin();
           it != text.end();
-          ++it )
+          ++it, ++n )
     {
-        const wxChar c = *it;
-        unsigned int c_int = (unsigned int)c;
-
-        int w;
-        if ((c_int < FWC_SIZE) && (s_fontWidthCache.m_widths[c_int] != 0))
+        const wxUint32 ch = (*it).GetValue();
+        if ( ch < DIRECT_SIZE )
         {
-            w = s_fontWidthCache.m_widths[c_int];
+            advances[n] = entry->direct[ch];
         }
         else
         {
-            int dummyHeight;
-            DoGetTextExtent(c, &w, &dummyHeight);
-            if (c_int < FWC_SIZE)
-                s_fontWidthCache.m_widths[c_int] = w;
+            const auto itOther = entry->others.find(ch);
+            if ( itOther != entry->others.end() )
+                advances[n] = itOther->second;
         }
 
-        totalWidth += w;
-        widths[n++] = totalWidth;
+        if ( advances[n] < 0 )
+            missing++;
     }
 
-    return true;
+    return missing;
+}
+
+void wxGlyphAdvanceCache::Store(const wxString& key,
+                                const wxString& text,
+                                const wxVector<double>& advances)
+{
+    wxCHECK_RET( advances.size() == text.length(), "size mismatch" );
+
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    FontEntry* entry = DoFind(key);
+    if ( !entry )
+    {
+        if ( m_fonts.size() >= MAX_CACHED_FONTS )
+        {
+            m_index.erase(m_fonts.back().key);
+            m_fonts.pop_back();
+        }
+
+        m_fonts.push_front(FontEntry(key));
+        m_index[key] = m_fonts.begin();
+
+        entry = &m_fonts.front();
+    }
+
+    size_t n = 0;
+    for ( wxString::const_iterator it = text.begin();
+          it != text.end();
+          ++it, ++n )
+    {
+        const double w = advances[n];
+        if ( w < 0 )
+            continue;
+
+        const wxUint32 ch = (*it).GetValue();
+        if ( ch < DIRECT_SIZE )
+            entry->direct[ch] = w;
+        else if ( entry->others.size() < MAX_CACHED_OTHERS )
+            entry->others[ch] = w;
+    }
+}
+
+void wxGlyphAdvanceCache::Clear()
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    m_index.clear();
+    m_fonts.clear();
+}
+
+size_t wxGlyphAdvanceCache::GetFontCount() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    return m_fonts.size();
 }
 
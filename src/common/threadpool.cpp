@@ -0,0 +1,350 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool implementation
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#if wxUSE_THREADS
+
+#ifndef WX_PRECOMP
+    #include "wx/module.h"
+    #include "wx/utils.h"
+#endif // WX_PRECOMP
+
+#include "wx/private/threadpool.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolWorker: thread executing the tasks of the pool
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolWorker : public wxThread
+{
+public:
+    explicit wxThreadPoolWorker(wxThreadPool& pool)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_pool(pool)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() override
+    {
+        wxThreadPool::Task task;
+        while ( m_pool.GetNextTask(task) )
+        {
+            task();
+
+            // Don't keep any objects captured by the task alive any longer
+            // than needed.
+            task = wxThreadPool::Task();
+        }
+
+        return nullptr;
+    }
+
+private:
+    wxThreadPool& m_pool;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolWorker);
+};
+
+// ============================================================================
+// wxThreadPool implementation
+// ============================================================================
+
+wxThreadPool* wxThreadPool::ms_instance = nullptr;
+
+/* static */
+wxThreadPool& wxThreadPool::Get()
+{
+    // The global pool is normally created from the main thread, but protect
+    // against creating it twice if it's used from several threads at once.
+    static wxMutex s_mutex;
+    wxMutexLocker lock(s_mutex);
+
+    if ( !ms_instance )
+        ms_instance = new wxThreadPool();
+
+    return *ms_instance;
+}
+
+/* static */
+void wxThreadPool::CleanUp()
+{
+    delete ms_instance;
+    ms_instance = nullptr;
+}
+
+wxThreadPool::wxThreadPool(int maxThreads)
+    : m_maxThreads(maxThreads > 0 ? maxThreads
+                                  : wxMax(wxThread::GetCPUCount(), 1)),
+      m_condition(m_mutex),
+      m_idleThreads(0),
+      m_shuttingDown(false)
+{
+}
+
+wxThreadPool::~wxThreadPool()
+{
+    Shutdown();
+}
+
+void wxThreadPool::Post(const Task& task)
+{
+    {
+        wxMutexLocker lock(m_mutex);
+
+        if ( !m_shuttingDown )
+        {
+            m_tasks.push_back(task);
+
+            // Create a new thread if none of the existing ones is available
+            // to handle this task.
+            if ( m_idleThreads < static_cast<int>(m_tasks.size()) &&
+                    static_cast<int>(m_threads.size()) < m_maxThreads )
+            {
+                wxThreadPoolWorker* const thread = new wxThreadPoolWorker(*this);
+                if ( thread->Run() == wxTHREAD_NO_ERROR )
+                {
+                    m_threads.push_back(thread);
+                }
+                else
+                {
+                    delete thread;
+                }
+            }
+
+            if ( !m_threads.empty() )
+            {
+                m_condition.Signal();
+                return;
+            }
+
+            // We couldn't create any threads, so execute the task ourselves.
+            m_tasks.pop_back();
+        }
+    }
+
+    task();
+}
+
+bool wxThreadPool::GetNextTask(Task& task)
+{
+    wxMutexLocker lock(m_mutex);
+
+    while ( m_tasks.empty() )
+    {
+        if ( m_shuttingDown )
+            return false;
+
+        m_idleThreads++;
+        m_condition.Wait();
+        m_idleThreads--;
+    }
+
+    if ( m_shuttingDown )
+        return false;
+
+    task = m_tasks.front();
+    m_tasks.pop_front();
+
+    return true;
+}
+
+void wxThreadPool::Shutdown()
+{
+    wxVector<wxThreadPoolWorker*> threads;
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_shuttingDown = true;
+        m_tasks.clear();
+        threads.swap(m_threads);
+
+        m_condition.Broadcast();
+    }
+
+    for ( size_t n = 0; n < threads.size(); n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+}
+
+namespace
+{
+
+// State shared between the thread calling ParallelFor() and the tasks used
+// to help it. It is reference-counted because the helper tasks may start
+// running only after ParallelFor() has already returned.
+struct ParallelForState
+{
+    ParallelForState(size_t count_, const std::function<void(size_t)>& func_)
+        : count(count_),
+          func(func_),
+          next(0),
+          condition(mutex),
+          active(0),
+          done(false)
+    {
+    }
+
+    // Process the items until there are none left or an exception is thrown.
+    void ProcessItems()
+    {
+#if wxUSE_EXCEPTIONS
+        try
+#endif // wxUSE_EXCEPTIONS
+        {
+            for ( ;; )
+            {
+                const size_t n = next++;
+                if ( n >= count )
+                    break;
+
+                func(n);
+            }
+        }
+#if wxUSE_EXCEPTIONS
+        catch ( ... )
+        {
+            // Don't start processing any more items and remember the first
+            // exception to rethrow it from ParallelFor() once all helpers are
+            // done: we can't let it propagate from here, as "func" must not
+            // be destroyed while the helpers may still be using it.
+            next = count;
+
+            wxMutexLocker lock(mutex);
+            if ( !exception )
+                exception = std::current_exception();
+        }
+#endif // wxUSE_EXCEPTIONS
+    }
+
+    const size_t count;
+    const std::function<void(size_t)>& func;
+
+    // Index of the next item to process.
+    std::atomic<size_t> next;
+
+    // Protects "active" and "done".
+    wxMutex mutex;
+    wxCondition condition;
+
+    // Number of helpers currently processing the items.
+    int active;
+
+    // Set once the calling thread has finished processing the items, after
+    // this no new helpers may start doing it as "func" may not be valid any
+    // more.
+    bool done;
+
+#if wxUSE_EXCEPTIONS
+    // The first exception thrown by "func", if any.
+    std::exception_ptr exception;
+#endif // wxUSE_EXCEPTIONS
+};
+
+} // anonymous namespace
+
+void wxThreadPool::ParallelFor(size_t count,
+                               const std::function<void(size_t)>& func,
+                               int maxThreads)
+{
+    if ( maxThreads <= 0 || maxThreads > m_maxThreads )
+        maxThreads = m_maxThreads;
+
+    if ( static_cast<size_t>(maxThreads) > count )
+        maxThreads = static_cast<int>(count);
+
+    if ( maxThreads <= 1 )
+    {
+        for ( size_t n = 0; n < count; n++ )
+            func(n);
+
+        return;
+    }
+
+    std::shared_ptr<ParallelForState> state(new ParallelForState(count, func));
+
+    for ( int n = 1; n < maxThreads; n++ )
+    {
+        Post([state]()
+        {
+            {
+                wxMutexLocker lock(state->mutex);
+                if ( state->done )
+                    return;
+
+                state->active++;
+            }
+
+            state->ProcessItems();
+
+            wxMutexLocker lock(state->mutex);
+            if ( --state->active == 0 )
+                state->condition.Signal();
+        });
+    }
+
+    state->ProcessItems();
+
+    // All items have been taken by now, but some of them may be still being
+    // processed by the helpers, so wait until they finish.
+#if wxUSE_EXCEPTIONS
+    std::exception_ptr exception;
+#endif // wxUSE_EXCEPTIONS
+    {
+        wxMutexLocker lock(state->mutex);
+        state->done = true;
+        while ( state->active )
+            state->condition.Wait();
+
+#if wxUSE_EXCEPTIONS
+        exception = state->exception;
+#endif // wxUSE_EXCEPTIONS
+    }
+
+#if wxUSE_EXCEPTIONS
+    if ( exception )
+        std::rethrow_exception(exception);
+#endif // wxUSE_EXCEPTIONS
+}
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolModule: destroys the global pool on shutdown
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolModule : public wxModule
+{
+public:
+    wxThreadPoolModule() { }
+
+    virtual bool OnInit() override { return true; }
+    virtual void OnExit() override { wxThreadPool::CleanUp(); }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxThreadPoolModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxThreadPoolModule, wxModule);
+
+#endif // wxUSE_THREADS
@@ -70,6 +70,8 @@
 #endif
 
 #ifndef WX_PRECOMP
+    #include "wx/app.h"
+    #include "wx/module.h"
     #include "wx/utils.h"                   // Only for wxMin()
 #endif // WX_PRECOMP
 
@@ -84,6 +86,11 @@
 #include "wx/rawbmp.h"
 
 #include "wx/private/bmpbndl.h"
+#include "wx/private/threadpool.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
 
 // ----------------------------------------------------------------------------
 // private helpers
@@ -92,80 +99,304 @@
 namespace
 {
 
+// Default value for wxBitmapBundle::SetSVGCacheLimit().
+const size_t DEFAULT_SVG_CACHE_LIMIT = 8*1024*1024;
+
+// Key identifying the bitmap in wxSVGRasterCache.
+struct wxSVGRasterKey
+{
+    wxSVGRasterKey(wxUint64 id_, const wxSize& size_)
+        : id(id_), size(size_)
+    {
+    }
+
+    bool operator==(const wxSVGRasterKey& other) const
+    {
+        return id == other.id && size == other.size;
+    }
+
+    // Hash of the SVG data, see wxBitmapBundleImplSVG::ComputeId().
+    wxUint64 id;
+
+    wxSize size;
+};
+
+struct wxSVGRasterKeyHash
+{
+    size_t operator()(const wxSVGRasterKey& key) const
+    {
+        return static_cast<size_t>(key.id ^ (key.id >> 32)) ^
+                (static_cast<size_t>(key.size.x) << 16) ^
+                 static_cast<size_t>(key.size.y);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// wxSVGRasterCache: LRU cache of the bitmaps rasterized from SVG
+// ----------------------------------------------------------------------------
+
+class wxSVGRasterCache
+{
+public:
+    // Get the global cache, creating it if necessary.
+    static wxSVGRasterCache& Get()
+    {
+        if ( !ms_instance )
+            ms_instance = new wxSVGRasterCache();
+
+        return *ms_instance;
+    }
+
+    // Destroy the global cache, if it exists.
+    static void CleanUp()
+    {
+        delete ms_instance;
+        ms_instance = nullptr;
+    }
+
+    wxSVGRasterCache()
+        : m_maxBytes(DEFAULT_SVG_CACHE_LIMIT)
+    {
+    }
+
+    // Return the cached bitmap or invalid bitmap if it's not in the cache.
+    wxBitmap Find(const wxSVGRasterKey& key)
+    {
+        const Index::iterator it = m_index.find(key);
+        if ( it == m_index.end() )
+        {
+            m_stats.misses++;
+            return wxBitmap();
+        }
+
+        m_stats.hits++;
+
+        // Move the entry to the front of the list of the recently used ones.
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+        return it->second->bitmap;
+    }
+
+    // Check if the bitmap is in the cache without updating the statistics.
+    bool Has(const wxSVGRasterKey& key) const
+    {
+        return m_index.find(key) != m_index.end();
+    }
+
+    // Add a new bitmap, which must not be in the cache yet. Returns false if
+    // the bitmap is too big to be cached.
+    bool Add(const wxSVGRasterKey& key, const wxBitmap& bitmap)
+    {
+        const size_t bytes = GetBitmapBytes(bitmap);
+        if ( bytes > m_maxBytes )
+            return false;
+
+        Trim(m_maxBytes - bytes);
+
+        m_entries.push_front(Entry(key, bitmap));
+        m_index.insert(Index::value_type(key, m_entries.begin()));
+
+        m_stats.count++;
+        m_stats.bytes += bytes;
+
+        return true;
+    }
+
+    void SetMaxBytes(size_t maxBytes)
+    {
+        m_maxBytes = maxBytes;
+
+        Trim(m_maxBytes);
+    }
+
+    size_t GetMaxBytes() const { return m_maxBytes; }
+
+    void Clear()
+    {
+        m_index.clear();
+        m_entries.clear();
+
+        m_stats = wxBitmapBundleCacheStats();
+    }
+
+    const wxBitmapBundleCacheStats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry
+    {
+        Entry(const wxSVGRasterKey& key_, const wxBitmap& bitmap_)
+            : key(key_), bitmap(bitmap_)
+        {
+        }
+
+        wxSVGRasterKey key;
+        wxBitmap bitmap;
+    };
+
+    typedef std::list<Entry> Entries;
+    typedef std::unordered_map<wxSVGRasterKey,
+                               Entries::iterator,
+                               wxSVGRasterKeyHash> Index;
+
+    static size_t GetBitmapBytes(const wxBitmap& bitmap)
+    {
+        return static_cast<size_t>(bitmap.GetWidth())*bitmap.GetHeight()*4;
+    }
+
+    // Remove the least recently used entries until the total size of the
+    // remaining ones doesn't exceed the given one.
+    void Trim(size_t maxBytes)
+    {
+        while ( m_stats.bytes > maxBytes )
+        {
+            const Entry& entry = m_entries.back();
+
+            m_stats.bytes -= GetBitmapBytes(entry.bitmap);
+            m_stats.count--;
+            m_stats.evictions++;
+
+            m_index.erase(entry.key);
+            m_entries.pop_back();
+        }
+    }
+
+    // Most recently used entries come first.
+    Entries m_entries;
+
+    Index m_index;
+
+    size_t m_maxBytes;
+
+    wxBitmapBundleCacheStats m_stats;
+
+    static wxSVGRasterCache* ms_instance;
+
+    wxDECLARE_NO_COPY_CLASS(wxSVGRasterCache);
+};
+
+wxSVGRasterCache* wxSVGRasterCache::ms_instance = nullptr;
+
+// ----------------------------------------------------------------------------
+// wxSVGParsedImage: parsed SVG image which can be shared between threads
+// ----------------------------------------------------------------------------
+
+// The parsed image is never modified after its creation, so it can be safely
+// rasterized by several threads at once, as long as each of them uses its own
+// rasterizer. It is kept alive by the background tasks rasterizing it even if
+// the bundle itself is destroyed in the meanwhile.
+class wxSVGParsedImage
+{
+public:
+    // Takes ownership of the given valid image.
+    explicit wxSVGParsedImage(NSVGimage* svgImage)
+        : m_svgImage(svgImage)
+    {
+    }
+
+    ~wxSVGParsedImage()
+    {
+        nsvgDelete(m_svgImage);
+    }
+
+    // Rasterize the image of the given size into RGBA buffer.
+    void Rasterize(NSVGrasterizer* rasterizer,
+                   const wxSize& size,
+                   wxVector<unsigned char>& buffer) const;
+
+private:
+    NSVGimage* const m_svgImage;
+
+    wxDECLARE_NO_COPY_CLASS(wxSVGParsedImage);
+};
+
+typedef std::shared_ptr<const wxSVGParsedImage> wxSVGParsedImagePtr;
+
+// ----------------------------------------------------------------------------
+// wxBitmapBundleImplSVG: wxBitmapBundleImpl rasterizing the SVG image
+// ----------------------------------------------------------------------------
+
 class wxBitmapBundleImplSVG : public wxBitmapBundleImpl
 {
 public:
     // Ctor must be passed a valid NSVGimage and takes ownership of it.
-    wxBitmapBundleImplSVG(NSVGimage* svgImage, const wxSize& sizeDef)
-        : m_svgImage(svgImage),
+    //
+    // The id must be computed by ComputeId() from the SVG data.
+    wxBitmapBundleImplSVG(NSVGimage* svgImage, const wxSize& sizeDef, wxUint64 id)
+        : m_image(std::make_shared<wxSVGParsedImage>(svgImage)),
           m_svgRasterizer(nsvgCreateRasterizer()),
-          m_sizeDef(sizeDef)
+          m_sizeDef(sizeDef),
+          m_id(id)
     {
     }
 
     ~wxBitmapBundleImplSVG()
     {
         nsvgDeleteRasterizer(m_svgRasterizer);
-        nsvgDelete(m_svgImage);
     }
 
+    // Return the value identifying the given SVG data: this must be called
+    // before parsing it, as parsing modifies the data.
+    static wxUint64 ComputeId(const char* data, size_t len);
+
     virtual wxSize GetDefaultSize() const override;
     virtual wxSize GetPreferredBitmapSizeAtScale(double scale) const override;
     virtual wxBitmap GetBitmap(const wxSize& size) override;
 
-private:
-    wxBitmap DoRasterize(const wxSize& size);
+    // Used by wxBitmapBundle::PrerasterizeSVG().
+    const wxSVGParsedImagePtr& GetParsedImage() const { return m_image; }
+    wxUint64 GetId() const { return m_id; }
 
-    NSVGimage* const m_svgImage;
+private:
+    const wxSVGParsedImagePtr m_image;
     NSVGrasterizer* const m_svgRasterizer;
 
     const wxSize m_sizeDef;
 
-    // Cache the last used bitmap (may be invalid if not used yet).
-    //
-    // Note that we cache only the last bitmap and not all the bitmaps ever
-    // requested from GetBitmap() for the different sizes because there would
-    // be no way to clear such cache and its growth could be unbounded,
-    // resulting in too many bitmap objects being used in an application using
-    // SVG for all of its icons.
-    wxBitmap m_cachedBitmap;
+    // The bitmaps are cached in the global wxSVGRasterCache using this id,
+    // which is the same for all bundles created from the same SVG data.
+    const wxUint64 m_id;
+
+    // The last bitmap which couldn't be stored in the global cache because
+    // it's too big for it, this avoids rasterizing it every time it's used.
+    wxBitmap m_bitmapUncached;
 
     wxDECLARE_NO_COPY_CLASS(wxBitmapBundleImplSVG);
 };
 
-} // anonymous namespace
-
-// ============================================================================
-// wxBitmapBundleImplSVG implementation
-// ============================================================================
+// ----------------------------------------------------------------------------
+// wxSVGRasterCacheModule: destroys the cache on shutdown
+// ----------------------------------------------------------------------------
 
-wxSize wxBitmapBundleImplSVG::GetDefaultSize() const
+// The cached bitmaps must be destroyed before the GUI is cleaned up.
+class wxSVGRasterCacheModule : public wxModule
 {
-    return m_sizeDef;
-}
+public:
+    wxSVGRasterCacheModule() { }
 
-wxSize wxBitmapBundleImplSVG::GetPreferredBitmapSizeAtScale(double scale) const
-{
-    // We consider that we can render at any scale.
-    return m_sizeDef*scale;
-}
+    virtual bool OnInit() override { return true; }
+    virtual void OnExit() override { wxSVGRasterCache::CleanUp(); }
 
-wxBitmap wxBitmapBundleImplSVG::GetBitmap(const wxSize& size)
-{
-    if ( !m_cachedBitmap.IsOk() || m_cachedBitmap.GetSize() != size )
-    {
-        m_cachedBitmap = DoRasterize(size);
-    }
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxSVGRasterCacheModule);
+};
 
-    return m_cachedBitmap;
-}
+wxIMPLEMENT_DYNAMIC_CLASS(wxSVGRasterCacheModule, wxModule);
 
-wxBitmap wxBitmapBundleImplSVG::DoRasterize(const wxSize& size)
+} // anonymous namespace
+
+// ============================================================================
+// wxSVGParsedImage implementation
+// ============================================================================
+
+void
+wxSVGParsedImage::Rasterize(NSVGrasterizer* rasterizer,
+                            const wxSize& size,
+                            wxVector<unsigned char>& buffer) const
 {
-    wxVector<unsigned char> buffer(size.x*size.y*4);
+    buffer.resize(size.x*size.y*4);
     nsvgRasterize
     (
-        m_svgRasterizer,
+        rasterizer,
         m_svgImage,
         0.0, 0.0,           // no offset
         wxMin
@@ -177,12 +408,22 @@ wxBitmap wxBitmapBundleImplSVG::DoRasterize(const wxSize& size)
         size.x, size.y,
         size.x*4            // stride -- we have no gaps between lines
     );
+}
+
+// ----------------------------------------------------------------------------
+// helper functions
+// ----------------------------------------------------------------------------
 
+namespace
+{
+
+// Create the bitmap from the RGBA data returned by wxSVGParsedImage.
+wxBitmap CreateBitmapFromRGBA(const wxSize& size, const unsigned char* src)
+{
     wxBitmap bitmap(size, 32);
     wxAlphaPixelData bmpdata(bitmap);
     wxAlphaPixelData::Iterator dst(bmpdata);
 
-    const unsigned char* src = &buffer[0];
     for ( int y = 0; y < size.y; ++y )
     {
         dst.MoveTo(bmpdata, 0, y);
@@ -216,12 +457,76 @@ wxBitmap wxBitmapBundleImplSVG::DoRasterize(const wxSize& size)
     return bitmap;
 }
 
+} // anonymous namespace
+
+// ============================================================================
+// wxBitmapBundleImplSVG implementation
+// ============================================================================
+
+wxSize wxBitmapBundleImplSVG::GetDefaultSize() const
+{
+    return m_sizeDef;
+}
+
+wxSize wxBitmapBundleImplSVG::GetPreferredBitmapSizeAtScale(double scale) const
+{
+    // We consider that we can render at any scale.
+    return m_sizeDef*scale;
+}
+
 /* static */
-wxBitmapBundle wxBitmapBundle::FromSVG(char* data, const wxSize& sizeDef)
+wxUint64 wxBitmapBundleImplSVG::ComputeId(const char* data, size_t len)
+{
+    // Use 64-bit FNV-1a hash, which is simple and good enough for this.
+    wxUint64 hash = wxULL(14695981039346656037);
+    for ( size_t n = 0; n < len; n++ )
+    {
+        hash ^= static_cast<unsigned char>(data[n]);
+        hash *= wxULL(1099511628211);
+    }
+
+    // Also mix in the length to make collisions even less likely.
+    hash ^= len;
+    hash *= wxULL(1099511628211);
+
+    return hash;
+}
+
+wxBitmap wxBitmapBundleImplSVG::GetBitmap(const wxSize& size)
 {
+    if ( m_bitmapUncached.IsOk() && m_bitmapUncached.GetSize() == size )
+        return m_bitmapUncached;
+
+    wxSVGRasterCache& cache = wxSVGRasterCache::Get();
+
+    const wxSVGRasterKey key(m_id, size);
+
+    wxBitmap bitmap = cache.Find(key);
+    if ( !bitmap.IsOk() )
+    {
+        wxVector<unsigned char> buffer;
+        m_image->Rasterize(m_svgRasterizer, size, buffer);
+
+        bitmap = CreateBitmapFromRGBA(size, &buffer[0]);
+        if ( bitmap.IsOk() && !cache.Add(key, bitmap) )
+            m_bitmapUncached = bitmap;
+    }
+
+    return bitmap;
+}
+
+namespace
+{
+
+// Parse the SVG data, which is modified by this function, and return the
+// parsed image or null on failure. Also return the id of the data.
+NSVGimage* ParseSVG(char* data, wxUint64* id)
+{
+    *id = wxBitmapBundleImplSVG::ComputeId(data, strlen(data));
+
     NSVGimage* const svgImage = nsvgParse(data, "px", 96);
     if ( !svgImage )
-        return wxBitmapBundle();
+        return nullptr;
 
     // Somewhat unexpectedly, a non-null but empty image is returned even if
     // the data is not SVG at all, e.g. without this check creating a bundle
@@ -229,10 +534,59 @@ wxBitmapBundle wxBitmapBundle::FromSVG(char* data, const wxSize& sizeDef)
     if ( svgImage->width == 0 && svgImage->height == 0 && !svgImage->shapes )
     {
         nsvgDelete(svgImage);
-        return wxBitmapBundle();
+        return nullptr;
+    }
+
+    return svgImage;
+}
+
+// Read the contents of the file into the provided buffer.
+bool ReadSVGFile(const wxString& path, wxCharBuffer& buf)
+{
+    // There is nsvgParseFromFile(), but it doesn't work with Unicode filenames
+    // under MSW and does exactly the same thing that we do here in any case,
+    // so it seems better to use our code.
+#ifndef wxNO_SVG_FILE
+#if wxUSE_FFILE
+    wxFFile file(path, "rb");
+#elif wxUSE_FILE
+    wxFile file(path);
+#endif
+    if ( file.IsOpened() )
+    {
+        const wxFileOffset lenAsOfs = file.Length();
+        if ( lenAsOfs != wxInvalidOffset )
+        {
+            const size_t len = static_cast<size_t>(lenAsOfs);
+
+            buf = wxCharBuffer(len);
+            if ( file.Read(buf.data(), len) == len )
+                return true;
+        }
     }
+#else // wxNO_SVG_FILE
+    wxUnusedVar(path);
+    wxUnusedVar(buf);
+#endif // !wxNO_SVG_FILE
+
+    return false;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// wxBitmapBundle SVG-related functions
+// ============================================================================
+
+/* static */
+wxBitmapBundle wxBitmapBundle::FromSVG(char* data, const wxSize& sizeDef)
+{
+    wxUint64 id;
+    NSVGimage* const svgImage = ParseSVG(data, &id);
+    if ( !svgImage )
+        return wxBitmapBundle();
 
-    return wxBitmapBundle(new wxBitmapBundleImplSVG(svgImage, sizeDef));
+    return wxBitmapBundle(new wxBitmapBundleImplSVG(svgImage, sizeDef, id));
 }
 
 /* static */
@@ -255,31 +609,165 @@ wxBitmapBundle wxBitmapBundle::FromSVG(const wxByte* data, size_t len, const wxS
 /* static */
 wxBitmapBundle wxBitmapBundle::FromSVGFile(const wxString& path, const wxSize& sizeDef)
 {
-    // There is nsvgParseFromFile(), but it doesn't work with Unicode filenames
-    // under MSW and does exactly the same thing that we do here in any case,
-    // so it seems better to use our code.
-#ifndef wxNO_SVG_FILE
-#if wxUSE_FFILE
-    wxFFile file(path, "rb");
-#elif wxUSE_FILE
-    wxFile file(path);
-#endif
-    if ( file.IsOpened() )
+    wxCharBuffer buf;
+    if ( !ReadSVGFile(path, buf) )
+        return wxBitmapBundle();
+
+    return wxBitmapBundle::FromSVG(buf.data(), sizeDef);
+}
+
+/* static */
+wxVector<wxBitmapBundle>
+wxBitmapBundle::FromSVGFiles(const wxVector<wxString>& paths, const wxSize& sizeDef)
+{
+    // Read and parse the files in parallel, but create the bundles in this
+    // thread only, as their reference counting is not thread-safe.
+    struct Parsed
     {
-        const wxFileOffset lenAsOfs = file.Length();
-        if ( lenAsOfs != wxInvalidOffset )
+        NSVGimage* svgImage;
+        wxUint64 id;
+    };
+
+    wxVector<Parsed> parsed(paths.size());
+
+    const auto parse = [&](size_t n)
+    {
+        parsed[n].svgImage = nullptr;
+
+        wxCharBuffer buf;
+        if ( ReadSVGFile(paths[n], buf) )
+            parsed[n].svgImage = ParseSVG(buf.data(), &parsed[n].id);
+    };
+
+#if wxUSE_THREADS
+    wxThreadPool::Get().ParallelFor(paths.size(), parse);
+#else // !wxUSE_THREADS
+    for ( size_t n = 0; n < paths.size(); n++ )
+        parse(n);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    wxVector<wxBitmapBundle> bundles(paths.size());
+    for ( size_t n = 0; n < paths.size(); n++ )
+    {
+        if ( parsed[n].svgImage )
         {
-            const size_t len = static_cast<size_t>(lenAsOfs);
+            bundles[n] = wxBitmapBundle(new wxBitmapBundleImplSVG(parsed[n].svgImage,
+                                                                  sizeDef,
+                                                                  parsed[n].id));
+        }
+    }
+
+    return bundles;
+}
 
-            wxCharBuffer buf(len);
-            char* const ptr = buf.data();
-            if ( file.Read(ptr, len) == len )
-                return wxBitmapBundle::FromSVG(ptr, sizeDef);
+/* static */
+void
+wxBitmapBundle::PrerasterizeSVG(const wxVector<wxBitmapBundle>& bundles,
+                                const wxVector<wxSize>& sizes)
+{
+#if wxUSE_THREADS
+    wxCHECK_RET( wxThread::IsMain(), wxS("must be called from the main thread") );
+
+    // We need the application object to get the results back in this thread.
+    if ( !wxTheApp )
+        return;
+
+    const wxSVGRasterCache& cache = wxSVGRasterCache::Get();
+
+    for ( size_t n = 0; n < bundles.size(); n++ )
+    {
+        const wxBitmapBundleImplSVG* const
+            impl = dynamic_cast<wxBitmapBundleImplSVG*>(bundles[n].GetImpl());
+        if ( !impl )
+            continue;
+
+        // Skip the sizes which are already available.
+        const wxUint64 id = impl->GetId();
+
+        wxVector<wxSize> sizesToDo;
+        for ( size_t i = 0; i < sizes.size(); i++ )
+        {
+            if ( !cache.Has(wxSVGRasterKey(id, sizes[i])) )
+                sizesToDo.push_back(sizes[i]);
         }
+
+        if ( sizesToDo.empty() )
+            continue;
+
+        // Note that the task must not reference the bundle itself, as its
+        // reference count is not thread-safe, so it only uses the parsed
+        // image which may be used from any thread.
+        const wxSVGParsedImagePtr image = impl->GetParsedImage();
+
+        wxThreadPool::Get().Post([image, id, sizesToDo]()
+        {
+            NSVGrasterizer* const rasterizer = nsvgCreateRasterizer();
+            if ( !rasterizer )
+                return;
+
+            for ( size_t i = 0; i < sizesToDo.size(); i++ )
+            {
+                const wxSize size = sizesToDo[i];
+
+                std::shared_ptr<wxVector<unsigned char>>
+                    buffer(new wxVector<unsigned char>());
+                image->Rasterize(rasterizer, size, *buffer);
+
+                // Creating bitmaps is only possible in the main thread, so
+                // do it there. Note that using wxTheApp here is safe because
+                // the thread pool is shut down, waiting for this task, before
+                // the application object is destroyed.
+                wxTheApp->CallAfter([id, size, buffer]()
+                {
+                    wxSVGRasterCache& cacheMain = wxSVGRasterCache::Get();
+
+                    const wxSVGRasterKey key(id, size);
+
+                    // It could have been already rasterized in the meanwhile.
+                    if ( cacheMain.Has(key) )
+                        return;
+
+                    const wxBitmap bitmap = CreateBitmapFromRGBA(size, &(*buffer)[0]);
+                    if ( bitmap.IsOk() )
+                        cacheMain.Add(key, bitmap);
+                });
+            }
+
+            nsvgDeleteRasterizer(rasterizer);
+        });
     }
-#endif // !wxNO_SVG_FILE
+#else // !wxUSE_THREADS
+    wxUnusedVar(bundles);
+    wxUnusedVar(sizes);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+// ----------------------------------------------------------------------------
+// SVG cache functions
+// ----------------------------------------------------------------------------
+
+/* static */
+void wxBitmapBundle::SetSVGCacheLimit(size_t maxBytes)
+{
+    wxSVGRasterCache::Get().SetMaxBytes(maxBytes);
+}
+
+/* static */
+size_t wxBitmapBundle::GetSVGCacheLimit()
+{
+    return wxSVGRasterCache::Get().GetMaxBytes();
+}
 
-    return wxBitmapBundle();
+/* static */
+void wxBitmapBundle::ClearSVGCache()
+{
+    wxSVGRasterCache::Get().Clear();
+}
+
+/* static */
+wxBitmapBundleCacheStats wxBitmapBundle::GetSVGCacheStats()
+{
+    return wxSVGRasterCache::Get().GetStats();
 }
 
 #endif // wxHAS_SVG
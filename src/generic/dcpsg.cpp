@@ -26,10 +26,16 @@
 
 #include "wx/prntbase.h"
 #include "wx/generic/prntdlgg.h"
+#include "wx/generic/private/dcpsg.h"
 #include "wx/paper.h"
 #include "wx/filename.h"
 #include "wx/stdpaths.h"
 
+#if wxUSE_ZLIB && wxUSE_STREAMS
+    #include "wx/mstream.h"
+    #include "wx/zstream.h"
+#endif
+
 #ifdef __WXMSW__
 
 #ifdef DrawText
@@ -210,6 +216,106 @@ static const char *wxPostScriptHeaderStrSplit =
 "    }loop\n"        // [ str-items
 "  ]\n"              // [ str-items ]
 "} def\n";
+// Short names for the most often used operators, to make the output smaller.
+static const char *wxPostScriptHeaderProcs =
+"/n { newpath } bind def\n"
+"/m { moveto } bind def\n"
+"/l { lineto } bind def\n"
+"/c { curveto } bind def\n"
+"/h { closepath } bind def\n"
+"/s { stroke } bind def\n"
+"/f { fill } bind def\n"
+"/ef { eofill } bind def\n"
+"/w { setlinewidth } bind def\n"
+"/rg { setrgbcolor } bind def\n"
+"/ln {\n"                  // x1 y1 x2 y2
+"  newpath 4 2 roll\n"     // x2 y2 x1 y1
+"  moveto lineto stroke\n"
+"} bind def\n"
+"/re {\n"                  // x1 y1 x2 y2
+"  newpath\n"
+"  3 index 3 index moveto\n"
+"  1 index 3 index lineto\n"
+"  2 copy lineto\n"
+"  3 -1 roll pop exch pop\n" // x1 y2
+"  lineto closepath\n"
+"} bind def\n";
+
+// Draw the image described by the dictionary on the stack, without the
+// DataSource entry, using the data following it in the current file and
+// encoded using ASCII85 and Flate filters.
+//
+// Note that the remaining data is explicitly skipped after drawing the image
+// as Flate decoder may not read the end of its input.
+static const char *wxPostScriptHeaderFlateImage =
+"/flateimage {\n"                       // dict
+"  currentfile /ASCII85Decode filter\n" // dict a85
+"  dup /FlateDecode filter\n"           // dict a85 flate
+"  3 -1 roll dup /DataSource\n"         // a85 flate dict dict /DataSource
+"  4 -1 roll put\n"                     // a85 dict
+"  image\n"                             // a85
+"  flushfile\n"
+"} bind def\n";
+
+// Size of the buffer used for the output: when it's full, the data is written
+// to the file or stream.
+static const size_t PS_BUFFER_SIZE = 64*1024;
+
+size_t wxFormatPSNumber(double value, char *buf)
+{
+    // Fall back to the slow, but general, function for the huge numbers which
+    // can't appear in the normal output anyhow.
+    if ( !(fabs(value) < 1e15) )
+    {
+        const wxScopedCharBuffer str = wxString::FromCDouble(value, 3).utf8_str();
+        const size_t len = wxMin(str.length(), size_t(31));
+        memcpy(buf, str.data(), len);
+        return len;
+    }
+
+    const bool negative = value < 0;
+    const wxUint64 n = static_cast<wxUint64>(fabs(value) * 1000 + 0.5);
+
+    char tmp[32];
+    char* const end = tmp + WXSIZEOF(tmp);
+    char* p = end;
+
+    unsigned frac = static_cast<unsigned>(n % 1000);
+    if ( frac )
+    {
+        int digits = 3;
+        while ( frac % 10 == 0 )
+        {
+            frac /= 10;
+            digits--;
+        }
+
+        while ( digits-- )
+        {
+            *--p = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+
+        *--p = '.';
+    }
+
+    wxUint64 whole = n / 1000;
+    do
+    {
+        *--p = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    }
+    while ( whole );
+
+    // Don't output "-0".
+    if ( negative && n )
+        *--p = '-';
+
+    const size_t len = end - p;
+    memcpy(buf, p, len);
+    return len;
+}
+
 //-------------------------------------------------------------------------------
 // wxPostScriptDC
 //-------------------------------------------------------------------------------
@@ -227,6 +333,11 @@ wxPostScriptDC::wxPostScriptDC(const wxPrintData& printData)
 {
 }
 
+void wxPostScriptDC::EnableImageCompression(bool enable)
+{
+    static_cast<wxPostScriptDCImpl*>(GetImpl())->EnableImageCompression(enable);
+}
+
 // we don't want to use only 72 dpi from PS print
 static const int DPI = 600;
 static const double PS2DEV = 600.0 / 72.0;
@@ -303,10 +414,14 @@ void wxPostScriptDCImpl::Init()
     m_underlineThickness = 0.0;
 
     m_isFontChanged = false;
+
+    m_compressImages = false;
 }
 
 wxPostScriptDCImpl::~wxPostScriptDCImpl ()
 {
+    PsFlush();
+
     if (m_pstream)
     {
         fclose( m_pstream );
@@ -314,6 +429,15 @@ wxPostScriptDCImpl::~wxPostScriptDCImpl ()
     }
 }
 
+void wxPostScriptDCImpl::EnableImageCompression(bool enable)
+{
+#if wxUSE_ZLIB && wxUSE_STREAMS
+    m_compressImages = enable;
+#else
+    wxUnusedVar(enable);
+#endif
+}
+
 bool wxPostScriptDCImpl::IsOk() const
 {
   return m_ok;
@@ -346,20 +470,10 @@ void wxPostScriptDCImpl::DoSetClippingRegion (wxCoord x, wxCoord y, wxCoord w, w
 
     m_clipping = true;
 
-    wxString buffer;
-    buffer.Printf( "gsave\n"
-                   "newpath\n"
-                   "%f %f moveto\n"
-                   "%f %f lineto\n"
-                   "%f %f lineto\n"
-                   "%f %f lineto\n"
-                   "closepath clip newpath\n",
-            XLOG2DEV(x),   YLOG2DEV(y),
-            XLOG2DEV(x+w), YLOG2DEV(y),
-            XLOG2DEV(x+w), YLOG2DEV(y+h),
-            XLOG2DEV(x),   YLOG2DEV(y+h) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrint( "gsave\n" );
+    PsPrintOp( { XLOG2DEV(x),   YLOG2DEV(y),
+                 XLOG2DEV(x+w), YLOG2DEV(y+h) }, "re" );
+    PsPrint( "clip newpath\n" );
 }
 
 
@@ -409,15 +523,8 @@ void wxPostScriptDCImpl::DoDrawLine (wxCoord x1, wxCoord y1, wxCoord x2, wxCoord
 
     SetPen( m_pen );
 
-    wxString buffer;
-    buffer.Printf( "newpath\n"
-                   "%f %f moveto\n"
-                   "%f %f lineto\n"
-                   "stroke\n",
-            XLOG2DEV(x1), YLOG2DEV(y1),
-            XLOG2DEV(x2), YLOG2DEV(y2) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrintOp( { XLOG2DEV(x1), YLOG2DEV(y1),
+                 XLOG2DEV(x2), YLOG2DEV(y2) }, "ln" );
 
     CalcBoundingBox( x1, y1, x2, y2 );
 }
@@ -458,16 +565,12 @@ void wxPostScriptDCImpl::DoDrawArc (wxCoord x1, wxCoord y1, wxCoord x2, wxCoord
     int i_radius = wxRound( radius );
 
     // Draw the arc (open)
-    wxString buffer;
     if ( m_brush.IsNonTransparent() || m_pen.IsNonTransparent() )
     {
-        buffer.Printf( "newpath\n"
-                       "%f %f %f %f %f %f ellipse\n",
-                XLOG2DEV(xc), YLOG2DEV(yc),
-                XLOG2DEVREL(i_radius), YLOG2DEVREL(i_radius),
-                alpha1, alpha2 );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint( "n\n" );
+        PsPrintOp( { XLOG2DEV(xc), YLOG2DEV(yc),
+                     XLOG2DEVREL(i_radius), YLOG2DEVREL(i_radius),
+                     alpha1, alpha2 }, "ellipse" );
     }
 
     // Close and fill the arc if brush is not transparent.
@@ -477,25 +580,22 @@ void wxPostScriptDCImpl::DoDrawArc (wxCoord x1, wxCoord y1, wxCoord x2, wxCoord
         // shouldn't be drawn if arc is full.
         if ( x1 != x2 || y1 != y2 )
         {
-            buffer.Printf( "%f %f lineto\n",
-                    XLOG2DEV(xc), YLOG2DEV(yc) );
-            buffer.Replace( ",", "." );
-            PsPrint( buffer );
+            PsPrintOp( { XLOG2DEV(xc), YLOG2DEV(yc) }, "l" );
         }
-        PsPrint( "closepath\n" );
+        PsPrint( "h\n" );
 
         SetBrush(m_brush);
         // We need to preserve current path to draw the contour in the next step.
         if ( m_pen.IsNonTransparent() )
-            PsPrint( "gsave fill grestore\n" );
+            PsPrint( "gsave f grestore\n" );
         else
-            PsPrint( "fill\n" );
+            PsPrint( "f\n" );
     }
 
     if ( m_pen.IsNonTransparent() )
     {
         SetPen(m_pen);
-        PsPrint( "stroke\n" );
+        PsPrint( "s\n" );
     }
 
     CalcBoundingBox( xc-i_radius, yc-i_radius, xc+i_radius, yc+i_radius );
@@ -524,14 +624,10 @@ void wxPostScriptDCImpl::DoDrawEllipticArc(wxCoord x,wxCoord y,wxCoord w,wxCoord
     {
         SetBrush( m_brush );
 
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f %f %f %f %f true ellipticarc\n",
-                  XLOG2DEV(x+w/2), YLOG2DEV(y+h/2),
-                  XLOG2DEVREL(w/2), YLOG2DEVREL(h/2),
-                  sa, ea );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint( "n\n" );
+        PsPrintOp( { XLOG2DEV(x+w/2), YLOG2DEV(y+h/2),
+                     XLOG2DEVREL(w/2), YLOG2DEVREL(h/2),
+                     sa, ea }, "true ellipticarc" );
 
         CalcBoundingBox( wxPoint(x, y), wxSize(w, h) );
     }
@@ -540,14 +636,10 @@ void wxPostScriptDCImpl::DoDrawEllipticArc(wxCoord x,wxCoord y,wxCoord w,wxCoord
     {
         SetPen( m_pen );
 
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f %f %f %f %f false ellipticarc\n",
-                  XLOG2DEV(x+w/2), YLOG2DEV(y+h/2),
-                  XLOG2DEVREL(w/2), YLOG2DEVREL(h/2),
-                  sa, ea );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint( "n\n" );
+        PsPrintOp( { XLOG2DEV(x+w/2), YLOG2DEV(y+h/2),
+                     XLOG2DEVREL(w/2), YLOG2DEVREL(h/2),
+                     sa, ea }, "false ellipticarc" );
 
         CalcBoundingBox( wxPoint(x, y), wxSize(w, h) );
     }
@@ -562,15 +654,8 @@ void wxPostScriptDCImpl::DoDrawPoint (wxCoord x, wxCoord y)
 
     SetPen (m_pen);
 
-    wxString buffer;
-    buffer.Printf( "newpath\n"
-                   "%f %f moveto\n"
-                   "%f %f lineto\n"
-                   "stroke\n",
-            XLOG2DEV(x),   YLOG2DEV(y),
-            XLOG2DEV(x+1), YLOG2DEV(y) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrintOp( { XLOG2DEV(x),   YLOG2DEV(y),
+                 XLOG2DEV(x+1), YLOG2DEV(y) }, "ln" );
 
     CalcBoundingBox( x, y );
 }
@@ -585,63 +670,18 @@ void wxPostScriptDCImpl::DoDrawPolygon (int n, const wxPoint points[], wxCoord x
     {
         SetBrush( m_brush );
 
-        PsPrint( "newpath\n" );
-
-        double xx = XLOG2DEV(points[0].x + xoffset);
-        double yy = YLOG2DEV(points[0].y + yoffset);
-
-        wxString buffer;
-        buffer.Printf( "%f %f moveto\n", xx, yy );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
-
-        CalcBoundingBox( points[0].x + xoffset, points[0].y + yoffset );
-
-        for (int i = 1; i < n; i++)
-        {
-            xx = XLOG2DEV(points[i].x + xoffset);
-            yy = YLOG2DEV(points[i].y + yoffset);
-
-            buffer.Printf( "%f %f lineto\n", xx, yy );
-            buffer.Replace( ",", "." );
-            PsPrint( buffer );
-
-            CalcBoundingBox( points[i].x + xoffset, points[i].y + yoffset);
-        }
-
-        PsPrint( (fillStyle == wxODDEVEN_RULE ? "eofill\n" : "fill\n") );
+        PsPrint( "n\n" );
+        PsPrintPolyPath( n, points, xoffset, yoffset );
+        PsPrint( (fillStyle == wxODDEVEN_RULE ? "ef\n" : "f\n") );
     }
 
     if ( m_pen.IsNonTransparent() )
     {
         SetPen( m_pen );
 
-        PsPrint( "newpath\n" );
-
-        double xx = XLOG2DEV(points[0].x + xoffset);
-        double yy = YLOG2DEV(points[0].y + yoffset);
-
-        wxString buffer;
-        buffer.Printf( "%f %f moveto\n", xx, yy );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
-
-        CalcBoundingBox( points[0].x + xoffset, points[0].y + yoffset );
-
-        for (int i = 1; i < n; i++)
-        {
-            xx = XLOG2DEV(points[i].x + xoffset);
-            yy = YLOG2DEV(points[i].y + yoffset);
-
-            buffer.Printf( "%f %f lineto\n", xx, yy );
-            buffer.Replace( ",", "." );
-            PsPrint( buffer );
-
-            CalcBoundingBox( points[i].x + xoffset, points[i].y + yoffset);
-        }
-
-        PsPrint( "closepath\n" );
-        PsPrint( "stroke\n" );
+        PsPrint( "n\n" );
+        PsPrintPolyPath( n, points, xoffset, yoffset );
+        PsPrint( "h s\n" );
     }
 }
 
@@ -655,69 +695,28 @@ void wxPostScriptDCImpl::DoDrawPolyPolygon (int n, const int count[], const wxPo
     {
         SetBrush( m_brush );
 
-        PsPrint( "newpath\n" );
+        PsPrint( "n\n" );
 
         int ofs = 0;
         for (int i = 0; i < n; ofs += count[i++])
         {
-            double xx = XLOG2DEV(points[ofs].x + xoffset);
-            double yy = YLOG2DEV(points[ofs].y + yoffset);
-
-            wxString buffer;
-            buffer.Printf( "%f %f moveto\n", xx, yy );
-            buffer.Replace( ",", "." );
-            PsPrint( buffer );
-
-            CalcBoundingBox( points[ofs].x + xoffset, points[ofs].y + yoffset );
-
-            for (int j = 1; j < count[i]; j++)
-            {
-                xx = XLOG2DEV(points[ofs+j].x + xoffset);
-                yy = YLOG2DEV(points[ofs+j].y + yoffset);
-
-                buffer.Printf( "%f %f lineto\n", xx, yy );
-                buffer.Replace( ",", "." );
-                PsPrint( buffer );
-
-                CalcBoundingBox( points[ofs+j].x + xoffset, points[ofs+j].y + yoffset);
-            }
+            PsPrintPolyPath( count[i], points + ofs, xoffset, yoffset );
         }
-        PsPrint( (fillStyle == wxODDEVEN_RULE ? "eofill\n" : "fill\n") );
+        PsPrint( (fillStyle == wxODDEVEN_RULE ? "ef\n" : "f\n") );
     }
 
     if ( m_pen.IsNonTransparent() )
     {
         SetPen( m_pen );
 
-        PsPrint( "newpath\n" );
+        PsPrint( "n\n" );
 
         int ofs = 0;
         for (int i = 0; i < n; ofs += count[i++])
         {
-            double xx = XLOG2DEV(points[ofs].x + xoffset);
-            double yy = YLOG2DEV(points[ofs].y + yoffset);
-
-            wxString buffer;
-            buffer.Printf( "%f %f moveto\n", xx, yy );
-            buffer.Replace( ",", "." );
-            PsPrint( buffer );
-
-            CalcBoundingBox( points[ofs].x + xoffset, points[ofs].y + yoffset );
-
-            for (int j = 1; j < count[i]; j++)
-            {
-                xx = XLOG2DEV(points[ofs+j].x + xoffset);
-                yy = YLOG2DEV(points[ofs+j].y + yoffset);
-
-                buffer.Printf( "%f %f lineto\n", xx, yy );
-                buffer.Replace( ",", "." );
-                PsPrint( buffer );
-
-                CalcBoundingBox( points[ofs+j].x + xoffset, points[ofs+j].y + yoffset);
-            }
+            PsPrintPolyPath( count[i], points + ofs, xoffset, yoffset );
         }
-        PsPrint( "closepath\n" );
-        PsPrint( "stroke\n" );
+        PsPrint( "h s\n" );
     }
 }
 
@@ -732,28 +731,9 @@ void wxPostScriptDCImpl::DoDrawLines (int n, const wxPoint points[], wxCoord xof
 
     SetPen (m_pen);
 
-    int i;
-    for ( i =0; i<n ; i++ )
-        CalcBoundingBox( points[i].x+xoffset, points[i].y+yoffset );
-
-    wxString buffer;
-    buffer.Printf( "newpath\n"
-                   "%f %f moveto\n",
-              XLOG2DEV(points[0].x+xoffset),
-              YLOG2DEV(points[0].y+yoffset) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
-
-    for (i = 1; i < n; i++)
-    {
-        buffer.Printf( "%f %f lineto\n",
-                  XLOG2DEV(points[i].x+xoffset),
-                  YLOG2DEV(points[i].y+yoffset) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
-    }
-
-    PsPrint( "stroke\n" );
+    PsPrint( "n\n" );
+    PsPrintPolyPath( n, points, xoffset, yoffset );
+    PsPrint( "s\n" );
 }
 
 void wxPostScriptDCImpl::DoDrawRectangle (wxCoord x, wxCoord y, wxCoord width, wxCoord height)
@@ -767,20 +747,8 @@ void wxPostScriptDCImpl::DoDrawRectangle (wxCoord x, wxCoord y, wxCoord width, w
     {
         SetBrush( m_brush );
 
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f moveto\n"
-                       "%f %f lineto\n"
-                       "%f %f lineto\n"
-                       "%f %f lineto\n"
-                       "closepath\n"
-                       "fill\n",
-                XLOG2DEV(x),         YLOG2DEV(y),
-                XLOG2DEV(x + width), YLOG2DEV(y),
-                XLOG2DEV(x + width), YLOG2DEV(y + height),
-                XLOG2DEV(x),         YLOG2DEV(y + height) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrintOp( { XLOG2DEV(x),         YLOG2DEV(y),
+                     XLOG2DEV(x + width), YLOG2DEV(y + height) }, "re f" );
 
         CalcBoundingBox( wxPoint(x, y), wxSize(width, height) );
     }
@@ -789,20 +757,8 @@ void wxPostScriptDCImpl::DoDrawRectangle (wxCoord x, wxCoord y, wxCoord width, w
     {
         SetPen (m_pen);
 
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f moveto\n"
-                       "%f %f lineto\n"
-                       "%f %f lineto\n"
-                       "%f %f lineto\n"
-                       "closepath\n"
-                       "stroke\n",
-                XLOG2DEV(x),         YLOG2DEV(y),
-                XLOG2DEV(x + width), YLOG2DEV(y),
-                XLOG2DEV(x + width), YLOG2DEV(y + height),
-                XLOG2DEV(x),         YLOG2DEV(y + height) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrintOp( { XLOG2DEV(x),         YLOG2DEV(y),
+                     XLOG2DEV(x + width), YLOG2DEV(y + height) }, "re s" );
 
         CalcBoundingBox( wxPoint(x, y), wxSize(width, height) );
     }
@@ -825,64 +781,40 @@ void wxPostScriptDCImpl::DoDrawRoundedRectangle (wxCoord x, wxCoord y, wxCoord w
 
     wxCoord rad = (wxCoord) radius;
 
-    if ( m_brush.IsNonTransparent() )
+    for ( int pass = 0; pass < 2; pass++ )
     {
-        SetBrush( m_brush );
-
-        /* Draw rectangle anticlockwise */
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f %f 90 180 arc\n"
-                       "%f %f lineto\n"
-                       "%f %f %f 180 270 arc\n"
-                       "%f %f lineto\n"
-                       "%f %f %f 270 0 arc\n"
-                       "%f %f lineto\n"
-                       "%f %f %f 0 90 arc\n"
-                       "%f %f lineto\n"
-                       "closepath\n"
-                       "fill\n",
-                XLOG2DEV(x + rad), YLOG2DEV(y + rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x), YLOG2DEV(y + height - rad),
-                XLOG2DEV(x + rad), YLOG2DEV(y + height - rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x + width - rad), YLOG2DEV(y + height),
-                XLOG2DEV(x + width - rad), YLOG2DEV(y + height - rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x + width), YLOG2DEV(y + rad),
-                XLOG2DEV(x + width - rad), YLOG2DEV(y + rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x + rad), YLOG2DEV(y) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        // Fill the rectangle during the first pass and draw its outline
+        // during the second one.
+        if ( pass == 0 )
+        {
+            if ( !m_brush.IsNonTransparent() )
+                continue;
 
-        CalcBoundingBox( wxPoint(x, y), wxSize(width, height) );
-    }
+            SetBrush( m_brush );
+        }
+        else
+        {
+            if ( !m_pen.IsNonTransparent() )
+                continue;
 
-    if ( m_pen.IsNonTransparent() )
-    {
-        SetPen (m_pen);
+            SetPen( m_pen );
+        }
 
         /* Draw rectangle anticlockwise */
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f %f 90 180 arc\n"
-                       "%f %f lineto\n"
-                       "%f %f %f 180 270 arc\n"
-                       "%f %f lineto\n"
-                       "%f %f %f 270 0 arc\n"
-                       "%f %f lineto\n"
-                       "%f %f %f 0 90 arc\n"
-                       "%f %f lineto\n"
-                       "closepath\n"
-                       "stroke\n",
-                XLOG2DEV(x + rad), YLOG2DEV(y + rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x), YLOG2DEV(y + height - rad),
-                XLOG2DEV(x + rad), YLOG2DEV(y + height - rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x + width - rad), YLOG2DEV(y + height),
-                XLOG2DEV(x + width - rad), YLOG2DEV(y + height - rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x + width), YLOG2DEV(y + rad),
-                XLOG2DEV(x + width - rad), YLOG2DEV(y + rad), XLOG2DEVREL(rad),
-                XLOG2DEV(x + rad), YLOG2DEV(y) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint( "n\n" );
+        PsPrintOp( { XLOG2DEV(x + rad), YLOG2DEV(y + rad), XLOG2DEVREL(rad) },
+                   "90 180 arc" );
+        PsPrintOp( { XLOG2DEV(x), YLOG2DEV(y + height - rad) }, "l" );
+        PsPrintOp( { XLOG2DEV(x + rad), YLOG2DEV(y + height - rad), XLOG2DEVREL(rad) },
+                   "180 270 arc" );
+        PsPrintOp( { XLOG2DEV(x + width - rad), YLOG2DEV(y + height) }, "l" );
+        PsPrintOp( { XLOG2DEV(x + width - rad), YLOG2DEV(y + height - rad), XLOG2DEVREL(rad) },
+                   "270 0 arc" );
+        PsPrintOp( { XLOG2DEV(x + width), YLOG2DEV(y + rad) }, "l" );
+        PsPrintOp( { XLOG2DEV(x + width - rad), YLOG2DEV(y + rad), XLOG2DEVREL(rad) },
+                   "0 90 arc" );
+        PsPrintOp( { XLOG2DEV(x + rad), YLOG2DEV(y) }, "l" );
+        PsPrint( pass == 0 ? "h f\n" : "h s\n" );
 
         CalcBoundingBox( wxPoint(x, y), wxSize(width, height) );
     }
@@ -899,14 +831,10 @@ void wxPostScriptDCImpl::DoDrawEllipse (wxCoord x, wxCoord y, wxCoord width, wxC
     {
         SetBrush (m_brush);
 
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f %f %f 0 360 ellipse\n"
-                       "fill\n",
-                XLOG2DEV(x + width / 2), YLOG2DEV(y + height / 2),
-                XLOG2DEVREL(width / 2), YLOG2DEVREL(height / 2) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint( "n\n" );
+        PsPrintOp( { XLOG2DEV(x + width / 2), YLOG2DEV(y + height / 2),
+                     XLOG2DEVREL(width / 2), YLOG2DEVREL(height / 2) },
+                   "0 360 ellipse f" );
 
         CalcBoundingBox( x - width, y - height, x + width, y + height );
     }
@@ -915,14 +843,10 @@ void wxPostScriptDCImpl::DoDrawEllipse (wxCoord x, wxCoord y, wxCoord width, wxC
     {
         SetPen (m_pen);
 
-        wxString buffer;
-        buffer.Printf( "newpath\n"
-                       "%f %f %f %f 0 360 ellipse\n"
-                       "stroke\n",
-                XLOG2DEV(x + width / 2), YLOG2DEV(y + height / 2),
-                XLOG2DEVREL(width / 2), YLOG2DEVREL(height / 2) );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint( "n\n" );
+        PsPrintOp( { XLOG2DEV(x + width / 2), YLOG2DEV(y + height / 2),
+                     XLOG2DEVREL(width / 2), YLOG2DEVREL(height / 2) },
+                   "0 360 ellipse s" );
 
         CalcBoundingBox( x - width, y - height, x + width, y + height );
     }
@@ -952,24 +876,64 @@ void wxPostScriptDCImpl::DoDrawBitmap( const wxBitmap& bitmap, wxCoord x, wxCoor
     double xx = XLOG2DEV(x);
     double yy = YLOG2DEV(y + bitmap.GetHeight());
 
+    const unsigned char* data = image.GetData();
+    const size_t dataLen = 3*size_t(w)*size_t(h);
+
+#if wxUSE_ZLIB && wxUSE_STREAMS
+    if ( m_compressImages )
+    {
+        wxMemoryOutputStream compressed;
+        {
+            wxZlibOutputStream zstream(compressed, -1, wxZLIB_ZLIB);
+            zstream.Write(data, dataLen);
+        }
+
+        PsPrint( "gsave\n" );
+        PsPrintOp( { xx, yy }, "translate" );
+        PsPrintOp( { ww, hh }, "scale" );
+
+        wxString buffer;
+        buffer.Printf( "/DeviceRGB setcolorspace\n"
+                       "<<\n"
+                       "/ImageType 1\n"
+                       "/Width %d\n"
+                       "/Height %d\n"
+                       "/BitsPerComponent 8\n"
+                       "/Decode [0 1 0 1 0 1]\n"
+                       "/ImageMatrix [%d 0 0 %d 0 %d]\n"
+                       ">>\n",
+                w, h, w, -h, h );
+        PsPrint( buffer );
+        PsPrint( "flateimage\n" );
+
+        const wxStreamBuffer* const sbuf = compressed.GetOutputStreamBuffer();
+        PsPrintASCII85( static_cast<const unsigned char*>(sbuf->GetBufferStart()),
+                        compressed.GetLength() );
+
+        PsPrint( "grestore\n" );
+        return;
+    }
+#endif // wxUSE_ZLIB && wxUSE_STREAMS
+
     wxString buffer;
     buffer.Printf( "/origstate save def\n"
                    "20 dict begin\n"
                    "/pix %d string def\n"
                    "/grays %d string def\n"
                    "/npixels 0 def\n"
-                   "/rgbindx 0 def\n"
-                   "%f %f translate\n"
-                   "%f %f scale\n"
-                   "%d %d 8\n"
+                   "/rgbindx 0 def\n",
+            w, w );
+    PsPrint( buffer );
+    PsPrintOp( { xx, yy }, "translate" );
+    PsPrintOp( { ww, hh }, "scale" );
+    buffer.Printf( "%d %d 8\n"
                    "[%d 0 0 %d 0 %d]\n"
                    "{currentfile pix readhexstring pop}\n"
                    "false 3 colorimage\n",
-            w, w, xx, yy, ww, hh, w, h, w, -h, h );
-    buffer.Replace( ",", "." );
+            w, h, w, -h, h );
     PsPrint( buffer );
 
-    unsigned char* data = image.GetData();
+    static const char hexDigits[] = "0123456789ABCDEF";
 
     // size of the buffer = width*rgb(3)*hexa(2)+'\n'
     wxCharBuffer charbuffer(w*6 + 1);
@@ -982,20 +946,14 @@ void wxPostScriptDCImpl::DoDrawBitmap( const wxBitmap& bitmap, wxCoord x, wxCoor
         //cols
         for (int i = 0; i < w*3; i++)
         {
-            char c1, c2;
-            wxDecToHex(*data, &c1, &c2);
-            *(bufferindex++) = c1;
-            *(bufferindex++) = c2;
+            *(bufferindex++) = hexDigits[*data >> 4];
+            *(bufferindex++) = hexDigits[*data & 0x0f];
 
             data++;
         }
         *(bufferindex++) = '\n';
-        *bufferindex = 0;
 
-        if (m_pstream)
-            fwrite( charbuffer, 1, strlen( charbuffer ), m_pstream );
-        else
-            PsPrint( charbuffer );
+        PsWrite( charbuffer.data(), bufferindex - charbuffer.data() );
     }
 
     PsPrint( "end\n" );
@@ -1027,10 +985,7 @@ void wxPostScriptDCImpl::SetPSColour(const wxColor& col)
         double bluePS = (double)blue / 255.0;
         double greenPS = (double)green / 255.0;
 
-        wxString buffer;
-        buffer.Printf( "%f %f %f setrgbcolor\n", redPS, greenPS, bluePS );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrintOp( { redPS, greenPS, bluePS }, "rg" );
 
         m_currentRed = red;
         m_currentBlue = blue;
@@ -1140,9 +1095,9 @@ void wxPostScriptDCImpl::SetPSFont()
 
     // Select font
     double size = m_font.GetPointSize() * double(GetFontPointSizeAdjustment(DPI));
-    buffer.Printf( "%s findfont %f scalefont setfont\n", name, size * m_scaleX );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrint( name );
+    PsPrint( " findfont " );
+    PsPrintOp( { size * m_scaleX }, "scalefont setfont" );
 
     m_isFontChanged = false;
 }
@@ -1168,10 +1123,9 @@ void wxPostScriptDCImpl::SetPen( const wxPen& pen )
     else
         width = (double) m_pen.GetWidth();
 
+    PsPrintOp( { width * DEV2PS * m_scaleX }, "w" );
+
     wxString buffer;
-    buffer.Printf( "%f setlinewidth\n", width * DEV2PS * m_scaleX );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
 
 /*
      Line style - WRONG: 2nd arg is OFFSET
@@ -1318,22 +1272,20 @@ void wxPostScriptDCImpl::DrawAnyText(const wxWX2MBbuf& textbuf, wxCoord textDesc
         // uy = by + text_descent - m_underlinePosition =>
         // dy = -(text_descent - m_underlinePosition)
         // It's negated due to the orientation of Y-axis.
-        buffer.Printf( "  gsave\n"
-                       "  0.0 %f rmoveto\n"
-                       "  %f setlinewidth\n"
-                       "  dup stringwidth rlineto\n"
-                       "  stroke\n"
-                       "  grestore\n",
-                        -YLOG2DEVREL(textDescent - int(m_underlinePosition)),
-                        m_underlineThickness );
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrint(       "  gsave\n" );
+        PsPrint(       "  0 " );
+        PsPrintOp( { -YLOG2DEVREL(textDescent - int(m_underlinePosition)) },
+                       "rmoveto" );
+        PsPrint(       "  " );
+        PsPrintOp( { m_underlineThickness }, "w" );
+        PsPrint(       "  dup stringwidth rlineto\n"
+                       "  s\n"
+                       "  grestore\n" );
     }
     PsPrint(           "  show\n" ); // x y
     // Advance to the beginning of th next line.
-    buffer.Printf(     "  %f add moveto\n", -YLOG2DEVREL(int(lineHeight)) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrint(           "  " );
+    PsPrintOp( { -YLOG2DEVREL(int(lineHeight)) }, "add m" );
     // Execute above statements for all elements of the array
     PsPrint(           "} forall\n" );
 }
@@ -1357,10 +1309,7 @@ void wxPostScriptDCImpl::DoDrawText( const wxString& text, wxCoord x, wxCoord y
 //        - note that there is still rounding error in text_descent!
     wxCoord by = y + size - text_descent; // baseline
 
-    wxString buffer;
-    buffer.Printf( "%f %f moveto\n", XLOG2DEV(x), YLOG2DEV(by) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrintOp( { XLOG2DEV(x), YLOG2DEV(by) }, "m" );
 
     DrawAnyText(textbuf, text_descent, size);
 
@@ -1391,20 +1340,12 @@ void wxPostScriptDCImpl::DoDrawRotatedText( const wxString& text, wxCoord x, wxC
     wxCoord bx = wxRound(x + (size - text_descent) * sin(rad));
     wxCoord by = wxRound(y + (size - text_descent) * cos(rad));
 
-    wxString buffer;
-    buffer.Printf( "%f %f moveto\n", XLOG2DEV(bx), YLOG2DEV(by));
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
-
-    buffer.Printf( "%f rotate\n", angle );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrintOp( { XLOG2DEV(bx), YLOG2DEV(by) }, "m" );
+    PsPrintOp( { angle }, "rotate" );
 
     DrawAnyText(textbuf, text_descent, size);
 
-    buffer.Printf( "%f rotate\n", -angle );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrintOp( { -angle }, "rotate" );
 
     wxCoord w, h;
     GetOwner()->GetMultiLineTextExtent(text, &w, &h);
@@ -1444,14 +1385,9 @@ void wxPostScriptDCImpl::DoDrawSpline( const wxPointList *points )
     wxPoint2DDouble p2(*pt);
     wxPoint2DDouble p3 = (p1 + p2) / 2.0;
 
-    wxString buffer;
-    buffer.Printf( "newpath\n"
-                   "%f %f moveto\n"
-                   "%f %f lineto\n",
-            XLOG2DEV(wxRound(p1.m_x)), YLOG2DEV(wxRound(p1.m_y)),
-            XLOG2DEV(wxRound(p3.m_x)), YLOG2DEV(wxRound(p3.m_y)) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrint( "n\n" );
+    PsPrintOp( { XLOG2DEV(wxRound(p1.m_x)), YLOG2DEV(wxRound(p1.m_y)) }, "m" );
+    PsPrintOp( { XLOG2DEV(wxRound(p3.m_x)), YLOG2DEV(wxRound(p3.m_y)) }, "l" );
 
     CalcBoundingBox( (wxCoord)p1.m_x, (wxCoord)p1.m_y );
     CalcBoundingBox( (wxCoord)p3.m_x, (wxCoord)p3.m_y );
@@ -1469,12 +1405,9 @@ void wxPostScriptDCImpl::DoDrawSpline( const wxPointList *points )
         wxPoint2DDouble c1 = (p0 + (p1 * 2.0)) / 3.0;
         wxPoint2DDouble c2 = ((p1 * 2.0) + p3) / 3.0;
 
-        buffer.Printf("%f %f %f %f %f %f curveto\n",
-            XLOG2DEV(wxRound(c1.m_x)), YLOG2DEV(wxRound(c1.m_y)),
-            XLOG2DEV(wxRound(c2.m_x)), YLOG2DEV(wxRound(c2.m_y)),
-            XLOG2DEV(wxRound(p3.m_x)), YLOG2DEV(wxRound(p3.m_y)));
-        buffer.Replace( ",", "." );
-        PsPrint( buffer );
+        PsPrintOp( { XLOG2DEV(wxRound(c1.m_x)), YLOG2DEV(wxRound(c1.m_y)),
+                     XLOG2DEV(wxRound(c2.m_x)), YLOG2DEV(wxRound(c2.m_y)),
+                     XLOG2DEV(wxRound(p3.m_x)), YLOG2DEV(wxRound(p3.m_y)) }, "c" );
 
         CalcBoundingBox( (wxCoord)p0.m_x, (wxCoord)p0.m_y );
         CalcBoundingBox( (wxCoord)p3.m_x, (wxCoord)p3.m_y );
@@ -1485,11 +1418,7 @@ void wxPostScriptDCImpl::DoDrawSpline( const wxPointList *points )
        next-to-last and last point respectively, in the point list
      */
 
-    buffer.Printf( "%f %f lineto\n"
-                   "stroke\n",
-                   XLOG2DEV(wxRound(p2.m_x)), YLOG2DEV(wxRound(p2.m_y)) );
-    buffer.Replace( ",", "." );
-    PsPrint( buffer );
+    PsPrintOp( { XLOG2DEV(wxRound(p2.m_x)), YLOG2DEV(wxRound(p2.m_y)) }, "l s" );
 
     CalcBoundingBox((wxCoord)p2.m_x, (wxCoord)p2.m_y);
 }
@@ -1632,6 +1561,9 @@ bool wxPostScriptDCImpl::StartDoc( const wxString& WXUNUSED(message) )
 
     m_ok = true;
 
+    m_psBuffer.clear();
+    m_psBuffer.reserve(PS_BUFFER_SIZE);
+
     wxString buffer;
 
     PsPrint( "%!PS-Adobe-2.0\n" );
@@ -1669,6 +1601,10 @@ bool wxPostScriptDCImpl::StartDoc( const wxString& WXUNUSED(message) )
     buffer.Printf( "%%%%DocumentPaperSizes: %s\n", paper );
     PsPrint( buffer );
 
+    // Compressed images use Flate filter which is only available in level 3.
+    if ( m_compressImages )
+        PsPrint( "%%LanguageLevel: 3\n" );
+
     PsPrint( "%%EndComments\n\n" );
 
     PsPrint( "%%BeginProlog\n" );
@@ -1679,6 +1615,9 @@ bool wxPostScriptDCImpl::StartDoc( const wxString& WXUNUSED(message) )
     PsPrint( wxPostScriptHeaderReencodeISO1 );
     PsPrint( wxPostScriptHeaderReencodeISO2 );
     PsPrint( wxPostScriptHeaderStrSplit );
+    PsPrint( wxPostScriptHeaderProcs );
+    if ( m_compressImages )
+        PsPrint( wxPostScriptHeaderFlateImage );
     PsPrint( "%%EndProlog\n" );
 
     SetBrush( *wxBLACK_BRUSH );
@@ -1706,6 +1645,8 @@ void wxPostScriptDCImpl::EndDoc ()
         PsPrint( "grestore\n" );
     }
 
+    PsFlush();
+
     if ( m_pstream ) {
         fclose( m_pstream );
         m_pstream = nullptr;
@@ -1881,7 +1822,114 @@ wxCoord wxPostScriptDCImpl::GetCharHeight() const
 
 void wxPostScriptDCImpl::PsPrint( const wxString& str )
 {
-    const wxCharBuffer psdata(str.utf8_str());
+    const wxScopedCharBuffer psdata(str.utf8_str());
+
+    PsWrite( psdata.data(), psdata.length() );
+}
+
+void wxPostScriptDCImpl::PsPrint( const char* psdata )
+{
+    PsWrite( psdata, strlen( psdata ) );
+}
+
+void wxPostScriptDCImpl::PsPrint( char ch )
+{
+    PsWrite( &ch, 1 );
+}
+
+void wxPostScriptDCImpl::PsWrite( const char* data, size_t len )
+{
+    m_psBuffer.append( data, len );
+
+    if ( m_psBuffer.length() >= PS_BUFFER_SIZE )
+        PsFlush();
+}
+
+void wxPostScriptDCImpl::PsPrintOp( std::initializer_list<double> values,
+                                    const char* op )
+{
+    char buf[32];
+    for ( double value : values )
+    {
+        const size_t len = wxFormatPSNumber( value, buf );
+        buf[len] = ' ';
+        m_psBuffer.append( buf, len + 1 );
+    }
+
+    PsPrint( op );
+    PsPrint( '\n' );
+}
+
+void wxPostScriptDCImpl::PsPrintPolyPath( int n, const wxPoint points[],
+                                          wxCoord xoffset, wxCoord yoffset )
+{
+    for ( int i = 0; i < n; i++ )
+    {
+        const wxCoord x = points[i].x + xoffset;
+        const wxCoord y = points[i].y + yoffset;
+
+        PsPrintOp( { XLOG2DEV(x), YLOG2DEV(y) }, i == 0 ? "m" : "l" );
+
+        CalcBoundingBox( x, y );
+    }
+}
+
+void wxPostScriptDCImpl::PsPrintASCII85( const unsigned char* data, size_t len )
+{
+    // Break the lines after this number of characters: this is not required,
+    // but is friendlier to the tools processing the output line by line.
+    static const int MAX_LINE_LEN = 75;
+
+    char line[MAX_LINE_LEN + 5 + 1];
+    int pos = 0;
+
+    for ( size_t n = 0; n < len; n += 4 )
+    {
+        const size_t count = wxMin(len - n, size_t(4));
+
+        wxUint32 tuple = 0;
+        for ( size_t i = 0; i < 4; i++ )
+        {
+            tuple <<= 8;
+            if ( i < count )
+                tuple |= data[n + i];
+        }
+
+        if ( tuple == 0 && count == 4 )
+        {
+            // Special abbreviation for a group of zeroes.
+            line[pos++] = 'z';
+        }
+        else
+        {
+            char encoded[5];
+            for ( int i = 4; i >= 0; i-- )
+            {
+                encoded[i] = static_cast<char>('!' + tuple % 85);
+                tuple /= 85;
+            }
+
+            // Partial group of N bytes is output as N+1 characters.
+            memcpy(line + pos, encoded, count + 1);
+            pos += count + 1;
+        }
+
+        if ( pos >= MAX_LINE_LEN )
+        {
+            line[pos++] = '\n';
+            PsWrite( line, pos );
+            pos = 0;
+        }
+    }
+
+    PsWrite( line, pos );
+    PsPrint( "~>\n" );
+}
+
+void wxPostScriptDCImpl::PsFlush()
+{
+    if ( m_psBuffer.empty() )
+        return;
 
     switch (m_printData.GetPrintMode())
     {
@@ -1894,19 +1942,32 @@ void wxPostScriptDCImpl::PsPrint( const wxString& str )
                 // wxPostScriptPrintNativeData methods on it crashes.
                 wxPostScriptPrintNativeData *data =
                     wxDynamicCast(m_printData.GetNativeData(), wxPostScriptPrintNativeData);
-                wxCHECK_RET( data, wxS("Cannot obtain output stream") );
-                wxOutputStream* outputstream = data->GetOutputStream();
-                wxCHECK_RET( outputstream, wxT("invalid outputstream") );
-                outputstream->Write( psdata, strlen( psdata ) );
+                wxOutputStream* outputstream = data ? data->GetOutputStream() : nullptr;
+                if ( !outputstream )
+                {
+                    m_psBuffer.clear();
+                    wxFAIL_MSG( wxS("Cannot obtain output stream") );
+                    return;
+                }
+
+                outputstream->Write( m_psBuffer.data(), m_psBuffer.length() );
             }
             break;
 #endif // wxUSE_STREAMS
 
         // save data into file
         default:
-            wxCHECK_RET( m_pstream, wxT("invalid postscript dc") );
-            fwrite( psdata, 1, strlen( psdata ), m_pstream );
+            if ( !m_pstream )
+            {
+                m_psBuffer.clear();
+                wxFAIL_MSG( wxS("invalid postscript dc") );
+                return;
+            }
+
+            fwrite( m_psBuffer.data(), 1, m_psBuffer.length(), m_pstream );
     }
+
+    m_psBuffer.clear();
 }
 
 void wxPostScriptDCImpl::DoGetTextExtent(const wxString& string,
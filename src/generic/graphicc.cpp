@@ -25,6 +25,8 @@
 #include <cairo.h>
 #include <float.h>
 
+#include <atomic>
+
 bool wxCairoInit();
 
 #ifndef WX_PRECOMP
@@ -34,11 +36,14 @@ bool wxCairoInit();
     #include "wx/dcmemory.h"
     #include "wx/dcprint.h"
     #include "wx/log.h"
+    #include "wx/module.h"
     #include "wx/window.h"
 #endif
 
+#include "wx/private/glyphcache.h"
 #include "wx/private/graphics.h"
 #include "wx/rawbmp.h"
+#include "wx/thread.h"
 #include "wx/vector.h"
 #include "wx/display.h"
 #ifdef __WXMSW__
@@ -101,7 +106,7 @@ using namespace std;
 #include <cairo-quartz.h>
 #endif
 
-// Helper functions for dealing with alpha pre-multiplication.
+// Helper function for dealing with alpha pre-multiplication.
 namespace
 {
 
@@ -110,13 +115,223 @@ namespace
         return alpha ? (data * alpha) / 0xff : data;
     }
 
-    inline unsigned char Unpremultiply(unsigned char alpha, unsigned char data)
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// Caches of the native objects
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Counters returned by wxGetCairoCacheStats(): they are atomic because the
+// graphics objects may be used from different threads.
+std::atomic<unsigned long> gs_pathHits(0);
+std::atomic<unsigned long> gs_pathMisses(0);
+std::atomic<unsigned long> gs_patternHits(0);
+std::atomic<unsigned long> gs_patternMisses(0);
+
+inline void IncrementCacheCounter(std::atomic<unsigned long>& counter)
+{
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Hatch patterns don't depend on anything but the style, the colour and the
+// type of the target surface, so they are shared by all pens and brushes: this
+// avoids rendering them again every time wxGraphicsContext::SetPen() or
+// SetBrush() is called with the same wxPen or wxBrush, as this creates a new
+// graphics object each time.
+//
+// The single global cache object is owned by wxCairoGraphicsModule, which
+// destroys it before Cairo can be unloaded.
+class wxCairoHatchPatternCache
+{
+public:
+    wxCairoHatchPatternCache() = default;
+
+    ~wxCairoHatchPatternCache()
     {
-        return alpha ? (data * 0xff) / alpha : data;
+        for ( size_t n = 0; n < m_entries.size(); n++ )
+            cairo_pattern_destroy(m_entries[n].pattern);
     }
 
+    // Return a new reference to the pattern for the given hatch style and
+    // colour to be used with the given target, creating it if necessary.
+    cairo_pattern_t* Get(cairo_surface_t* target,
+                         wxHatchStyle hatchStyle,
+                         double red, double green, double blue, double alpha)
+    {
+        const cairo_surface_type_t surfaceType = cairo_surface_get_type(target);
+
+        wxCRIT_SECT_LOCKER(lock, m_cs);
+
+        for ( size_t n = 0; n < m_entries.size(); n++ )
+        {
+            const Entry& e = m_entries[n];
+            if ( e.surfaceType == surfaceType &&
+                    e.hatchStyle == hatchStyle &&
+                    e.red == red && e.green == green &&
+                        e.blue == blue && e.alpha == alpha )
+            {
+                IncrementCacheCounter(gs_patternHits);
+                return cairo_pattern_reference(e.pattern);
+            }
+        }
+
+        IncrementCacheCounter(gs_patternMisses);
+
+        // Don't let the cache grow indefinitely: the programs using many
+        // different hatch colours are rare and it's fine to recreate the
+        // patterns for them.
+        if ( m_entries.size() == MAX_ENTRIES )
+        {
+            cairo_pattern_destroy(m_entries.front().pattern);
+            m_entries.erase(m_entries.begin());
+        }
+
+        Entry e;
+        e.surfaceType = surfaceType;
+        e.hatchStyle = hatchStyle;
+        e.red = red;
+        e.green = green;
+        e.blue = blue;
+        e.alpha = alpha;
+        e.pattern = Create(target, hatchStyle, red, green, blue, alpha);
+        m_entries.push_back(e);
+
+        return cairo_pattern_reference(e.pattern);
+    }
+
+    // Create a new pattern without caching it.
+    static cairo_pattern_t* Create(cairo_surface_t* target,
+                                   wxHatchStyle hatchStyle,
+                                   double red, double green,
+                                   double blue, double alpha);
+
+    // Get the global cache, may return null if it doesn't exist (yet or any
+    // more).
+    static wxCairoHatchPatternCache* Get() { return ms_instance; }
+
+    // Create or destroy the global cache, only called by the module.
+    static void Initialize() { ms_instance = new wxCairoHatchPatternCache(); }
+    static void CleanUp() { wxDELETE(ms_instance); }
+
+private:
+    enum { MAX_ENTRIES = 32 };
+
+    struct Entry
+    {
+        cairo_surface_type_t surfaceType;
+        wxHatchStyle hatchStyle;
+        double red, green, blue, alpha;
+        cairo_pattern_t* pattern;
+    };
+
+    wxVector<Entry> m_entries;
+
+    static wxCairoHatchPatternCache* ms_instance;
+
+#if wxUSE_THREADS
+    wxCriticalSection m_cs;
+#endif // wxUSE_THREADS
+
+    wxDECLARE_NO_COPY_CLASS(wxCairoHatchPatternCache);
+};
+
+wxCairoHatchPatternCache* wxCairoHatchPatternCache::ms_instance = nullptr;
+
+/* static */
+cairo_pattern_t*
+wxCairoHatchPatternCache::Create(cairo_surface_t* target,
+                                 wxHatchStyle hatchStyle,
+                                 double red, double green,
+                                 double blue, double alpha)
+{
+    // Use a surface similar to the target one, so that the hatch is not
+    // rasterized when drawing on the vector surfaces, such as PDF or SVG
+    // ones: this is why the patterns are cached per surface type.
+    cairo_surface_t* const
+        surface = cairo_surface_create_similar(target,
+                                               CAIRO_CONTENT_COLOR_ALPHA,
+                                               10, 10);
+
+    cairo_t* const cr = cairo_create(surface);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+    cairo_set_line_width(cr, 1);
+    cairo_set_line_join(cr,CAIRO_LINE_JOIN_MITER);
+
+    switch ( hatchStyle )
+    {
+        case wxHATCHSTYLE_CROSS:
+            cairo_move_to(cr, 5, 0);
+            cairo_line_to(cr, 5, 10);
+            cairo_move_to(cr, 0, 5);
+            cairo_line_to(cr, 10, 5);
+            break;
+
+        case wxHATCHSTYLE_BDIAGONAL:
+            cairo_move_to(cr, 0, 10);
+            cairo_line_to(cr, 10, 0);
+            break;
+
+        case wxHATCHSTYLE_FDIAGONAL:
+            cairo_move_to(cr, 0, 0);
+            cairo_line_to(cr, 10, 10);
+            break;
+
+        case wxHATCHSTYLE_CROSSDIAG:
+            cairo_move_to(cr, 0, 0);
+            cairo_line_to(cr, 10, 10);
+            cairo_move_to(cr, 10, 0);
+            cairo_line_to(cr, 0, 10);
+            break;
+
+        case wxHATCHSTYLE_HORIZONTAL:
+            cairo_move_to(cr, 0, 5);
+            cairo_line_to(cr, 10, 5);
+            break;
+
+        case wxHATCHSTYLE_VERTICAL:
+            cairo_move_to(cr, 5, 0);
+            cairo_line_to(cr, 5, 10);
+            break;
+
+        default:
+            wxFAIL_MSG(wxS("Invalid hatch pattern style."));
+    }
+
+    cairo_set_source_rgba(cr, red, green, blue, alpha);
+    cairo_stroke(cr);
+
+    cairo_destroy(cr);
+
+    cairo_pattern_t* const pattern = cairo_pattern_create_for_surface(surface);
+    cairo_surface_destroy(surface);
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+
+    return pattern;
+}
+
 } // anonymous namespace
 
+wxCairoCacheStats wxGetCairoCacheStats()
+{
+    wxCairoCacheStats stats;
+    stats.pathHits = gs_pathHits.load(std::memory_order_relaxed);
+    stats.pathMisses = gs_pathMisses.load(std::memory_order_relaxed);
+    stats.patternHits = gs_patternHits.load(std::memory_order_relaxed);
+    stats.patternMisses = gs_patternMisses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void wxResetCairoCacheStats()
+{
+    gs_pathHits = 0;
+    gs_pathMisses = 0;
+    gs_patternHits = 0;
+    gs_patternMisses = 0;
+}
+
 class WXDLLIMPEXP_CORE wxCairoPathData : public wxGraphicsPathData
 {
 public :
@@ -184,10 +399,27 @@ public :
 
     virtual bool Contains( wxDouble x, wxDouble y, wxPolygonFillMode fillStyle = wxWINDING_RULE) const override;
 
+    // Return the copy of the path which can be appended to a Cairo context.
+    //
+    // Unlike GetNativePath(), this copy is owned by this object and is reused
+    // until the path changes, so drawing the same path many times is cheap.
+    const cairo_path_t* GetCachedPath() const;
+
 private :
+    // Must be called whenever the path changes.
+    void InvalidateCachedPath();
+
     cairo_t* m_pathContext;
+
+    // Cached copy of the path returned by GetCachedPath(), may be null.
+    mutable cairo_path_t* m_cachedPath;
 };
 
+inline const wxCairoPathData* GetCairoPathData(const wxGraphicsPath& path)
+{
+    return static_cast<const wxCairoPathData*>(path.GetPathData());
+}
+
 class WXDLLIMPEXP_CORE wxCairoMatrixData : public wxGraphicsMatrixData
 {
 public :
@@ -285,9 +517,6 @@ protected:
     class wxCairoBitmapData* m_bmpdata;
 
 private:
-    // Called once to allocate m_pattern if needed.
-    void InitHatchPattern(cairo_t* ctext);
-
     wxHatchStyle m_hatchStyle;
 
     wxDECLARE_NO_COPY_CLASS(wxCairoPenBrushBaseData);
@@ -345,6 +574,9 @@ public:
 #ifdef __WXGTK__
     const wxFont& GetFont() const { return m_wxfont; }
 #endif
+
+    // Return the key identifying this font in wxGlyphAdvanceCache.
+    wxString GetGlyphCacheKey() const;
 private :
     void InitColour(const wxColour& col);
     void InitFontComponents(const wxString& facename,
@@ -509,6 +741,9 @@ public:
     virtual void GetTextExtent( const wxString &str, wxDouble *width, wxDouble *height,
                                 wxDouble *descent, wxDouble *externalLeading ) const override;
     virtual void GetPartialTextExtents(const wxString& text, wxArrayDouble& widths) const override;
+    virtual void GetMultipleTextExtents(const wxArrayString& strings,
+                                        wxArrayDouble& widths,
+                                        wxArrayDouble& heights) const override;
 
 #ifdef __WXMSW__
     virtual WXHDC GetNativeHDC() override;
@@ -694,68 +929,6 @@ wxCairoPenBrushBaseData::~wxCairoPenBrushBaseData()
         cairo_pattern_destroy(m_pattern);
 }
 
-void wxCairoPenBrushBaseData::InitHatchPattern(cairo_t* ctext)
-{
-    cairo_surface_t* const
-        surface = cairo_surface_create_similar(
-                    cairo_get_target(ctext), CAIRO_CONTENT_COLOR_ALPHA, 10, 10
-                );
-
-    cairo_t* const cr = cairo_create(surface);
-    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
-    cairo_set_line_width(cr, 1);
-    cairo_set_line_join(cr,CAIRO_LINE_JOIN_MITER);
-
-    switch ( m_hatchStyle )
-    {
-        case wxHATCHSTYLE_CROSS:
-            cairo_move_to(cr, 5, 0);
-            cairo_line_to(cr, 5, 10);
-            cairo_move_to(cr, 0, 5);
-            cairo_line_to(cr, 10, 5);
-            break;
-
-        case wxHATCHSTYLE_BDIAGONAL:
-            cairo_move_to(cr, 0, 10);
-            cairo_line_to(cr, 10, 0);
-            break;
-
-        case wxHATCHSTYLE_FDIAGONAL:
-            cairo_move_to(cr, 0, 0);
-            cairo_line_to(cr, 10, 10);
-            break;
-
-        case wxHATCHSTYLE_CROSSDIAG:
-            cairo_move_to(cr, 0, 0);
-            cairo_line_to(cr, 10, 10);
-            cairo_move_to(cr, 10, 0);
-            cairo_line_to(cr, 0, 10);
-            break;
-
-        case wxHATCHSTYLE_HORIZONTAL:
-            cairo_move_to(cr, 0, 5);
-            cairo_line_to(cr, 10, 5);
-            break;
-
-        case wxHATCHSTYLE_VERTICAL:
-            cairo_move_to(cr, 5, 0);
-            cairo_line_to(cr, 5, 10);
-            break;
-
-        default:
-            wxFAIL_MSG(wxS("Invalid hatch pattern style."));
-    }
-
-    cairo_set_source_rgba(cr, m_red, m_green, m_blue, m_alpha);
-    cairo_stroke(cr);
-
-    cairo_destroy(cr);
-
-    m_pattern = cairo_pattern_create_for_surface(surface);
-    cairo_surface_destroy(surface);
-    cairo_pattern_set_extend(m_pattern, CAIRO_EXTEND_REPEAT);
-}
-
 void wxCairoPenBrushBaseData::InitStipple(wxBitmap* bmp)
 {
     wxCHECK_RET( bmp && bmp->IsOk(), wxS("Invalid stippled bitmap") );
@@ -767,8 +940,8 @@ void wxCairoPenBrushBaseData::InitStipple(wxBitmap* bmp)
 
 void wxCairoPenBrushBaseData::InitHatch(wxHatchStyle hatchStyle)
 {
-    // We can't create m_pattern right now as we don't have the Cairo context
-    // needed for it, so just remember that we need to do it.
+    // Don't create m_pattern right now as the pen or brush may be never used,
+    // just remember that we need to do it.
     m_hatchStyle = hatchStyle;
 }
 
@@ -776,13 +949,30 @@ void wxCairoPenBrushBaseData::Apply( wxGraphicsContext* context )
 {
     cairo_t* const ctext = (cairo_t*) context->GetNativeContext();
 
-    if ( m_hatchStyle != wxHATCHSTYLE_INVALID && !m_pattern )
-        InitHatchPattern(ctext);
-
     if ( m_pattern )
-        cairo_set_source(ctext, m_pattern);
+    {
+        IncrementCacheCounter(gs_patternHits);
+    }
+    else if ( m_hatchStyle != wxHATCHSTYLE_INVALID )
+    {
+        cairo_surface_t* const target = cairo_get_target(ctext);
+
+        wxCairoHatchPatternCache* const cache = wxCairoHatchPatternCache::Get();
+        m_pattern = cache ? cache->Get(target, m_hatchStyle,
+                                       m_red, m_green, m_blue, m_alpha)
+                          : wxCairoHatchPatternCache::Create(target, m_hatchStyle,
+                                                             m_red, m_green,
+                                                             m_blue, m_alpha);
+    }
     else
-        cairo_set_source_rgba(ctext, m_red, m_green, m_blue, m_alpha);
+    {
+        // Create the solid pattern once instead of letting
+        // cairo_set_source_rgba() do it every time we're used.
+        IncrementCacheCounter(gs_patternMisses);
+        m_pattern = cairo_pattern_create_rgba(m_red, m_green, m_blue, m_alpha);
+    }
+
+    cairo_set_source(ctext, m_pattern);
 }
 
 void wxCairoPenBrushBaseData::AddGradientStops(const wxGraphicsGradientStops& stops)
@@ -1246,6 +1436,15 @@ void wxCairoFontData::Apply( wxGraphicsContext* context )
     cairo_set_font_size(ctext, m_size );
 }
 
+wxString wxCairoFontData::GetGlyphCacheKey() const
+{
+    // Notice that the text extents returned by Cairo are in user space and
+    // so don't depend on the current transformation matrix.
+    return wxString::Format("cairo|%s|%g|%d|%d",
+                            wxString::FromUTF8(m_fontName), m_size,
+                            int(m_slant), int(m_weight));
+}
+
 //-----------------------------------------------------------------------------
 // wxCairoPathData implementation
 //-----------------------------------------------------------------------------
@@ -1253,6 +1452,8 @@ void wxCairoFontData::Apply( wxGraphicsContext* context )
 wxCairoPathData::wxCairoPathData( wxGraphicsRenderer* renderer, cairo_t* pathcontext)
     : wxGraphicsPathData(renderer)
 {
+    m_cachedPath = nullptr;
+
     if (pathcontext)
     {
         m_pathContext = pathcontext;
@@ -1267,6 +1468,7 @@ wxCairoPathData::wxCairoPathData( wxGraphicsRenderer* renderer, cairo_t* pathcon
 
 wxCairoPathData::~wxCairoPathData()
 {
+    InvalidateCachedPath();
     cairo_destroy(m_pathContext);
 }
 
@@ -1276,12 +1478,34 @@ wxGraphicsObjectRefData *wxCairoPathData::Clone() const
     cairo_t* pathcontext = cairo_create(surface);
     cairo_surface_destroy (surface);
 
-    cairo_path_t* path = cairo_copy_path(m_pathContext);
-    cairo_append_path(pathcontext, path);
-    cairo_path_destroy(path);
+    cairo_append_path(pathcontext, GetCachedPath());
     return new wxCairoPathData( GetRenderer() ,pathcontext);
 }
 
+const cairo_path_t* wxCairoPathData::GetCachedPath() const
+{
+    if ( m_cachedPath )
+    {
+        IncrementCacheCounter(gs_pathHits);
+    }
+    else
+    {
+        IncrementCacheCounter(gs_pathMisses);
+        m_cachedPath = cairo_copy_path(m_pathContext);
+    }
+
+    return m_cachedPath;
+}
+
+void wxCairoPathData::InvalidateCachedPath()
+{
+    if ( m_cachedPath )
+    {
+        cairo_path_destroy(m_cachedPath);
+        m_cachedPath = nullptr;
+    }
+}
+
 
 void* wxCairoPathData::GetNativePath() const
 {
@@ -1299,28 +1523,34 @@ void wxCairoPathData::UnGetNativePath(void *p) const
 
 void wxCairoPathData::MoveToPoint( wxDouble x , wxDouble y )
 {
+    InvalidateCachedPath();
     cairo_move_to(m_pathContext,x,y);
 }
 
 void wxCairoPathData::AddLineToPoint( wxDouble x , wxDouble y )
 {
+    InvalidateCachedPath();
     cairo_line_to(m_pathContext,x,y);
 }
 
 void wxCairoPathData::AddPath( const wxGraphicsPathData* path )
 {
-    cairo_path_t* p = (cairo_path_t*)path->GetNativePath();
-    cairo_append_path(m_pathContext, p);
-    UnGetNativePath(p);
+    // Notice that the path may be this path itself, so only invalidate our
+    // cached copy after appending it.
+    const wxCairoPathData* const other = static_cast<const wxCairoPathData*>(path);
+    cairo_append_path(m_pathContext, other->GetCachedPath());
+    InvalidateCachedPath();
 }
 
 void wxCairoPathData::CloseSubpath()
 {
+    InvalidateCachedPath();
     cairo_close_path(m_pathContext);
 }
 
 void wxCairoPathData::AddCurveToPoint( wxDouble cx1, wxDouble cy1, wxDouble cx2, wxDouble cy2, wxDouble x, wxDouble y )
 {
+    InvalidateCachedPath();
     cairo_curve_to(m_pathContext,cx1,cy1,cx2,cy2,x,y);
 }
 
@@ -1337,6 +1567,8 @@ void wxCairoPathData::GetCurrentPoint( wxDouble* x, wxDouble* y) const
 
 void wxCairoPathData::AddArc( wxDouble x, wxDouble y, wxDouble r, double startAngle, double endAngle, bool clockwise )
 {
+    InvalidateCachedPath();
+
     // as clockwise means positive in our system (y pointing downwards)
     // TODO make this interpretation dependent of the
     // real device trans
@@ -1354,6 +1586,10 @@ void wxCairoPathData::Transform( const wxGraphicsMatrixData* matrix )
     cairo_matrix_t m = *((cairo_matrix_t*) matrix->GetNativeMatrix());
     cairo_matrix_invert( &m );
     cairo_transform(m_pathContext,&m);
+
+    // The path returned by cairo_copy_path() is in the user space, so it's
+    // affected by the change of the transformation too.
+    InvalidateCachedPath();
 }
 
 // gets the bounding box enclosing all points (possibly including control points)
@@ -1405,11 +1641,13 @@ bool wxCairoPathData::Contains( wxDouble x, wxDouble y, wxPolygonFillMode fillSt
 
 void wxCairoPathData::AddRectangle(wxDouble x, wxDouble y, wxDouble w, wxDouble h)
 {
+    InvalidateCachedPath();
     cairo_rectangle(m_pathContext, x, y, w, h);
 }
 
 void wxCairoPathData::AddCircle(wxDouble x, wxDouble y, wxDouble r)
 {
+    InvalidateCachedPath();
     cairo_move_to(m_pathContext, x+r, y);
     cairo_arc(m_pathContext, x, y, r, 0.0, 2*M_PI);
     cairo_close_path(m_pathContext);
@@ -1420,6 +1658,8 @@ void wxCairoPathData::AddEllipse(wxDouble x, wxDouble y, wxDouble w, wxDouble h)
     if (w <= 0 || h <= 0)
         return;
 
+    InvalidateCachedPath();
+
     cairo_move_to(m_pathContext, x+w, y+h/2.0);
     w /= 2.0;
     h /= 2.0;
@@ -1765,106 +2005,30 @@ wxCairoBitmapData::wxCairoBitmapData(wxGraphicsRenderer* renderer,
 
     int stride = InitBuffer(image.GetWidth(), image.GetHeight(), bufferFormat);
 
-    // Copy wxImage data into the buffer. Notice that we work with wxUint32
-    // values and not bytes becase Cairo always works with buffers in native
-    // endianness.
-    wxUint32* dst = reinterpret_cast<wxUint32*>(m_buffer);
-    const unsigned char* src = image.GetData();
-
-    if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
-    {
-        const unsigned char* alpha = image.GetAlpha();
-
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const unsigned char a = alpha ? *alpha : wxALPHA_OPAQUE;
-
-                *dst++ = a                    << 24 |
-                         ((a * src[0]) / 255) << 16 |
-                         ((a * src[1]) / 255) <<  8 |
-                         ((a * src[2]) / 255);
-                src += 3;
-
-                if ( alpha )
-                    alpha++;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
-    else // RGB
-    {
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                *dst++ = src[0] << 16 |
-                         src[1] <<  8 |
-                         src[2];
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
-
-    // if there is a mask, set the alpha bytes in the target buffer to
-    // fully transparent or retain original value
-    if ( image.HasMask() )
-    {
-        unsigned char mr = image.GetMaskRed();
-        unsigned char mg = image.GetMaskGreen();
-        unsigned char mb = image.GetMaskBlue();
-
-        dst = reinterpret_cast<wxUint32*>(m_buffer);
-        src = image.GetData();
-
-        if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
-        {
-            for ( int y = 0; y < m_height; y++ )
-            {
-                wxUint32* const rowStartDst = dst;
-
-                for ( int x = 0; x < m_width; x++ )
-                {
-                    if ( src[0] == mr && src[1] == mg && src[2] == mb )
-                        *dst = 0;
-
-                    dst++;
-                    src += 3;
-                }
-
-                dst = rowStartDst + stride / 4;
-            }
-        }
-    }
+    // This takes care of both alpha and mask, if any, and the result can be
+    // used for RGB24 format too, as the alpha byte is just ignored by it.
+    image.CopyToPremultipliedARGB(m_buffer, stride);
 
     InitSurface(bufferFormat, stride);
 }
 
 wxImage wxCairoBitmapData::ConvertToImage() const
 {
-    wxImage image(m_width, m_height, false /* don't clear */);
-
     // Get the surface type and format.
     wxCHECK_MSG( cairo_surface_get_type(m_surface) == CAIRO_SURFACE_TYPE_IMAGE,
                  wxNullImage,
                  wxS("Can't convert non-image surface to image.") );
 
+    bool hasAlpha;
     switch ( cairo_image_surface_get_format(m_surface) )
     {
         case CAIRO_FORMAT_ARGB32:
-            image.SetAlpha();
+            hasAlpha = true;
             break;
 
         case CAIRO_FORMAT_RGB24:
-            // Nothing to do, we don't use alpha by default.
+            // We don't use alpha by default.
+            hasAlpha = false;
             break;
 
         case CAIRO_FORMAT_A8:
@@ -1879,62 +2043,17 @@ wxImage wxCairoBitmapData::ConvertToImage() const
 
     // Prepare for copying data.
     cairo_surface_flush(m_surface);
-    const wxUint32* src = (wxUint32*)cairo_image_surface_get_data(m_surface);
+    const unsigned char* src = cairo_image_surface_get_data(m_surface);
     wxCHECK_MSG( src, wxNullImage, wxS("Failed to get Cairo surface data.") );
 
     int stride = cairo_image_surface_get_stride(m_surface);
     wxCHECK_MSG( stride > 0, wxNullImage,
                  wxS("Failed to get Cairo surface stride.") );
 
-    // As we work with wxUint32 pointers and not char ones, we need to adjust
-    // the stride accordingly. This should be lossless as the stride must be a
-    // multiple of pixel size.
-    wxASSERT_MSG( !(stride % sizeof(wxUint32)), wxS("Unexpected stride.") );
-    stride /= sizeof(wxUint32);
-
-    unsigned char* dst = image.GetData();
-    unsigned char *alpha = image.GetAlpha();
-    if ( alpha )
-    {
-        // We need to also copy alpha and undo the pre-multiplication as Cairo
-        // stores pre-multiplied values in this format while wxImage does not.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
-
-                const unsigned char a = argb >> 24;
-                *alpha++ = a;
-
-                // Copy the RGB data undoing the pre-multiplication.
-                *dst++ = Unpremultiply(a, argb >> 16);
-                *dst++ = Unpremultiply(a, argb >>  8);
-                *dst++ = Unpremultiply(a, argb);
-            }
-
-            src = rowStart + stride;
-        }
-    }
-    else // RGB
-    {
-        // Things are pretty simple in this case, just copy RGB bytes.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
-
-                *dst++ = (argb & 0x00ff0000) >> 16;
-                *dst++ = (argb & 0x0000ff00) >>  8;
-                *dst++ = (argb & 0x000000ff);
-            }
-
-            src = rowStart + stride;
-        }
-    }
+    // Cairo uses exactly the format expected by this function, including
+    // pre-multiplication of the colour components by alpha.
+    wxImage image;
+    image.CreateFromPremultipliedARGB(m_width, m_height, src, stride, hasAlpha);
 
     return image;
 }
@@ -2544,8 +2663,17 @@ void wxCairoContext::Init(cairo_t *context, bool storeInitClip)
     // Attempt to find the system font scaling parameter (e.g. "Fonts->Scaling
     // Factor" in Gnome Tweaks, "Force font DPI" in KDE System Settings or
     // GDK_DPI_SCALE environment variable).
-    GdkScreen* screen = gdk_screen_get_default();
-    m_fontScalingFactor = screen ? float(gdk_screen_get_resolution(screen) / 96.0) : 1.0f;
+    //
+    // GDK can only be used from the main thread, so remember the value found
+    // there and reuse it for the contexts created by the other threads, e.g.
+    // when rendering images in parallel.
+    static std::atomic<float> s_fontScalingFactor(1.0f);
+    if ( wxIsMainThread() )
+    {
+        GdkScreen* screen = gdk_screen_get_default();
+        s_fontScalingFactor = screen ? float(gdk_screen_get_resolution(screen) / 96.0) : 1.0f;
+    }
+    m_fontScalingFactor = s_fontScalingFactor;
 #endif
 
     m_context = context;
@@ -2760,11 +2888,9 @@ void wxCairoContext::StrokePath( const wxGraphicsPath& path )
     if ( !m_pen.IsNull() )
     {
         OffsetHelper helper(ShouldOffset(), m_context, m_pen);
-        cairo_path_t* cp = (cairo_path_t*) path.GetNativePath() ;
-        cairo_append_path(m_context,cp);
+        cairo_append_path(m_context, GetCairoPathData(path)->GetCachedPath());
         ((wxCairoPenData*)m_pen.GetRefData())->Apply(this);
         cairo_stroke(m_context);
-        path.UnGetNativePath(cp);
     }
 }
 
@@ -2773,12 +2899,10 @@ void wxCairoContext::FillPath( const wxGraphicsPath& path , wxPolygonFillMode fi
     if ( !m_brush.IsNull() )
     {
         OffsetHelper helper(ShouldOffset(), m_context, m_pen);
-        cairo_path_t* cp = (cairo_path_t*) path.GetNativePath() ;
-        cairo_append_path(m_context,cp);
+        cairo_append_path(m_context, GetCairoPathData(path)->GetCachedPath());
         ((wxCairoBrushData*)m_brush.GetRefData())->Apply(this);
         cairo_set_fill_rule(m_context,fillStyle==wxODDEVEN_RULE ? CAIRO_FILL_RULE_EVEN_ODD : CAIRO_FILL_RULE_WINDING);
         cairo_fill(m_context);
-        path.UnGetNativePath(cp);
     }
 }
 
@@ -3073,6 +3197,76 @@ void wxCairoContext::GetTextExtent( const wxString &str, wxDouble *width, wxDoub
     }
 }
 
+void wxCairoContext::GetMultipleTextExtents(const wxArrayString& strings,
+                                            wxArrayDouble& widths,
+                                            wxArrayDouble& heights) const
+{
+    const size_t count = strings.size();
+
+    widths.assign(count, 0.);
+    heights.assign(count, 0.);
+
+    wxCHECK_RET( !m_font.IsNull(), wxT("wxCairoContext::GetMultipleTextExtents - no valid font set") );
+
+    wxCairoFontData* const
+        fontData = static_cast<wxCairoFontData*>(m_font.GetRefData());
+
+#ifdef __WXGTK__
+    // Contrary to GetTextExtent(), create the layout and set its font only
+    // once, as this is much more expensive than measuring the text itself.
+    const wxFont& font = fontData->GetFont();
+    if ( font.IsOk() )
+    {
+        wxGtkObject<PangoLayout> layout(pango_cairo_create_layout(m_context));
+        ApplyFont(layout, font);
+
+        for ( size_t i = 0; i < count; ++i )
+        {
+            if ( strings[i].empty() )
+                continue;
+
+            const wxCharBuffer data = strings[i].utf8_str();
+            if ( !data )
+                continue;
+
+            int w, h;
+            pango_layout_set_text(layout, data, data.length());
+            pango_layout_get_pixel_size(layout, &w, &h);
+
+            widths[i] = w;
+            heights[i] = h;
+        }
+
+        return;
+    }
+#endif // __WXGTK__
+
+    fontData->Apply(const_cast<wxCairoContext*>(this));
+
+    cairo_font_extents_t fe;
+    cairo_font_extents(m_context, &fe);
+
+    // See the comments in GetTextExtent() about these adjustments.
+    if ( fe.descent < 0 )
+        fe.descent = -fe.descent;
+
+    if ( fe.height < (fe.ascent + fe.descent ) )
+        fe.height = fe.ascent + fe.descent;
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+        if ( strings[i].empty() )
+            continue;
+
+        const wxWX2MBbuf buf(strings[i].mb_str(wxConvUTF8));
+        cairo_text_extents_t te;
+        cairo_text_extents(m_context, buf, &te);
+
+        widths[i] = te.width;
+        heights[i] = fe.height;
+    }
+}
+
 void wxCairoContext::GetPartialTextExtents(const wxString& text, wxArrayDouble& widths) const
 {
     widths.Empty();
@@ -3145,14 +3339,43 @@ void wxCairoContext::GetPartialTextExtents(const wxString& text, wxArrayDouble&
     while (i++ < len)
         widths.Add(PANGO_PIXELS(w));
 #else
-    for (size_t i = 0; i < text.length(); i++)
+    // Measuring all the substrings of the text would be too slow for long
+    // strings, so sum the advances of the individual characters instead,
+    // caching them as they are measured.
+    wxCairoFontData* const
+        fontData = static_cast<wxCairoFontData*>(m_font.GetRefData());
+    fontData->Apply(const_cast<wxCairoContext*>(this));
+
+    const wxString key = fontData->GetGlyphCacheKey();
+    wxGlyphAdvanceCache& cache = wxGlyphAdvanceCache::Get();
+
+    wxVector<double> advances;
+    if ( cache.Lookup(key, text, advances) )
     {
-        const wxCharBuffer data = text.SubString(0, i).utf8_str();
+        size_t n = 0;
+        for ( wxString::const_iterator it = text.begin();
+              it != text.end();
+              ++it, ++n )
+        {
+            if ( advances[n] >= 0 )
+                continue;
 
-        cairo_text_extents_t te;
-        cairo_text_extents(m_context, (const char*)data, &te);
+            const wxCharBuffer data = wxString(*it).utf8_str();
+
+            cairo_text_extents_t te;
+            cairo_text_extents(m_context, (const char*)data, &te);
 
-        widths.push_back(te.width);
+            advances[n] = te.x_advance;
+        }
+
+        cache.Store(key, text, advances);
+    }
+
+    double w = 0;
+    for ( size_t n = 0; n < advances.size(); n++ )
+    {
+        w += advances[n];
+        widths.push_back(w);
     }
 #endif
 }
@@ -3728,6 +3951,44 @@ wxGraphicsRenderer* wxGraphicsRenderer::GetCairoRenderer()
     return &gs_cairoGraphicsRenderer;
 }
 
+// ----------------------------------------------------------------------------
+// wxCairoGraphicsModule: owns the global objects using Cairo
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+class wxCairoGraphicsModule : public wxModule
+{
+public:
+    wxCairoGraphicsModule()
+    {
+#ifndef __WXGTK__
+        // Cairo is loaded dynamically in this case and our objects must be
+        // destroyed before it is unloaded.
+        AddDependency("wxCairoModule");
+#endif
+    }
+
+    virtual bool OnInit() override
+    {
+        wxCairoHatchPatternCache::Initialize();
+        return true;
+    }
+
+    virtual void OnExit() override
+    {
+        wxCairoHatchPatternCache::CleanUp();
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxCairoGraphicsModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxCairoGraphicsModule, wxModule);
+
+} // anonymous namespace
+
 #else // !wxUSE_CAIRO
 
 wxGraphicsRenderer* wxGraphicsRenderer::GetCairoRenderer()
@@ -46,6 +46,8 @@
 #include "wx/renderer.h"
 #include "wx/headerctrl.h"
 #include "wx/scopeguard.h"
+#include "wx/thread.h"
+#include "wx/timer.h"
 
 #if wxUSE_CLIPBOARD
     #include "wx/clipbrd.h"
@@ -55,11 +57,16 @@
 #include "wx/generic/gridctrl.h"
 #include "wx/generic/grideditors.h"
 #include "wx/generic/private/grid.h"
+#include "wx/private/threadpool.h"
 
 const char wxGridNameStr[] = "grid";
 
 // Required for wxIs... functions
 #include <ctype.h>
+#include <limits.h>
+
+#include <algorithm>
+#include <deque>
 
 // ----------------------------------------------------------------------------
 // globals
@@ -1217,21 +1224,68 @@ wxGridCellAttrData::FindIndex(int row, int col) const
 
 wxGridRowOrColAttrData::~wxGridRowOrColAttrData()
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    for ( const auto& run : m_runs )
+    {
+        run.attr->DecRef();
+    }
+}
+
+size_t wxGridRowOrColAttrData::FindRun(int rowOrCol) const
+{
+    return std::lower_bound(m_runs.begin(), m_runs.end(), rowOrCol,
+                            [](const Run& run, int n)
+                            {
+                                return run.last < n;
+                            }) - m_runs.begin();
+}
+
+/* static */
+void
+wxGridRowOrColAttrData::AppendRun(Runs& runs,
+                                  int first,
+                                  int last,
+                                  wxGridCellAttr *attr)
+{
+    if ( !runs.empty() )
     {
-        m_attrs[n]->DecRef();
+        Run& prev = runs.back();
+        if ( prev.attr == attr && prev.last + 1 == first )
+        {
+            prev.last = last;
+
+            // we already have a reference to this attribute
+            attr->DecRef();
+            return;
+        }
     }
+
+    const Run run = { first, last, attr };
+    runs.push_back(run);
+}
+
+void wxGridRowOrColAttrData::MergeWithNext(size_t n)
+{
+    if ( n + 1 >= m_runs.size() )
+        return;
+
+    Run& run = m_runs[n];
+    const Run& next = m_runs[n + 1];
+    if ( run.attr != next.attr || run.last + 1 != next.first )
+        return;
+
+    run.last = next.last;
+    next.attr->DecRef();
+    m_runs.erase(m_runs.begin() + n + 1);
 }
 
 wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 {
     wxGridCellAttr *attr = nullptr;
 
-    int n = m_rowsOrCols.Index(rowOrCol);
-    if ( n != wxNOT_FOUND )
+    const size_t n = FindRun(rowOrCol);
+    if ( n < m_runs.size() && m_runs[n].first <= rowOrCol )
     {
-        attr = m_attrs[(size_t)n];
+        attr = m_runs[n].attr;
         attr->IncRef();
     }
 
@@ -1240,70 +1294,124 @@ wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 
 void wxGridRowOrColAttrData::SetAttr(wxGridCellAttr *attr, int rowOrCol)
 {
-    int i = m_rowsOrCols.Index(rowOrCol);
-    if ( i == wxNOT_FOUND )
+    // index at which the run for the new attribute should be inserted
+    size_t n = FindRun(rowOrCol);
+
+    if ( n < m_runs.size() && m_runs[n].first <= rowOrCol )
     {
-        if ( attr )
+        // we already have an attribute for this row or column
+        const Run run = m_runs[n];
+        if ( run.attr == attr )
         {
-            // store the new attribute, taking its ownership
-            m_rowsOrCols.Add(rowOrCol);
-            m_attrs.Add(attr);
+            // as we already own a reference to this attribute, we must
+            // release the one passed to us, this won't destroy it
+            attr->DecRef();
+            return;
         }
-        // nothing to remove
-    }
-    else // we have an attribute for this row or column
-    {
-        size_t n = (size_t)i;
-
-        // notice that this code works correctly even when the old attribute is
-        // the same as the new one: as we own of it, we must call DecRef() on
-        // it in any case and this won't result in destruction of the new
-        // attribute if it's the same as old one because it must have ref count
-        // of at least 2 to be passed to us while we keep a reference to it too
-        m_attrs[n]->DecRef();
 
-        if ( attr )
+        // remove this row or column from the run using the old attribute,
+        // possibly splitting it in two
+        if ( run.first == run.last )
+        {
+            m_runs.erase(m_runs.begin() + n);
+            run.attr->DecRef();
+        }
+        else if ( run.first == rowOrCol )
+        {
+            m_runs[n].first++;
+        }
+        else if ( run.last == rowOrCol )
         {
-            // replace the attribute with the new one
-            m_attrs[n] = attr;
+            m_runs[n].last--;
+            n++;
         }
-        else // remove the attribute
+        else
         {
-            m_rowsOrCols.RemoveAt(n);
-            m_attrs.RemoveAt(n);
+            m_runs[n].last = rowOrCol - 1;
+
+            run.attr->IncRef();
+            const Run after = { rowOrCol + 1, run.last, run.attr };
+            m_runs.insert(m_runs.begin() + n + 1, after);
+            n++;
         }
     }
+
+    if ( !attr )
+        return;
+
+    // store the new attribute, taking its ownership, and merge it with the
+    // neighbouring runs using the same attribute, if any
+    const Run run = { rowOrCol, rowOrCol, attr };
+    m_runs.insert(m_runs.begin() + n, run);
+
+    MergeWithNext(n);
+    if ( n > 0 )
+        MergeWithNext(n - 1);
 }
 
 void wxGridRowOrColAttrData::UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    if ( !numRowsOrCols )
+        return;
+
+    const int first = static_cast<int>(pos);
+
+    // find the first run affected by the change, all the previous ones remain
+    // unchanged
+    const size_t start = FindRun(first);
+    if ( start == m_runs.size() )
+        return;
+
+    Runs runs(m_runs.begin(), m_runs.begin() + start);
+    runs.reserve(m_runs.size() + 1);
+
+    if ( numRowsOrCols > 0 )
     {
-        int & rowOrCol = m_rowsOrCols[n];
-        if ( (size_t)rowOrCol >= pos )
+        // If rows or cols inserted, shift the runs after them and split the
+        // run containing the insertion point, as the new rows or columns
+        // don't have any attributes.
+        for ( size_t n = start; n < m_runs.size(); n++ )
         {
-            if ( numRowsOrCols > 0 )
+            const Run& run = m_runs[n];
+            if ( run.first >= first )
             {
-                // If rows or cols inserted, increment row/col counter where necessary
-                rowOrCol += numRowsOrCols;
+                AppendRun(runs, run.first + numRowsOrCols,
+                          run.last + numRowsOrCols, run.attr);
             }
-            else if ( numRowsOrCols < 0)
+            else
             {
-                // If rows/cols deleted, either decrement row/col counter (if row/col still exists)
-                if ((size_t)rowOrCol >= pos - numRowsOrCols)
-                    rowOrCol += numRowsOrCols;
-                else
-                {
-                    m_rowsOrCols.RemoveAt(n);
-                    m_attrs[n]->DecRef();
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
+                run.attr->IncRef();
+                AppendRun(runs, run.first, first - 1, run.attr);
+                AppendRun(runs, first + numRowsOrCols,
+                          run.last + numRowsOrCols, run.attr);
             }
         }
     }
+    else
+    {
+        // If rows/cols deleted, remove them from the runs and shift the
+        // runs after them, merging the runs which become adjacent if
+        // they use the same attribute.
+        const int end = first - numRowsOrCols;
+        for ( size_t n = start; n < m_runs.size(); n++ )
+        {
+            const Run& run = m_runs[n];
+
+            const int newFirst = run.first < first
+                                    ? run.first
+                                    : wxMax(run.first, end) + numRowsOrCols;
+            const int newLast = run.last < end
+                                    ? wxMin(run.last, first - 1)
+                                    : run.last + numRowsOrCols;
+
+            if ( newFirst <= newLast )
+                AppendRun(runs, newFirst, newLast, run.attr);
+            else
+                run.attr->DecRef();
+        }
+    }
+
+    m_runs.swap(runs);
 }
 
 // ----------------------------------------------------------------------------
@@ -2254,185 +2362,1376 @@ wxString wxGridStringTable::GetCornerLabelValue() const
 }
 
 //////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////
+//
+// A grid table storing typed data in columns.
+//
 
-wxBEGIN_EVENT_TABLE(wxGridSubwindow, wxWindow)
-    EVT_MOUSE_CAPTURE_LOST(wxGridSubwindow::OnMouseCaptureLost)
-wxEND_EVENT_TABLE()
+wxIMPLEMENT_DYNAMIC_CLASS(wxGridColumnarTable, wxGridTableBase);
 
-void wxGridSubwindow::OnMouseCaptureLost(wxMouseCaptureLostEvent& WXUNUSED(event))
+void wxGridColumnarTable::Column::Insert(size_t pos, size_t count)
 {
-    m_owner->CancelMouseCapture();
-}
+    switch ( type )
+    {
+        case Column_Number:
+            numbers.insert(numbers.begin() + pos, count, 0);
+            break;
 
-wxBEGIN_EVENT_TABLE( wxGridRowLabelWindow, wxGridSubwindow )
-    EVT_PAINT( wxGridRowLabelWindow::OnPaint )
-    EVT_MOUSEWHEEL( wxGridRowLabelWindow::OnMouseWheel )
-    EVT_MOUSE_EVENTS( wxGridRowLabelWindow::OnMouseEvent )
-wxEND_EVENT_TABLE()
+        case Column_Float:
+            floats.insert(floats.begin() + pos, count, 0.);
+            break;
 
-void wxGridRowLabelWindow::OnPaint( wxPaintEvent& WXUNUSED(event) )
-{
-    wxPaintDC dc(this);
+        case Column_Bool:
+            bools.insert(bools.begin() + pos, count, false);
+            break;
 
-    // NO - don't do this because it will set both the x and y origin
-    // coords to match the parent scrolled window and we just want to
-    // set the y coord  - MB
-    //
-    // m_owner->PrepareDC( dc );
+        case Column_String:
+            strings.insert(strings.begin() + pos, count, 0);
+            break;
+    }
+}
 
-    int x, y;
-    wxGridWindow *gridWindow = IsFrozen() ? m_owner->m_frozenRowGridWin :
-                                            m_owner->m_gridWin;
-    m_owner->GetGridWindowOffset(gridWindow, x, y);
-    m_owner->CalcGridWindowUnscrolledPosition( x, y, &x, &y, gridWindow );
-    wxPoint pt = dc.GetDeviceOrigin();
-    dc.SetDeviceOrigin( pt.x, pt.y-y );
+void wxGridColumnarTable::Column::Erase(size_t pos, size_t count)
+{
+    switch ( type )
+    {
+        case Column_Number:
+            numbers.erase(numbers.begin() + pos, numbers.begin() + pos + count);
+            break;
 
-    wxArrayInt rows = m_owner->CalcRowLabelsExposed( GetUpdateRegion(), gridWindow);
-    m_owner->DrawRowLabels( dc, rows );
+        case Column_Float:
+            floats.erase(floats.begin() + pos, floats.begin() + pos + count);
+            break;
 
-    if ( IsFrozen() )
-        m_owner->DrawLabelFrozenBorder(dc, this, true);
+        case Column_Bool:
+            bools.erase(bools.begin() + pos, bools.begin() + pos + count);
+            break;
+
+        case Column_String:
+            strings.erase(strings.begin() + pos, strings.begin() + pos + count);
+            break;
+    }
 }
 
-void wxGridRowLabelWindow::OnMouseEvent( wxMouseEvent& event )
+void wxGridColumnarTable::Column::Reserve(size_t count)
 {
-    m_owner->ProcessRowColLabelMouseEvent( wxGridRowOperations(), event, this );
+    switch ( type )
+    {
+        case Column_Number:
+            numbers.reserve(count);
+            break;
+
+        case Column_Float:
+            floats.reserve(count);
+            break;
+
+        case Column_Bool:
+            bools.reserve(count);
+            break;
+
+        case Column_String:
+            strings.reserve(count);
+            break;
+    }
 }
 
-void wxGridRowLabelWindow::OnMouseWheel( wxMouseEvent& event )
+void wxGridColumnarTable::Column::Reset()
 {
-    if (!m_owner->ProcessWindowEvent( event ))
-        event.Skip();
+    std::fill(numbers.begin(), numbers.end(), 0);
+    std::fill(floats.begin(), floats.end(), 0.);
+    std::fill(bools.begin(), bools.end(), false);
+    std::fill(strings.begin(), strings.end(), 0);
+
+    // the strings which are not used any more are only removed from the
+    // dictionary here
+    if ( type == Column_String )
+    {
+        dict.resize(1);
+        dictIndex.clear();
+        dictIndex[wxString()] = 0;
+    }
 }
 
-//////////////////////////////////////////////////////////////////////
+wxUint32 wxGridColumnarTable::Column::GetStringIndex(const wxString& s)
+{
+    const auto it = dictIndex.find(s);
+    if ( it != dictIndex.end() )
+        return it->second;
 
-wxBEGIN_EVENT_TABLE( wxGridColLabelWindow, wxGridSubwindow )
-    EVT_PAINT( wxGridColLabelWindow::OnPaint )
-    EVT_MOUSEWHEEL( wxGridColLabelWindow::OnMouseWheel )
-    EVT_MOUSE_EVENTS( wxGridColLabelWindow::OnMouseEvent )
-wxEND_EVENT_TABLE()
+    const wxUint32 index = static_cast<wxUint32>(dict.size());
+    dict.push_back(s);
+    dictIndex[s] = index;
 
-void wxGridColLabelWindow::OnPaint( wxPaintEvent& WXUNUSED(event) )
+    return index;
+}
+
+wxGridColumnarTable::wxGridColumnarTable()
+        : wxGridTableBase()
 {
-    wxPaintDC dc(this);
+    m_numRows = 0;
+}
 
-    // NO - don't do this because it will set both the x and y origin
-    // coords to match the parent scrolled window and we just want to
-    // set the x coord  - MB
-    //
-    // m_owner->PrepareDC( dc );
+wxGridColumnarTable::wxGridColumnarTable( int numRows )
+        : wxGridTableBase()
+{
+    m_numRows = numRows;
+}
 
-    // Column indices become invalid when the grid is empty, so avoid doing
-    // anything at all in this case.
-    if ( m_owner->GetNumberCols() == 0 )
-        return;
+void wxGridColumnarTable::AppendColumn( ColumnType type, const wxString& label )
+{
+    Column column(type);
+    column.label = label;
+    column.Insert(0, m_numRows);
 
-    int x, y;
-    wxGridWindow *gridWindow = IsFrozen() ? m_owner->m_frozenColGridWin :
-                                            m_owner->m_gridWin;
-    m_owner->GetGridWindowOffset(gridWindow, x, y);
-    m_owner->CalcGridWindowUnscrolledPosition( x, y, &x, &y, gridWindow );
-    wxPoint pt = dc.GetDeviceOrigin();
-    dc.SetDeviceOrigin( pt.x-x, pt.y );
+    if ( type == Column_String )
+    {
+        column.dict.push_back(wxString());
+        column.dictIndex[wxString()] = 0;
+    }
 
-    wxArrayInt cols = m_owner->CalcColLabelsExposed( GetUpdateRegion(), gridWindow );
-    m_owner->DrawColLabels( dc, cols );
+    m_columns.push_back(std::move(column));
 
-    if ( IsFrozen() )
-        m_owner->DrawLabelFrozenBorder(dc, this, false);
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_COLS_APPENDED,
+                                1 );
+    }
 }
 
-void wxGridColLabelWindow::OnMouseEvent( wxMouseEvent& event )
+wxGridColumnarTable::ColumnType wxGridColumnarTable::GetColumnType( int col ) const
 {
-    m_owner->ProcessRowColLabelMouseEvent( wxGridColumnOperations(), event, this );
+    wxCHECK_MSG( col >= 0 && static_cast<size_t>(col) < m_columns.size(),
+                 Column_String,
+                 wxT("invalid column index in wxGridColumnarTable") );
+
+    return m_columns[col].type;
 }
 
-void wxGridColLabelWindow::OnMouseWheel( wxMouseEvent& event )
+void wxGridColumnarTable::ReserveRows( size_t numRows )
 {
-    if (!m_owner->ProcessWindowEvent( event ))
-        event.Skip();
+    for ( auto& column : m_columns )
+        column.Reserve(numRows);
 }
 
-//////////////////////////////////////////////////////////////////////
+wxGridColumnarTable::Column*
+wxGridColumnarTable::GetColumn( int row, int col )
+{
+    wxCHECK_MSG( (row >= 0 && static_cast<size_t>(row) < m_numRows) &&
+                 (col >= 0 && static_cast<size_t>(col) < m_columns.size()),
+                 nullptr,
+                 wxT("invalid row or column index in wxGridColumnarTable") );
 
-wxBEGIN_EVENT_TABLE( wxGridCornerLabelWindow, wxGridSubwindow )
-    EVT_MOUSEWHEEL( wxGridCornerLabelWindow::OnMouseWheel )
-    EVT_MOUSE_EVENTS( wxGridCornerLabelWindow::OnMouseEvent )
-    EVT_PAINT( wxGridCornerLabelWindow::OnPaint )
-wxEND_EVENT_TABLE()
+    return &m_columns[col];
+}
 
-void wxGridCornerLabelWindow::OnPaint( wxPaintEvent& WXUNUSED(event) )
+const wxGridColumnarTable::Column*
+wxGridColumnarTable::GetColumn( int row, int col ) const
 {
-    wxPaintDC dc(this);
-
-    m_owner->DrawCornerLabel(dc);
+    return const_cast<wxGridColumnarTable*>(this)->GetColumn(row, col);
 }
 
-void wxGridCornerLabelWindow::OnMouseEvent( wxMouseEvent& event )
+wxGridColumnarTable::Column*
+wxGridColumnarTable::GetColumnForValues( int col, ColumnType type,
+                                         size_t row, size_t count )
 {
-    m_owner->ProcessCornerLabelMouseEvent( event );
+    wxCHECK_MSG( col >= 0 && static_cast<size_t>(col) < m_columns.size(),
+                 nullptr,
+                 wxT("invalid column index in wxGridColumnarTable") );
+
+    Column& column = m_columns[col];
+    wxCHECK_MSG( column.type == type, nullptr,
+                 wxT("column doesn't contain values of this type") );
+
+    wxCHECK_MSG( row <= m_numRows && count <= m_numRows - row, nullptr,
+                 wxT("invalid rows range in wxGridColumnarTable") );
+
+    return &column;
 }
 
-void wxGridCornerLabelWindow::OnMouseWheel( wxMouseEvent& event )
+void wxGridColumnarTable::SetNumberValues( int col, size_t row,
+                                           const wxLongLong_t* values,
+                                           size_t count )
 {
-    if (!m_owner->ProcessWindowEvent(event))
-        event.Skip();
+    Column* const column = GetColumnForValues(col, Column_Number, row, count);
+    if ( column )
+        std::copy(values, values + count, column->numbers.begin() + row);
 }
 
-//////////////////////////////////////////////////////////////////////
+void wxGridColumnarTable::SetFloatValues( int col, size_t row,
+                                          const double* values,
+                                          size_t count )
+{
+    Column* const column = GetColumnForValues(col, Column_Float, row, count);
+    if ( column )
+        std::copy(values, values + count, column->floats.begin() + row);
+}
 
-wxBEGIN_EVENT_TABLE( wxGridWindow, wxGridSubwindow )
-    EVT_PAINT( wxGridWindow::OnPaint )
-    EVT_MOUSEWHEEL( wxGridWindow::OnMouseWheel )
-    EVT_MOUSE_EVENTS( wxGridWindow::OnMouseEvent )
-    EVT_KEY_DOWN( wxGridWindow::OnKeyDown )
-    EVT_KEY_UP( wxGridWindow::OnKeyUp )
-    EVT_CHAR( wxGridWindow::OnChar )
-    EVT_SET_FOCUS( wxGridWindow::OnFocus )
-    EVT_KILL_FOCUS( wxGridWindow::OnFocus )
-wxEND_EVENT_TABLE()
+void wxGridColumnarTable::SetBoolValues( int col, size_t row,
+                                         const bool* values,
+                                         size_t count )
+{
+    Column* const column = GetColumnForValues(col, Column_Bool, row, count);
+    if ( column )
+        std::copy(values, values + count, column->bools.begin() + row);
+}
 
-void wxGridWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
+void wxGridColumnarTable::SetStringValues( int col, size_t row,
+                                           const wxString* values,
+                                           size_t count )
 {
-    wxAutoBufferedPaintDC dc( this );
-    m_owner->PrepareDCFor( dc, this );
-    wxRegion reg = GetUpdateRegion();
+    Column* const column = GetColumnForValues(col, Column_String, row, count);
+    if ( !column )
+        return;
 
-    wxGridCellCoordsVector dirtyCells = m_owner->CalcCellsExposed( reg , this );
-    m_owner->DrawGridCellArea( dc, dirtyCells );
+    for ( size_t n = 0; n < count; n++ )
+        column->strings[row + n] = column->GetStringIndex(values[n]);
+}
 
-    m_owner->DrawGridSpace( dc, this );
+wxLongLong_t wxGridColumnarTable::GetValueAsLongLong( int row, int col ) const
+{
+    const Column* const column = GetColumn(row, col);
+    if ( !column )
+        return 0;
 
-    m_owner->DrawAllGridWindowLines( dc, reg, this );
+    wxCHECK_MSG( column->type == Column_Number, 0,
+                 wxT("column doesn't contain numbers") );
 
-    m_owner->DrawOverlaySelection( dc, this );
+    return column->numbers[row];
+}
 
-    if ( m_type != wxGridWindow::wxGridWindowNormal )
-        m_owner->DrawFrozenBorder( dc, this );
+void wxGridColumnarTable::SetValueAsLongLong( int row, int col, wxLongLong_t value )
+{
+    Column* const column = GetColumn(row, col);
+    if ( !column )
+        return;
 
-    m_owner->DrawHighlight( dc, dirtyCells );
+    wxCHECK_RET( column->type == Column_Number,
+                 wxT("column doesn't contain numbers") );
+
+    column->numbers[row] = value;
 }
 
-void wxGrid::Render( wxDC& dc,
-                     const wxPoint& position,
-                     const wxSize& size,
-                     const wxGridCellCoords& topLeft,
-                     const wxGridCellCoords& bottomRight,
-                     int style )
+wxString wxGridColumnarTable::GetValue( int row, int col )
 {
-    wxCHECK_RET( bottomRight.GetCol() < GetNumberCols(),
-                 "Invalid right column" );
-    wxCHECK_RET( bottomRight.GetRow() < GetNumberRows(),
-                 "Invalid bottom row" );
+    const Column* const column = GetColumn(row, col);
+    if ( !column )
+        return wxString();
 
-    // store user settings and reset later
+    switch ( column->type )
+    {
+        case Column_Number:
+            return wxString() << column->numbers[row];
 
-    // Don't show row/col highlight of the current cell when rendering
-    const auto currentCellCoords = m_currentCellCoords;
-    m_currentCellCoords = wxGridNoCellCoords;
+        case Column_Float:
+            return wxString::FromDouble(column->floats[row]);
+
+        case Column_Bool:
+            // use the same representation as wxGridCellBoolEditor by default
+            return column->bools[row] ? wxString(wxS("1")) : wxString();
+
+        case Column_String:
+            return column->dict[column->strings[row]];
+    }
+
+    return wxString();
+}
+
+void wxGridColumnarTable::SetValue( int row, int col, const wxString& value )
+{
+    Column* const column = GetColumn(row, col);
+    if ( !column )
+        return;
+
+    // the values which can't be parsed are ignored, as the cell can't be
+    // empty, and the cell keeps its previous value
+    switch ( column->type )
+    {
+        case Column_Number:
+            {
+                wxLongLong_t n;
+                if ( value.ToLongLong(&n) )
+                    column->numbers[row] = n;
+            }
+            break;
+
+        case Column_Float:
+            {
+                double d;
+                if ( value.ToDouble(&d) )
+                    column->floats[row] = d;
+            }
+            break;
+
+        case Column_Bool:
+            column->bools[row] = !value.empty() && value != wxS("0");
+            break;
+
+        case Column_String:
+            column->strings[row] = column->GetStringIndex(value);
+            break;
+    }
+}
+
+bool wxGridColumnarTable::IsEmptyCell( int row, int col )
+{
+    const Column* const column = GetColumn(row, col);
+    if ( !column )
+        return true;
+
+    switch ( column->type )
+    {
+        case Column_Number:
+        case Column_Float:
+            break;
+
+        case Column_Bool:
+            return !column->bools[row];
+
+        case Column_String:
+            return column->strings[row] == 0;
+    }
+
+    return false;
+}
+
+wxString wxGridColumnarTable::GetTypeName( int WXUNUSED(row), int col )
+{
+    switch ( GetColumnType(col) )
+    {
+        case Column_Number:
+            return wxGRID_VALUE_NUMBER;
+
+        case Column_Float:
+            return wxGRID_VALUE_FLOAT;
+
+        case Column_Bool:
+            return wxGRID_VALUE_BOOL;
+
+        case Column_String:
+            break;
+    }
+
+    return wxGRID_VALUE_STRING;
+}
+
+namespace
+{
+
+inline bool FitsInLong(wxLongLong_t value)
+{
+    return value >= LONG_MIN && value <= LONG_MAX;
+}
+
+} // anonymous namespace
+
+bool wxGridColumnarTable::CanGetValueAs( int row, int col,
+                                         const wxString& typeName )
+{
+    // all values can be retrieved as strings
+    if ( typeName == wxGRID_VALUE_STRING )
+        return true;
+
+    if ( typeName != GetTypeName(row, col) )
+        return false;
+
+    // but numbers can only be retrieved using GetValueAsLong() if they fit
+    // into long, which is only 32 bits under Win64
+    if ( typeName == wxGRID_VALUE_NUMBER )
+        return FitsInLong(GetValueAsLongLong(row, col));
+
+    return true;
+}
+
+long wxGridColumnarTable::GetValueAsLong( int row, int col )
+{
+    const wxLongLong_t value = GetValueAsLongLong(row, col);
+
+    wxCHECK_MSG( FitsInLong(value), 0,
+                 wxT("number doesn't fit in long, use GetValueAsLongLong()") );
+
+    return static_cast<long>(value);
+}
+
+double wxGridColumnarTable::GetValueAsDouble( int row, int col )
+{
+    const Column* const column = GetColumn(row, col);
+    if ( !column )
+        return 0.;
+
+    wxCHECK_MSG( column->type == Column_Float, 0.,
+                 wxT("column doesn't contain floating point numbers") );
+
+    return column->floats[row];
+}
+
+bool wxGridColumnarTable::GetValueAsBool( int row, int col )
+{
+    const Column* const column = GetColumn(row, col);
+    if ( !column )
+        return false;
+
+    wxCHECK_MSG( column->type == Column_Bool, false,
+                 wxT("column doesn't contain booleans") );
+
+    return column->bools[row];
+}
+
+void wxGridColumnarTable::SetValueAsLong( int row, int col, long value )
+{
+    SetValueAsLongLong(row, col, value);
+}
+
+void wxGridColumnarTable::SetValueAsDouble( int row, int col, double value )
+{
+    Column* const column = GetColumn(row, col);
+    if ( !column )
+        return;
+
+    wxCHECK_RET( column->type == Column_Float,
+                 wxT("column doesn't contain floating point numbers") );
+
+    column->floats[row] = value;
+}
+
+void wxGridColumnarTable::SetValueAsBool( int row, int col, bool value )
+{
+    Column* const column = GetColumn(row, col);
+    if ( !column )
+        return;
+
+    wxCHECK_RET( column->type == Column_Bool,
+                 wxT("column doesn't contain booleans") );
+
+    column->bools[row] = value;
+}
+
+void wxGridColumnarTable::Clear()
+{
+    for ( auto& column : m_columns )
+        column.Reset();
+}
+
+bool wxGridColumnarTable::InsertRows( size_t pos, size_t numRows )
+{
+    if ( pos >= m_numRows )
+    {
+        return AppendRows( numRows );
+    }
+
+    for ( auto& column : m_columns )
+        column.Insert(pos, numRows);
+
+    m_numRows += numRows;
+
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_ROWS_INSERTED,
+                                pos,
+                                numRows );
+    }
+
+    return true;
+}
+
+bool wxGridColumnarTable::AppendRows( size_t numRows )
+{
+    for ( auto& column : m_columns )
+        column.Insert(m_numRows, numRows);
+
+    m_numRows += numRows;
+
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_ROWS_APPENDED,
+                                numRows );
+    }
+
+    return true;
+}
+
+bool wxGridColumnarTable::DeleteRows( size_t pos, size_t numRows )
+{
+    wxCHECK_MSG( pos < m_numRows, false,
+                 wxT("invalid row index in wxGridColumnarTable::DeleteRows()") );
+
+    if ( numRows > m_numRows - pos )
+    {
+        numRows = m_numRows - pos;
+    }
+
+    for ( auto& column : m_columns )
+        column.Erase(pos, numRows);
+
+    m_numRows -= numRows;
+
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_ROWS_DELETED,
+                                pos,
+                                numRows );
+    }
+
+    return true;
+}
+
+void wxGridColumnarTable::DoInsertCols( size_t pos, size_t numCols )
+{
+    Column column(Column_String);
+    column.Insert(0, m_numRows);
+    column.dict.push_back(wxString());
+    column.dictIndex[wxString()] = 0;
+
+    m_columns.insert(m_columns.begin() + pos, numCols, column);
+}
+
+bool wxGridColumnarTable::InsertCols( size_t pos, size_t numCols )
+{
+    if ( pos >= m_columns.size() )
+    {
+        return AppendCols( numCols );
+    }
+
+    DoInsertCols(pos, numCols);
+
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_COLS_INSERTED,
+                                pos,
+                                numCols );
+    }
+
+    return true;
+}
+
+bool wxGridColumnarTable::AppendCols( size_t numCols )
+{
+    DoInsertCols(m_columns.size(), numCols);
+
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_COLS_APPENDED,
+                                numCols );
+    }
+
+    return true;
+}
+
+bool wxGridColumnarTable::DeleteCols( size_t pos, size_t numCols )
+{
+    wxCHECK_MSG( pos < m_columns.size(), false,
+                 wxT("invalid column index in wxGridColumnarTable::DeleteCols()") );
+
+    if ( numCols > m_columns.size() - pos )
+    {
+        numCols = m_columns.size() - pos;
+    }
+
+    m_columns.erase(m_columns.begin() + pos,
+                    m_columns.begin() + pos + numCols);
+
+    if ( GetView() )
+    {
+        GetView()->ProcessTableMessage( this,
+                                wxGRIDTABLE_NOTIFY_COLS_DELETED,
+                                pos,
+                                numCols );
+    }
+
+    return true;
+}
+
+void wxGridColumnarTable::SetColLabelValue( int col, const wxString& value )
+{
+    wxCHECK_RET( col >= 0 && static_cast<size_t>(col) < m_columns.size(),
+                 wxT("invalid column index in wxGridColumnarTable") );
+
+    m_columns[col].label = value;
+}
+
+wxString wxGridColumnarTable::GetColLabelValue( int col )
+{
+    if ( col >= 0 && static_cast<size_t>(col) < m_columns.size() &&
+            !m_columns[col].label.empty() )
+    {
+        return m_columns[col].label;
+    }
+
+    // using default label
+    //
+    return wxGridTableBase::GetColLabelValue( col );
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// A grid table fetching the data in the background.
+//
+
+#if wxUSE_THREADS
+
+class wxGridAsyncTableThread : public wxThread
+{
+public:
+    explicit wxGridAsyncTableThread(wxGridAsyncTableImpl& impl)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_impl(impl)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() override;
+
+private:
+    wxGridAsyncTableImpl& m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridAsyncTableThread);
+};
+
+#endif // wxUSE_THREADS
+
+class wxGridAsyncTableImpl
+{
+public:
+    wxGridAsyncTableImpl(wxGridAsyncTable* table,
+                         wxGridAsyncDataSource* source,
+                         int blockSize)
+        : m_table(table),
+          m_source(source),
+          m_blockSize(blockSize),
+          m_placeholder(wxS("..."))
+#if wxUSE_THREADS
+#if wxUSE_TIMER
+          , m_retryTimer(&m_notifier)
+#endif // wxUSE_TIMER
+          , m_cond(m_mutex)
+#endif // wxUSE_THREADS
+    {
+#if wxUSE_THREADS && wxUSE_TIMER
+        m_notifier.Bind(wxEVT_TIMER, [this](wxTimerEvent&) { RetryFailed(); });
+#endif // wxUSE_THREADS && wxUSE_TIMER
+    }
+
+    ~wxGridAsyncTableImpl()
+    {
+#if wxUSE_THREADS
+        StopThread();
+#endif // wxUSE_THREADS
+
+        delete m_source;
+    }
+
+    // a block of rows fetched from the data source
+    struct Block
+    {
+        wxVector<wxString> values;
+        int numCols = 0;
+        unsigned long lastUse = 0;
+    };
+
+    // a request to fetch a block, the data source size is stored in it
+    // because it can be only queried from the main thread
+    struct Request
+    {
+        int block;
+        int numRows;
+        int numCols;
+    };
+
+    // return the cached block containing the given row, requesting the
+    // blocks around the visible rows if it's not the same block as the last
+    // time, or nullptr if the block is not available yet
+    const Block* GetBlockForRow(int row);
+
+    void Invalidate();
+
+#if wxUSE_THREADS
+    void StopThread();
+
+    // called from the worker thread to wait for the next block to fetch,
+    // returns false if the thread should exit
+    bool WaitForRequest(Request& request, unsigned& generation);
+
+    // called from the worker thread after fetching the block
+    void OnBlockFetched(int block, unsigned generation, bool ok, Block& data);
+
+    // called in the main thread to take the fetched blocks
+    void ProcessFetched();
+
+#if wxUSE_TIMER
+    // called in the main thread to fetch the blocks which failed again
+    void RetryFailed();
+#endif // wxUSE_TIMER
+#endif // wxUSE_THREADS
+
+    // refresh the rows of the given block in the grid, if any
+    void RefreshBlock(int block);
+
+    // fetch the block synchronously, returns false if it failed
+    bool FetchBlock(const Request& request, Block& data);
+
+    // add the block to the cache, removing the least recently used blocks
+    // if it's full
+    void AddToCache(int block, Block& data);
+
+    // request fetching all blocks around the visible rows and the given one
+    void RequestBlocks(int row);
+
+    wxGridAsyncTable* const m_table;
+    wxGridAsyncDataSource* const m_source;
+
+    const int m_blockSize;
+    int m_prefetchBlocks = 2;
+    size_t m_cacheSize = 64;
+    wxString m_placeholder;
+
+    // these fields are only used by the main thread
+    std::unordered_map<int, Block> m_cache;
+    unsigned long m_useCounter = 0;
+    int m_lastBlock = -1;
+
+#if wxUSE_THREADS
+    // the blocks queued or being currently fetched
+    std::unordered_set<int> m_requested;
+
+    // handler used for executing ProcessFetched() in the main thread
+    wxEvtHandler m_notifier;
+
+#if wxUSE_TIMER
+    // the blocks which couldn't be fetched and the timer used for retrying
+    // fetching them if they're still shown
+    std::unordered_set<int> m_failed;
+    wxTimer m_retryTimer;
+#endif // wxUSE_TIMER
+
+    wxGridAsyncTableThread* m_thread = nullptr;
+
+    // all the fields below are protected by this mutex
+    wxMutex m_mutex;
+    wxCondition m_cond;
+
+    // the blocks to fetch, in order of priority
+    std::deque<Request> m_queue;
+
+    // the blocks fetched by the worker thread and not processed yet
+    struct Fetched
+    {
+        int block;
+        bool ok;
+        Block data;
+    };
+    wxVector<Fetched> m_fetched;
+
+    // incremented when the cache is invalidated to discard the blocks being
+    // fetched at that moment
+    unsigned m_generation = 0;
+
+    bool m_stop = false;
+#endif // wxUSE_THREADS
+
+    wxDECLARE_NO_COPY_CLASS(wxGridAsyncTableImpl);
+};
+
+bool wxGridAsyncTableImpl::FetchBlock(const Request& request, Block& data)
+{
+    const int firstRow = request.block*m_blockSize;
+    const int numRows = wxMin(m_blockSize, request.numRows - firstRow);
+    if ( numRows <= 0 )
+        return false;
+
+    data.numCols = request.numCols;
+    if ( !m_source->FetchRows(firstRow, numRows, data.numCols, data.values) )
+        return false;
+
+    wxASSERT_MSG( data.values.size() == static_cast<size_t>(numRows*data.numCols),
+                  wxS("wrong number of values returned by FetchRows()") );
+
+    return true;
+}
+
+void wxGridAsyncTableImpl::AddToCache(int block, Block& data)
+{
+    while ( m_cache.size() >= m_cacheSize )
+    {
+        auto oldest = m_cache.begin();
+        for ( auto it = m_cache.begin(); it != m_cache.end(); ++it )
+        {
+            if ( it->second.lastUse < oldest->second.lastUse )
+                oldest = it;
+        }
+
+        m_cache.erase(oldest);
+    }
+
+    data.lastUse = ++m_useCounter;
+    m_cache[block] = std::move(data);
+}
+
+const wxGridAsyncTableImpl::Block* wxGridAsyncTableImpl::GetBlockForRow(int row)
+{
+    const int block = row / m_blockSize;
+
+    // Checking the visible rows for each cell would be wasteful, so do it
+    // only when we move to another block, which happens just a few times
+    // when redrawing the grid.
+    if ( block != m_lastBlock )
+    {
+        m_lastBlock = block;
+        RequestBlocks(row);
+    }
+
+    auto it = m_cache.find(block);
+    if ( it == m_cache.end() )
+        return nullptr;
+
+    it->second.lastUse = ++m_useCounter;
+    return &it->second;
+}
+
+void wxGridAsyncTableImpl::RequestBlocks(int row)
+{
+    const int numRows = m_source->GetNumberRows();
+    if ( numRows <= 0 )
+        return;
+
+    const int numCols = m_source->GetNumberCols();
+
+    // Find the range of the visible rows, which includes the given row as
+    // it's always requested first.
+    int firstRow = row,
+        lastRow = row;
+
+    wxGrid* const grid = m_table->GetView();
+    if ( grid && grid->GetGridWindow() )
+    {
+        int top, bottom;
+        grid->CalcUnscrolledPosition(0, 0, nullptr, &top);
+        grid->CalcUnscrolledPosition
+              (
+                0, grid->GetGridWindow()->GetClientSize().y,
+                nullptr, &bottom
+              );
+
+        // Rows can be reordered, so check both ends of the range.
+        const int rowTop = grid->YToRow(top, true);
+        const int rowBottom = grid->YToRow(bottom, true);
+        if ( rowTop != wxNOT_FOUND && rowBottom != wxNOT_FOUND )
+        {
+            firstRow = wxMin(firstRow, wxMin(rowTop, rowBottom));
+            lastRow = wxMax(lastRow, wxMax(rowTop, rowBottom));
+        }
+    }
+
+    const int firstBlock = firstRow / m_blockSize;
+    const int lastBlock = lastRow / m_blockSize;
+    const int maxBlock = (numRows - 1) / m_blockSize;
+
+    // The blocks are fetched in the order of priority: first the visible
+    // ones and then alternating the blocks after and before them, as
+    // scrolling down is more common.
+    wxVector<int> blocks;
+    blocks.push_back(row / m_blockSize);
+    for ( int block = firstBlock; block <= lastBlock; ++block )
+        blocks.push_back(block);
+    for ( int n = 1; n <= m_prefetchBlocks; ++n )
+    {
+        if ( lastBlock + n <= maxBlock )
+            blocks.push_back(lastBlock + n);
+        if ( firstBlock - n >= 0 )
+            blocks.push_back(firstBlock - n);
+    }
+
+#if wxUSE_THREADS
+    {
+        wxMutexLocker lock(m_mutex);
+
+        // Forget about the blocks which were requested before but not
+        // fetched yet: if they're still needed, they're going to be requested
+        // again below and if not, there is no need to fetch them any more.
+        for ( const auto& request : m_queue )
+            m_requested.erase(request.block);
+        m_queue.clear();
+
+        for ( auto block : blocks )
+        {
+            if ( block > maxBlock || m_cache.count(block) )
+                continue;
+
+            if ( m_requested.insert(block).second )
+                m_queue.push_back(Request{block, numRows, numCols});
+        }
+
+        if ( m_queue.empty() )
+            return;
+
+        m_cond.Signal();
+    }
+
+    if ( !m_thread )
+    {
+        m_thread = new wxGridAsyncTableThread(*this);
+        if ( m_thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            wxLogError(_("Failed to start the thread fetching grid data."));
+
+            delete m_thread;
+            m_thread = nullptr;
+        }
+    }
+#else // !wxUSE_THREADS
+    // Without threads, we have no choice but to fetch the block needed right
+    // now synchronously, and prefetching the other ones would only make
+    // things slower.
+    const int block = blocks[0];
+    if ( block <= maxBlock && !m_cache.count(block) )
+    {
+        Block data;
+        if ( FetchBlock(Request{block, numRows, numCols}, data) )
+            AddToCache(block, data);
+    }
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+void wxGridAsyncTableImpl::Invalidate()
+{
+#if wxUSE_THREADS
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_queue.clear();
+        m_fetched.clear();
+        m_generation++;
+    }
+
+    m_requested.clear();
+
+#if wxUSE_TIMER
+    m_failed.clear();
+    m_retryTimer.Stop();
+#endif // wxUSE_TIMER
+#endif // wxUSE_THREADS
+
+    m_cache.clear();
+    m_lastBlock = -1;
+}
+
+void wxGridAsyncTableImpl::RefreshBlock(int block)
+{
+    wxGrid* const grid = m_table->GetView();
+    if ( !grid )
+        return;
+
+    // Refresh only the cells of this block, if they're still present.
+    const int firstRow = block*m_blockSize;
+    const int lastRow = wxMin(firstRow + m_blockSize,
+                              grid->GetNumberRows()) - 1;
+    if ( lastRow >= firstRow && grid->GetNumberCols() > 0 )
+        grid->RefreshBlock(firstRow, 0, lastRow, grid->GetNumberCols() - 1);
+}
+
+#if wxUSE_THREADS
+
+void wxGridAsyncTableImpl::StopThread()
+{
+    if ( !m_thread )
+        return;
+
+    {
+        wxMutexLocker lock(m_mutex);
+        m_stop = true;
+        m_cond.Signal();
+    }
+
+    m_thread->Wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+bool wxGridAsyncTableImpl::WaitForRequest(Request& request, unsigned& generation)
+{
+    wxMutexLocker lock(m_mutex);
+
+    while ( m_queue.empty() && !m_stop )
+        m_cond.Wait();
+
+    if ( m_stop )
+        return false;
+
+    request = m_queue.front();
+    m_queue.pop_front();
+    generation = m_generation;
+
+    return true;
+}
+
+void
+wxGridAsyncTableImpl::OnBlockFetched(int block,
+                                     unsigned generation,
+                                     bool ok,
+                                     Block& data)
+{
+    {
+        wxMutexLocker lock(m_mutex);
+
+        // The data may be already out of date.
+        if ( generation != m_generation )
+            return;
+
+        m_fetched.push_back(Fetched{block, ok, std::move(data)});
+
+        // If there were already some blocks, ProcessFetched() is already
+        // scheduled to run and will process this one too.
+        if ( m_fetched.size() > 1 )
+            return;
+    }
+
+    m_notifier.CallAfter([this]() { ProcessFetched(); });
+}
+
+void wxGridAsyncTableImpl::ProcessFetched()
+{
+    wxVector<Fetched> fetched;
+    {
+        wxMutexLocker lock(m_mutex);
+        fetched.swap(m_fetched);
+    }
+
+    for ( auto& f : fetched )
+    {
+        m_requested.erase(f.block);
+
+        // If fetching failed, don't cache anything, so that we try fetching
+        // this block again when it's needed the next time, even if it's the
+        // same block as the last one.
+        if ( !f.ok )
+        {
+            m_lastBlock = -1;
+
+#if wxUSE_TIMER
+            // And refresh it after a delay, as otherwise it wouldn't be
+            // needed again if nothing else redraws the grid, but without
+            // retrying immediately to avoid hammering the failing source.
+            m_failed.insert(f.block);
+            if ( !m_retryTimer.IsRunning() )
+                m_retryTimer.StartOnce(1000);
+#endif // wxUSE_TIMER
+
+            continue;
+        }
+
+        AddToCache(f.block, f.data);
+
+        RefreshBlock(f.block);
+    }
+}
+
+#if wxUSE_TIMER
+
+void wxGridAsyncTableImpl::RetryFailed()
+{
+    m_lastBlock = -1;
+
+    for ( auto block : m_failed )
+        RefreshBlock(block);
+
+    m_failed.clear();
+}
+
+#endif // wxUSE_TIMER
+
+wxThread::ExitCode wxGridAsyncTableThread::Entry()
+{
+    wxGridAsyncTableImpl::Request request;
+    unsigned generation;
+    while ( m_impl.WaitForRequest(request, generation) )
+    {
+        wxGridAsyncTableImpl::Block data;
+        const bool ok = m_impl.FetchBlock(request, data);
+        m_impl.OnBlockFetched(request.block, generation, ok, data);
+    }
+
+    return nullptr;
+}
+
+#endif // wxUSE_THREADS
+
+wxGridAsyncTable::wxGridAsyncTable( wxGridAsyncDataSource* source,
+                                    int blockSize )
+    : m_impl(new wxGridAsyncTableImpl(this, source, blockSize))
+{
+    wxASSERT_MSG( source, wxS("data source must be specified") );
+    wxASSERT_MSG( blockSize > 0, wxS("block size must be positive") );
+}
+
+wxGridAsyncTable::~wxGridAsyncTable()
+{
+    delete m_impl;
+}
+
+wxGridAsyncDataSource* wxGridAsyncTable::GetDataSource() const
+{
+    return m_impl->m_source;
+}
+
+void wxGridAsyncTable::SetPrefetchBlocks( int numBlocks )
+{
+    wxCHECK_RET( numBlocks >= 0, wxS("invalid number of blocks") );
+
+    m_impl->m_prefetchBlocks = numBlocks;
+}
+
+void wxGridAsyncTable::SetCacheSize( int numBlocks )
+{
+    wxCHECK_RET( numBlocks > 0, wxS("invalid number of blocks") );
+
+    m_impl->m_cacheSize = numBlocks;
+}
+
+void wxGridAsyncTable::SetPlaceholder( const wxString& placeholder )
+{
+    m_impl->m_placeholder = placeholder;
+}
+
+const wxString& wxGridAsyncTable::GetPlaceholder() const
+{
+    return m_impl->m_placeholder;
+}
+
+bool wxGridAsyncTable::IsRowAvailable( int row ) const
+{
+    return row >= 0 && m_impl->m_cache.count(row / m_impl->m_blockSize) != 0;
+}
+
+void wxGridAsyncTable::InvalidateCache()
+{
+    m_impl->Invalidate();
+
+    if ( GetView() )
+        GetView()->ForceRefresh();
+}
+
+int wxGridAsyncTable::GetNumberRows()
+{
+    return m_impl->m_source->GetNumberRows();
+}
+
+int wxGridAsyncTable::GetNumberCols()
+{
+    return m_impl->m_source->GetNumberCols();
+}
+
+wxString wxGridAsyncTable::GetValue( int row, int col )
+{
+    wxCHECK_MSG( row >= 0 && col >= 0, wxString(), wxS("invalid cell") );
+
+    const wxGridAsyncTableImpl::Block* const block = m_impl->GetBlockForRow(row);
+    if ( !block )
+        return m_impl->m_placeholder;
+
+    // The number of columns could have changed since the block was fetched.
+    if ( col >= block->numCols )
+        return wxString();
+
+    const size_t n = static_cast<size_t>(row % m_impl->m_blockSize)*block->numCols + col;
+    return n < block->values.size() ? block->values[n] : wxString();
+}
+
+void wxGridAsyncTable::SetValue( int WXUNUSED(row), int WXUNUSED(col),
+                                 const wxString& WXUNUSED(s) )
+{
+}
+
+void wxGridAsyncTable::SetView( wxGrid *grid )
+{
+    wxGridTableBase::SetView(grid);
+
+    // The visible rows need to be recomputed for the new view.
+    m_impl->m_lastBlock = -1;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+
+wxBEGIN_EVENT_TABLE(wxGridSubwindow, wxWindow)
+    EVT_MOUSE_CAPTURE_LOST(wxGridSubwindow::OnMouseCaptureLost)
+wxEND_EVENT_TABLE()
+
+void wxGridSubwindow::OnMouseCaptureLost(wxMouseCaptureLostEvent& WXUNUSED(event))
+{
+    m_owner->CancelMouseCapture();
+}
+
+wxBEGIN_EVENT_TABLE( wxGridRowLabelWindow, wxGridSubwindow )
+    EVT_PAINT( wxGridRowLabelWindow::OnPaint )
+    EVT_MOUSEWHEEL( wxGridRowLabelWindow::OnMouseWheel )
+    EVT_MOUSE_EVENTS( wxGridRowLabelWindow::OnMouseEvent )
+wxEND_EVENT_TABLE()
+
+void wxGridRowLabelWindow::OnPaint( wxPaintEvent& WXUNUSED(event) )
+{
+    wxPaintDC dc(this);
+
+    // NO - don't do this because it will set both the x and y origin
+    // coords to match the parent scrolled window and we just want to
+    // set the y coord  - MB
+    //
+    // m_owner->PrepareDC( dc );
+
+    int x, y;
+    wxGridWindow *gridWindow = IsFrozen() ? m_owner->m_frozenRowGridWin :
+                                            m_owner->m_gridWin;
+    m_owner->GetGridWindowOffset(gridWindow, x, y);
+    m_owner->CalcGridWindowUnscrolledPosition( x, y, &x, &y, gridWindow );
+    wxPoint pt = dc.GetDeviceOrigin();
+    dc.SetDeviceOrigin( pt.x, pt.y-y );
+
+    wxArrayInt rows = m_owner->CalcRowLabelsExposed( GetUpdateRegion(), gridWindow);
+    m_owner->DrawRowLabels( dc, rows );
+
+    if ( IsFrozen() )
+        m_owner->DrawLabelFrozenBorder(dc, this, true);
+}
+
+void wxGridRowLabelWindow::OnMouseEvent( wxMouseEvent& event )
+{
+    m_owner->ProcessRowColLabelMouseEvent( wxGridRowOperations(), event, this );
+}
+
+void wxGridRowLabelWindow::OnMouseWheel( wxMouseEvent& event )
+{
+    if (!m_owner->ProcessWindowEvent( event ))
+        event.Skip();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+wxBEGIN_EVENT_TABLE( wxGridColLabelWindow, wxGridSubwindow )
+    EVT_PAINT( wxGridColLabelWindow::OnPaint )
+    EVT_MOUSEWHEEL( wxGridColLabelWindow::OnMouseWheel )
+    EVT_MOUSE_EVENTS( wxGridColLabelWindow::OnMouseEvent )
+wxEND_EVENT_TABLE()
+
+void wxGridColLabelWindow::OnPaint( wxPaintEvent& WXUNUSED(event) )
+{
+    wxPaintDC dc(this);
+
+    // NO - don't do this because it will set both the x and y origin
+    // coords to match the parent scrolled window and we just want to
+    // set the x coord  - MB
+    //
+    // m_owner->PrepareDC( dc );
+
+    // Column indices become invalid when the grid is empty, so avoid doing
+    // anything at all in this case.
+    if ( m_owner->GetNumberCols() == 0 )
+        return;
+
+    int x, y;
+    wxGridWindow *gridWindow = IsFrozen() ? m_owner->m_frozenColGridWin :
+                                            m_owner->m_gridWin;
+    m_owner->GetGridWindowOffset(gridWindow, x, y);
+    m_owner->CalcGridWindowUnscrolledPosition( x, y, &x, &y, gridWindow );
+    wxPoint pt = dc.GetDeviceOrigin();
+    dc.SetDeviceOrigin( pt.x-x, pt.y );
+
+    wxArrayInt cols = m_owner->CalcColLabelsExposed( GetUpdateRegion(), gridWindow );
+    m_owner->DrawColLabels( dc, cols );
+
+    if ( IsFrozen() )
+        m_owner->DrawLabelFrozenBorder(dc, this, false);
+}
+
+void wxGridColLabelWindow::OnMouseEvent( wxMouseEvent& event )
+{
+    m_owner->ProcessRowColLabelMouseEvent( wxGridColumnOperations(), event, this );
+}
+
+void wxGridColLabelWindow::OnMouseWheel( wxMouseEvent& event )
+{
+    if (!m_owner->ProcessWindowEvent( event ))
+        event.Skip();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+wxBEGIN_EVENT_TABLE( wxGridCornerLabelWindow, wxGridSubwindow )
+    EVT_MOUSEWHEEL( wxGridCornerLabelWindow::OnMouseWheel )
+    EVT_MOUSE_EVENTS( wxGridCornerLabelWindow::OnMouseEvent )
+    EVT_PAINT( wxGridCornerLabelWindow::OnPaint )
+wxEND_EVENT_TABLE()
+
+void wxGridCornerLabelWindow::OnPaint( wxPaintEvent& WXUNUSED(event) )
+{
+    wxPaintDC dc(this);
+
+    m_owner->DrawCornerLabel(dc);
+}
+
+void wxGridCornerLabelWindow::OnMouseEvent( wxMouseEvent& event )
+{
+    m_owner->ProcessCornerLabelMouseEvent( event );
+}
+
+void wxGridCornerLabelWindow::OnMouseWheel( wxMouseEvent& event )
+{
+    if (!m_owner->ProcessWindowEvent(event))
+        event.Skip();
+}
+
+//////////////////////////////////////////////////////////////////////
+
+wxBEGIN_EVENT_TABLE( wxGridWindow, wxGridSubwindow )
+    EVT_PAINT( wxGridWindow::OnPaint )
+    EVT_MOUSEWHEEL( wxGridWindow::OnMouseWheel )
+    EVT_MOUSE_EVENTS( wxGridWindow::OnMouseEvent )
+    EVT_KEY_DOWN( wxGridWindow::OnKeyDown )
+    EVT_KEY_UP( wxGridWindow::OnKeyUp )
+    EVT_CHAR( wxGridWindow::OnChar )
+    EVT_SET_FOCUS( wxGridWindow::OnFocus )
+    EVT_KILL_FOCUS( wxGridWindow::OnFocus )
+wxEND_EVENT_TABLE()
+
+void wxGridWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
+{
+    wxAutoBufferedPaintDC dc( this );
+    m_owner->PrepareDCFor( dc, this );
+    wxRegion reg = GetUpdateRegion();
+
+    wxGridCellCoordsVector dirtyCells = m_owner->CalcCellsExposed( reg , this );
+    m_owner->DrawGridCellArea( dc, dirtyCells );
+
+    m_owner->DrawGridSpace( dc, this );
+
+    m_owner->DrawAllGridWindowLines( dc, reg, this );
+
+    m_owner->DrawOverlaySelection( dc, this );
+
+    if ( m_type != wxGridWindow::wxGridWindowNormal )
+        m_owner->DrawFrozenBorder( dc, this );
+
+    m_owner->DrawHighlight( dc, dirtyCells );
+}
+
+void wxGrid::Render( wxDC& dc,
+                     const wxPoint& position,
+                     const wxSize& size,
+                     const wxGridCellCoords& topLeft,
+                     const wxGridCellCoords& bottomRight,
+                     int style )
+{
+    wxCHECK_RET( bottomRight.GetCol() < GetNumberCols(),
+                 "Invalid right column" );
+    wxCHECK_RET( bottomRight.GetRow() < GetNumberRows(),
+                 "Invalid bottom row" );
+
+    // store user settings and reset later
+
+    // Don't show row/col highlight of the current cell when rendering
+    const auto currentCellCoords = m_currentCellCoords;
+    m_currentCellCoords = wxGridNoCellCoords;
     wxON_BLOCK_EXIT_SET(m_currentCellCoords, currentCellCoords);
 
     // remove grid selection, don't paint selection colour
@@ -2884,6 +4183,8 @@ wxGrid::~wxGrid()
     ClearAttrCache();
     wxSafeDecRef(m_defaultCellAttr);
 
+    ClearTextWidthCache();
+
 #ifdef DEBUG_ATTR_CACHE
     size_t total = gs_nAttrCacheHits + gs_nAttrCacheMisses;
     wxPrintf(wxT("wxGrid attribute cache statistics: "
@@ -3091,6 +4392,7 @@ wxGrid::SetTable(wxGridTableBase *table,
 
             // Don't hold on to attributes cached from the old table
             ClearAttrCache();
+            ClearTextWidthCache();
 
             m_table->SetView(nullptr);
             if( m_ownTable )
@@ -3106,11 +4408,9 @@ wxGrid::SetTable(wxGridTableBase *table,
         m_numFrozenRows = 0;
         m_numFrozenCols = 0;
 
-        // kill row and column size arrays
-        m_colWidths.Empty();
-        m_colRights.Empty();
-        m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        // kill row and column sizes
+        m_colSizes.Clear();
+        m_rowSizes.Clear();
     }
 
     if (table)
@@ -3238,6 +4538,10 @@ void wxGrid::Init()
     m_sortCol = wxNOT_FOUND;
     m_sortIsAscending = true;
 
+    m_colAutoSizeFlags = wxGRID_AUTOSIZE_DEFAULT;
+    m_colAutoSizeMaxValues = 0;
+    m_textWidthCache = nullptr;
+
     m_useNativeHeader =
     m_nativeColumnLabels = false;
 
@@ -3268,95 +4572,65 @@ void wxGrid::Init()
 }
 
 // ----------------------------------------------------------------------------
-// the idea is to call these functions only when necessary because they create
-// quite big arrays which eat memory mostly unnecessary - in particular, if
-// default widths/heights are used for all rows/columns, we may not use these
-// arrays at all
-//
-// with some extra code, it should be possible to only store the widths/heights
-// different from default ones (resulting in space savings for huge grids) but
-// this is not done currently
+// the idea is to call these functions only when necessary: if default
+// widths/heights are used for all rows/columns, we don't need to store any
+// sizes at all and, even after calling them, only the sizes different from
+// the default ones are stored until there are too many of them
 // ----------------------------------------------------------------------------
 
 void wxGrid::InitRowHeights()
 {
-    m_rowHeights.Empty();
-    m_rowBottoms.Empty();
-
-    m_rowHeights.Alloc( m_numRows );
-    m_rowBottoms.Alloc( m_numRows );
-
-    m_rowHeights.Add( m_defaultRowHeight, m_numRows );
-
-    for ( int i = 0; i < m_numRows; i++ )
-    {
-        int rowBottom = ( GetRowPos( i ) + 1 ) * m_defaultRowHeight;
-        m_rowBottoms.Add( rowBottom );
-    }
+    m_rowSizes.Init(m_numRows, m_defaultRowHeight, m_rowAt);
 }
 
 void wxGrid::InitColWidths()
 {
-    m_colWidths.Empty();
-    m_colRights.Empty();
-
-    m_colWidths.Alloc( m_numCols );
-    m_colRights.Alloc( m_numCols );
-
-    m_colWidths.Add( m_defaultColWidth, m_numCols );
-
-    for ( int i = 0; i < m_numCols; i++ )
-    {
-        int colRight = ( GetColPos( i ) + 1 ) * m_defaultColWidth;
-        m_colRights.Add( colRight );
-    }
+    m_colSizes.Init(m_numCols, m_defaultColWidth, m_colAt);
 }
 
 int wxGrid::GetColWidth(int col) const
 {
-    if ( m_colWidths.IsEmpty() )
+    if ( m_colSizes.IsEmpty() )
         return m_defaultColWidth;
 
-    // a negative width indicates a hidden column
-    return m_colWidths[col] > 0 ? m_colWidths[col] : 0;
+    return m_colSizes.GetSize(col);
 }
 
 int wxGrid::GetColLeft(int col) const
 {
-    if ( m_colRights.IsEmpty() )
+    if ( m_colSizes.IsEmpty() )
         return GetColPos( col ) * m_defaultColWidth;
 
-    return m_colRights[col] - GetColWidth(col);
+    return m_colSizes.GetEnd(col) - GetColWidth(col);
 }
 
 int wxGrid::GetColRight(int col) const
 {
-    return m_colRights.IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
-                                 : m_colRights[col];
+    return m_colSizes.IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
+                                : m_colSizes.GetEnd(col);
 }
 
 int wxGrid::GetRowHeight(int row) const
 {
     // no custom heights / hidden rows
-    if ( m_rowHeights.IsEmpty() )
+    if ( m_rowSizes.IsEmpty() )
         return m_defaultRowHeight;
 
-    // a negative height indicates a hidden row
-    return m_rowHeights[row] > 0 ? m_rowHeights[row] : 0;
+    return m_rowSizes.GetSize(row);
 }
 
 int wxGrid::GetRowTop(int row) const
 {
-    if ( m_rowBottoms.IsEmpty() )
+    if ( m_rowSizes.IsEmpty() )
         return GetRowPos( row ) * m_defaultRowHeight;
 
-    return m_rowBottoms[row] - GetRowHeight(row);
+    return m_rowSizes.GetEnd(row) - GetRowHeight(row);
 }
 
 int wxGrid::GetRowBottom(int row) const
 {
-    return m_rowBottoms.IsEmpty() ? (GetRowPos( row ) + 1) * m_defaultRowHeight
-                                  : m_rowBottoms[row];
+    return m_rowSizes.IsEmpty() ? (GetRowPos( row ) + 1) * m_defaultRowHeight
+                                : m_rowSizes.GetEnd(row);
 }
 
 void wxGrid::CalcDimensions()
@@ -3524,24 +4798,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
             }
 
 
-            if ( !m_rowHeights.IsEmpty() )
-            {
-                m_rowHeights.Insert( m_defaultRowHeight, pos, numRows );
-                m_rowBottoms.Insert( 0, pos, numRows );
-
-                int bottom = 0;
-                if ( pos > 0 )
-                    bottom = m_rowBottoms[GetRowAt( pos - 1 )];
-
-                int rowPos;
-                for ( rowPos = pos; rowPos < m_numRows; rowPos++ )
-                {
-                    i = GetRowAt( rowPos );
-
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
-            }
+            m_rowSizes.InsertLines(pos, numRows, m_defaultRowHeight, m_rowAt);
 
             UpdateCurrentCellOnRedim();
 
@@ -3578,24 +4835,8 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
                 }
             }
 
-            if ( !m_rowHeights.IsEmpty() )
-            {
-                m_rowHeights.Add( m_defaultRowHeight, numRows );
-                m_rowBottoms.Add( 0, numRows );
-
-                int bottom = 0;
-                if ( oldNumRows > 0 )
-                    bottom = m_rowBottoms[oldNumRows - 1];
-
-                int rowPos;
-                for ( rowPos = oldNumRows; rowPos < m_numRows; rowPos++ )
-                {
-                    i = GetRowAt( rowPos );
-
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
-            }
+            m_rowSizes.InsertLines(oldNumRows, numRows, m_defaultRowHeight,
+                                   m_rowAt);
 
             UpdateCurrentCellOnRedim();
 
@@ -3631,21 +4872,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
                 }
             }
 
-            if ( !m_rowHeights.IsEmpty() )
-            {
-                m_rowHeights.RemoveAt( pos, numRows );
-                m_rowBottoms.RemoveAt( pos, numRows );
-
-                int h = 0;
-                int rowPos;
-                for ( rowPos = 0; rowPos < m_numRows; rowPos++ )
-                {
-                    i = GetRowAt( rowPos );
-
-                    h += GetRowHeight(i);
-                    m_rowBottoms[i] = h;
-                }
-            }
+            m_rowSizes.DeleteLines(pos, numRows, m_rowAt);
 
             UpdateCurrentCellOnRedim();
 
@@ -3703,24 +4930,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
                 }
             }
 
-            if ( !m_colWidths.IsEmpty() )
-            {
-                m_colWidths.Insert( m_defaultColWidth, pos, numCols );
-                m_colRights.Insert( 0, pos, numCols );
-
-                int right = 0;
-                if ( pos > 0 )
-                    right = m_colRights[GetColAt( pos - 1 )];
-
-                int colPos;
-                for ( colPos = pos; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
-            }
+            m_colSizes.InsertLines(pos, numCols, m_defaultColWidth, m_colAt);
 
             // See comment for wxGRIDTABLE_NOTIFY_COLS_APPENDED case explaining
             // why this has to be done here and not before.
@@ -3762,28 +4972,12 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
                 }
             }
 
-            if ( !m_colWidths.IsEmpty() )
-            {
-                m_colWidths.Add( m_defaultColWidth, numCols );
-                m_colRights.Add( 0, numCols );
-
-                int right = 0;
-                if ( oldNumCols > 0 )
-                    right = m_colRights[GetColAt( oldNumCols - 1 )];
-
-                int colPos;
-                for ( colPos = oldNumCols; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
-            }
+            m_colSizes.InsertLines(oldNumCols, numCols, m_defaultColWidth,
+                                   m_colAt);
 
-            // Notice that this must be called after updating m_colWidths above
+            // Notice that this must be called after updating m_colSizes above
             // as the native grid control will check whether the new columns
-            // are shown which results in accessing m_colWidths array.
+            // are shown which results in accessing the column widths.
             if ( m_useNativeHeader )
                 GetGridColHeader()->SetColumnCount(m_numCols);
 
@@ -3821,21 +5015,7 @@ bool wxGrid::Redimension( const wxGridTableMessage& msg )
                 }
             }
 
-            if ( !m_colWidths.IsEmpty() )
-            {
-                m_colWidths.RemoveAt( pos, numCols );
-                m_colRights.RemoveAt( pos, numCols );
-
-                int w = 0;
-                int colPos;
-                for ( colPos = 0; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    w += GetColWidth(i);
-                    m_colRights[i] = w;
-                }
-            }
+            m_colSizes.DeleteLines(pos, numCols, m_colAt);
 
             // See comment for wxGRIDTABLE_NOTIFY_COLS_APPENDED case explaining
             // why this has to be done here and not before.
@@ -5452,21 +6632,7 @@ void wxGrid::RefreshAfterRowPosChange()
     // recalculate the row bottoms as the row positions have changed,
     // unless we calculate them dynamically because all rows heights are the
     // same and it's easy to do
-    if ( !m_rowHeights.empty() )
-    {
-        int rowBottom = 0;
-        for ( int rowPos = 0; rowPos < m_numRows; rowPos++ )
-        {
-            int rowID = GetRowAt( rowPos );
-
-            // Ignore the currently hidden rows.
-            const int height = m_rowHeights[rowID];
-            if ( height > 0 )
-                rowBottom += height;
-
-            m_rowBottoms[rowID] = rowBottom;
-        }
-    }
+    m_rowSizes.SetLinesOrder(m_rowAt);
 
     // and make the changes visible
     RefreshArea(wxGA_Cells | wxGA_RowLabels);
@@ -5553,21 +6719,7 @@ void wxGrid::RefreshAfterColPosChange()
     // recalculate the column rights as the column positions have changed,
     // unless we calculate them dynamically because all columns widths are the
     // same and it's easy to do
-    if ( !m_colWidths.empty() )
-    {
-        int colRight = 0;
-        for ( int colPos = 0; colPos < m_numCols; colPos++ )
-        {
-            int colID = GetColAt( colPos );
-
-            // Ignore the currently hidden columns.
-            const int width = m_colWidths[colID];
-            if ( width > 0 )
-                colRight += width;
-
-            m_colRights[colID] = colRight;
-        }
-    }
+    m_colSizes.SetLinesOrder(m_colAt);
 
     int areas = wxGA_Cells;
 
@@ -6197,55 +7349,28 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
 {
     InitPixelFields();
 
+    // The same fonts have different sizes in pixels now.
+    ClearTextWidthCache();
+
     // If we have any non-default row sizes, we need to scale them (default
     // ones will be scaled due to the reinitialization of m_defaultRowHeight
     // inside InitPixelFields() above).
-    if ( !m_rowHeights.empty() )
-    {
-        int total = 0;
-        for ( unsigned i = 0; i < m_rowHeights.size(); ++i )
+    m_rowSizes.TransformSizes([&event](int height)
         {
-            int height = m_rowHeights[i];
-
-            // Skip hidden rows.
-            if ( height <= 0 )
-                continue;
-
-            height = event.ScaleY(height);
-            total += height;
-
-            m_rowHeights[i] = height;
-            m_rowBottoms[i] = total;
-        }
-    }
+            return event.ScaleY(height);
+        });
 
     // Similarly for columns, except that here we need to update the native
     // control even if none of the widths had been changed, as it's not going
     // to do it on its own when redisplayed.
-    wxHeaderCtrl* const
-        colHeader = m_useNativeHeader ? GetGridColHeader() : nullptr;
-    if ( !m_colWidths.empty() )
-    {
-        int total = 0;
-        for ( unsigned i = 0; i < m_colWidths.size(); ++i )
+    m_colSizes.TransformSizes([&event](int width)
         {
-            int width = m_colWidths[i];
+            return event.ScaleX(width);
+        });
 
-            if ( width <= 0 )
-                continue;
-
-            width = event.ScaleX(width);
-            total += width;
-
-            m_colWidths[i] = width;
-            m_colRights[i] = total;
-
-            if ( colHeader )
-                colHeader->UpdateColumn(i);
-        }
-    }
-    else if ( colHeader )
+    if ( m_useNativeHeader )
     {
+        wxHeaderCtrl* const colHeader = GetGridColHeader();
         for ( int i = 0; i < m_numCols; ++i )
         {
             colHeader->UpdateColumn(i);
@@ -8322,9 +9447,8 @@ wxGridCellCoords wxGrid::XYToCell(int x, int y, wxGridWindow *gridWindow) const
 }
 
 // compute row or column from some (unscrolled) coordinate value, using either
-// m_defaultRowHeight/m_defaultColWidth or binary search on array of
-// m_rowBottoms/m_colRights to do it quickly in O(log n) time.
-// NOTE: This may not work correctly for reordered columns.
+// m_defaultRowHeight/m_defaultColWidth or m_rowSizes/m_colSizes to do it
+// quickly in O(log n) time.
 int wxGrid::PosToLinePos(int coord,
                          bool clipToMinMax,
                          const wxGridOperations& oper,
@@ -8343,8 +9467,8 @@ int wxGrid::PosToLinePos(int coord,
 
     // check for the simplest case: if we have no explicit line sizes
     // configured, then we already know the line this position falls in
-    const wxArrayInt& lineEnds = oper.GetLineEnds(this);
-    if ( lineEnds.empty() )
+    const wxGridLineSizes& lineSizes = oper.GetLineSizes(this);
+    if ( lineSizes.IsEmpty() )
     {
         if ( maxPos < (numLines + minPos) )
             return maxPos;
@@ -8352,45 +9476,20 @@ int wxGrid::PosToLinePos(int coord,
         return clipToMinMax ? numLines + minPos - 1 : -1;
     }
 
-    // binary search is quite efficient and we can't really make any assumptions
-    // on where to start here since row and columns could be of size 0 if they are
-    // hidden. While this could be made more efficient, some profiling will be
-    // necessary to determine if it really is a performance bottleneck
-    maxPos = numLines + minPos - 1;
+    // this finds the line even if some lines are hidden, i.e. have size 0,
+    // and, in this case, never returns the position of a hidden line
+    const int pos = lineSizes.FindPosAt(coord);
 
-    // check if the position is beyond the last column
-    const int lineAtMaxPos = oper.GetLineAt(this, maxPos);
-    if ( coord >= lineEnds[lineAtMaxPos] )
+    // check if the position is beyond the last line in this window
+    maxPos = numLines + minPos - 1;
+    if ( pos > maxPos )
         return clipToMinMax ? maxPos : wxNOT_FOUND;
 
     // or before the first one
-    const int lineAt0 = oper.GetLineAt(this, minPos);
-    if ( coord < oper.GetLineStartPos(this, lineAt0) )
+    if ( pos < minPos )
         return clipToMinMax ? minPos : wxNOT_FOUND;
-    else if ( coord < lineEnds[lineAt0] )
-        return minPos;
-
-    // finally do perform the binary search
-    while ( minPos < maxPos )
-    {
-        wxCHECK_MSG( lineEnds[oper.GetLineAt(this, minPos)] <= coord &&
-                        coord < lineEnds[oper.GetLineAt(this, maxPos)],
-                     -1,
-                     "wxGrid: internal error in PosToLinePos()" );
-
-        if ( coord >= lineEnds[oper.GetLineAt(this, maxPos - 1)] )
-            return maxPos;
-        else
-            maxPos--;
-
-        const int median = minPos + (maxPos - minPos + 1) / 2;
-        if ( coord < lineEnds[oper.GetLineAt(this, median)] )
-            maxPos = median;
-        else
-            minPos = median;
-    }
 
-    return maxPos;
+    return pos;
 }
 
 int
@@ -9745,6 +10844,7 @@ void wxGrid::SetDefaultCellFitMode(wxGridFitMode fitMode)
 void wxGrid::SetDefaultCellFont( const wxFont& font )
 {
     m_defaultCellAttr->SetFont(font);
+    ClearTextWidthCache();
 }
 
 // For editors and renderers the type registry takes precedence over the
@@ -10074,6 +11174,7 @@ void wxGrid::SetAttr(int row, int col, wxGridCellAttr *attr)
     {
         m_table->SetAttr(attr, row, col);
         ClearAttrCache();
+        ClearTextWidthCache();
     }
     else
     {
@@ -10087,6 +11188,7 @@ void wxGrid::SetRowAttr(int row, wxGridCellAttr *attr)
     {
         m_table->SetRowAttr(attr, row);
         ClearAttrCache();
+        ClearTextWidthCache();
     }
     else
     {
@@ -10100,6 +11202,7 @@ void wxGrid::SetColAttr(int col, wxGridCellAttr *attr)
     {
         m_table->SetColAttr(attr, col);
         ClearAttrCache();
+        ClearTextWidthCache();
     }
     else
     {
@@ -10344,11 +11447,9 @@ void wxGrid::SetDefaultRowSize( int height, bool resizeExistingRows )
     if ( resizeExistingRows )
     {
         // since we are resizing all rows to the default row size,
-        // we can simply clear the row heights and row bottoms
-        // arrays (which also allows us to take advantage of
-        // some speed optimisations)
-        m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        // we can simply clear the row sizes (which also allows us
+        // to take advantage of some speed optimisations)
+        m_rowSizes.Clear();
         CalcDimensions();
     }
 }
@@ -10439,22 +11540,16 @@ void wxGrid::DoSetRowSize( int row, int height )
 {
     wxCHECK_RET( row >= 0 && row < m_numRows, wxT("invalid row index") );
 
-    if ( m_rowHeights.IsEmpty() )
+    if ( m_rowSizes.IsEmpty() )
     {
-        // need to really create the array
+        // need to really start storing the sizes
         InitRowHeights();
     }
 
-    const int diff = UpdateRowOrColSize(m_rowHeights[row], height);
+    const int diff = m_rowSizes.SetSize(row, height);
     if ( !diff )
         return;
 
-
-    for ( int rowPos = GetRowPos(row); rowPos < m_numRows; rowPos++ )
-    {
-        m_rowBottoms[GetRowAt(rowPos)] += diff;
-    }
-
     InvalidateBestSize();
 
     CalcDimensions();
@@ -10513,11 +11608,9 @@ void wxGrid::SetDefaultColSize( int width, bool resizeExistingCols )
     if ( resizeExistingCols )
     {
         // since we are resizing all columns to the default column size,
-        // we can simply clear the col widths and col rights
-        // arrays (which also allows us to take advantage of
-        // some speed optimisations)
-        m_colWidths.Empty();
-        m_colRights.Empty();
+        // we can simply clear the column sizes (which also allows us
+        // to take advantage of some speed optimisations)
+        m_colSizes.Clear();
 
         CalcDimensions();
     }
@@ -10575,13 +11668,13 @@ void wxGrid::DoSetColSize( int col, int width )
 {
     wxCHECK_RET( col >= 0 && col < m_numCols, wxT("invalid column index") );
 
-    if ( m_colWidths.IsEmpty() )
+    if ( m_colSizes.IsEmpty() )
     {
-        // need to really create the array
+        // need to really start storing the sizes
         InitColWidths();
     }
 
-    const int diff = UpdateRowOrColSize(m_colWidths[col], width);
+    const int diff = m_colSizes.SetSize(col, width);
     if ( !diff )
         return;
 
@@ -10598,11 +11691,6 @@ void wxGrid::DoSetColSize( int col, int width )
     }
     //else: will be refreshed when the header is redrawn
 
-    for ( int colPos = GetColPos(col); colPos < m_numCols; colPos++ )
-    {
-        m_colRights[GetColAt(colPos)] += diff;
-    }
-
     InvalidateBestSize();
 
     CalcDimensions();
@@ -10678,58 +11766,335 @@ int wxGrid::GetRowMinimalHeight(int row) const
 {
     const auto it = m_rowMinHeights.find(row);
 
-    return it != m_rowMinHeights.end() ? it->second : m_minAcceptableRowHeight;
-}
+    return it != m_rowMinHeights.end() ? it->second : m_minAcceptableRowHeight;
+}
+
+void wxGrid::SetColMinimalAcceptableWidth( int width )
+{
+    // We do allow a width of 0 since this gives us
+    // an easy way to temporarily hiding columns.
+    if ( width >= 0 )
+        m_minAcceptableColWidth = width;
+}
+
+void wxGrid::SetRowMinimalAcceptableHeight( int height )
+{
+    // We do allow a height of 0 since this gives us
+    // an easy way to temporarily hiding rows.
+    if ( height >= 0 )
+        m_minAcceptableRowHeight = height;
+}
+
+int  wxGrid::GetColMinimalAcceptableWidth() const
+{
+    return m_minAcceptableColWidth;
+}
+
+int  wxGrid::GetRowMinimalAcceptableHeight() const
+{
+    return m_minAcceptableRowHeight;
+}
+
+void wxGrid::SetNativeHeaderColCount()
+{
+    wxASSERT_MSG( m_useNativeHeader, "no column header window" );
+
+    GetGridColHeader()->SetColumnCount(m_numCols);
+
+    SetNativeHeaderColOrder();
+}
+
+void wxGrid::SetNativeHeaderColOrder()
+{
+    wxASSERT_MSG( m_useNativeHeader, "no column header window" );
+
+    if ( !m_colAt.empty() )
+        GetGridColHeader()->SetColumnsOrder(m_colAt);
+    else
+        GetGridColHeader()->ResetColumnsOrder();
+}
+
+// ----------------------------------------------------------------------------
+// auto sizing
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// number of texts measured by a single task when using multiple threads
+const size_t GRID_MEASURE_CHUNK_SIZE = 512;
+
+// maximal number of the text widths cached for a single font
+const size_t GRID_MAX_CACHED_WIDTHS = 1 << 20;
+
+// Return the width of the possibly multiline text.
+#if wxUSE_THREADS && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+wxCoord GetMultiLineTextWidth(wxGraphicsContext* gc, const wxString& text)
+{
+    wxDouble widthMax = 0;
+
+    size_t start = 0;
+    for ( ;; )
+    {
+        const size_t end = text.find('\n', start);
+
+        wxDouble width;
+        gc->GetTextExtent(text.substr(start, end - start), &width, nullptr);
+        if ( width > widthMax )
+            widthMax = width;
+
+        if ( end == wxString::npos )
+            break;
+
+        start = end + 1;
+    }
+
+    return static_cast<wxCoord>(ceil(widthMax));
+}
+#endif // wxUSE_THREADS && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+
+} // anonymous namespace
+
+// Widths of the texts already measured, for each font, kept by wxGrid between
+// the calls to AutoSizeColumn[s]().
+class wxGridTextWidthCache
+{
+public:
+    typedef std::unordered_map<wxString, wxCoord> Widths;
+
+    wxGridTextWidthCache() = default;
+
+    Widths& GetWidths(const wxFont& font)
+    {
+        return m_widths[font.GetNativeFontInfoDesc()];
+    }
+
+private:
+    std::unordered_map<wxString, Widths> m_widths;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTextWidthCache);
+};
+
+namespace
+{
+
+// This class collects the texts of the cells, grouping them by their font, and
+// then measures each distinct text only once, using several threads if
+// possible, and only if its width is not cached yet.
+class TextWidthMeasurer
+{
+public:
+    TextWidthMeasurer() = default;
+
+    void Add(const wxFont& font, const wxString& text)
+    {
+        if ( text.empty() )
+            return;
+
+        // The same font is almost always used for all cells, so check for
+        // the last one first.
+        if ( m_last == -1 || m_groups[m_last].font != font )
+        {
+            m_last = -1;
+            for ( size_t n = 0; n < m_groups.size(); n++ )
+            {
+                if ( m_groups[n].font == font )
+                {
+                    m_last = n;
+                    break;
+                }
+            }
+
+            if ( m_last == -1 )
+            {
+                m_groups.push_back(Group(font));
+                m_last = m_groups.size() - 1;
+            }
+        }
+
+        m_groups[m_last].texts.insert(text);
+    }
+
+    // Return the maximal width of all texts. If maxTexts is positive, only
+    // measure this number of the longest texts in each group.
+    wxCoord GetMaxWidth(wxReadOnlyDC& dc,
+                        size_t maxTexts,
+                        wxGridTextWidthCache& cache) const
+    {
+        wxCoord widthMax = 0;
+        for ( const auto& group : m_groups )
+        {
+            wxVector<const wxString*> texts;
+            texts.reserve(group.texts.size());
+            for ( const auto& text : group.texts )
+                texts.push_back(&text);
+
+            if ( maxTexts && texts.size() > maxTexts )
+            {
+                // Compare the strings themselves if they have the same
+                // length to select the same texts independently of their
+                // order in the hash set.
+                std::nth_element(texts.begin(),
+                                 texts.begin() + maxTexts,
+                                 texts.end(),
+                                 [](const wxString* s1, const wxString* s2)
+                                 {
+                                    if ( s1->length() != s2->length() )
+                                        return s1->length() > s2->length();
+
+                                    return *s1 < *s2;
+                                 });
+                texts.resize(maxTexts);
+            }
+
+            wxGridTextWidthCache::Widths& widths = cache.GetWidths(group.font);
+
+            wxVector<const wxString*> uncached;
+            for ( const auto text : texts )
+            {
+                const auto it = widths.find(*text);
+                if ( it == widths.end() )
+                    uncached.push_back(text);
+                else if ( it->second > widthMax )
+                    widthMax = it->second;
+            }
+
+            if ( uncached.empty() )
+                continue;
+
+            const wxVector<wxCoord>
+                measured = MeasureTexts(dc, group.font, uncached);
+
+            // Don't let the cache grow indefinitely.
+            if ( widths.size() + uncached.size() > GRID_MAX_CACHED_WIDTHS )
+                widths.clear();
+
+            for ( size_t n = 0; n < uncached.size(); n++ )
+            {
+                widths[*uncached[n]] = measured[n];
+
+                if ( measured[n] > widthMax )
+                    widthMax = measured[n];
+            }
+        }
+
+        return widthMax;
+    }
+
+private:
+    // Return the widths of all the given texts.
+    static wxVector<wxCoord> MeasureTexts(wxReadOnlyDC& dc,
+                                          const wxFont& font,
+                                          const wxVector<const wxString*>& texts)
+    {
+#if wxUSE_THREADS && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+        // Only Cairo graphics objects can be used from the worker threads.
+        // Notice that we use it even if there is only one thread, to get the
+        // same results independently of the number of threads.
+        wxGraphicsRenderer* const renderer = wxGraphicsRenderer::GetCairoRenderer();
+        if ( renderer )
+            return MeasureTextsInParallel(renderer, font, texts);
+#endif // wxUSE_THREADS && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+
+        dc.SetFont(font);
+
+        wxVector<wxCoord> widths;
+        widths.reserve(texts.size());
+        for ( const auto text : texts )
+            widths.push_back(dc.GetMultiLineTextExtent(*text).x);
+
+        return widths;
+    }
+
+#if wxUSE_THREADS && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+    static wxVector<wxCoord>
+    MeasureTextsInParallel(wxGraphicsRenderer* renderer,
+                           const wxFont& font,
+                           const wxVector<const wxString*>& texts)
+    {
+        // Each chunk of this vector is filled by a single thread.
+        wxVector<wxCoord> widths(texts.size(), 0);
+
+        const size_t numChunks = (texts.size() + GRID_MEASURE_CHUNK_SIZE - 1)
+                                    / GRID_MEASURE_CHUNK_SIZE;
+        if ( !numChunks )
+            return widths;
+
+        const int numThreads = wxMin(wxThreadPool::Get().GetMaxThreads(),
+                                     static_cast<int>(numChunks));
+
+        // The contexts are created, and their font is set, in this thread,
+        // as the font objects can't be shared between the threads, and each
+        // context is only used by a single thread at any time.
+        wxVector<std::unique_ptr<wxGraphicsContext>> contexts(numThreads);
+        wxVector<int> freeContexts;
+        for ( int n = 0; n < numThreads; n++ )
+        {
+            contexts[n].reset(renderer->CreateMeasuringContext());
+            wxCHECK_MSG( contexts[n], widths,
+                         "failed to create measuring context" );
+
+            contexts[n]->SetFont(font, *wxBLACK);
+            freeContexts.push_back(n);
+        }
+
+        wxCriticalSection csFree;
+
+        wxThreadPool::Get().ParallelFor(numChunks, [&](size_t chunk)
+        {
+            int index;
+            {
+                wxCRIT_SECT_LOCKER(lock, csFree);
+                index = freeContexts.back();
+                freeContexts.pop_back();
+            }
+
+            wxGraphicsContext* const gc = contexts[index].get();
+
+            const size_t end = wxMin(texts.size(),
+                                     (chunk + 1)*GRID_MEASURE_CHUNK_SIZE);
+            for ( size_t n = chunk*GRID_MEASURE_CHUNK_SIZE; n < end; n++ )
+                widths[n] = GetMultiLineTextWidth(gc, *texts[n]);
+
+            wxCRIT_SECT_LOCKER(lock, csFree);
+            freeContexts.push_back(index);
+        }, numThreads);
 
-void wxGrid::SetColMinimalAcceptableWidth( int width )
-{
-    // We do allow a width of 0 since this gives us
-    // an easy way to temporarily hiding columns.
-    if ( width >= 0 )
-        m_minAcceptableColWidth = width;
-}
+        return widths;
+    }
+#endif // wxUSE_THREADS && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
 
-void wxGrid::SetRowMinimalAcceptableHeight( int height )
-{
-    // We do allow a height of 0 since this gives us
-    // an easy way to temporarily hiding rows.
-    if ( height >= 0 )
-        m_minAcceptableRowHeight = height;
-}
+    struct Group
+    {
+        explicit Group(const wxFont& font_) : font(font_) { }
 
-int  wxGrid::GetColMinimalAcceptableWidth() const
-{
-    return m_minAcceptableColWidth;
-}
+        wxFont font;
+        std::unordered_set<wxString> texts;
+    };
 
-int  wxGrid::GetRowMinimalAcceptableHeight() const
-{
-    return m_minAcceptableRowHeight;
-}
+    wxVector<Group> m_groups;
 
-void wxGrid::SetNativeHeaderColCount()
-{
-    wxASSERT_MSG( m_useNativeHeader, "no column header window" );
+    // index of the last used group or -1
+    int m_last = -1;
 
-    GetGridColHeader()->SetColumnCount(m_numCols);
+    wxDECLARE_NO_COPY_CLASS(TextWidthMeasurer);
+};
 
-    SetNativeHeaderColOrder();
+} // anonymous namespace
+
+void wxGrid::ClearTextWidthCache()
+{
+    wxDELETE(m_textWidthCache);
 }
 
-void wxGrid::SetNativeHeaderColOrder()
+void wxGrid::SetColAutoSizeMode(int flags, int maxValues)
 {
-    wxASSERT_MSG( m_useNativeHeader, "no column header window" );
+    wxCHECK_RET( maxValues >= 0, wxS("invalid number of values") );
 
-    if ( !m_colAt.empty() )
-        GetGridColHeader()->SetColumnsOrder(m_colAt);
-    else
-        GetGridColHeader()->ResetColumnsOrder();
+    m_colAutoSizeFlags = flags;
+    m_colAutoSizeMaxValues = maxValues;
 }
 
-// ----------------------------------------------------------------------------
-// auto sizing
-// ----------------------------------------------------------------------------
-
 void
 wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
 {
@@ -10778,10 +12143,42 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
     wxGridCellAttrPtr attr;
     wxGridCellRendererPtr renderer;
 
+    // When using the fast mode, the texts of the cells are collected and
+    // measured all at once after the loop below.
+    const bool fast = column && (m_colAutoSizeFlags & wxGRID_AUTOSIZE_FAST);
+    TextWidthMeasurer measurer;
+
+    // By default, all rows are measured, but if only the visible ones should
+    // be, collect them first.
+    const bool visibleOnly =
+        column && (m_colAutoSizeFlags & wxGRID_AUTOSIZE_VISIBLE_ROWS);
+    wxVector<int> visibleRows;
+    if ( visibleOnly )
+    {
+        for ( int pos = 0; pos < m_numFrozenRows; pos++ )
+            visibleRows.push_back(GetRowAt(pos));
+
+        int top, bottom;
+        CalcGridWindowUnscrolledPosition(0, 0, nullptr, &top, m_gridWin);
+        CalcGridWindowUnscrolledPosition(0, m_gridWin->GetClientSize().y,
+                                         nullptr, &bottom, m_gridWin);
+
+        const int posTop = YToPos(top, m_gridWin);
+        const int posBottom = YToPos(bottom, m_gridWin);
+        if ( posTop != wxNOT_FOUND && posBottom != wxNOT_FOUND )
+        {
+            for ( int pos = posTop; pos <= posBottom; pos++ )
+                visibleRows.push_back(GetRowAt(pos));
+        }
+    }
+
     wxCoord extent, extentMax = 0;
-    int max = column ? m_numRows : m_numCols;
-    for ( int rowOrCol = 0; rowOrCol < max; rowOrCol++ )
+    int max = visibleOnly ? static_cast<int>(visibleRows.size())
+                          : column ? m_numRows : m_numCols;
+    for ( int n = 0; n < max; n++ )
     {
+        const int rowOrCol = visibleOnly ? visibleRows[n] : n;
+
         if ( column )
         {
             if ( !IsRowShown(rowOrCol) )
@@ -10839,6 +12236,14 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
 
         if ( renderer )
         {
+            wxString text;
+            if ( fast && span == CellSpan_None &&
+                    renderer->GetTextToMeasure(*this, row, col, text) )
+            {
+                measurer.Add(attr->GetFont(), text);
+                continue;
+            }
+
             extent = column
                         ? renderer->GetBestWidth(*this, *attr, dc, row, col,
                                                  GetRowHeight(row))
@@ -10862,6 +12267,17 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
         }
     }
 
+    if ( fast )
+    {
+        if ( !m_textWidthCache )
+            m_textWidthCache = new wxGridTextWidthCache;
+
+        extent = measurer.GetMaxWidth(dc, m_colAutoSizeMaxValues,
+                                      *m_textWidthCache);
+        if ( extent > extentMax )
+            extentMax = extent;
+    }
+
     // now also compare with the column label extent
     wxCoord extentLabel;
     dc.SetFont( GetLabelFont() );
@@ -11097,24 +12513,23 @@ wxSize wxGrid::DoGetBestSize() const
     wxSize size(m_rowLabelWidth + m_extraWidth,
                 m_colLabelHeight + m_extraHeight);
 
-    if ( m_colWidths.empty() )
+    // the end of the last line is the total size of all of them
+    if ( m_colSizes.IsEmpty() )
     {
         size.x += m_defaultColWidth*m_numCols;
     }
     else
     {
-        for ( int col = 0; col < m_numCols; col++ )
-            size.x += GetColWidth(col);
+        size.x += GetColRight(GetColAt(m_numCols - 1));
     }
 
-    if ( m_rowHeights.empty() )
+    if ( m_rowSizes.IsEmpty() )
     {
         size.y += m_defaultRowHeight*m_numRows;
     }
     else
     {
-        for ( int row = 0; row < m_numRows; row++ )
-            size.y += GetRowHeight(row);
+        size.y += GetRowBottom(GetRowAt(m_numRows - 1));
     }
 
     return size + GetWindowBorderSize();
@@ -11962,6 +13377,390 @@ int wxGridSizesInfo::GetSize(unsigned pos) const
     return it->second;
 }
 
+// ----------------------------------------------------------------------------
+// wxGridLineSizes
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Switch to storing the sizes of all lines when more than 1/N of them have
+// non-default sizes: at this point the memory saving becomes insignificant
+// while updating the sizes becomes slower.
+const int GRID_SPARSE_SIZES_RATIO = 8;
+
+inline int GetVisibleLineSize(int size)
+{
+    // a negative size indicates a hidden line
+    return size > 0 ? size : 0;
+}
+
+} // anonymous namespace
+
+void wxGridLineSizes::Init(int count, int size, const wxArrayInt& lineAt)
+{
+    Clear();
+
+    m_count = count;
+    m_base = size;
+
+    // The sparse mode relies on line positions being the same as their
+    // indices, so we can't use it if the lines are reordered.
+    if ( !lineAt.empty() )
+    {
+        MakeDense();
+        SetPositions(lineAt);
+    }
+}
+
+void wxGridLineSizes::Clear()
+{
+    m_count = 0;
+    m_base = 0;
+
+    m_custom.clear();
+    m_sizes.clear();
+    m_tree.clear();
+    m_posOf.clear();
+}
+
+size_t wxGridLineSizes::FindCustom(int line) const
+{
+    return std::lower_bound(m_custom.begin(), m_custom.end(), line,
+                            [](const CustomSize& custom, int l)
+                            {
+                                return custom.line < l;
+                            }) - m_custom.begin();
+}
+
+int wxGridLineSizes::GetSparseEnd(int line) const
+{
+    int end = (line + 1)*m_base;
+
+    const size_t n = FindCustom(line + 1);
+    if ( n )
+        end += m_custom[n - 1].delta;
+
+    return end;
+}
+
+int wxGridLineSizes::GetSize(int line) const
+{
+    wxCHECK_MSG( line >= 0 && line < m_count, 0, "invalid line index" );
+
+    if ( IsSparse() )
+    {
+        const size_t n = FindCustom(line);
+        if ( n < m_custom.size() && m_custom[n].line == line )
+            return GetVisibleLineSize(m_custom[n].size);
+
+        return m_base;
+    }
+
+    return GetVisibleLineSize(m_sizes[line]);
+}
+
+int wxGridLineSizes::GetEnd(int line) const
+{
+    wxCHECK_MSG( line >= 0 && line < m_count, 0, "invalid line index" );
+
+    if ( IsSparse() )
+        return GetSparseEnd(line);
+
+    int end = 0;
+    for ( int i = GetPos(line) + 1; i > 0; i -= i & -i )
+        end += m_tree[i];
+
+    return end;
+}
+
+int wxGridLineSizes::FindPosAt(int coord) const
+{
+    if ( IsSparse() )
+    {
+        // Find the first custom line ending after the given coordinate.
+        size_t lo = 0,
+               hi = m_custom.size();
+        while ( lo < hi )
+        {
+            const size_t mid = (lo + hi) / 2;
+            const CustomSize& custom = m_custom[mid];
+            if ( (custom.line + 1)*m_base + custom.delta <= coord )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        // All lines between the previous custom line and this one have the
+        // base size, so we can find the line among them directly.
+        int prevLine = -1,
+            prevEnd = 0;
+        if ( lo )
+        {
+            prevLine = m_custom[lo - 1].line;
+            prevEnd = (prevLine + 1)*m_base + m_custom[lo - 1].delta;
+        }
+
+        const int nextLine = lo < m_custom.size() ? m_custom[lo].line
+                                                  : m_count;
+        if ( m_base > 0 )
+        {
+            const int pos = prevLine + 1 + (coord - prevEnd) / m_base;
+            if ( pos < nextLine )
+                return pos;
+        }
+
+        return nextLine;
+    }
+
+    // Descend the Fenwick tree looking for the number of lines ending before
+    // or at the given coordinate, which is also the position of the line
+    // containing it.
+    int step = 1;
+    while ( step <= m_count / 2 )
+        step *= 2;
+
+    int pos = 0;
+    for ( ; step; step /= 2 )
+    {
+        const int next = pos + step;
+        if ( next <= m_count && m_tree[next] <= coord )
+        {
+            pos = next;
+            coord -= m_tree[next];
+        }
+    }
+
+    return pos;
+}
+
+int wxGridLineSizes::SetSize(int line, int size)
+{
+    wxCHECK_MSG( line >= 0 && line < m_count, 0, "invalid line index" );
+
+    if ( !IsSparse() )
+    {
+        const int diff = UpdateRowOrColSize(m_sizes[line], size);
+        for ( int i = GetPos(line) + 1; diff && i <= m_count; i += i & -i )
+            m_tree[i] += diff;
+
+        return diff;
+    }
+
+    const size_t n = FindCustom(line);
+    const bool found = n < m_custom.size() && m_custom[n].line == line;
+
+    int current = found ? m_custom[n].size : m_base;
+    const int diff = UpdateRowOrColSize(current, size);
+    if ( !diff )
+        return 0;
+
+    if ( current == m_base )
+    {
+        if ( found )
+            m_custom.erase(m_custom.begin() + n);
+    }
+    else if ( found )
+    {
+        m_custom[n].size = current;
+    }
+    else
+    {
+        const CustomSize custom = { line, current, 0 };
+        m_custom.insert(m_custom.begin() + n, custom);
+    }
+
+    if ( m_custom.size() > static_cast<size_t>(m_count / GRID_SPARSE_SIZES_RATIO) )
+    {
+        MakeDense();
+        Rebuild();
+    }
+    else
+    {
+        UpdateDeltas(n);
+    }
+
+    return diff;
+}
+
+void
+wxGridLineSizes::InsertLines(int line, int count, int size,
+                             const wxArrayInt& lineAt)
+{
+    if ( IsEmpty() )
+        return;
+
+    if ( IsSparse() )
+    {
+        if ( size == m_base && lineAt.empty() )
+        {
+            // Just shift the custom lines after the inserted ones, the deltas
+            // don't change as the new lines have the base size.
+            for ( size_t n = FindCustom(line); n < m_custom.size(); ++n )
+                m_custom[n].line += count;
+
+            m_count += count;
+            return;
+        }
+
+        MakeDense();
+    }
+
+    m_sizes.insert(m_sizes.begin() + line, count, size);
+    m_count += count;
+
+    SetPositions(lineAt);
+}
+
+void
+wxGridLineSizes::DeleteLines(int line, int count, const wxArrayInt& lineAt)
+{
+    if ( IsEmpty() )
+        return;
+
+    if ( count >= m_count )
+    {
+        Clear();
+        return;
+    }
+
+    if ( IsSparse() )
+    {
+        const size_t first = FindCustom(line);
+        m_custom.erase(m_custom.begin() + first,
+                       m_custom.begin() + FindCustom(line + count));
+
+        for ( size_t n = first; n < m_custom.size(); ++n )
+            m_custom[n].line -= count;
+
+        m_count -= count;
+
+        if ( lineAt.empty() )
+        {
+            UpdateDeltas(first);
+            return;
+        }
+
+        MakeDense();
+    }
+    else
+    {
+        m_sizes.erase(m_sizes.begin() + line, m_sizes.begin() + line + count);
+        m_count -= count;
+    }
+
+    SetPositions(lineAt);
+}
+
+void wxGridLineSizes::SetLinesOrder(const wxArrayInt& lineAt)
+{
+    if ( IsEmpty() )
+        return;
+
+    if ( IsSparse() )
+    {
+        // Nothing to do if the lines are still not reordered.
+        if ( lineAt.empty() )
+            return;
+
+        MakeDense();
+    }
+
+    SetPositions(lineAt);
+}
+
+wxGridSizesInfo wxGridLineSizes::GetSizesInfo(int defSize) const
+{
+    wxGridSizesInfo info;
+    info.m_sizeDefault = defSize;
+
+    if ( IsSparse() )
+    {
+        // This can only happen if the default size was changed without
+        // resizing the existing lines, so it should be rare.
+        if ( m_base != defSize )
+        {
+            for ( int line = 0; line < m_count; ++line )
+                info.m_customSizes[line] = m_base;
+        }
+
+        for ( const auto& custom : m_custom )
+        {
+            if ( custom.size != defSize )
+                info.m_customSizes[custom.line] = custom.size;
+            else
+                info.m_customSizes.erase(custom.line);
+        }
+    }
+    else
+    {
+        for ( int line = 0; line < m_count; ++line )
+        {
+            if ( m_sizes[line] != defSize )
+                info.m_customSizes[line] = m_sizes[line];
+        }
+    }
+
+    return info;
+}
+
+void wxGridLineSizes::UpdateDeltas(size_t start)
+{
+    int delta = start ? m_custom[start - 1].delta : 0;
+    for ( size_t n = start; n < m_custom.size(); ++n )
+    {
+        delta += GetVisibleLineSize(m_custom[n].size) - m_base;
+        m_custom[n].delta = delta;
+    }
+}
+
+void wxGridLineSizes::MakeDense()
+{
+    m_sizes.assign(m_count, m_base);
+    for ( const auto& custom : m_custom )
+        m_sizes[custom.line] = custom.size;
+
+    m_custom.clear();
+}
+
+void wxGridLineSizes::SetPositions(const wxArrayInt& lineAt)
+{
+    if ( lineAt.empty() )
+    {
+        m_posOf.clear();
+    }
+    else
+    {
+        m_posOf.resize(m_count);
+        for ( int pos = 0; pos < m_count; ++pos )
+            m_posOf[lineAt[pos]] = pos;
+    }
+
+    Rebuild();
+}
+
+void wxGridLineSizes::Rebuild()
+{
+    if ( IsSparse() )
+    {
+        UpdateDeltas(0);
+        return;
+    }
+
+    // Build the Fenwick tree in linear time by propagating each partial sum
+    // to its parent.
+    m_tree.assign(m_count + 1, 0);
+    for ( int line = 0; line < m_count; ++line )
+        m_tree[GetPos(line) + 1] = GetVisibleLineSize(m_sizes[line]);
+
+    for ( int i = 1; i <= m_count; ++i )
+    {
+        const int parent = i + (i & -i);
+        if ( parent <= m_count )
+            m_tree[parent] += m_tree[i];
+    }
+}
+
 // ----------------------------------------------------------------------------
 // drop target
 // ----------------------------------------------------------------------------
@@ -217,6 +217,14 @@ wxSize wxGridCellDateRenderer::GetBestSize(wxGrid& grid,
     return DoGetBestSize(attr, dc, GetString(grid, row, col));
 }
 
+bool wxGridCellDateRenderer::GetTextToMeasure(wxGrid& grid,
+                                              int row, int col,
+                                              wxString& text)
+{
+    text = GetString(grid, row, col);
+    return true;
+}
+
 wxSize wxGridCellDateRenderer::GetMaxBestSize(wxGrid& WXUNUSED(grid),
                                               wxGridCellAttr& attr,
                                               wxDC& dc)
@@ -356,6 +364,14 @@ wxSize wxGridCellEnumRenderer::GetBestSize(wxGrid& grid,
     return DoGetBestSize(attr, dc, GetString(grid, row, col));
 }
 
+bool wxGridCellEnumRenderer::GetTextToMeasure(wxGrid& grid,
+                                              int row, int col,
+                                              wxString& text)
+{
+    text = GetString(grid, row, col);
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // wxGridCellAutoWrapStringRenderer
 // ----------------------------------------------------------------------------
@@ -616,6 +632,14 @@ wxSize wxGridCellStringRenderer::GetBestSize(wxGrid& grid,
     return DoGetBestSize(attr, dc, grid.GetCellValue(row, col));
 }
 
+bool wxGridCellStringRenderer::GetTextToMeasure(wxGrid& grid,
+                                                int row, int col,
+                                                wxString& text)
+{
+    text = grid.GetCellValue(row, col);
+    return true;
+}
+
 void wxGridCellStringRenderer::Draw(wxGrid& grid,
                                     wxGridCellAttr& attr,
                                     wxDC& dc,
@@ -763,6 +787,14 @@ wxSize wxGridCellNumberRenderer::GetBestSize(wxGrid& grid,
     return DoGetBestSize(attr, dc, GetString(grid, row, col));
 }
 
+bool wxGridCellNumberRenderer::GetTextToMeasure(wxGrid& grid,
+                                                int row, int col,
+                                                wxString& text)
+{
+    text = GetString(grid, row, col);
+    return true;
+}
+
 wxSize wxGridCellNumberRenderer::GetMaxBestSize(wxGrid& WXUNUSED(grid),
                                                 wxGridCellAttr& attr,
                                                 wxDC& dc)
@@ -892,6 +924,14 @@ wxSize wxGridCellFloatRenderer::GetBestSize(wxGrid& grid,
     return DoGetBestSize(attr, dc, GetString(grid, row, col));
 }
 
+bool wxGridCellFloatRenderer::GetTextToMeasure(wxGrid& grid,
+                                               int row, int col,
+                                               wxString& text)
+{
+    text = GetString(grid, row, col);
+    return true;
+}
+
 void wxGridCellFloatRenderer::SetParameters(const wxString& params)
 {
     if ( params.empty() )
@@ -600,20 +600,40 @@ void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale)
     wxBitmapRefData* bmpData = new wxBitmapRefData(w, h, depth);
     bmpData->m_scaleFactor = scale;
     m_refData = bmpData;
-    GdkPixbuf* pixbuf_dst = gdk_pixbuf_new(GDK_COLORSPACE_RGB, depth == 32, 8, w, h);
-    bmpData->m_pixbufNoMask = pixbuf_dst;
-    wxASSERT(bmpData->m_bpp == 32 || !gdk_pixbuf_get_has_alpha(bmpData->m_pixbufNoMask));
     const guchar* src = image.GetData();
+    guchar* dst;
 
-    guchar* dst = gdk_pixbuf_get_pixels(pixbuf_dst);
-    const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
-    CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
-
-    if (depth == 32 && alpha)
+    if (depth == 24 && !alpha && !image.HasMask())
+    {
+        // Create the surface used for drawing directly, instead of creating
+        // a pixbuf which would need to be converted to it later anyhow. This
+        // is not done for the images with alpha, as premultiplying it would
+        // lose the precision of the partially transparent pixels, while the
+        // pixbuf preserves them exactly, nor for the images with mask, which
+        // must be kept separately from the pixel data.
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, w, h);
+        cairo_surface_flush(surface);
+        dst = cairo_image_surface_get_data(surface);
+        image.CopyToPremultipliedARGB(dst, cairo_image_surface_get_stride(surface));
+        cairo_surface_mark_dirty(surface);
+        bmpData->m_surface = surface;
+    }
+    else
     {
-        for (int j = 0; j < h; j++, dst += dstStride)
-            for (int i = 0; i < w; i++)
-                dst[i * 4 + 3] = *alpha++;
+        GdkPixbuf* pixbuf_dst = gdk_pixbuf_new(GDK_COLORSPACE_RGB, depth == 32, 8, w, h);
+        bmpData->m_pixbufNoMask = pixbuf_dst;
+        wxASSERT(bmpData->m_bpp == 32 || !gdk_pixbuf_get_has_alpha(bmpData->m_pixbufNoMask));
+
+        dst = gdk_pixbuf_get_pixels(pixbuf_dst);
+        const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
+        CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
+
+        if (depth == 32 && alpha)
+        {
+            for (int j = 0; j < h; j++, dst += dstStride)
+                for (int i = 0; i < w; i++)
+                    dst[i * 4 + 3] = *alpha++;
+        }
     }
     if (image.HasMask())
     {
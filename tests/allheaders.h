@@ -166,6 +166,7 @@
 #include <wx/gifdecod.h>
 #include <wx/glcanvas.h>
 #include <wx/graphics.h>
+#include <wx/graphrec.h>
 #include <wx/grid.h>
 #include <wx/hash.h>
 #include <wx/hashmap.h>
@@ -183,6 +184,7 @@
 #include <wx/iconloc.h>
 #include <wx/imagbmp.h>
 #include <wx/image.h>
+#include <wx/imagebatch.h>
 #include <wx/imaggif.h>
 #include <wx/imagiff.h>
 #include <wx/imagjpeg.h>
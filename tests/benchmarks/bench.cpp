@@ -16,9 +16,14 @@
 // ----------------------------------------------------------------------------
 
 #include <float.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
 
 #include "wx/app.h"
 #include "wx/cmdline.h"
+#include "wx/filefn.h"
 #include "wx/stopwatch.h"
 #include "wx/uilocale.h"
 
@@ -39,6 +44,7 @@ static const char OPTION_RUN_TIME = 't';
 static const char OPTION_NUM_RUNS = 'n';
 static const char OPTION_NUMERIC_PARAM = 'p';
 static const char OPTION_STRING_PARAM = 's';
+static const char OPTION_FORMAT = 'f';
 
 // ----------------------------------------------------------------------------
 // BenchApp declaration
@@ -74,22 +80,101 @@ private:
     // list all registered benchmarks
     void ListBenchmarks();
 
+    // check if the benchmark with the given name should be run
+    bool ShouldRun(const wxString& name) const;
+
     // command lines options/parameters
     wxSortedArrayString m_toRun;
     long m_numRuns, // number of times to run a single benchmark or 0
          m_runTime, // minimum time to run a single benchmark if m_numRuns == 0
          m_numParam;
     wxString m_strParam;
+
+    // output the results in JSON format instead of human-readable text
+    bool m_json;
 };
 
 wxIMPLEMENT_APP_CONSOLE(BenchApp);
 
+// ============================================================================
+// memory allocations counting
+// ============================================================================
+
+static std::atomic<unsigned long> gs_numAllocs(0);
+
+#ifdef __GLIBC__
+
+// With glibc we can count all allocations, including those done by malloc()
+// directly, by overriding the standard functions and forwarding to the real
+// implementation. Note that operator new uses malloc() too, so it doesn't
+// need to be overridden.
+extern "C"
+{
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size)
+{
+    ++gs_numAllocs;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size)
+{
+    ++gs_numAllocs;
+    return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    ++gs_numAllocs;
+    return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+#else // !__GLIBC__
+
+// Elsewhere only count the allocations done using operator new.
+void* operator new(size_t size)
+{
+    ++gs_numAllocs;
+
+    void* const ptr = malloc(size ? size : 1);
+    if ( !ptr )
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+#endif // __GLIBC__/!__GLIBC__
+
 // ============================================================================
 // Bench namespace symbols implementation
 // ============================================================================
 
 Bench::Function *Bench::Function::ms_head = nullptr;
 
+// Number of bytes set by the currently running benchmark, 0 if none.
+static double gs_bytesPerRun = 0;
+
 long Bench::GetNumericParameter(long defVal)
 {
     const long val = wxGetApp().GetNumericParameter();
@@ -102,6 +187,50 @@ wxString Bench::GetStringParameter(const wxString& defVal)
     return !val.empty() ? val : defVal;
 }
 
+void Bench::SetBytesPerRun(double bytes)
+{
+    gs_bytesPerRun = bytes;
+}
+
+unsigned long Bench::GetAllocationsCount()
+{
+    return gs_numAllocs;
+}
+
+// ============================================================================
+// helpers
+// ============================================================================
+
+// Return the string quoted and escaped as required by JSON (RFC 8259).
+static wxString JSONQuote(const wxString& str)
+{
+    wxString quoted("\"");
+    for ( wxString::const_iterator it = str.begin(); it != str.end(); ++it )
+    {
+        const wxUniChar ch = *it;
+        switch ( ch.GetValue() )
+        {
+            case '"':  quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\b': quoted += "\\b"; break;
+            case '\f': quoted += "\\f"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+
+            default:
+                if ( ch.GetValue() < 0x20 )
+                    quoted += wxString::Format("\\u%04x", ch.GetValue());
+                else
+                    quoted += ch;
+        }
+    }
+
+    quoted += '"';
+
+    return quoted;
+}
+
 // ============================================================================
 // BenchApp implementation
 // ============================================================================
@@ -111,6 +240,7 @@ BenchApp::BenchApp()
     m_numRuns = 0; // this means to use m_runTime
     m_runTime = 500; // default minimum
     m_numParam = 0;
+    m_json = false;
 }
 
 bool BenchApp::OnInit()
@@ -121,8 +251,11 @@ bool BenchApp::OnInit()
     // Some benchmarks are locale-sensitive, so use the current locale.
     wxUILocale::UseDefault();
 
-    wxPrintf("wxWidgets benchmarking program\n"
-             "Build: %s\n", WX_BUILD_OPTIONS_SIGNATURE);
+    if ( !m_json )
+    {
+        wxPrintf("wxWidgets benchmarking program\n"
+                 "Build: %s\n", WX_BUILD_OPTIONS_SIGNATURE);
+    }
 
 #if wxUSE_GUI
     // create a hidden parent window to be used as parent for the GUI controls
@@ -176,8 +309,13 @@ void BenchApp::OnInitCmdLine(wxCmdLineParser& parser)
                      "string parameter used by some benchmark functions "
                      "(default: empty)",
                      wxCMD_LINE_VAL_STRING);
+    parser.AddOption(OPTION_FORMAT,
+                     "format",
+                     "output format: \"text\" (default) or \"json\" "
+                     "for one JSON object per line",
+                     wxCMD_LINE_VAL_STRING);
 
-    parser.AddParam("benchmark name",
+    parser.AddParam("benchmark name or wildcard pattern",
                     wxCMD_LINE_VAL_STRING,
                     wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
 }
@@ -205,6 +343,22 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
     const bool numRunsSpecified = parser.Found(OPTION_NUM_RUNS, &m_numRuns);
     parser.Found(OPTION_NUMERIC_PARAM, &m_numParam);
     parser.Found(OPTION_STRING_PARAM, &m_strParam);
+
+    wxString format;
+    if ( parser.Found(OPTION_FORMAT, &format) )
+    {
+        if ( format == "json" )
+        {
+            m_json = true;
+        }
+        else if ( format != "text" )
+        {
+            wxFprintf(stderr, "Unknown output format \"%s\".\n", format);
+
+            return false;
+        }
+    }
+
     if ( parser.Found(OPTION_SINGLE) )
     {
         if ( runTimeSpecified || numRunsSpecified )
@@ -222,19 +376,24 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
         m_runTime = 0;
     }
 
-    // construct sorted array for quick verification of benchmark names
-    wxSortedArrayString benchmarks;
-    for ( Bench::Function *func = Bench::Function::GetFirst();
-          func;
-          func = func->GetNext() )
-    {
-        benchmarks.push_back(func->GetName());
-    }
-
     for ( size_t n = 0; n < count; n++ )
     {
         const wxString name = parser.GetParam(n);
-        if ( benchmarks.Index(name) == wxNOT_FOUND )
+
+        // Check that the name, or pattern, matches at least one benchmark.
+        bool found = false;
+        for ( Bench::Function *func = Bench::Function::GetFirst();
+              func;
+              func = func->GetNext() )
+        {
+            if ( wxMatchWild(name, func->GetName()) )
+            {
+                found = true;
+                break;
+            }
+        }
+
+        if ( !found )
         {
             wxFprintf(stderr, "No benchmark named \"%s\".\n", name);
             return false;
@@ -260,14 +419,14 @@ int BenchApp::OnRun()
         params += wxString::Format("s=\"%s\"", m_strParam);
     }
 
-    if ( !params.empty() )
+    if ( !params.empty() && !m_json )
         wxPrintf("Benchmarks are running with non-default %s\n", params);
 
     for ( Bench::Function *func = Bench::Function::GetFirst();
           func;
           func = func->GetNext() )
     {
-        if ( m_toRun.Index(func->GetName()) == wxNOT_FOUND )
+        if ( !ShouldRun(func->GetName()) )
             continue;
 
         if ( !RunSingleBenchmark(func) )
@@ -282,11 +441,16 @@ int BenchApp::OnRun()
 
 bool BenchApp::RunSingleBenchmark(Bench::Function* func)
 {
+    gs_bytesPerRun = 0;
+
     if ( !func->Init() )
         return false;
 
-    wxPrintf("Benchmarking %s: ", func->GetName());
-    fflush(stdout);
+    if ( !m_json )
+    {
+        wxPrintf("Benchmarking %s: ", func->GetName());
+        fflush(stdout);
+    }
 
     // We use the algorithm for iteratively computing the mean and the
     // standard deviation of the sequence of values described in Knuth's
@@ -302,6 +466,8 @@ bool BenchApp::RunSingleBenchmark(Bench::Function* func)
     // of the first sequence M(N) and the standard deviation is
     // sqrt(S(N)/(N-1)).
 
+    const unsigned long allocsStart = Bench::GetAllocationsCount();
+
     wxStopWatch swTotal;
     if ( !func->Run() )
         return false;
@@ -343,24 +509,64 @@ bool BenchApp::RunSingleBenchmark(Bench::Function* func)
             break;
     }
 
+    const double allocsPerRun =
+        double(Bench::GetAllocationsCount() - allocsStart) / n;
+
     func->Done();
 
-    // For a single run there is no standard deviation and min/max don't make
-    // much sense.
-    if ( n == 1 )
-    {
-        wxPrintf("single run took %.0fus\n", m);
-    }
-    else
-    {
+    // Throughput in MB/s, 0 if the benchmark doesn't define it.
+    const double mbPerSec = m > 0 ? gs_bytesPerRun / m : 0;
+
+    if ( n > 1 )
         s = sqrt(s / (n - 1));
 
+    if ( m_json )
+    {
+        wxString params;
+        if ( m_numParam )
+            params += wxString::Format(", \"num_param\": %ld", m_numParam);
+        if ( !m_strParam.empty() )
+            params += ", \"str_param\": " + JSONQuote(m_strParam);
+
+        // Use C locale for the numbers to ensure that the output is valid.
         wxPrintf
         (
-            "%ld runs, %.0fus avg, %.0f std dev (%.0f/%.0f min/max)\n",
-            n, m, s, timeMin, timeMax
+            "{\"name\": %s%s, \"runs\": %ld, \"avg_us\": %s, "
+            "\"stddev_us\": %s, \"min_us\": %s, \"max_us\": %s, "
+            "\"mb_per_s\": %s, \"allocs_per_run\": %s}\n",
+            JSONQuote(func->GetName()),
+            params,
+            n,
+            wxString::FromCDouble(m, 1),
+            wxString::FromCDouble(s, 1),
+            wxString::FromCDouble(n > 1 ? timeMin : m, 1),
+            wxString::FromCDouble(n > 1 ? timeMax : m, 1),
+            wxString::FromCDouble(mbPerSec, 2),
+            wxString::FromCDouble(allocsPerRun, 1)
         );
     }
+    else
+    {
+        // For a single run there is no standard deviation and min/max don't
+        // make much sense.
+        if ( n == 1 )
+        {
+            wxPrintf("single run took %.0fus", m);
+        }
+        else
+        {
+            wxPrintf
+            (
+                "%ld runs, %.0fus avg, %.0f std dev (%.0f/%.0f min/max)",
+                n, m, s, timeMin, timeMax
+            );
+        }
+
+        if ( mbPerSec > 0 )
+            wxPrintf(", %.1f MB/s", mbPerSec);
+
+        wxPrintf(", %.1f allocs/run\n", allocsPerRun);
+    }
 
     fflush(stdout);
 
@@ -376,6 +582,17 @@ int BenchApp::OnExit()
     return 0;
 }
 
+bool BenchApp::ShouldRun(const wxString& name) const
+{
+    for ( size_t n = 0; n < m_toRun.size(); n++ )
+    {
+        if ( wxMatchWild(m_toRun[n], name) )
+            return true;
+    }
+
+    return false;
+}
+
 /* static */
 void BenchApp::ListBenchmarks()
 {
@@ -93,6 +93,25 @@ long GetNumericParameter(long defValue = 1);
  */
 wxString GetStringParameter(const wxString& defValue = wxString());
 
+/**
+    Set the number of bytes processed by a single run of the benchmark.
+
+    This should be called by the benchmark function or its initialization
+    function if it makes sense to express its performance as throughput. If
+    it is called, the number of megabytes processed per second is shown in
+    the benchmark results.
+ */
+void SetBytesPerRun(double bytes);
+
+/**
+    Get the number of memory allocations done by the program so far.
+
+    Allocations are counted only if they're done using operator new or, when
+    using glibc, using malloc() and related functions. If counting them is
+    not supported at all, always returns 0.
+ */
+unsigned long GetAllocationsCount();
+
 } // namespace Bench
 
 /**
@@ -8,6 +8,10 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "wx/image.h"
+#include "wx/math.h"
+#include "wx/mstream.h"
+#include "wx/palette.h"
+#include "wx/utils.h"
 
 #include "bench.h"
 
@@ -118,3 +122,301 @@ BENCHMARK_FUNC(ShrinkHighQuality)
     return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
                        wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+// ----------------------------------------------------------------------------
+// Systematic image codecs benchmarks
+// ----------------------------------------------------------------------------
+
+// Create an image of the given size with smooth gradients and some noise,
+// to make it look more like a photo than a completely synthetic image would.
+//
+// If limitColours is true, only 216 colours are used, which allows saving the
+// image in the formats supporting at most 256 colours.
+static wxImage CreateTestImage(int width, int height, bool limitColours)
+{
+    wxImage image(width, height, false /* don't clear */);
+
+    unsigned char* p = image.GetData();
+    unsigned seed = 1;
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            // Simple linear congruential generator is good enough for noise.
+            seed = seed*1103515245 + 12345;
+            const int noise = static_cast<int>((seed >> 16) & 0x1f) - 0x10;
+
+            int rgb[3] =
+            {
+                255*x/width + noise,
+                255*y/height + noise,
+                255*(x + y)/(width + height) - noise
+            };
+
+            for ( int n = 0; n < 3; n++ )
+            {
+                int c = wxMax(0, wxMin(rgb[n], 255));
+                if ( limitColours )
+                    c = (c / 43) * 51;
+
+                *p++ = static_cast<unsigned char>(c);
+            }
+        }
+    }
+
+    return image;
+}
+
+// The data used by the codec benchmark currently being run.
+static wxBitmapType gs_codecType = wxBITMAP_TYPE_INVALID;
+static wxImage gs_codecImage;
+static wxMemoryBuffer gs_codecData;
+
+static bool InitCodec(wxBitmapType type, int size)
+{
+    static bool s_handlersAdded = false;
+    if ( !s_handlersAdded )
+    {
+        s_handlersAdded = true;
+        wxInitAllImageHandlers();
+    }
+
+    const bool limitColours = type == wxBITMAP_TYPE_GIF ||
+                                type == wxBITMAP_TYPE_XPM;
+
+    gs_codecType = type;
+    gs_codecImage = CreateTestImage(size, size, limitColours);
+
+#if wxUSE_PALETTE
+    // GIF handler can only save images with a palette, so provide the one
+    // containing all the colours used by the image.
+    if ( type == wxBITMAP_TYPE_GIF )
+    {
+        unsigned char r[216], g[216], b[216];
+        for ( int n = 0; n < 216; n++ )
+        {
+            r[n] = (n / 36)*51;
+            g[n] = (n / 6 % 6)*51;
+            b[n] = (n % 6)*51;
+        }
+
+        gs_codecImage.SetPalette(wxPalette(216, r, g, b));
+    }
+#endif // wxUSE_PALETTE
+
+    // Prepare the encoded data to be used by the decoding benchmark.
+    wxMemoryOutputStream stream;
+    if ( !gs_codecImage.SaveFile(stream, type) )
+        return false;
+
+    gs_codecData.Clear();
+    gs_codecData.AppendData(stream.GetOutputStreamBuffer()->GetBufferStart(),
+                            stream.GetLength());
+
+    // Use the size of the uncompressed data for both encoding and decoding.
+    Bench::SetBytesPerRun(3.*size*size);
+
+    return true;
+}
+
+static void DoneCodec()
+{
+    gs_codecImage = wxImage();
+    gs_codecData.Clear();
+}
+
+static bool DoDecode()
+{
+    wxMemoryInputStream stream(gs_codecData.GetData(), gs_codecData.GetDataLen());
+
+    wxImage image;
+    return image.LoadFile(stream, gs_codecType);
+}
+
+static bool DoEncode()
+{
+    wxMemoryOutputStream stream;
+    return gs_codecImage.SaveFile(stream, gs_codecType);
+}
+
+// Define DecodeXXX_N and EncodeXXX_N benchmarks for the given format and size.
+#define IMAGE_CODEC_BENCHMARKS(fmt, type, size)                               \
+    static bool InitCodec##fmt##size() { return InitCodec(type, size); }     \
+    BENCHMARK_FUNC_WITH_INIT(Decode##fmt##_##size,                            \
+                             InitCodec##fmt##size, DoneCodec)                 \
+    {                                                                         \
+        return DoDecode();                                                    \
+    }                                                                         \
+    BENCHMARK_FUNC_WITH_INIT(Encode##fmt##_##size,                            \
+                             InitCodec##fmt##size, DoneCodec)                 \
+    {                                                                         \
+        return DoEncode();                                                    \
+    }
+
+#define IMAGE_CODEC_BENCHMARKS_ALL_SIZES(fmt, type)                           \
+    IMAGE_CODEC_BENCHMARKS(fmt, type, 128)                                    \
+    IMAGE_CODEC_BENCHMARKS(fmt, type, 512)                                    \
+    IMAGE_CODEC_BENCHMARKS(fmt, type, 2048)
+
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(PNG, wxBITMAP_TYPE_PNG)
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(JPEG, wxBITMAP_TYPE_JPEG)
+#if wxUSE_LIBTIFF
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(TIFF, wxBITMAP_TYPE_TIFF)
+#endif // wxUSE_LIBTIFF
+#if wxUSE_GIF
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(GIF, wxBITMAP_TYPE_GIF)
+#endif // wxUSE_GIF
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(BMP, wxBITMAP_TYPE_BMP)
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(TGA, wxBITMAP_TYPE_TGA)
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(PNM, wxBITMAP_TYPE_PNM)
+IMAGE_CODEC_BENCHMARKS_ALL_SIZES(XPM, wxBITMAP_TYPE_XPM)
+
+// Compress PNG using all available threads instead of a single one.
+static bool InitPNGParallel()
+{
+    if ( !InitCodec(wxBITMAP_TYPE_PNG, 2048) )
+        return false;
+
+    gs_codecImage.SetOption(wxIMAGE_OPTION_PNG_COMPRESSION_THREADS, 0);
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(EncodePNGParallel_2048, InitPNGParallel, DoneCodec)
+{
+    return DoEncode();
+}
+
+// Saving PNG without filtering is much faster.
+static bool InitPNGNoFilter()
+{
+    if ( !InitCodec(wxBITMAP_TYPE_PNG, 2048) )
+        return false;
+
+    gs_codecImage.SetOption(wxIMAGE_OPTION_PNG_FILTER, wxPNG_FILTER_NONE);
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(EncodePNGNoFilter_2048, InitPNGNoFilter, DoneCodec)
+{
+    return DoEncode();
+}
+
+// ----------------------------------------------------------------------------
+// Image processing benchmarks
+// ----------------------------------------------------------------------------
+
+// Unlike GetTestImage(), this function returns a big image, making the
+// overhead of the operations less important than the processing itself.
+static const wxImage& GetBigTestImage()
+{
+    static const wxImage s_image = CreateTestImage(1920, 1080, false);
+
+    return s_image;
+}
+
+static bool InitBigImage()
+{
+    Bench::SetBytesPerRun(3.*GetBigTestImage().GetWidth()*GetBigTestImage().GetHeight());
+
+    return GetBigTestImage().IsOk();
+}
+
+static bool DoScale(wxImageResizeQuality quality, int percent)
+{
+    const wxImage& image = GetBigTestImage();
+    return image.Scale(image.GetWidth()*percent/100,
+                       image.GetHeight()*percent/100,
+                       quality).IsOk();
+}
+
+// Define EnlargeBigXXX and ShrinkBigXXX benchmarks for the given quality.
+#define IMAGE_SCALE_BENCHMARKS(name, quality)                                 \
+    BENCHMARK_FUNC_WITH_INIT(EnlargeBig##name, InitBigImage, nullptr)         \
+    {                                                                         \
+        return DoScale(quality, Bench::GetNumericParameter(150));             \
+    }                                                                         \
+    BENCHMARK_FUNC_WITH_INIT(ShrinkBig##name, InitBigImage, nullptr)          \
+    {                                                                         \
+        return DoScale(quality, Bench::GetNumericParameter(50));              \
+    }
+
+IMAGE_SCALE_BENCHMARKS(Nearest, wxIMAGE_QUALITY_NEAREST)
+IMAGE_SCALE_BENCHMARKS(Bilinear, wxIMAGE_QUALITY_BILINEAR)
+IMAGE_SCALE_BENCHMARKS(Bicubic, wxIMAGE_QUALITY_BICUBIC)
+IMAGE_SCALE_BENCHMARKS(BoxAverage, wxIMAGE_QUALITY_BOX_AVERAGE)
+IMAGE_SCALE_BENCHMARKS(Normal, wxIMAGE_QUALITY_NORMAL)
+IMAGE_SCALE_BENCHMARKS(High, wxIMAGE_QUALITY_HIGH)
+
+BENCHMARK_FUNC_WITH_INIT(Rotate90, InitBigImage, nullptr)
+{
+    return GetBigTestImage().Rotate90().IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(Rotate180, InitBigImage, nullptr)
+{
+    return GetBigTestImage().Rotate180().IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(RotateAngle, InitBigImage, nullptr)
+{
+    const wxImage& image = GetBigTestImage();
+    const double angle = Bench::GetNumericParameter(30)*M_PI/180;
+    return image.Rotate(angle,
+                        wxPoint(image.GetWidth() / 2, image.GetHeight() / 2),
+                        true /* interpolating */).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(Blur, InitBigImage, nullptr)
+{
+    return GetBigTestImage().Blur(Bench::GetNumericParameter(5)).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(BlurHorizontal, InitBigImage, nullptr)
+{
+    return GetBigTestImage().BlurHorizontal(Bench::GetNumericParameter(5)).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(BlurVertical, InitBigImage, nullptr)
+{
+    return GetBigTestImage().BlurVertical(Bench::GetNumericParameter(5)).IsOk();
+}
+
+// The HSV functions modify the image in place, so they operate on a copy of
+// the test image which is made once only.
+static wxImage gs_hsvImage;
+
+static bool InitHSV()
+{
+    gs_hsvImage = GetBigTestImage().Copy();
+
+    return InitBigImage();
+}
+
+static void DoneHSV()
+{
+    gs_hsvImage = wxImage();
+}
+
+BENCHMARK_FUNC_WITH_INIT(RotateHue, InitHSV, DoneHSV)
+{
+    gs_hsvImage.RotateHue(0.1);
+    return gs_hsvImage.IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ChangeSaturation, InitHSV, DoneHSV)
+{
+    gs_hsvImage.ChangeSaturation(0.1);
+    return gs_hsvImage.IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ChangeBrightness, InitHSV, DoneHSV)
+{
+    gs_hsvImage.ChangeBrightness(0.1);
+    return gs_hsvImage.IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ChangeHSV, InitHSV, DoneHSV)
+{
+    gs_hsvImage.ChangeHSV(0.1, 0.1, 0.1);
+    return gs_hsvImage.IsOk();
+}
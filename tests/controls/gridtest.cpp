@@ -18,6 +18,7 @@
 
 #include "wx/grid.h"
 #include "wx/headerctrl.h"
+#include "wx/thread.h"
 #include "testableframe.h"
 #include "asserthelper.h"
 #include "wx/uiaction.h"
@@ -28,6 +29,8 @@
 
 #include "waitfor.h"
 
+#include <algorithm>
+
 // To disable tests which work locally, but not when run on GitHub CI.
 #if defined(__WXGTK__) && !defined(__WXGTK3__)
     #define wxSKIP_AUTOMATIC_TEST_IF_GTK2() \
@@ -1835,6 +1838,67 @@ TEST_CASE_METHOD(GridTestCase, "Grid::AutoSizeColumn", "[grid]")
     }
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::AutoSizeColumnFast", "[grid]")
+{
+    m_grid->AppendRows(200 - m_grid->GetNumberRows());
+    m_grid->SetColLabelValue(0, wxString());
+
+    for ( int row = 0; row < 100; row++ )
+        m_grid->SetCellValue(row, 0, wxString('W', row % 5 + 1));
+    m_grid->SetCellValue(199, 0, wxString('W', 30));
+
+    m_grid->AutoSizeColumn(0, false);
+    const int widthDefault = m_grid->GetColSize(0);
+
+    m_grid->SetColAutoSizeMode(wxGRID_AUTOSIZE_FAST);
+    CHECK( m_grid->GetColAutoSizeFlags() == wxGRID_AUTOSIZE_FAST );
+
+    m_grid->AutoSizeColumn(0, false);
+    const int widthFast = m_grid->GetColSize(0);
+
+    // The text may be measured slightly differently in the fast mode.
+    CHECK( widthFast == Approx(widthDefault).margin(widthDefault / 10) );
+
+    // But the result must always be the same.
+    m_grid->AutoSizeColumn(0, false);
+    CHECK( m_grid->GetColSize(0) == widthFast );
+
+    // Measuring only the longest text is enough here.
+    m_grid->SetColAutoSizeMode(wxGRID_AUTOSIZE_FAST, 1);
+    CHECK( m_grid->GetColAutoSizeMaxValues() == 1 );
+
+    m_grid->AutoSizeColumn(0, false);
+    CHECK( m_grid->GetColSize(0) == widthFast );
+
+    // The last row is not visible, so its value is not taken into account.
+    m_grid->SetColAutoSizeMode(wxGRID_AUTOSIZE_FAST |
+                               wxGRID_AUTOSIZE_VISIBLE_ROWS);
+    m_grid->AutoSizeColumn(0, false);
+    CHECK( m_grid->GetColSize(0) < widthFast );
+
+    m_grid->SetColAutoSizeMode(wxGRID_AUTOSIZE_VISIBLE_ROWS);
+    m_grid->AutoSizeColumn(0, false);
+    CHECK( m_grid->GetColSize(0) < widthDefault );
+
+    // The widths of the texts are cached between the calls, but the new
+    // values must still be taken into account.
+    m_grid->SetColAutoSizeMode(wxGRID_AUTOSIZE_FAST);
+    m_grid->AutoSizeColumn(0, false);
+    CHECK( m_grid->GetColSize(0) == widthFast );
+
+    m_grid->SetCellValue(199, 0, wxString('W', 40));
+    m_grid->AutoSizeColumn(0, false);
+    const int widthLonger = m_grid->GetColSize(0);
+    CHECK( widthLonger > widthFast );
+
+    // And the cached widths must not be used after changing the font.
+    wxGridCellAttr* const attr = new wxGridCellAttr;
+    attr->SetFont(m_grid->GetDefaultCellFont().Scaled(2));
+    m_grid->SetColAttr(0, attr);
+    m_grid->AutoSizeColumn(0, false);
+    CHECK( m_grid->GetColSize(0) > widthLonger );
+}
+
 TEST_CASE_METHOD(GridTestCase, "Grid::DrawInvalidCell", "[grid][multicell]")
 {
     // Set up a multicell with inside an overflowing cell.
@@ -2618,6 +2682,402 @@ TEST_CASE("GridBlockCoords::SymDifference", "[grid]")
     }
 }
 
+TEST_CASE("GridLineSizes", "[grid]")
+{
+    wxGridLineSizes sizes;
+    CHECK( sizes.IsEmpty() );
+
+    SECTION("Sparse")
+    {
+        // This must not allocate anything proportional to the number of lines.
+        sizes.Init(50000000, 20, wxArrayInt());
+        CHECK( sizes.SetSize(1000, 50) == 30 );
+        CHECK( sizes.SetSize(2000, 0) == -20 );
+
+        CHECK( sizes.GetSize(999) == 20 );
+        CHECK( sizes.GetSize(1000) == 50 );
+        CHECK( sizes.GetSize(2000) == 0 );
+        CHECK( sizes.GetEnd(999) == 20000 );
+        CHECK( sizes.GetEnd(1000) == 20050 );
+        CHECK( sizes.GetEnd(49999999) == 1000000010 );
+
+        CHECK( sizes.FindPosAt(0) == 0 );
+        CHECK( sizes.FindPosAt(20049) == 1000 );
+        CHECK( sizes.FindPosAt(20050) == 1001 );
+        CHECK( sizes.FindPosAt(40030) == 2001 );
+        CHECK( sizes.FindPosAt(1000000010) == 50000000 );
+
+        // Showing the line back restores its old size.
+        CHECK( sizes.SetSize(2000, -1) == 20 );
+        CHECK( sizes.GetEnd(49999999) == 1000000030 );
+
+        sizes.InsertLines(0, 10, 20, wxArrayInt());
+        CHECK( sizes.GetSize(1010) == 50 );
+        CHECK( sizes.FindPosAt(20249) == 1010 );
+
+        sizes.DeleteLines(0, 1001, wxArrayInt());
+        CHECK( sizes.GetSize(9) == 50 );
+        CHECK( sizes.GetEnd(9) == 230 );
+    }
+
+    SECTION("Dense")
+    {
+        sizes.Init(10, 10, wxArrayInt());
+        for ( int line = 0; line < 10; ++line )
+            sizes.SetSize(line, line + 1);
+
+        CHECK( sizes.GetEnd(9) == 55 );
+        CHECK( sizes.FindPosAt(5) == 2 );
+        CHECK( sizes.FindPosAt(6) == 3 );
+
+        sizes.SetSize(3, 0);
+        CHECK( sizes.GetEnd(3) == 6 );
+        CHECK( sizes.FindPosAt(6) == 4 );
+
+        wxGridSizesInfo info = sizes.GetSizesInfo(1);
+        CHECK( info.GetSize(0) == 1 );
+        CHECK( info.GetSize(3) == 0 );
+        CHECK( info.GetSize(9) == 10 );
+    }
+
+    SECTION("Reordered")
+    {
+        sizes.Init(3, 10, wxArrayInt());
+        sizes.SetSize(0, 30);
+
+        wxArrayInt order;
+        order.push_back(2);
+        order.push_back(0);
+        order.push_back(1);
+        sizes.SetLinesOrder(order);
+
+        CHECK( sizes.GetEnd(2) == 10 );
+        CHECK( sizes.GetEnd(0) == 40 );
+        CHECK( sizes.GetEnd(1) == 50 );
+        CHECK( sizes.FindPosAt(10) == 1 );
+        CHECK( sizes.FindPosAt(40) == 2 );
+
+        sizes.SetLinesOrder(wxArrayInt());
+        CHECK( sizes.GetEnd(0) == 30 );
+        CHECK( sizes.FindPosAt(10) == 0 );
+    }
+}
+
+TEST_CASE("GridColumnarTable", "[grid][table]")
+{
+    wxGridColumnarTable table;
+    table.AppendColumn(wxGridColumnarTable::Column_Number, "Id");
+    table.AppendColumn(wxGridColumnarTable::Column_Float);
+    table.AppendColumn(wxGridColumnarTable::Column_Bool);
+    table.AppendColumn(wxGridColumnarTable::Column_String);
+
+    CHECK( table.GetNumberCols() == 4 );
+    CHECK( table.GetColLabelValue(0) == "Id" );
+    CHECK( table.GetColLabelValue(1) == "B" );
+
+    CHECK( table.AppendRows(3) );
+    CHECK( table.GetNumberRows() == 3 );
+
+    const wxLongLong_t ids[] = { 1, wxLL(10000000000), -3 };
+    table.SetNumberValues(0, 0, ids, WXSIZEOF(ids));
+
+    const double values[] = { 0.5, 1.5 };
+    table.SetFloatValues(1, 1, values, WXSIZEOF(values));
+
+    const wxString strings[] = { "foo", "bar", "foo" };
+    table.SetStringValues(3, 0, strings, WXSIZEOF(strings));
+
+    table.SetValueAsBool(1, 2, true);
+
+    CHECK( table.GetTypeName(0, 0) == wxGRID_VALUE_NUMBER );
+    CHECK( table.GetTypeName(0, 1) == wxGRID_VALUE_FLOAT );
+    CHECK( table.GetTypeName(0, 2) == wxGRID_VALUE_BOOL );
+    CHECK( table.GetTypeName(0, 3) == wxGRID_VALUE_STRING );
+
+    CHECK( table.CanGetValueAs(0, 0, wxGRID_VALUE_NUMBER) );
+    CHECK( table.CanGetValueAs(0, 0, wxGRID_VALUE_STRING) );
+    CHECK( !table.CanGetValueAs(0, 0, wxGRID_VALUE_FLOAT) );
+
+    CHECK( table.GetValueAsLongLong(1, 0) == wxLL(10000000000) );
+    CHECK( table.GetValue(1, 0) == "10000000000" );
+
+    // Values not fitting into long can't be retrieved as numbers on the
+    // platforms where it is 32 bits.
+    table.SetValueAsLongLong(1, 0, wxLL(3000000000));
+    CHECK( table.GetValueAsLongLong(1, 0) == wxLL(3000000000) );
+    CHECK( table.GetValue(1, 0) == "3000000000" );
+    CHECK( table.CanGetValueAs(1, 0, wxGRID_VALUE_STRING) );
+    if ( sizeof(long) == 4 )
+    {
+        CHECK( !table.CanGetValueAs(1, 0, wxGRID_VALUE_NUMBER) );
+    }
+    else
+    {
+        CHECK( table.CanGetValueAs(1, 0, wxGRID_VALUE_NUMBER) );
+        CHECK( table.GetValueAsLongLong(1, 0) == table.GetValueAsLong(1, 0) );
+    }
+
+    table.SetValueAsLongLong(1, 0, -wxLL(3000000000));
+    CHECK( table.CanGetValueAs(1, 0, wxGRID_VALUE_NUMBER) == (sizeof(long) > 4) );
+
+    table.SetValueAsLongLong(1, 0, wxLL(2147483647));
+    CHECK( table.CanGetValueAs(1, 0, wxGRID_VALUE_NUMBER) );
+    CHECK( table.GetValueAsLong(1, 0) == 2147483647 );
+    CHECK( table.GetValueAsLong(2, 0) == -3 );
+    CHECK( table.GetValue(2, 0) == "-3" );
+    CHECK( table.GetValueAsDouble(0, 1) == 0. );
+    CHECK( table.GetValueAsDouble(2, 1) == 1.5 );
+    CHECK( !table.GetValueAsBool(0, 2) );
+    CHECK( table.GetValueAsBool(1, 2) );
+    CHECK( table.GetValue(1, 2) == "1" );
+    CHECK( table.GetValue(2, 3) == "foo" );
+
+    CHECK( table.IsEmptyCell(0, 2) );
+    CHECK( !table.IsEmptyCell(0, 3) );
+
+    table.SetValue(0, 0, "42");
+    CHECK( table.GetValueAsLong(0, 0) == 42 );
+
+    // Invalid values are ignored.
+    table.SetValue(0, 0, "bloordyblop");
+    CHECK( table.GetValueAsLong(0, 0) == 42 );
+
+    CHECK( table.InsertRows(1) );
+    CHECK( table.GetNumberRows() == 4 );
+    CHECK( table.GetValueAsLong(1, 0) == 0 );
+    CHECK( table.GetValue(1, 3) == "" );
+    CHECK( table.GetValue(2, 3) == "bar" );
+
+    CHECK( table.DeleteRows(0, 2) );
+    CHECK( table.GetNumberRows() == 2 );
+    CHECK( table.GetValue(0, 3) == "bar" );
+    CHECK( table.GetValueAsBool(0, 2) );
+
+    CHECK( table.AppendCols() );
+    CHECK( table.GetColumnType(4) == wxGridColumnarTable::Column_String );
+
+    CHECK( table.DeleteCols(0) );
+    CHECK( table.GetColumnType(0) == wxGridColumnarTable::Column_Float );
+
+    table.Clear();
+    CHECK( table.GetNumberRows() == 2 );
+    CHECK( table.IsEmptyCell(0, 2) );
+    CHECK( table.IsEmptyCell(0, 3) );
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE("GridAsyncTable", "[grid][table]")
+{
+    // Data source returning "row:col" values and remembering which blocks
+    // were fetched.
+    class TestDataSource : public wxGridAsyncDataSource
+    {
+    public:
+        int GetNumberRows() override { return 100; }
+        int GetNumberCols() override { return 2; }
+
+        bool FetchRows(int firstRow, int numRows, int numCols,
+                       wxVector<wxString>& values) override
+        {
+            for ( int row = firstRow; row < firstRow + numRows; ++row )
+            {
+                for ( int col = 0; col < numCols; ++col )
+                    values.push_back(wxString::Format("%d:%d", row, col));
+            }
+
+            wxCriticalSectionLocker lock(m_cs);
+            m_fetched.push_back(firstRow);
+
+            return true;
+        }
+
+        wxVector<int> GetFetched()
+        {
+            wxCriticalSectionLocker lock(m_cs);
+            return m_fetched;
+        }
+
+    private:
+        wxCriticalSection m_cs;
+        wxVector<int> m_fetched;
+    };
+
+    TestDataSource* const source = new TestDataSource;
+    wxGridAsyncTable table(source, 10);
+    table.SetPrefetchBlocks(1);
+
+    CHECK( table.GetNumberRows() == 100 );
+    CHECK( table.GetNumberCols() == 2 );
+
+    // The value is not available initially.
+    CHECK( table.GetValue(25, 1) == table.GetPlaceholder() );
+    CHECK( !table.IsRowAvailable(25) );
+
+    REQUIRE( WaitFor("block fetch", [&table]() {
+        return table.IsRowAvailable(25) &&
+                table.IsRowAvailable(15) &&
+                    table.IsRowAvailable(35);
+    }, 5000) );
+
+    CHECK( table.GetValue(25, 1) == "25:1" );
+    CHECK( table.GetValue(20, 0) == "20:0" );
+
+    // The block of the requested row is fetched first.
+    wxVector<int> fetched = source->GetFetched();
+    REQUIRE( fetched.size() == 3 );
+    CHECK( fetched[0] == 20 );
+    CHECK( !table.IsRowAvailable(5) );
+
+    // Discarding the cache makes the data unavailable again.
+    table.InvalidateCache();
+    CHECK( !table.IsRowAvailable(25) );
+
+    table.SetPlaceholder("?");
+    CHECK( table.GetValue(95, 0) == "?" );
+
+    REQUIRE( WaitFor("block refetch", [&table]() {
+        return table.IsRowAvailable(95) && table.IsRowAvailable(85);
+    }, 5000) );
+    CHECK( table.GetValue(99, 1) == "99:1" );
+
+    // There is no block after the last one.
+    fetched = source->GetFetched();
+    CHECK( fetched.size() == 5 );
+}
+
+TEST_CASE("GridAsyncTable::Retry", "[grid][table]")
+{
+    // Data source failing to fetch each block the first time and checking
+    // that its size is only queried from the main thread.
+    class FailingDataSource : public wxGridAsyncDataSource
+    {
+    public:
+        int GetNumberRows() override { CheckMainThread(); return 30; }
+        int GetNumberCols() override { CheckMainThread(); return 1; }
+
+        bool FetchRows(int firstRow, int numRows, int WXUNUSED(numCols),
+                       wxVector<wxString>& values) override
+        {
+            wxCriticalSectionLocker lock(m_cs);
+            m_attempts++;
+
+            if ( std::find(m_failed.begin(), m_failed.end(), firstRow)
+                    == m_failed.end() )
+            {
+                m_failed.push_back(firstRow);
+                return false;
+            }
+
+            for ( int row = firstRow; row < firstRow + numRows; ++row )
+                values.push_back(wxString::Format("%d", row));
+
+            return true;
+        }
+
+        int GetAttempts()
+        {
+            wxCriticalSectionLocker lock(m_cs);
+            return m_attempts;
+        }
+
+        bool WasCalledFromWorker()
+        {
+            wxCriticalSectionLocker lock(m_cs);
+            return m_calledFromWorker;
+        }
+
+    private:
+        void CheckMainThread()
+        {
+            if ( !wxThread::IsMain() )
+            {
+                wxCriticalSectionLocker lock(m_cs);
+                m_calledFromWorker = true;
+            }
+        }
+
+        wxCriticalSection m_cs;
+        wxVector<int> m_failed;
+        int m_attempts = 0;
+        bool m_calledFromWorker = false;
+    };
+
+    FailingDataSource* const source = new FailingDataSource;
+    wxGridAsyncTable table(source, 10);
+    table.SetPrefetchBlocks(0);
+
+    CHECK( table.GetValue(5, 0) == table.GetPlaceholder() );
+
+    // The block must be requested again when it's needed after the failure,
+    // even if it's still the same block as the last one.
+    REQUIRE( WaitFor("block retry", [&table]() {
+        table.GetValue(5, 0);
+        return table.IsRowAvailable(5);
+    }, 5000) );
+
+    CHECK( table.GetValue(5, 0) == "5" );
+    CHECK( source->GetAttempts() == 2 );
+    CHECK( !source->WasCalledFromWorker() );
+}
+
+#endif // wxUSE_THREADS
+
+TEST_CASE("GridCellAttrProvider::RowAttr", "[grid][attr]")
+{
+    wxGridCellAttrProvider provider;
+
+    // Return the row attribute, without keeping a reference to it.
+    const auto getRowAttr = [&provider](int row)
+    {
+        wxGridCellAttrPtr attr(provider.GetAttr(row, 0, wxGridCellAttr::Row));
+        return attr.get();
+    };
+
+    // Set the same attribute for a band of rows.
+    wxGridCellAttr* const band = new wxGridCellAttr;
+    for ( int row = 10; row < 20; ++row )
+    {
+        band->IncRef();
+        provider.SetRowAttr(band, row);
+    }
+    band->DecRef();
+
+    wxGridCellAttr* const other = new wxGridCellAttr;
+    provider.SetRowAttr(other, 15);
+
+    CHECK( getRowAttr(9) == nullptr );
+    CHECK( getRowAttr(10) == band );
+    CHECK( getRowAttr(14) == band );
+    CHECK( getRowAttr(15) == other );
+    CHECK( getRowAttr(16) == band );
+    CHECK( getRowAttr(19) == band );
+    CHECK( getRowAttr(20) == nullptr );
+
+    // Inserting rows in the middle of the band splits it.
+    provider.UpdateAttrRows(12, 3);
+    CHECK( getRowAttr(11) == band );
+    CHECK( getRowAttr(12) == nullptr );
+    CHECK( getRowAttr(14) == nullptr );
+    CHECK( getRowAttr(15) == band );
+    CHECK( getRowAttr(18) == other );
+    CHECK( getRowAttr(22) == band );
+    CHECK( getRowAttr(23) == nullptr );
+
+    // And deleting them joins it back.
+    provider.UpdateAttrRows(12, -3);
+    CHECK( getRowAttr(12) == band );
+    CHECK( getRowAttr(15) == other );
+
+    provider.SetRowAttr(nullptr, 15);
+    CHECK( getRowAttr(15) == nullptr );
+
+    provider.UpdateAttrRows(0, -10);
+    CHECK( getRowAttr(0) == band );
+    CHECK( getRowAttr(4) == band );
+    CHECK( getRowAttr(5) == nullptr );
+}
+
 //
 // TestableGrid
 //
@@ -23,6 +23,7 @@
 #endif // __WINDOWS__
 
 #include "asserthelper.h"
+#include "waitfor.h"
 
 // ----------------------------------------------------------------------------
 // tests
@@ -496,6 +497,108 @@ TEST_CASE("BitmapBundle::FromSVGFile", "[bmpbundle][svg][file]")
     CHECK( b.GetDefaultSize() == size );
 }
 
+TEST_CASE("BitmapBundle::SVGCache", "[bmpbundle][svg][cache]")
+{
+    static const char svg_data[] =
+        "<svg viewBox=\"0 0 100 100\">"
+        "<circle cx=\"50\" cy=\"50\" r=\"50\" fill=\"red\"/>"
+        "</svg>"
+        ;
+
+    const size_t limitOrig = wxBitmapBundle::GetSVGCacheLimit();
+    wxBitmapBundle::ClearSVGCache();
+
+    wxBitmapBundle b = wxBitmapBundle::FromSVG(svg_data, wxSize(16, 16));
+    REQUIRE( b.IsOk() );
+
+    CHECK( b.GetBitmap(wxSize(16, 16)).GetSize() == wxSize(16, 16) );
+    CHECK( b.GetBitmap(wxSize(32, 32)).GetSize() == wxSize(32, 32) );
+
+    wxBitmapBundleCacheStats stats = wxBitmapBundle::GetSVGCacheStats();
+    CHECK( stats.misses == 2 );
+    CHECK( stats.hits == 0 );
+    CHECK( stats.count == 2 );
+    CHECK( stats.bytes == (16*16 + 32*32)*4 );
+
+    // Both sizes are cached now.
+    CHECK( b.GetBitmap(wxSize(16, 16)).GetSize() == wxSize(16, 16) );
+    CHECK( b.GetBitmap(wxSize(32, 32)).GetSize() == wxSize(32, 32) );
+    CHECK( wxBitmapBundle::GetSVGCacheStats().hits == 2 );
+
+    // And another bundle created from the same data uses the same bitmaps.
+    wxBitmapBundle b2 = wxBitmapBundle::FromSVG(svg_data, wxSize(16, 16));
+    CHECK( b2.GetBitmap(wxSize(32, 32)).GetSize() == wxSize(32, 32) );
+    stats = wxBitmapBundle::GetSVGCacheStats();
+    CHECK( stats.hits == 3 );
+    CHECK( stats.misses == 2 );
+
+    // Reducing the limit evicts the least recently used bitmap.
+    wxBitmapBundle::SetSVGCacheLimit(32*32*4);
+    stats = wxBitmapBundle::GetSVGCacheStats();
+    CHECK( stats.count == 1 );
+    CHECK( stats.evictions == 1 );
+
+    CHECK( b.GetBitmap(wxSize(32, 32)).GetSize() == wxSize(32, 32) );
+    CHECK( wxBitmapBundle::GetSVGCacheStats().hits == 4 );
+
+    // Bitmaps bigger than the limit are not put in the global cache.
+    const wxBitmap bmp64 = b.GetBitmap(wxSize(64, 64));
+    CHECK( bmp64.GetSize() == wxSize(64, 64) );
+    stats = wxBitmapBundle::GetSVGCacheStats();
+    CHECK( stats.misses == 3 );
+    CHECK( stats.count == 1 );
+
+    // But the last one of them is still kept by the bundle itself.
+    CHECK( b.GetBitmap(wxSize(64, 64)).IsSameAs(bmp64) );
+    CHECK( wxBitmapBundle::GetSVGCacheStats().misses == 3 );
+
+    wxBitmapBundle::SetSVGCacheLimit(0);
+    CHECK( wxBitmapBundle::GetSVGCacheStats().count == 0 );
+
+    // Even when the global cache is disabled.
+    const wxBitmap bmp48 = b2.GetBitmap(wxSize(48, 48));
+    CHECK( b2.GetBitmap(wxSize(48, 48)).IsSameAs(bmp48) );
+    CHECK( wxBitmapBundle::GetSVGCacheStats().count == 0 );
+
+    wxBitmapBundle::SetSVGCacheLimit(limitOrig);
+    wxBitmapBundle::ClearSVGCache();
+}
+
+TEST_CASE("BitmapBundle::PrerasterizeSVG", "[bmpbundle][svg][cache]")
+{
+    wxVector<wxString> paths;
+    paths.push_back("horse.svg");
+    paths.push_back("horse.bmp");
+
+    const wxVector<wxBitmapBundle>
+        bundles = wxBitmapBundle::FromSVGFiles(paths, wxSize(20, 20));
+    REQUIRE( bundles.size() == 2 );
+    REQUIRE( bundles[0].IsOk() );
+    CHECK( bundles[0].GetDefaultSize() == wxSize(20, 20) );
+    CHECK( !bundles[1].IsOk() );
+
+    wxBitmapBundle::ClearSVGCache();
+
+    wxVector<wxSize> sizes;
+    sizes.push_back(wxSize(16, 16));
+    sizes.push_back(wxSize(32, 32));
+    wxBitmapBundle::PrerasterizeSVG(bundles, sizes);
+
+#if wxUSE_THREADS
+    REQUIRE( WaitFor("bitmaps to be rasterized", []() {
+        return wxBitmapBundle::GetSVGCacheStats().count == 2;
+    }, 5000) );
+
+    CHECK( bundles[0].GetBitmap(wxSize(32, 32)).GetSize() == wxSize(32, 32) );
+
+    const wxBitmapBundleCacheStats stats = wxBitmapBundle::GetSVGCacheStats();
+    CHECK( stats.hits == 1 );
+    CHECK( stats.misses == 0 );
+#endif // wxUSE_THREADS
+
+    wxBitmapBundle::ClearSVGCache();
+}
+
 // This can be used to test loading an arbitrary image file by setting the
 // environment variable WX_TEST_IMAGE_PATH to point to it.
 TEST_CASE("BitmapBundle::Load", "[.]")
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/graphics/dcbuffer.cpp
+// Purpose:     wxBufferedPaintDC unit tests
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#include "wx/app.h"
+#include "wx/dcbuffer.h"
+#include "wx/scrolwin.h"
+#include "wx/window.h"
+
+#include "waitfor.h"
+
+#include <memory>
+
+namespace
+{
+
+// Helper remembering the dirty region of the last wxEVT_PAINT received by the
+// window using wxBUFFER_PERSISTENT.
+class DirtyRegionRecorder
+{
+public:
+    explicit DirtyRegionRecorder(wxWindow* win)
+        : m_win(win),
+          m_painted(false)
+    {
+        m_win->Bind(wxEVT_PAINT, [this](wxPaintEvent&)
+        {
+            wxBufferedPaintDC dc(m_win, wxBUFFER_CLIENT_AREA |
+                                        wxBUFFER_PERSISTENT);
+            dc.SetBackground(*wxWHITE_BRUSH);
+            dc.Clear();
+
+            m_dirty = dc.GetDirtyRegion();
+            m_painted = true;
+        });
+    }
+
+    // Refresh the given rectangle, wait until the window is repainted and
+    // return the dirty region used for it.
+    wxRegion Repaint(const wxRect& rect = wxRect(0, 0, 1, 1))
+    {
+        m_painted = false;
+        m_dirty.Clear();
+
+        m_win->RefreshRect(rect);
+        m_win->Update();
+        WaitFor("repaint", [this]() { return m_painted; });
+
+        return m_dirty;
+    }
+
+private:
+    wxWindow* const m_win;
+    wxRegion m_dirty;
+    bool m_painted;
+};
+
+// Create a child window of the given size and wait until it is shown.
+template <typename T>
+std::unique_ptr<T> CreateTestWindow(const wxSize& size)
+{
+    wxWindow* const parent = wxTheApp->GetTopWindow();
+    parent->Raise();
+    parent->SetSize(wxSize(400, 400));
+
+    std::unique_ptr<T> win(new T(parent, wxID_ANY));
+    win->SetClientSize(size);
+
+    WaitForPaint waitForPaint(win.get());
+    win->Show();
+    waitForPaint.YieldUntilPainted();
+
+    return win;
+}
+
+size_t CountRects(const wxRegion& region)
+{
+    size_t count = 0;
+    for ( wxRegionIterator it(region); it; ++it )
+        count++;
+
+    return count;
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxBufferedPaintDC::Persistent::Resize", "[dc][dcbuffer]")
+{
+#ifdef __WXGTK__
+    // Under wxGTK we need to have two children (at least) because if there
+    // is one child its paint area is set to fill the whole parent frame.
+    std::unique_ptr<wxWindow> w0(new wxWindow(wxTheApp->GetTopWindow(), wxID_ANY));
+#endif // wxGTK
+
+    std::unique_ptr<wxWindow> win = CreateTestWindow<wxWindow>(wxSize(100, 100));
+    DirtyRegionRecorder recorder(win.get());
+
+    // Initially the entire window must be drawn.
+    wxRegion dirty = recorder.Repaint();
+    CHECK( dirty.Contains(wxRect(0, 0, 100, 100)) == wxInRegion );
+
+    // But after this only the refreshed part.
+    dirty = recorder.Repaint(wxRect(10, 20, 30, 40));
+    CHECK( dirty.Contains(wxRect(10, 20, 30, 40)) == wxInRegion );
+    CHECK( dirty.Contains(wxRect(50, 70, 50, 30)) == wxOutRegion );
+
+    // When the window grows, its new parts must be redrawn even if they are
+    // not refreshed explicitly.
+    win->SetClientSize(150, 120);
+    dirty = recorder.Repaint();
+    CHECK( dirty.Contains(wxRect(100, 0, 50, 120)) == wxInRegion );
+    CHECK( dirty.Contains(wxRect(0, 100, 150, 20)) == wxInRegion );
+
+    // And shrinking the window and growing it again must redraw the part
+    // which was not shown in the meanwhile.
+    win->SetClientSize(80, 120);
+    recorder.Repaint();
+    win->SetClientSize(150, 120);
+    dirty = recorder.Repaint();
+    CHECK( dirty.Contains(wxRect(80, 0, 70, 120)) == wxInRegion );
+}
+
+TEST_CASE("wxBufferedPaintDC::Persistent::Scroll", "[dc][dcbuffer]")
+{
+#ifdef __WXGTK__
+    std::unique_ptr<wxWindow> w0(new wxWindow(wxTheApp->GetTopWindow(), wxID_ANY));
+#endif // wxGTK
+
+    std::unique_ptr<wxScrolledCanvas>
+        win = CreateTestWindow<wxScrolledCanvas>(wxSize(100, 100));
+    win->SetScrollbars(1, 1, 1000, 1000);
+    win->SetClientSize(100, 100);
+
+    DirtyRegionRecorder recorder(win.get());
+    recorder.Repaint(wxRect(0, 0, 100, 100));
+
+    // The part of the window which became visible after scrolling must be
+    // redrawn.
+    win->Scroll(0, 30);
+    wxRegion dirty = recorder.Repaint();
+    CHECK( dirty.Contains(wxRect(0, 70, 100, 30)) == wxInRegion );
+
+    win->Scroll(20, 30);
+    dirty = recorder.Repaint();
+    CHECK( dirty.Contains(wxRect(80, 0, 20, 100)) == wxInRegion );
+
+    // Scrolling back must redraw the previously hidden part too.
+    win->Scroll(0, 0);
+    dirty = recorder.Repaint();
+    CHECK( dirty.Contains(wxRect(0, 0, 100, 30)) == wxInRegion );
+    CHECK( dirty.Contains(wxRect(0, 0, 20, 100)) == wxInRegion );
+}
+
+TEST_CASE("wxBufferedPaintDC::Persistent::Complex", "[dc][dcbuffer]")
+{
+#ifdef __WXGTK__
+    std::unique_ptr<wxWindow> w0(new wxWindow(wxTheApp->GetTopWindow(), wxID_ANY));
+#endif // wxGTK
+
+    std::unique_ptr<wxWindow> win = CreateTestWindow<wxWindow>(wxSize(200, 200));
+    DirtyRegionRecorder recorder(win.get());
+    recorder.Repaint(wxRect(0, 0, 200, 200));
+
+    // Refresh many disjoint rectangles: as the dirty region would be too
+    // complex, the entire bounding box of them must be redrawn.
+    for ( int n = 0; n < 30; n++ )
+        win->RefreshRect(wxRect(5*n, 5*n, 2, 2));
+
+    const wxRegion dirty = recorder.Repaint(wxRect(150, 150, 2, 2));
+    CHECK( CountRects(dirty) <= 16 );
+    CHECK( dirty.Contains(wxRect(0, 0, 152, 152)) == wxInRegion );
+}
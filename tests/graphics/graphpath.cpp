@@ -19,6 +19,10 @@
 #include "wx/dcmemory.h"
 #include "wx/dcgraph.h"
 
+#if wxUSE_CAIRO
+    #include "wx/private/graphics.h"
+#endif
+
 #include <memory>
 
 static void DoAllTests(wxGraphicsContext* gc);
@@ -74,6 +78,50 @@ TEST_CASE("GraphicsPathTestCaseCairo", "[path][cairo]")
     REQUIRE(gc);
     DoAllTests(gc.get());
 }
+
+TEST_CASE("GraphicsPathTestCaseCairo::Cache", "[path][cairo]")
+{
+    wxImage image(100, 100);
+    std::unique_ptr<wxGraphicsContext> gc(wxGraphicsRenderer::GetCairoRenderer()->CreateContextFromImage(image));
+    REQUIRE(gc);
+
+    gc->SetPen(*wxBLACK_PEN);
+    gc->SetBrush(*wxRED_BRUSH);
+
+    wxGraphicsPath path = gc->CreatePath();
+    path.AddRectangle(10, 10, 50, 50);
+
+    wxResetCairoCacheStats();
+
+    // Drawing the same path again reuses its native copy.
+    gc->FillPath(path);
+    gc->StrokePath(path);
+    gc->DrawPath(path);
+
+    wxCairoCacheStats stats = wxGetCairoCacheStats();
+    CHECK( stats.pathMisses == 1 );
+    CHECK( stats.pathHits == 3 );
+    CHECK( stats.patternMisses == 2 );
+    CHECK( stats.patternHits == 2 );
+
+    // But changing it invalidates the cached copy.
+    path.AddCircle(50, 50, 20);
+    gc->FillPath(path);
+
+    stats = wxGetCairoCacheStats();
+    CHECK( stats.pathMisses == 2 );
+    CHECK( stats.pathHits == 3 );
+
+    // Hatch patterns are shared by all brushes using the same style.
+    gc->SetBrush(wxBrush(*wxBLUE, wxBRUSHSTYLE_CROSSDIAG_HATCH));
+    gc->FillPath(path);
+    gc->SetBrush(wxBrush(*wxBLUE, wxBRUSHSTYLE_CROSSDIAG_HATCH));
+    gc->FillPath(path);
+
+    const wxCairoCacheStats statsHatch = wxGetCairoCacheStats();
+    CHECK( statsHatch.patternMisses - stats.patternMisses <= 1 );
+    CHECK( statsHatch.patternHits - stats.patternHits >= 1 );
+}
 #endif // wxUSE_CAIRO
 
 #define WX_CHECK_POINT(p1, p2, tolerance)      \
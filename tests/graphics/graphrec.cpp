@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/graphics/graphrec.cpp
+// Purpose:     wxGraphicsRecording unit tests
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#if wxUSE_GRAPHICS_CONTEXT
+
+#include "wx/bitmap.h"
+#include "wx/brush.h"
+#include "wx/graphrec.h"
+#include "wx/image.h"
+#include "wx/pen.h"
+#include "wx/region.h"
+
+#include <memory>
+
+namespace
+{
+
+const int IMAGE_SIZE = 100;
+
+// Draw something on the given context.
+void DrawSample(wxGraphicsContext* gc)
+{
+    gc->SetPen(wxPen(*wxBLUE, 3));
+    gc->SetBrush(*wxRED_BRUSH);
+    gc->DrawRectangle(5, 5, 20, 10);
+
+    gc->PushState();
+    gc->Translate(10, 40);
+    gc->Rotate(0.3);
+    gc->DrawEllipse(0, 0, 30, 15);
+    gc->PopState();
+
+    const wxPoint2DDouble points[] =
+    {
+        wxPoint2DDouble(60, 10),
+        wxPoint2DDouble(90, 30),
+        wxPoint2DDouble(70, 50),
+    };
+    gc->StrokeLines(WXSIZEOF(points), points);
+
+    wxGraphicsPath path = gc->CreatePath();
+    path.AddCircle(75, 80, 10);
+    gc->SetPen(wxNullPen);
+    gc->SetBrush(*wxGREEN_BRUSH);
+    gc->FillPath(path);
+}
+
+// Create a white image and draw on it using the given function.
+template <typename F>
+wxImage MakeImage(F draw)
+{
+    wxImage image(IMAGE_SIZE, IMAGE_SIZE);
+    image.SetRGB(wxRect(0, 0, IMAGE_SIZE, IMAGE_SIZE), 0xff, 0xff, 0xff);
+
+    {
+        std::unique_ptr<wxGraphicsContext> gc(wxGraphicsContext::Create(image));
+        REQUIRE( gc );
+        draw(gc.get());
+    }
+
+    return image;
+}
+
+bool AreImagesSame(const wxImage& image1, const wxImage& image2)
+{
+    return memcmp(image1.GetData(), image2.GetData(),
+                  3*IMAGE_SIZE*IMAGE_SIZE) == 0;
+}
+
+bool IsWhite(const wxImage& image, int x, int y)
+{
+    return image.GetRed(x, y) == 0xff &&
+            image.GetGreen(x, y) == 0xff &&
+                image.GetBlue(x, y) == 0xff;
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxGraphicsRecording::Basic", "[graphics][recording]")
+{
+    wxGraphicsRecording recording;
+    CHECK( recording.IsEmpty() );
+
+    {
+        std::unique_ptr<wxGraphicsContext> gc(recording.CreateContext());
+        REQUIRE( gc );
+        DrawSample(gc.get());
+    }
+
+    CHECK( recording.GetCommandCount() > 0 );
+    CHECK( recording.GetRenderer() == wxGraphicsRenderer::GetDefaultRenderer() );
+
+    // The bounding box must contain everything drawn.
+    const wxRect2DDouble box = recording.GetBoundingBox();
+    CHECK( box.Contains(wxRect2DDouble(5, 5, 20, 10)) );
+    CHECK( box.Contains(wxRect2DDouble(65, 70, 20, 20)) );
+    CHECK( box.GetRight() < IMAGE_SIZE );
+
+    const wxImage direct = MakeImage(DrawSample);
+    const wxImage replayed = MakeImage([&recording](wxGraphicsContext* gc)
+    {
+        recording.Replay(gc);
+    });
+
+    CHECK( AreImagesSame(direct, replayed) );
+
+    // A copy shares the same commands.
+    wxGraphicsRecording copy(recording);
+    copy.Clear();
+    CHECK( recording.IsEmpty() );
+}
+
+TEST_CASE("wxGraphicsRecording::Transform", "[graphics][recording]")
+{
+    wxGraphicsRecording recording;
+    {
+        std::unique_ptr<wxGraphicsContext> gc(recording.CreateContext());
+        REQUIRE( gc );
+        DrawSample(gc.get());
+    }
+
+    const wxImage direct = MakeImage([](wxGraphicsContext* gc)
+    {
+        gc->Translate(10, 5);
+        gc->Scale(0.5, 0.5);
+        DrawSample(gc);
+    });
+
+    const wxImage replayed = MakeImage([&recording](wxGraphicsContext* gc)
+    {
+        wxAffineMatrix2D transform;
+        transform.Translate(10, 5);
+        transform.Scale(0.5, 0.5);
+        recording.Replay(gc, transform);
+    });
+
+    CHECK( AreImagesSame(direct, replayed) );
+}
+
+TEST_CASE("wxGraphicsRecording::Region", "[graphics][recording]")
+{
+    wxGraphicsRecording recording;
+    {
+        std::unique_ptr<wxGraphicsContext> gc(recording.CreateContext());
+        REQUIRE( gc );
+
+        gc->SetPen(wxNullPen);
+        gc->SetBrush(*wxRED_BRUSH);
+        gc->DrawRectangle(10, 10, 20, 20);
+        gc->DrawRectangle(60, 60, 20, 20);
+    }
+
+    const wxImage image = MakeImage([&recording](wxGraphicsContext* gc)
+    {
+        recording.Replay(gc, wxRegion(0, 0, 50, 50));
+    });
+
+    CHECK( !IsWhite(image, 20, 20) );
+    CHECK( IsWhite(image, 70, 70) );
+
+    // The output is clipped to the region even for the commands partially
+    // inside it.
+    const wxImage clipped = MakeImage([&recording](wxGraphicsContext* gc)
+    {
+        recording.Replay(gc, wxRegion(0, 0, 20, 20));
+    });
+
+    CHECK( !IsWhite(clipped, 15, 15) );
+    CHECK( IsWhite(clipped, 25, 25) );
+
+    // Check that the commands outside of the region are really skipped and
+    // not just clipped out by replaying into another recording.
+    const auto countReplayed = [&recording](const wxRegion& region)
+    {
+        wxGraphicsRecording replayed;
+        {
+            std::unique_ptr<wxGraphicsContext> gc(replayed.CreateContext());
+            REQUIRE( gc );
+            recording.Replay(gc.get(), region);
+        }
+
+        return replayed.GetCommandCount();
+    };
+
+    CHECK( countReplayed(wxRegion(0, 0, 50, 50)) ==
+            countReplayed(wxRegion(0, 0, 100, 100)) - 1 );
+}
+
+TEST_CASE("wxGraphicsRecording::RegionWideCaps", "[graphics][recording]")
+{
+    // The corners of the projecting caps of a diagonal line extend further
+    // than half of the pen width from its ends and must not be culled.
+    wxGraphicsRecording recording;
+    {
+        std::unique_ptr<wxGraphicsContext> gc(recording.CreateContext());
+        REQUIRE( gc );
+
+        gc->SetPen(gc->CreatePen(wxGraphicsPenInfo(*wxRED, 20)
+                                    .Cap(wxCAP_PROJECTING)));
+        gc->StrokeLine(50, 50, 70, 70);
+    }
+
+    const wxImage image = MakeImage([&recording](wxGraphicsContext* gc)
+    {
+        recording.Replay(gc, wxRegion(35, 45, 3, 10));
+    });
+
+    CHECK( !IsWhite(image, 37, 50) );
+}
+
+TEST_CASE("wxGraphicsRecording::ResetClip", "[graphics][recording]")
+{
+    wxGraphicsRecording recording;
+    {
+        std::unique_ptr<wxGraphicsContext> gc(recording.CreateContext());
+        REQUIRE( gc );
+
+        gc->SetPen(wxNullPen);
+        gc->SetBrush(*wxRED_BRUSH);
+        gc->Clip(0, 0, 20, 20);
+        gc->ResetClip();
+        gc->DrawRectangle(10, 10, 80, 80);
+    }
+
+    // Resetting clipping in the recording must not reset the clipping region
+    // of the context on which it is replayed.
+    const wxImage image = MakeImage([&recording](wxGraphicsContext* gc)
+    {
+        gc->Clip(0, 0, 50, 50);
+        recording.Replay(gc);
+    });
+
+    CHECK( !IsWhite(image, 15, 15) );
+    CHECK( !IsWhite(image, 40, 40) );
+    CHECK( IsWhite(image, 60, 60) );
+}
+
+TEST_CASE("wxGraphicsTiledImageRenderer", "[graphics][recording]")
+{
+    wxGraphicsTiledImageRenderer renderer(wxSize(IMAGE_SIZE, IMAGE_SIZE));
+    renderer.SetTileSize(wxSize(30, 40));
+
+    const wxImage direct = MakeImage(DrawSample);
+
+    SECTION("Image")
+    {
+        const wxImage tiled = renderer.RenderImage(DrawSample);
+        REQUIRE( tiled.GetSize() == direct.GetSize() );
+        CHECK( AreImagesSame(direct, tiled) );
+    }
+
+    SECTION("SingleThread")
+    {
+        renderer.SetMaxThreads(1);
+
+        const wxImage tiled = renderer.RenderImage(DrawSample);
+        REQUIRE( tiled.GetSize() == direct.GetSize() );
+        CHECK( AreImagesSame(direct, tiled) );
+    }
+
+    SECTION("Bitmap")
+    {
+        // Objects not created by the context can be used too, as they're
+        // copied by the renderer for each thread.
+        wxImage image(20, 20);
+        image.SetRGB(wxRect(0, 0, 20, 20), 0, 0xff, 0);
+        const wxBitmap bitmap(image);
+        const wxRegion region(wxRect(0, 0, 70, 70));
+
+        const auto draw = [&bitmap, &region](wxGraphicsContext* gc)
+        {
+            gc->Clip(region);
+            for ( int n = 0; n < 5; n++ )
+                gc->DrawBitmap(bitmap, 15*n, 15*n, 20, 20);
+        };
+
+        const wxImage directBitmap = MakeImage(draw);
+        const wxImage tiled = renderer.RenderImage(draw);
+        REQUIRE( tiled.GetSize() == directBitmap.GetSize() );
+        CHECK( AreImagesSame(directBitmap, tiled) );
+        CHECK( !IsWhite(tiled, 50, 50) );
+        CHECK( IsWhite(tiled, 65, 75) );
+    }
+
+    SECTION("Tiles")
+    {
+        wxVector<wxRect> rects;
+        CHECK( renderer.Render(DrawSample,
+                    [&rects](const wxRect& rect, const wxImage& tile)
+                    {
+                        CHECK( tile.GetSize() == rect.GetSize() );
+                        rects.push_back(rect);
+                        return true;
+                    }) );
+
+        // 4 columns and 3 rows, with the last ones being partial.
+        REQUIRE( rects.size() == 12 );
+        CHECK( rects[0] == wxRect(0, 0, 30, 40) );
+        CHECK( rects[3] == wxRect(90, 0, 10, 40) );
+        CHECK( rects[4] == wxRect(0, 40, 30, 40) );
+        CHECK( rects[11] == wxRect(90, 80, 10, 20) );
+    }
+
+    SECTION("Cancel")
+    {
+        int count = 0;
+        CHECK( !renderer.Render(DrawSample,
+                    [&count](const wxRect&, const wxImage&)
+                    {
+                        return ++count < 5;
+                    }) );
+        CHECK( count == 5 );
+    }
+}
+
+#endif // wxUSE_GRAPHICS_CONTEXT
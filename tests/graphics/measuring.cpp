@@ -31,8 +31,12 @@
 #include "wx/dcps.h"
 #include "wx/metafile.h"
 
+#include "wx/private/glyphcache.h"
+
 #include "asserthelper.h"
 
+#include <memory>
+
 // ----------------------------------------------------------------------------
 // helper for XXXTextExtent() methods
 // ----------------------------------------------------------------------------
@@ -167,6 +171,92 @@ TEST_CASE("wxDC::GetPartialTextExtent", "[dc][text-extent][partial]")
     CHECK( widths[4] == dc.GetTextExtent("Hello").x );
 }
 
+TEST_CASE("wxDC::GetMultipleTextExtents", "[dc][text-extent]")
+{
+    wxClientDC dc(wxTheApp->GetTopWindow());
+
+    wxArrayString strings;
+    strings.push_back("Hello");
+    strings.push_back("");
+    strings.push_back("Hello, world!");
+    strings.push_back(wxString::FromUTF8("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82"));
+
+    wxVector<wxSize> extents;
+    dc.GetMultipleTextExtents(strings, extents);
+    REQUIRE( extents.size() == strings.size() );
+
+    for ( size_t n = 0; n < strings.size(); n++ )
+    {
+        INFO( "String #" << n << " \"" << strings[n] << "\"" );
+        CHECK( extents[n] == dc.GetTextExtent(strings[n]) );
+    }
+
+    CHECK( extents[1] == wxSize() );
+
+    // Check that using a different font works too.
+    wxFont font = dc.GetFont();
+    font.SetFractionalPointSize(3*font.GetFractionalPointSize());
+    dc.GetMultipleTextExtents(strings, extents, &font);
+    REQUIRE( extents.size() == strings.size() );
+
+    wxCoord w, h;
+    dc.GetTextExtent(strings[0], &w, &h, nullptr, nullptr, &font);
+    CHECK( extents[0] == wxSize(w, h) );
+    CHECK( extents[0].x > dc.GetTextExtent(strings[0]).x );
+
+    // And that the font was not changed.
+    CHECK( dc.GetFont() != font );
+
+    dc.GetMultipleTextExtents(wxArrayString(), extents);
+    CHECK( extents.empty() );
+}
+
+TEST_CASE("wxGlyphAdvanceCache", "[text-extent][partial]")
+{
+    wxGlyphAdvanceCache cache;
+
+    const wxString text = wxString::FromUTF8("ab\xd0\x96\xf0\x9f\x98\x80");
+
+    wxVector<double> advances;
+    CHECK( cache.Lookup("font", text, advances) == text.length() );
+    REQUIRE( advances.size() == text.length() );
+
+    // Store only some of the widths.
+    for ( size_t n = 0; n < advances.size(); n++ )
+        advances[n] = n % 2 ? -1. : n + 1.;
+    cache.Store("font", text, advances);
+    CHECK( cache.GetFontCount() == 1 );
+
+    CHECK( cache.Lookup("font", text, advances) == text.length() / 2 );
+    CHECK( advances[0] == 1 );
+    CHECK( advances[1] == -1 );
+    CHECK( advances[2] == 3 );
+
+    // The widths are stored per character and not per string.
+    CHECK( cache.Lookup("font", "aa", advances) == 0 );
+    CHECK( advances[1] == 1 );
+
+    // Different fonts don't share the widths.
+    CHECK( cache.Lookup("bold font", text, advances) == text.length() );
+
+    // Only a limited number of fonts is kept, the least recently used ones
+    // are forgotten.
+    for ( int n = 0; n < 100; n++ )
+    {
+        cache.Lookup("font", text, advances);
+        cache.Store(wxString::Format("font %d", n), "x", wxVector<double>(1, n));
+    }
+
+    CHECK( cache.GetFontCount() < 100 );
+    CHECK( cache.Lookup("font 0", "x", advances) == 1 );
+    CHECK( cache.Lookup("font 99", "x", advances) == 0 );
+    CHECK( advances[0] == 99 );
+    CHECK( cache.Lookup("font", text, advances) == text.length() / 2 );
+
+    cache.Clear();
+    CHECK( cache.GetFontCount() == 0 );
+}
+
 #ifdef TEST_GC
 
 TEST_CASE("wxGC::GetTextExtent", "[dc][text-extent]")
@@ -187,4 +277,32 @@ TEST_CASE("wxGC::GetTextExtent", "[dc][text-extent]")
     CHECK(height > 0.0);
 }
 
+TEST_CASE("wxGC::GetMultipleTextExtents", "[dc][text-extent]")
+{
+    wxGraphicsRenderer* renderer = wxGraphicsRenderer::GetDefaultRenderer();
+    REQUIRE(renderer);
+    std::unique_ptr<wxGraphicsContext> context(renderer->CreateMeasuringContext());
+    REQUIRE(context);
+    context->SetFont(*wxNORMAL_FONT, *wxBLACK);
+
+    wxArrayString strings;
+    strings.push_back("x");
+    strings.push_back("Hello, world!");
+
+    wxArrayDouble widths, heights;
+    context->GetMultipleTextExtents(strings, widths, heights);
+    REQUIRE( widths.size() == strings.size() );
+    REQUIRE( heights.size() == strings.size() );
+
+    for ( size_t n = 0; n < strings.size(); n++ )
+    {
+        double width, height;
+        context->GetTextExtent(strings[n], &width, &height, nullptr, nullptr);
+        CHECK( widths[n] == width );
+        CHECK( heights[n] == height );
+    }
+
+    CHECK( widths[1] > widths[0] );
+}
+
 #endif // TEST_GC
@@ -0,0 +1,296 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/graphics/psdc.cpp
+// Purpose:     wxPostScriptDC unit tests
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#if wxUSE_PRINTING_ARCHITECTURE && wxUSE_POSTSCRIPT
+
+#include "wx/bitmap.h"
+#include "wx/cmndata.h"
+#include "wx/dcps.h"
+#include "wx/ffile.h"
+#include "wx/image.h"
+
+#if wxUSE_ZLIB && wxUSE_STREAMS
+    #include "wx/mstream.h"
+    #include "wx/zstream.h"
+#endif
+
+#include "wx/generic/private/dcpsg.h"
+#include "wx/private/localeset.h"
+
+#include "testfile.h"
+
+#include <functional>
+
+namespace
+{
+
+std::string FormatPS(double value)
+{
+    char buf[32];
+    return std::string(buf, wxFormatPSNumber(value, buf));
+}
+
+// Generate a PostScript file using the given function for drawing on its only
+// page and return its contents, without the creation date line which changes
+// every time.
+wxString
+GeneratePS(const std::function<void (wxDC&)>& draw, bool compress = false)
+{
+    TempFile ps(wxFileName::CreateTempFileName("wxpstest"));
+
+    wxPrintData printData;
+    printData.SetPrintMode(wxPRINT_MODE_FILE);
+    printData.SetFilename(ps.GetName());
+
+    {
+        wxPostScriptDC dc(printData);
+        REQUIRE( dc.IsOk() );
+
+        if ( compress )
+            dc.EnableImageCompression();
+
+        REQUIRE( dc.StartDoc("test") );
+        dc.StartPage();
+        draw(dc);
+        dc.EndPage();
+        dc.EndDoc();
+    }
+
+    wxString contents;
+    wxFFile file(ps.GetName());
+    REQUIRE( file.ReadAll(&contents, wxConvISO8859_1) );
+
+    const size_t start = contents.find("%%CreationDate:");
+    if ( start != wxString::npos )
+        contents.erase(start, contents.find('\n', start) + 1 - start);
+
+    return contents;
+}
+
+void DrawSample(wxDC& dc)
+{
+    dc.SetUserScale(0.5, 0.25);
+    dc.SetPen(wxPen(*wxRED, 3));
+    dc.SetBrush(*wxBLUE_BRUSH);
+    dc.DrawLine(1, 3, 17, 31);
+    dc.DrawRectangle(5, 7, 11, 13);
+    dc.DrawEllipse(20, 30, 15, 9);
+}
+
+bool HasCommaDecimalSeparator(const wxString& s)
+{
+    for ( size_t n = 1; n + 1 < s.length(); n++ )
+    {
+        if ( s[n] == ',' && wxIsdigit(s[n - 1]) && wxIsdigit(s[n + 1]) )
+            return true;
+    }
+
+    return false;
+}
+
+#if wxUSE_ZLIB && wxUSE_STREAMS
+
+// Decode the ASCII85 data starting at the given position and terminated by
+// "~>".
+wxMemoryBuffer DecodeASCII85(const wxString& s, size_t pos)
+{
+    wxMemoryBuffer decoded;
+
+    wxUint64 tuple = 0;
+    int count = 0;
+    for ( ; pos < s.length(); pos++ )
+    {
+        const wxUniChar ch = s[pos];
+        if ( ch == '~' )
+            break;
+
+        if ( wxIsspace(ch) )
+            continue;
+
+        if ( ch == 'z' && count == 0 )
+        {
+            const char zeros[4] = { 0 };
+            decoded.AppendData(zeros, sizeof(zeros));
+            continue;
+        }
+
+        REQUIRE( ch >= '!' );
+        REQUIRE( ch <= 'u' );
+
+        tuple = tuple*85 + (ch.GetValue() - '!');
+        if ( ++count == 5 )
+        {
+            for ( int i = 3; i >= 0; i-- )
+                decoded.AppendByte(static_cast<char>((tuple >> (8*i)) & 0xff));
+
+            tuple = 0;
+            count = 0;
+        }
+    }
+
+    REQUIRE( s.compare(pos, 2, "~>") == 0 );
+
+    // The last partial group of N+1 characters encodes N bytes.
+    if ( count )
+    {
+        for ( int i = count; i < 5; i++ )
+            tuple = tuple*85 + 84;
+
+        for ( int i = 0; i < count - 1; i++ )
+            decoded.AppendByte(static_cast<char>((tuple >> (24 - 8*i)) & 0xff));
+    }
+
+    return decoded;
+}
+
+#endif // wxUSE_ZLIB && wxUSE_STREAMS
+
+} // anonymous namespace
+
+TEST_CASE("wxPostScriptDC::FormatNumber", "[psdc]")
+{
+    CHECK( FormatPS(0) == "0" );
+    CHECK( FormatPS(1) == "1" );
+    CHECK( FormatPS(-17) == "-17" );
+    CHECK( FormatPS(1.5) == "1.5" );
+    CHECK( FormatPS(-0.25) == "-0.25" );
+    CHECK( FormatPS(0.125) == "0.125" );
+    CHECK( FormatPS(3.14159) == "3.142" );
+    CHECK( FormatPS(2.9996) == "3" );
+    CHECK( FormatPS(1234567.5) == "1234567.5" );
+
+    // Values rounding to 0 must not be output as "-0".
+    CHECK( FormatPS(-0.0001) == "0" );
+
+    // Huge values are still formatted correctly.
+    CHECK( FormatPS(1e20) == "100000000000000000000.000" );
+
+    // And the result doesn't depend on the locale.
+    wxLocaleSetter setLocale("fr_FR.UTF-8");
+    if ( wxString::Format("%.1f", 1.5) != "1,5" )
+    {
+        WARN("Skipping test requiring French locale.");
+        return;
+    }
+
+    CHECK( FormatPS(1.5) == "1.5" );
+    CHECK( FormatPS(1e20) == "100000000000000000000.000" );
+}
+
+TEST_CASE("wxPostScriptDC::Output", "[psdc]")
+{
+    const wxString ps = GeneratePS(DrawSample);
+
+    CHECK( ps.StartsWith("%!PS-Adobe") );
+    CHECK( ps.Contains("%%EndProlog\n") );
+    CHECK( ps.EndsWith("showpage\n") );
+
+    // The compact operators must be defined in the prolog and used.
+    CHECK( ps.Contains("/m { moveto } bind def\n") );
+    CHECK( ps.Contains("/rg { setrgbcolor } bind def\n") );
+    CHECK( ps.Contains("/ln {") );
+    CHECK( ps.Contains("/re {") );
+    CHECK( ps.Contains(" ln\n") );
+    CHECK( ps.Contains(" re f\n") );
+    CHECK( ps.Contains(" rg\n") );
+    CHECK( ps.Contains(" w\n") );
+
+    // No need for the compressed images support by default.
+    CHECK( !ps.Contains("flateimage") );
+    CHECK( !ps.Contains("%%LanguageLevel: 3") );
+
+    CHECK( !HasCommaDecimalSeparator(ps) );
+
+    // The output must be exactly the same when using a locale with comma as
+    // decimal separator.
+    wxLocaleSetter setLocale("fr_FR.UTF-8");
+    if ( wxString::Format("%.1f", 1.5) != "1,5" )
+    {
+        WARN("Skipping test requiring French locale.");
+        return;
+    }
+
+    const wxString psFrench = GeneratePS(DrawSample);
+    CHECK( !HasCommaDecimalSeparator(psFrench) );
+    CHECK( psFrench == ps );
+}
+
+TEST_CASE("wxPostScriptDC::Buffering", "[psdc]")
+{
+    // Generate output much bigger than the internal buffer to check that it
+    // is flushed correctly.
+    const int NUM_LINES = 20000;
+
+    const wxString ps = GeneratePS([](wxDC& dc)
+    {
+        for ( int n = 0; n < NUM_LINES; n++ )
+            dc.DrawLine(n % 100, n / 100, n % 100 + 10, n / 100 + 20);
+    });
+
+    size_t count = 0;
+    for ( size_t pos = ps.find(" ln\n"); pos != wxString::npos;
+          pos = ps.find(" ln\n", pos + 1) )
+    {
+        count++;
+    }
+
+    CHECK( count == NUM_LINES );
+    CHECK( ps.EndsWith("showpage\n") );
+}
+
+#if wxUSE_ZLIB && wxUSE_STREAMS
+
+TEST_CASE("wxPostScriptDC::CompressedImage", "[psdc][image]")
+{
+    // Use an image with different pixels and the size of data which is not a
+    // multiple of 4.
+    wxImage image(13, 7);
+    for ( int y = 0; y < image.GetHeight(); y++ )
+    {
+        for ( int x = 0; x < image.GetWidth(); x++ )
+        {
+            if ( y == 0 )
+                image.SetRGB(x, y, 0, 0, 0);
+            else
+                image.SetRGB(x, y, 17*x, 31*y, (x*y) % 256);
+        }
+    }
+
+    const wxString ps = GeneratePS([&image](wxDC& dc)
+    {
+        dc.DrawBitmap(wxBitmap(image), 10, 20);
+    }, true /* compress */);
+
+    CHECK( ps.Contains("%%LanguageLevel: 3\n") );
+    CHECK( ps.Contains("/flateimage {") );
+
+    const size_t pos = ps.find("\nflateimage\n");
+    REQUIRE( pos != wxString::npos );
+
+    const wxMemoryBuffer compressed = DecodeASCII85(ps, pos + strlen("\nflateimage\n"));
+
+    wxMemoryInputStream memStream(compressed.GetData(), compressed.GetDataLen());
+    wxZlibInputStream zlibStream(memStream, wxZLIB_ZLIB);
+
+    const size_t dataLen = 3*image.GetWidth()*image.GetHeight();
+    wxMemoryBuffer decoded(dataLen);
+    zlibStream.Read(decoded.GetWriteBuf(dataLen), dataLen);
+    REQUIRE( zlibStream.LastRead() == dataLen );
+
+    CHECK( memcmp(decoded.GetData(), image.GetData(), dataLen) == 0 );
+}
+
+#endif // wxUSE_ZLIB && wxUSE_STREAMS
+
+#endif // wxUSE_PRINTING_ARCHITECTURE && wxUSE_POSTSCRIPT
@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/graphics/svgdc.cpp
+// Purpose:     wxSVGFileDC unit tests
+// Author:      wxWidgets team
+// Created:     2026-10-16
+// Copyright:   (c) 2026 wxWidgets team
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#if wxUSE_SVG
+
+#include "wx/dcsvg.h"
+#include "wx/ffile.h"
+#include "wx/image.h"
+#include "wx/sstream.h"
+#include "wx/wfstream.h"
+
+#if wxUSE_ZLIB
+    #include "wx/zstream.h"
+#endif
+
+#include "wx/private/localeset.h"
+
+#include "testfile.h"
+
+namespace
+{
+
+// Return the contents of the given SVG file.
+wxString ReadSVG(const wxString& filename)
+{
+    wxString contents;
+    wxFFile file(filename);
+    REQUIRE( file.ReadAll(&contents, wxConvUTF8) );
+    return contents;
+}
+
+// Count the number of occurrences of the given substring.
+size_t CountOf(const wxString& str, const wxString& sub)
+{
+    size_t count = 0;
+    for ( size_t pos = str.find(sub); pos != wxString::npos;
+          pos = str.find(sub, pos + sub.length()) )
+    {
+        count++;
+    }
+
+    return count;
+}
+
+// Bitmap handler remembering the positions it was called with.
+class TestBitmapHandler : public wxSVGBitmapHandler
+{
+public:
+    explicit TestBitmapHandler(wxVector<wxPoint>& positions)
+        : m_positions(positions)
+    {
+    }
+
+    virtual bool ProcessBitmap(const wxBitmap& WXUNUSED(bitmap),
+                               wxCoord x, wxCoord y,
+                               wxOutputStream& stream) const override
+    {
+        m_positions.push_back(wxPoint(x, y));
+
+        const char* const s = "<image/>\n";
+        stream.Write(s, strlen(s));
+        return stream.IsOk();
+    }
+
+private:
+    wxVector<wxPoint>& m_positions;
+};
+
+wxBitmap MakeBitmap(const wxColour& colour)
+{
+    wxImage image(4, 4);
+    image.SetRGB(wxRect(0, 0, 4, 4),
+                 colour.Red(), colour.Green(), colour.Blue());
+    return wxBitmap(image);
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxSVGFileDC::Numbers", "[svg][dc]")
+{
+    TempFile svg("numbers.svg");
+
+    const auto drawAndRead = [&svg]()
+    {
+        {
+            wxSVGFileDC dc(svg.GetName());
+            dc.DrawEllipse(10, 20, 5, 7);
+            dc.DrawEllipse(-10, -20, 3, 1);
+        }
+
+        return ReadSVG(svg.GetName());
+    };
+
+    const wxString
+        expected1 = "<ellipse cx=\"12.50\" cy=\"23.50\" rx=\"2.50\" ry=\"3.50\"/>",
+        expected2 = "<ellipse cx=\"-8.50\" cy=\"-19.50\" rx=\"1.50\" ry=\"0.50\"/>";
+
+    wxString contents = drawAndRead();
+    CHECK( contents.Contains(expected1) );
+    CHECK( contents.Contains(expected2) );
+
+    // The output must not depend on the current locale, even if it uses
+    // comma as decimal separator.
+    wxLocaleSetter setLocale("fr_FR.UTF-8");
+    if ( wxString::Format("%.1f", 1.5) != "1,5" )
+    {
+        WARN("Skipping test requiring French locale.");
+        return;
+    }
+
+    contents = drawAndRead();
+    CHECK( contents.Contains(expected1) );
+    CHECK( contents.Contains(expected2) );
+}
+
+#if wxUSE_ZLIB
+
+TEST_CASE("wxSVGFileDC::Compressed", "[svg][dc]")
+{
+    TempFile svgz("compressed.svgz");
+    {
+        wxSVGFileDC dc(svgz.GetName());
+        dc.DrawEllipse(10, 20, 5, 7);
+    }
+
+    wxFileInputStream fileStream(svgz.GetName());
+    REQUIRE( fileStream.IsOk() );
+
+    // The file must be in gzip format and not just zlib one.
+    char magic[2] = { 0 };
+    fileStream.Read(magic, sizeof(magic));
+    CHECK( static_cast<unsigned char>(magic[0]) == 0x1f );
+    CHECK( static_cast<unsigned char>(magic[1]) == 0x8b );
+    fileStream.SeekI(0);
+
+    wxZlibInputStream zlibStream(fileStream, wxZLIB_GZIP);
+    wxString contents;
+    wxStringOutputStream stringStream(&contents, wxConvUTF8);
+    zlibStream.Read(stringStream);
+
+    CHECK( contents.StartsWith("<?xml") );
+    CHECK( contents.Contains("<ellipse cx=\"12.50\"") );
+    CHECK( contents.Contains("</svg>") );
+}
+
+#endif // wxUSE_ZLIB
+
+TEST_CASE("wxSVGFileDC::Bitmaps", "[svg][dc]")
+{
+    TempFile svg("bitmaps.svg");
+
+    const wxBitmap red = MakeBitmap(*wxRED);
+    const wxBitmap blue = MakeBitmap(*wxBLUE);
+
+    wxVector<wxPoint> positions;
+
+    SECTION("Default")
+    {
+        {
+            wxSVGFileDC dc(svg.GetName());
+            dc.SetBitmapHandler(new TestBitmapHandler(positions));
+            dc.DrawBitmap(red, 10, 20);
+            dc.DrawBitmap(red, 30, 40);
+            dc.DrawBitmap(blue, 50, 60);
+        }
+
+        // By default the handler is called for each bitmap at its position.
+        REQUIRE( positions.size() == 3 );
+        CHECK( positions[0] == wxPoint(10, 20) );
+        CHECK( positions[1] == wxPoint(30, 40) );
+        CHECK( positions[2] == wxPoint(50, 60) );
+
+        const wxString contents = ReadSVG(svg.GetName());
+        CHECK( CountOf(contents, "<image/>") == 3 );
+        CHECK( !contents.Contains("<use") );
+    }
+
+    SECTION("Shared")
+    {
+        {
+            wxSVGFileDC dc(svg.GetName());
+            dc.SetBitmapHandler(new TestBitmapHandler(positions));
+            dc.EnableBitmapSharing();
+            dc.DrawBitmap(red, 10, 20);
+            dc.DrawBitmap(blue, 50, 60);
+
+            // A different bitmap with the same contents is shared too.
+            dc.DrawBitmap(MakeBitmap(*wxRED), 30, 40);
+        }
+
+        // Only the distinct bitmaps are passed to the handler.
+        REQUIRE( positions.size() == 2 );
+        CHECK( positions[0] == wxPoint(0, 0) );
+        CHECK( positions[1] == wxPoint(0, 0) );
+
+        const wxString contents = ReadSVG(svg.GetName());
+        CHECK( CountOf(contents, "<image/>") == 2 );
+        CHECK( contents.Contains("<use xlink:href=\"#bitmap0\" x=\"10\" y=\"20\"/>") );
+        CHECK( contents.Contains("<use xlink:href=\"#bitmap1\" x=\"50\" y=\"60\"/>") );
+        CHECK( contents.Contains("<use xlink:href=\"#bitmap0\" x=\"30\" y=\"40\"/>") );
+    }
+}
+
+#endif // wxUSE_SVG
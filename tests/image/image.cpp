@@ -31,6 +31,9 @@
 #include "wx/wfstream.h"
 #include "wx/clipbrd.h"
 #include "wx/dataobj.h"
+#include "wx/imagebatch.h"
+#include "wx/scopeguard.h"
+#include "wx/thread.h"
 
 // Check if we can use wxDIB::ConvertToBitmap(), which only exists for MSW and
 // which assumes the target is little-endian (matching the file format)
@@ -41,7 +44,9 @@
 #endif
 
 #include "testimage.h"
+#include "waitfor.h"
 
+#include <functional>
 #include <memory>
 
 #define CHECK_EQUAL_COLOUR_RGB(c1, c2) \
@@ -1052,6 +1057,56 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::SavePNG", "[image]")
 
 }
 
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::SavePNGParallel", "[image]")
+{
+    const wxImageHandler& handler = *wxImage::FindHandler(wxBITMAP_TYPE_PNG);
+
+    // Use an image big enough to be split in several parts.
+    wxImage expected24 = wxImage("horse.png").Scale(600, 600);
+    REQUIRE( expected24.IsOk() );
+
+    expected24.SetOption(wxIMAGE_OPTION_PNG_COMPRESSION_THREADS, 4);
+
+    SECTION("RGB")
+    {
+        CompareImage(handler, expected24);
+
+        expected24.SetOption(wxIMAGE_OPTION_PNG_FILTER, wxPNG_FILTER_NONE);
+        CompareImage(handler, expected24);
+
+        expected24.SetOption(wxIMAGE_OPTION_PNG_FILTER,
+                             wxPNG_FILTER_SUB | wxPNG_FILTER_PAETH);
+        CompareImage(handler, expected24);
+    }
+
+    SECTION("RGBA")
+    {
+        wxImage expected32(expected24);
+        SetAlpha(&expected32);
+
+        CompareImage(handler, expected32, wxIMAGE_HAVE_ALPHA);
+    }
+
+    SECTION("Grey")
+    {
+        wxImage expected8 = expected24.ConvertToGreyscale();
+        expected8.SetOption(wxIMAGE_OPTION_PNG_FORMAT, wxPNG_TYPE_GREY_RED);
+
+        CompareImage(handler, expected8);
+
+        expected8.SetOption(wxIMAGE_OPTION_PNG_BITDEPTH, 16);
+        CompareImage(handler, expected8);
+    }
+
+    SECTION("Palette")
+    {
+        wxImage expected8 = expected24.ConvertToGreyscale();
+        expected8.SetOption(wxIMAGE_OPTION_PNG_FORMAT, wxPNG_TYPE_PALETTE);
+
+        CompareImage(handler, expected8, wxIMAGE_HAVE_PALETTE);
+    }
+}
+
 #if wxUSE_LIBTIFF
 static void TestTIFFImage(const wxString& option, int value,
     const wxImage *compareImage = nullptr)
@@ -1529,6 +1584,617 @@ TEST_CASE_METHOD(ImageHandlersInit, "wxImage::ScaleCompare", "[image]")
                                "image/cross_nearest_neighb_256x256.png");
 }
 
+TEST_CASE("wxImage::ScaleUniform", "[image]")
+{
+    // Scaling an image filled with a single colour must preserve this colour
+    // exactly, whichever algorithm is used, and also preserve the alpha.
+    wxImage image(37, 23);
+    image.SetRGB(wxRect(0, 0, 37, 23), 0x12, 0x80, 0xfe);
+    image.InitAlpha();
+    memset(image.GetAlpha(), 0xc0, 37*23);
+
+    const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_NEAREST,
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+    };
+
+    const wxSize sizes[] = { wxSize(1, 1), wxSize(10, 7), wxSize(101, 89) };
+
+    for ( size_t q = 0; q < WXSIZEOF(qualities); q++ )
+    {
+        for ( size_t s = 0; s < WXSIZEOF(sizes); s++ )
+        {
+            INFO("Quality " << qualities[q] << ", size " << sizes[s]);
+
+            const wxImage scaled = image.Scale(sizes[s].x, sizes[s].y,
+                                               qualities[q]);
+            REQUIRE( scaled.HasAlpha() );
+
+            const unsigned char* data = scaled.GetData();
+            const unsigned char* alpha = scaled.GetAlpha();
+            const int numPixels = sizes[s].x*sizes[s].y;
+            for ( int n = 0; n < numPixels; n++, data += 3 )
+            {
+                CHECK( data[0] == 0x12 );
+                CHECK( data[1] == 0x80 );
+                CHECK( data[2] == 0xfe );
+                CHECK( alpha[n] == 0xc0 );
+            }
+        }
+    }
+}
+
+TEST_CASE("wxImage::View", "[image]")
+{
+    wxImage image(10, 8);
+    image.InitAlpha();
+    for ( int y = 0; y < image.GetHeight(); y++ )
+    {
+        for ( int x = 0; x < image.GetWidth(); x++ )
+        {
+            image.SetRGB(x, y, x, y, x + y);
+            image.SetAlpha(x, y, 10*x + y);
+        }
+    }
+
+    const wxRect rect(2, 3, 5, 4);
+    const wxImageView view(image, rect);
+    REQUIRE( view.IsOk() );
+    CHECK( view.GetSize() == wxSize(5, 4) );
+    CHECK( view.GetStride() == 30 );
+    CHECK( view.GetAlphaStride() == 10 );
+
+    // The view data is the image data itself.
+    CHECK( view.GetData() == image.GetData() + 3*(3*10 + 2) );
+    CHECK( view.GetRowData(1)[0] == 2 );
+    CHECK( view.GetRowData(1)[1] == 4 );
+    CHECK( view.GetRowAlpha(2)[1] == 35 );
+
+    const wxImageView sub = view.GetSubView(wxRect(1, 1, 2, 2));
+    CHECK( sub.GetRect() == wxRect(3, 4, 2, 2) );
+    CHECK( sub.GetRowData(0)[0] == 3 );
+
+    CHECK_THAT( view.ToImage(), RGBASameAs(image.GetSubImage(rect)) );
+    CHECK_THAT( wxImageView(image).ToImage(), RGBASameAs(image) );
+
+    // Modifying the image doesn't affect the existing view.
+    const wxImage copy = view.ToImage();
+    image.SetRGB(2, 3, 0xff, 0xff, 0xff);
+    CHECK( image.GetRed(2, 3) == 0xff );
+    CHECK( view.GetData()[0] == 2 );
+    CHECK_THAT( view.ToImage(), RGBASameAs(copy) );
+}
+
+TEST_CASE("wxImage::PremultipliedARGB", "[image]")
+{
+    wxImage image(3, 2);
+    image.SetRGB(wxRect(0, 0, 3, 2), 0x80, 0x40, 0xff);
+    image.SetRGB(2, 1, 1, 2, 3);
+
+    // Leave a gap of 2 pixels at the end of each row.
+    const int stride = 5*4;
+    wxUint32 buf[2*5];
+    memset(buf, 0xcc, sizeof(buf));
+
+    unsigned char* const data = reinterpret_cast<unsigned char*>(buf);
+
+    SECTION("No alpha")
+    {
+        REQUIRE( image.CopyToPremultipliedARGB(data, stride) );
+        CHECK( buf[0] == 0xff8040ff );
+        CHECK( buf[2] == 0xff8040ff );
+        CHECK( buf[3] == 0xcccccccc );
+        CHECK( buf[7] == 0xff010203 );
+
+        wxImage copy;
+        REQUIRE( copy.CreateFromPremultipliedARGB(3, 2, data, stride, false) );
+        CHECK( !copy.HasAlpha() );
+        CHECK_THAT( copy, RGBSameAs(image) );
+    }
+
+    SECTION("Alpha")
+    {
+        image.InitAlpha();
+        image.SetAlpha(1, 0, 0x80);
+        image.SetAlpha(2, 0, wxALPHA_TRANSPARENT);
+
+        REQUIRE( image.CopyToPremultipliedARGB(data, stride) );
+        CHECK( buf[0] == 0xff8040ff );
+        CHECK( buf[1] == 0x80402080 );
+        CHECK( buf[2] == 0 );
+
+        wxImage copy;
+        REQUIRE( copy.CreateFromPremultipliedARGB(3, 2, data, stride) );
+        REQUIRE( copy.HasAlpha() );
+        CHECK( copy.GetAlpha(1, 0) == 0x80 );
+        CHECK( copy.GetRed(1, 0) == 0x7f );
+        CHECK( copy.GetGreen(1, 0) == 0x3f );
+        CHECK( copy.GetBlue(1, 0) == 0xff );
+        CHECK( copy.GetAlpha(2, 1) == wxALPHA_OPAQUE );
+        CHECK( copy.GetRed(2, 1) == 1 );
+    }
+
+    SECTION("Mask")
+    {
+        image.SetMaskColour(1, 2, 3);
+
+        REQUIRE( image.CopyToPremultipliedARGB(data, stride) );
+        CHECK( buf[0] == 0xff8040ff );
+        CHECK( buf[7] == 0 );
+    }
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::MaxSize", "[image]")
+{
+    // Both JPEG, which scales the image during loading, and PNG, which
+    // doesn't, must result in the same size.
+    const char* const files[] = { "horse.jpg", "horse.png" };
+
+    for ( const char* const file : files )
+    {
+        INFO("Loading " << file);
+
+        wxImage image;
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 60);
+        image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, 80);
+        REQUIRE( image.LoadFile(file) );
+
+        CHECK( image.GetSize() == wxSize(60, 60) );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 200 );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == 200 );
+
+        image = wxImage();
+        image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, 150);
+        REQUIRE( image.LoadFile(file) );
+
+        CHECK( image.GetSize() == wxSize(150, 150) );
+
+        // The image must not be scaled up.
+        image = wxImage();
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 500);
+        REQUIRE( image.LoadFile(file) );
+
+        CHECK( image.GetSize() == wxSize(200, 200) );
+        CHECK( !image.HasOption(wxIMAGE_OPTION_ORIGINAL_WIDTH) );
+    }
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::BatchLoader", "[image]")
+{
+    wxEvtHandler handler;
+
+    const size_t numFiles = WXSIZEOF(g_testfiles);
+
+    wxVector<wxImage> images(numFiles + 1);
+    wxVector<bool> received(images.size(), false);
+    int numLoaded = 0,
+        numCompleted = 0;
+
+    handler.Bind(wxEVT_IMAGE_BATCH_LOADED, [&](wxImageBatchEvent& event)
+    {
+        REQUIRE( event.GetIndex() < images.size() );
+        CHECK( !received[event.GetIndex()] );
+
+        received[event.GetIndex()] = true;
+        images[event.GetIndex()] = event.GetImage();
+        numLoaded++;
+    });
+
+    handler.Bind(wxEVT_IMAGE_BATCH_COMPLETED, [&](wxImageBatchEvent&)
+    {
+        numCompleted++;
+    });
+
+    wxImageBatchLoader loader(&handler);
+    loader.SetMaxPending(2);
+    loader.SetMaxSize(20, 20);
+
+    for ( size_t n = 0; n < numFiles; n++ )
+        CHECK( loader.Add(g_testfiles[n].file, g_testfiles[n].type) == n );
+
+    CHECK( loader.Add("nosuchfile.png") == numFiles );
+
+    WaitFor("images to be loaded", [&]() { return numCompleted != 0; }, 5000);
+
+    CHECK( numCompleted == 1 );
+    CHECK( numLoaded == static_cast<int>(images.size()) );
+    CHECK( loader.GetPendingCount() == 0 );
+
+    for ( size_t n = 0; n < numFiles; n++ )
+    {
+        INFO("Loading " << g_testfiles[n].file);
+        CHECK( images[n].IsOk() );
+        CHECK( images[n].GetSize() == wxSize(20, 20) );
+    }
+
+    CHECK( !images.back().IsOk() );
+}
+
+namespace
+{
+
+// Handler blocking in LoadFile() until it is allowed to continue.
+class SlowImageHandler : public wxImageHandler
+{
+public:
+    static const wxBitmapType Type =
+        static_cast<wxBitmapType>(wxBITMAP_TYPE_MAX + 1);
+
+    SlowImageHandler()
+    {
+        SetName("Slow");
+        SetType(Type);
+    }
+
+    virtual bool LoadFile(wxImage* image, wxInputStream& WXUNUSED(stream),
+                          bool WXUNUSED(verbose), int WXUNUSED(index)) override
+    {
+        ms_started.Post();
+        ms_release.Wait();
+
+        return image->Create(1, 1);
+    }
+
+    // Allow the blocked LoadFile() to return, does nothing if called again.
+    static void Release()
+    {
+        if ( !ms_released )
+        {
+            ms_released = true;
+            ms_release.Post();
+        }
+    }
+
+    static wxSemaphore ms_started,
+                       ms_release;
+    static bool ms_released;
+
+protected:
+    virtual bool DoCanRead(wxInputStream& WXUNUSED(stream)) override
+    {
+        return false;
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(SlowImageHandler);
+};
+
+wxSemaphore SlowImageHandler::ms_started;
+wxSemaphore SlowImageHandler::ms_release;
+bool SlowImageHandler::ms_released = false;
+
+wxIMPLEMENT_DYNAMIC_CLASS(SlowImageHandler, wxImageHandler);
+
+} // anonymous namespace
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::BatchLoader::Cancel", "[image]")
+{
+    wxImage::AddHandler(new SlowImageHandler);
+
+    wxEvtHandler handler;
+
+    wxVector<size_t> loaded;
+    int numCompleted = 0;
+
+    handler.Bind(wxEVT_IMAGE_BATCH_LOADED, [&](wxImageBatchEvent& event)
+    {
+        loaded.push_back(event.GetIndex());
+    });
+
+    handler.Bind(wxEVT_IMAGE_BATCH_COMPLETED, [&](wxImageBatchEvent&)
+    {
+        numCompleted++;
+    });
+
+    {
+        wxImageBatchLoader loader(&handler, wxID_ANY, 2);
+
+        // The loader would block in its destructor if the image was still
+        // being loaded, so ensure it isn't, even if any checks below fail.
+        wxON_BLOCK_EXIT0(SlowImageHandler::Release);
+
+        // Cancel loading while the first image is still being loaded.
+        loader.Add("horse.png", SlowImageHandler::Type);
+        REQUIRE( SlowImageHandler::ms_started.WaitTimeout(5000) == wxSEMA_NO_ERROR );
+
+        loader.Cancel();
+        CHECK( loader.GetPendingCount() == 0 );
+
+        // The new batch must be completed even if the image from the old
+        // one is still being loaded.
+        CHECK( loader.Add("horse.png", wxBITMAP_TYPE_PNG) == 1 );
+        CHECK( loader.GetPendingCount() == 1 );
+
+        WaitFor("new batch to complete", [&]() { return numCompleted != 0; }, 5000);
+
+        CHECK( numCompleted == 1 );
+        REQUIRE( loaded.size() == 1 );
+        CHECK( loaded[0] == 1 );
+        CHECK( loader.GetPendingCount() == 0 );
+
+        // Let the cancelled image finish loading: no events must be sent
+        // for it.
+        SlowImageHandler::Release();
+        YieldForAWhile();
+    }
+
+    CHECK( loaded.size() == 1 );
+    CHECK( numCompleted == 1 );
+
+    wxImage::RemoveHandler("Slow");
+}
+
+#endif // wxUSE_THREADS
+
+namespace
+{
+
+// Sink storing the rows in a wxImage, which can then be compared with the
+// image loaded normally.
+class TestRowSink : public wxImageRowSink
+{
+public:
+    TestRowSink() = default;
+
+    virtual bool OnStart(int width, int height, bool hasAlpha) override
+    {
+        if ( !m_image.Create(width, height) )
+            return false;
+
+        if ( hasAlpha )
+            m_image.InitAlpha();
+
+        return true;
+    }
+
+    virtual bool OnRows(int y, int count,
+                        const unsigned char* data,
+                        const unsigned char* alpha) override
+    {
+        if ( m_stopAt == 0 )
+            return false;
+
+        m_stopAt--;
+        m_numCalls++;
+
+        const int width = m_image.GetWidth();
+        memcpy(m_image.GetData() + 3*width*y, data, 3*width*count);
+        if ( alpha )
+            memcpy(m_image.GetAlpha() + width*y, alpha, width*count);
+
+        return true;
+    }
+
+    const wxImage& GetImage() const { return m_image; }
+    int GetNumCalls() const { return m_numCalls; }
+
+    void StopAfter(int numCalls) { m_stopAt = numCalls; }
+
+private:
+    wxImage m_image;
+    int m_numCalls = 0;
+    int m_stopAt = -1;
+};
+
+} // anonymous namespace
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadRows", "[image]")
+{
+    const char* const files[] = { "horse.png", "horse.jpg", "image/toucan.png" };
+
+    for ( const char* const file : files )
+    {
+        INFO("Loading " << file);
+
+        wxImage expected;
+        REQUIRE( expected.LoadFile(file) );
+
+        wxFileInputStream stream(file);
+        REQUIRE( stream.IsOk() );
+
+        wxImage image;
+        TestRowSink sink;
+        CHECK( image.LoadRows(stream, sink) );
+
+        const wxImage& loaded = sink.GetImage();
+        REQUIRE( loaded.GetSize() == expected.GetSize() );
+        // Interlaced images rows are passed to the sink more than once.
+        CHECK( sink.GetNumCalls() >= expected.GetHeight() );
+
+        if ( expected.HasAlpha() )
+            CHECK_THAT( loaded, RGBASameAs(expected) );
+        else
+            CHECK_THAT( loaded, RGBSameAs(expected) );
+
+        // Check that loading can be stopped too.
+        wxFileInputStream stream2(file);
+        REQUIRE( stream2.IsOk() );
+
+        wxLogNull noLog;
+
+        TestRowSink sinkStop;
+        sinkStop.StopAfter(10);
+        CHECK( !image.LoadRows(stream2, sinkStop) );
+        CHECK( sinkStop.GetNumCalls() == 10 );
+    }
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadRows::Interlaced", "[image]")
+{
+    // This image uses Adam7 interlacing.
+    const char* const file = "image/toucan.png";
+
+    wxImage expected;
+    REQUIRE( expected.LoadFile(file) );
+
+    const int width = expected.GetWidth();
+    const int height = expected.GetHeight();
+
+    // Load only the first pass, during which all rows are passed to the sink.
+    const auto loadFirstPass = [=]()
+    {
+        wxFileInputStream stream(file);
+        REQUIRE( stream.IsOk() );
+
+        wxLogNull noLog;
+
+        TestRowSink sink;
+        sink.StopAfter(height);
+
+        wxImage image;
+        CHECK( !image.LoadRows(stream, sink) );
+        CHECK( sink.GetNumCalls() == height );
+
+        return sink.GetImage();
+    };
+
+    const wxImage pass1 = loadFirstPass();
+    REQUIRE( pass1.GetSize() == expected.GetSize() );
+
+    // After the first pass, each 8*8 block must be filled with the colour of
+    // its top left pixel, which is the only one decoded so far.
+    int mismatches = 0;
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            const int x0 = x & ~7,
+                      y0 = y & ~7;
+            if ( pass1.GetRed(x, y) != expected.GetRed(x0, y0) ||
+                    pass1.GetGreen(x, y) != expected.GetGreen(x0, y0) ||
+                        pass1.GetBlue(x, y) != expected.GetBlue(x0, y0) )
+                mismatches++;
+        }
+    }
+    CHECK( mismatches == 0 );
+
+    // And loading it again must give exactly the same result.
+    CHECK_THAT( loadFirstPass(), RGBSameAs(pass1) );
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::Blur", "[image]")
+{
+    SECTION("Edges")
+    {
+        wxImage image(3, 1);
+        image.SetRGB(0, 0, 0, 0, 0);
+        image.SetRGB(1, 0, 30, 60, 3);
+        image.SetRGB(2, 0, 90, 120, 9);
+
+        wxImage blurred = image.BlurHorizontal(1);
+        CHECK( blurred.GetRed(0, 0) == 10 );
+        CHECK( blurred.GetRed(1, 0) == 40 );
+        CHECK( blurred.GetRed(2, 0) == 70 );
+        CHECK( blurred.GetGreen(2, 0) == 100 );
+        CHECK( blurred.GetBlue(1, 0) == 4 );
+
+        // Radius bigger than the image size must work too.
+        blurred = image.BlurHorizontal(5);
+        CHECK( blurred.GetRed(0, 0) == (6*0 + 30 + 4*90)/11 );
+        CHECK( blurred.GetRed(2, 0) == (4*0 + 30 + 6*90)/11 );
+        CHECK_THAT( image.Blur(5), RGBSameAs(blurred) );
+    }
+
+    wxImage original;
+    REQUIRE( original.LoadFile("horse.bmp") );
+
+    SECTION("With alpha")
+    {
+        original.InitAlpha();
+
+        unsigned char* alpha = original.GetAlpha();
+        const int numPixels = original.GetWidth()*original.GetHeight();
+        for ( int n = 0; n < numPixels; n++ )
+            alpha[n] = static_cast<unsigned char>(n * 13);
+    }
+
+    SECTION("Without alpha")
+    {
+    }
+
+    // Blurring in both directions at once must be the same as doing it in
+    // each direction separately.
+    CHECK_THAT( original.Blur(4),
+                RGBASameAs(original.BlurHorizontal(4).BlurVertical(4)) );
+
+    CHECK_THAT( original.Blur(2, 3),
+                RGBASameAs(original.Blur(2).Blur(2).Blur(2)) );
+
+    const wxImage large = original.Scale(1000, 10);
+    CHECK_THAT( large.Blur(20, 2), RGBASameAs(large.Blur(20).Blur(20)) );
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::Parallelism", "[image]")
+{
+    wxImage original;
+    REQUIRE(original.LoadFile("horse.bmp"));
+
+    // Make the image big enough to be split into several bands.
+    original.Rescale(original.GetWidth()*4, original.GetHeight()*4,
+                     wxIMAGE_QUALITY_NEAREST);
+
+    // Check that the results are the same whether threads are used or not.
+    const auto check = [&original](const std::function<wxImage(wxImage)>& op)
+    {
+        wxImage::SetParallelism(1);
+        const wxImage expected = op(original.Copy());
+
+        wxImage::SetParallelism(0);
+        const wxImage actual = op(original.Copy());
+
+        wxImage::SetParallelism(3);
+        const wxImage actual3 = op(original.Copy());
+
+        wxImage::SetParallelism(1);
+
+        REQUIRE( actual.HasAlpha() == expected.HasAlpha() );
+        if ( expected.HasAlpha() )
+        {
+            CHECK_THAT( actual, RGBASameAs(expected) );
+            CHECK_THAT( actual3, RGBASameAs(expected) );
+        }
+        else
+        {
+            CHECK_THAT( actual, RGBSameAs(expected) );
+            CHECK_THAT( actual3, RGBSameAs(expected) );
+        }
+    };
+
+    for ( int withAlpha = 0; withAlpha < 2; withAlpha++ )
+    {
+        if ( withAlpha )
+        {
+            original.InitAlpha();
+
+            unsigned char* alpha = original.GetAlpha();
+            const int numPixels = original.GetWidth()*original.GetHeight();
+            for ( int n = 0; n < numPixels; n++ )
+                alpha[n] = static_cast<unsigned char>(n * 7);
+        }
+
+        check([](wxImage i) { return i.Scale(123, 456, wxIMAGE_QUALITY_NEAREST); });
+        check([](wxImage i) { return i.Scale(123, 456, wxIMAGE_QUALITY_BILINEAR); });
+        check([](wxImage i) { return i.Scale(900, 700, wxIMAGE_QUALITY_BICUBIC); });
+        check([](wxImage i) { return i.Scale(123, 456, wxIMAGE_QUALITY_BOX_AVERAGE); });
+        check([](wxImage i) { return i.Blur(7); });
+        check([](wxImage i) { return i.Blur(3, 3); });
+        check([](wxImage i) { return i.BlurVertical(5); });
+        check([](wxImage i) { return i.Rotate(0.3, wxPoint(10, 20)); });
+        check([](wxImage i) { return i.Rotate(0.7, wxPoint(10, 20), false); });
+        check([](wxImage i) { i.ChangeHSV(0.1, -0.2, 0.3); return i; });
+        check([](wxImage i) { return i.ConvertToGreyscale(); });
+    }
+}
+
+#endif // wxUSE_THREADS
+
 TEST_CASE_METHOD(ImageHandlersInit, "wxImage::CreateBitmapFromCursor", "[image]")
 {
 #if !defined __WXOSX_IPHONE__ && !defined __WXDFB__ && !defined __WXX11__
@@ -18,8 +18,11 @@
 
 #include "wx/thread.h"
 #include "wx/utils.h"
+#include "wx/private/threadpool.h"
 
+#include <atomic>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 // ----------------------------------------------------------------------------
@@ -418,3 +421,37 @@ void MiscThreadTestCase::TestThreadConditions()
         nFinished++;
     }
 }
+
+#if wxUSE_EXCEPTIONS
+
+TEST_CASE("wxThreadPool::ParallelFor::Exception", "[thread][pool]")
+{
+    wxThreadPool pool(4);
+
+    std::atomic<int> processed(0);
+    REQUIRE_THROWS_AS(
+        pool.ParallelFor(1000, [&processed](size_t n)
+        {
+            if ( n == 10 )
+                throw std::runtime_error("item failed");
+
+            wxMilliSleep(1);
+            ++processed;
+        }),
+        std::runtime_error
+    );
+
+    // No calls must be still running when ParallelFor() returns and the
+    // items after the failed one should have been skipped.
+    const int count = processed;
+    wxMilliSleep(50);
+    CHECK( processed == count );
+    CHECK( count < 999 );
+
+    // The pool must remain usable.
+    processed = 0;
+    pool.ParallelFor(100, [&processed](size_t) { ++processed; });
+    CHECK( processed == 100 );
+}
+
+#endif // wxUSE_EXCEPTIONS